@@ -175,6 +175,16 @@ TensorModifyUpdate::apply_to(const Value &old_tensor,
     return {};
 }
 
+size_t
+TensorModifyUpdate::apply_to_dense_cells(const ValueType &type, vespalib::eval::TypedCells cells) const
+{
+    if (auto cellsTensor = _tensor->getAsTensorPtr()) {
+        auto op = getJoinFunction(_operation);
+        return TensorPartialUpdate::modify_dense_cells(type, cells, op, *cellsTensor);
+    }
+    return 0;
+}
+
 bool
 TensorModifyUpdate::applyTo(FieldValue& value) const
 {
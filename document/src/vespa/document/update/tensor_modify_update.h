@@ -3,7 +3,7 @@
 #include "tensor_update.h"
 #include "valueupdate.h"
 
-namespace vespalib::eval { struct Value; }
+namespace vespalib::eval { struct Value; class ValueType; struct TypedCells; }
 
 namespace document {
 
@@ -46,6 +46,12 @@ public:
     std::unique_ptr<Value> apply_to(const Value &tensor,
                                     const ValueBuilderFactory &factory) const override;
     bool applyTo(FieldValue &value) const override;
+    /*
+     * Apply this update directly to the cells of a dense tensor with
+     * the given type. The cells must not be visible to any readers.
+     * Returns the number of cells that got a new value.
+     */
+    size_t apply_to_dense_cells(const vespalib::eval::ValueType &type, vespalib::eval::TypedCells cells) const;
     void printXml(XmlOutputStream &xos) const override;
     void print(std::ostream &out, bool verbose, const std::string &indent) const override;
     void deserialize(const DocumentTypeRepo &repo, const DataType &type, nbostream &stream) override;
@@ -7,6 +7,7 @@
 #include <vespa/vespalib/util/visit_ranges.h>
 #include <vespa/vespalib/util/shared_string_repo.h>
 #include <cassert>
+#include <cstring>
 #include <set>
 
 #include <vespa/log/log.h>
@@ -247,6 +248,47 @@ PerformModify::invoke(const Value &input, join_fun_t function, const Value &modi
 
 //-----------------------------------------------------------------------------
 
+struct PerformModifyDenseCells {
+    template<typename ICT, typename MCT>
+    static size_t invoke(const ValueType &input_type,
+                         TypedCells cells,
+                         join_fun_t function,
+                         const Value &modifier);
+};
+
+template <typename ICT, typename MCT>
+size_t
+PerformModifyDenseCells::invoke(const ValueType &input_type, TypedCells cells, join_fun_t function, const Value &modifier)
+{
+    AddressHandler handler(input_type, modifier.type());
+    if (! handler.valid) {
+        return 0;
+    }
+    auto dst = unconstify(cells.typify<ICT>());
+    const auto modifier_cells = modifier.cells().typify<MCT>();
+    auto modifier_view = modifier.index().create_view({});
+    modifier_view->lookup({});
+    size_t num_changed = 0;
+    size_t modifier_subspace_index;
+    while (modifier_view->next_result(handler.from_modifier.next_result_refs, modifier_subspace_index)) {
+        handler.handle_address();
+        size_t dense_idx = handler.dense_converter.get_dense_index();
+        if (dense_idx == npos()) {
+            continue;
+        }
+        ICT lhs = dst[dense_idx];
+        MCT rhs = modifier_cells[modifier_subspace_index];
+        ICT result = ICT(function(lhs, rhs));
+        if (memcmp(&result, &lhs, sizeof(ICT)) != 0) {
+            dst[dense_idx] = result;
+            ++num_changed;
+        }
+    }
+    return num_changed;
+}
+
+//-----------------------------------------------------------------------------
+
 struct PerformAdd {
     template<typename ICT, typename MCT>
     static Value::UP invoke(const Value &input,
@@ -403,6 +445,18 @@ TensorPartialUpdate::modify(const Value &input, join_fun_t function,
             input, function, modifier, factory);
 }
 
+size_t
+TensorPartialUpdate::modify_dense_cells(const ValueType &input_type, TypedCells cells,
+                                        join_fun_t function, const Value &modifier)
+{
+    assert(input_type.is_dense());
+    assert(cells.type == input_type.cell_type());
+    assert(cells.size == input_type.dense_subspace_size());
+    return typify_invoke<2, TypifyCellType, PerformModifyDenseCells>(
+            cells.type, modifier.cells().type,
+            input_type, cells, function, modifier);
+}
+
 Value::UP
 TensorPartialUpdate::add(const Value &input, const Value &add_cells, const ValueBuilderFactory &factory)
 {
@@ -12,6 +12,8 @@ struct TensorPartialUpdate {
     using join_fun_t = vespalib::eval::operation::op2_t;
     using Value = vespalib::eval::Value;
     using ValueBuilderFactory = vespalib::eval::ValueBuilderFactory;
+    using ValueType = vespalib::eval::ValueType;
+    using TypedCells = vespalib::eval::TypedCells;
 
     /**
      *  Make a copy of the input, but apply function(oldvalue, modifier.cellvalue)
@@ -23,6 +25,18 @@ struct TensorPartialUpdate {
     static Value::UP modify(const Value &input, join_fun_t function,
                             const Value &modifier, const ValueBuilderFactory &factory);
 
+    /**
+     *  Apply function(oldvalue, modifier.cellvalue) directly to the
+     *  cells of a dense value of the given type, for cells which also
+     *  exist in the "modifier". The cells must refer to memory that
+     *  is owned by the caller and not visible to any readers.
+     *  The modifier type must be as for modify() above.
+     *  Returns the number of cells that got a new value; zero if the
+     *  constraints are violated (leaving the cells untouched).
+     **/
+    static size_t modify_dense_cells(const ValueType &input_type, TypedCells cells,
+                                     join_fun_t function, const Value &modifier);
+
     /**
      *  Make a copy of the input, but add or overwrite cells from add_cells.
      *  Requires same type for input and add_cells.
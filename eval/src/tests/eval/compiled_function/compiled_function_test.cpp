@@ -2,9 +2,12 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/eval/eval/function.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/eval/eval/llvm/object_code_cache.h>
+#include <vespa/eval/eval/vm_forest.h>
 #include <vespa/eval/eval/test/eval_spec.h>
 #include <vespa/eval/eval/basic_nodes.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/io/fileutil.h>
 #include <cmath>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <iostream>
@@ -222,6 +225,69 @@ TEST_MT("require that multithreaded compilation works", 32) {
 
 //-----------------------------------------------------------------------------
 
+vespalib::string make_forest_expr(size_t num_trees) {
+    vespalib::string expr;
+    for (size_t i = 0; i < num_trees; ++i) {
+        expr += vespalib::make_string("%sif(a<%zu,%zu,if(b<%zu,%zu,%zu))", (i == 0) ? "" : "+", i, i, i, 2 * i, 3 * i);
+    }
+    return expr;
+}
+
+TEST("require that compiled functions can be stored in and loaded from object code cache") {
+    vespalib::string dir = "object_code_cache";
+    vespalib::rmdir(dir, true);
+    auto set_fun = Function::parse({"a"}, "a in [1,2,3,4,5,6,7,8,9,10,11,12]");
+    auto forest_fun = Function::parse({"a", "b"}, make_forest_expr(64));
+    std::vector<double> set_params({12.0});
+    std::vector<double> forest_params({21.0, 10.0});
+    double forest_expect = CompiledFunction(*forest_fun, PassParams::ARRAY, gbdt::Optimize::none).get_function()(&forest_params[0]);
+    ObjectCodeCache::bind(dir);
+    auto cache = ObjectCodeCache::get();
+    ASSERT_TRUE(cache);
+    for (size_t i = 0; i < 2; ++i) {
+        CompiledFunction set_cf(*set_fun, PassParams::ARRAY);
+        CompiledFunction forest_cf(*forest_fun, PassParams::ARRAY, gbdt::VMForest::optimize_chain);
+        CompiledFunction lazy_cf(*forest_fun, PassParams::LAZY, gbdt::VMForest::optimize_chain);
+        EXPECT_EQUAL(1u, forest_cf.get_forests().size());
+        EXPECT_EQUAL(1.0, set_cf.get_function()(&set_params[0]));
+        EXPECT_EQUAL(forest_expect, forest_cf.get_function()(&forest_params[0]));
+        EXPECT_EQUAL(forest_expect, lazy_cf.get_lazy_function()(my_resolve, &forest_params[0]));
+        EXPECT_EQUAL(3u, cache->num_stored());
+        EXPECT_EQUAL(3u * i, cache->num_loaded());
+    }
+    // native state (like large sets) is not part of the object code
+    CompiledFunction other_cf(*Function::parse({"a"}, "a in [1,2,3,4,5,6,7,8,9,10,11,13]"), PassParams::ARRAY);
+    EXPECT_EQUAL(0.0, other_cf.get_function()(&set_params[0]));
+    EXPECT_EQUAL(3u, cache->num_stored());
+    EXPECT_EQUAL(4u, cache->num_loaded());
+    ObjectCodeCache::bind("");
+    EXPECT_FALSE(ObjectCodeCache::get());
+    vespalib::rmdir(dir, true);
+}
+
+TEST("require that object code cache is pruned to its max size") {
+    vespalib::string dir = "object_code_cache";
+    vespalib::rmdir(dir, true);
+    auto fun = Function::parse({"a", "b"}, "a+b");
+    std::vector<double> params({1.0, 2.0});
+    ObjectCodeCache::bind(dir);
+    EXPECT_EQUAL(3.0, CompiledFunction(*fun, PassParams::ARRAY).get_function()(&params[0]));
+    EXPECT_EQUAL(3.0, CompiledFunction(*fun, PassParams::SEPARATE).get_function<2>()(1.0, 2.0));
+    EXPECT_EQUAL(2u, ObjectCodeCache::get()->num_stored());
+    EXPECT_EQUAL(0u, ObjectCodeCache::get()->num_removed());
+    ObjectCodeCache::bind(dir, 0);
+    auto cache = ObjectCodeCache::get();
+    EXPECT_EQUAL(2u, cache->num_removed());
+    EXPECT_EQUAL(3.0, CompiledFunction(*fun, PassParams::ARRAY).get_function()(&params[0]));
+    EXPECT_EQUAL(1u, cache->num_stored());
+    EXPECT_EQUAL(0u, cache->num_loaded());
+    EXPECT_EQUAL(3u, cache->num_removed());
+    ObjectCodeCache::bind("");
+    vespalib::rmdir(dir, true);
+}
+
+//-----------------------------------------------------------------------------
+
 TEST("require that function issues can be detected") {
     auto simple = Function::parse("a+b");
     auto complex = Function::parse("join(a,b,f(a,b)(a+b))");
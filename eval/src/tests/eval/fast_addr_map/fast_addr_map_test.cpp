@@ -0,0 +1,121 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/fast_addr_map.h>
+#include <vespa/vespalib/util/shared_string_repo.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+
+using Handles = SharedStringRepo::Handles;
+using vespalib::make_string_short::fmt;
+
+// sparse addresses with a given number of dimensions, where the
+// labels of address 'i' are made from 'i' and a per-map offset
+struct MyAddrs {
+    size_t num_dims;
+    Handles handles;
+    MyAddrs(size_t num_dims_in, size_t num_addrs, size_t offset)
+        : num_dims(num_dims_in), handles()
+    {
+        for (size_t i = 0; i < num_addrs; ++i) {
+            for (size_t d = 0; d < num_dims; ++d) {
+                handles.add(fmt("%zu_%zu", (i + offset), d));
+            }
+        }
+    }
+    ConstArrayRef<string_id> get_addr(size_t i) const {
+        return {&handles.view()[i * num_dims], num_dims};
+    }
+    void fill(FastAddrMap &map) const {
+        size_t num_addrs = handles.view().size() / num_dims;
+        for (size_t i = 0; i < num_addrs; ++i) {
+            map.add_mapping(FastAddrMap::hash_labels(get_addr(i)));
+        }
+    }
+};
+
+TEST(FastAddrMapTest, all_added_addresses_can_be_found) {
+    for (size_t num_dims: {1, 2, 3}) {
+        for (size_t num_addrs: {0, 1, 2, 7, 15, 16, 17, 100, 1000}) {
+            SCOPED_TRACE(fmt("num_dims: %zu, num_addrs: %zu", num_dims, num_addrs));
+            MyAddrs addrs(num_dims, num_addrs, 0);
+            MyAddrs other(num_dims, num_addrs, num_addrs);
+            FastAddrMap map(num_dims, addrs.handles.view(), 1);
+            addrs.fill(map);
+            EXPECT_EQ(map.size(), num_addrs);
+            for (size_t i = 0; i < num_addrs; ++i) {
+                EXPECT_EQ(map.lookup(addrs.get_addr(i)), i);
+                EXPECT_EQ(map.lookup(other.get_addr(i)), FastAddrMap::npos());
+            }
+        }
+    }
+}
+
+TEST(FastAddrMapTest, all_map_entries_are_visited) {
+    MyAddrs addrs(2, 100, 0);
+    FastAddrMap map(2, addrs.handles.view(), 100);
+    addrs.fill(map);
+    std::vector<size_t> seen(100, 0);
+    map.each_map_entry([&](auto subspace, auto hash) {
+                           ASSERT_LT(subspace, 100);
+                           EXPECT_EQ(hash, FastAddrMap::hash_labels(addrs.get_addr(subspace)));
+                           ++seen[subspace];
+                       });
+    EXPECT_EQ(seen, std::vector<size_t>(100, 1));
+}
+
+TEST(FastAddrMapTest, addresses_of_another_map_can_be_looked_up_in_batches) {
+    for (size_t num_dims: {1, 3}) {
+        SCOPED_TRACE(fmt("num_dims: %zu", num_dims));
+        // overlapping addresses: 50..149
+        MyAddrs my_addrs(num_dims, 150, 0);
+        MyAddrs other_addrs(num_dims, 100, 50);
+        FastAddrMap my_map(num_dims, my_addrs.handles.view(), 150);
+        FastAddrMap other_map(num_dims, other_addrs.handles.view(), 100);
+        my_addrs.fill(my_map);
+        other_addrs.fill(other_map);
+        size_t expect_subspace = 0;
+        my_map.lookup_each(other_map, [&](auto other_subspace, auto hash, auto my_subspace) {
+                               EXPECT_EQ(other_subspace, expect_subspace++);
+                               EXPECT_EQ(hash, FastAddrMap::hash_labels(other_addrs.get_addr(other_subspace)));
+                               EXPECT_EQ(my_subspace, other_subspace + 50);
+                           });
+        EXPECT_EQ(expect_subspace, 100);
+        size_t num_found = 0;
+        other_map.lookup_each(my_map, [&](auto my_subspace, auto, auto other_subspace) {
+                                  if (my_subspace < 50) {
+                                      EXPECT_EQ(other_subspace, FastAddrMap::npos());
+                                  } else {
+                                      EXPECT_EQ(other_subspace, my_subspace - 50);
+                                      ++num_found;
+                                  }
+                              });
+        EXPECT_EQ(num_found, 100);
+    }
+}
+
+TEST(FastAddrMapTest, addresses_with_colliding_hashes_are_kept_apart) {
+    // use the same hash for all addresses to force collisions
+    Handles handles;
+    handles.add("a");
+    handles.add("b");
+    handles.add("c");
+    handles.add("d");
+    FastAddrMap map(2, handles.view(), 2);
+    map.add_mapping(42);
+    map.add_mapping(42);
+    auto a = handles.view()[0];
+    auto b = handles.view()[1];
+    auto c = handles.view()[2];
+    auto d = handles.view()[3];
+    std::vector<string_id> ab = {a, b};
+    std::vector<string_id> cd = {c, d};
+    std::vector<string_id> ba = {b, a};
+    EXPECT_EQ(map.lookup(ConstArrayRef<string_id>(ab), 42), 0);
+    EXPECT_EQ(map.lookup(ConstArrayRef<string_id>(cd), 42), 1);
+    EXPECT_EQ(map.lookup(ConstArrayRef<string_id>(ba), 42), FastAddrMap::npos());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
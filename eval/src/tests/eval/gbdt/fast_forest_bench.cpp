@@ -4,10 +4,12 @@
 #include <vespa/eval/eval/fast_forest.h>
 #include <vespa/eval/eval/vm_forest.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
 #include "model.cpp"
 
 using namespace vespalib::eval;
 using namespace vespalib::eval::gbdt;
+using vespalib::BenchmarkTimer;
 
 template <typename T>
 void estimate_cost(size_t num_params, const char *label, const T &impl) {
@@ -23,6 +25,24 @@ void estimate_cost(size_t num_params, const char *label, const T &impl) {
             label, (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0));
 }
 
+double estimate_batch_cost_us(const FastForest &forest, size_t num_params, double value) {
+    auto ctx = forest.create_context();
+    size_t num_docs = FastForest::max_batch_size;
+    std::vector<float> params(num_params * num_docs, value);
+    std::vector<double> results(num_docs);
+    return BenchmarkTimer::benchmark([&](){ forest.eval_batch(*ctx, &params[0], num_docs, &results[0]); }, 5.0) * 1000.0 * 1000.0;
+}
+
+void estimate_batch_cost(size_t num_params, const FastForest &forest) {
+    double us_min = estimate_batch_cost_us(forest, num_params, 0.25);
+    double us_med = estimate_batch_cost_us(forest, num_params, 0.50);
+    double us_max = estimate_batch_cost_us(forest, num_params, 0.75);
+    double us_nan = estimate_batch_cost_us(forest, num_params, std::numeric_limits<float>::quiet_NaN());
+    double scale = (100.0 / FastForest::max_batch_size) / 1000.0;
+    fprintf(stderr, "[%12s] (per 100 eval): [low values] %6.3f ms, [medium values] %6.3f ms, [high values] %6.3f ms, [nan values] %6.3f ms\n",
+            "batch", (us_min * scale), (us_med * scale), (us_max * scale), (us_nan * scale));
+}
+
 void run_fast_forest_bench() {
     for (size_t tree_size: std::vector<size_t>({8,16,32,64,128,256})) {
         for (size_t num_trees: std::vector<size_t>({100, 500, 2500, 5000, 10000})) {
@@ -36,6 +56,7 @@ void run_fast_forest_bench() {
                             auto forest = FastForest::try_convert(*function, min_bits, 64);
                             if (forest) {
                                 estimate_cost(function->num_params(), forest->impl_name().c_str(), *forest);
+                                estimate_batch_cost(function->num_params(), *forest);
                             }
                             if (min_bits > 64) {
                                 break;
@@ -51,6 +51,38 @@ double eval_ff(const FastForest &ff, FastForest::Context &ctx, const std::vector
     return ff.eval(ctx, &my_params[0]);
 }
 
+std::vector<double> eval_ff_batch(const FastForest &ff, FastForest::Context &ctx, const std::vector<std::vector<double>> &docs) {
+    size_t num_docs = docs.size();
+    size_t num_params = docs.empty() ? 0 : docs[0].size();
+    std::vector<float> my_params(num_params * num_docs);
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        for (size_t param = 0; param < num_params; ++param) {
+            my_params[(param * num_docs) + doc] = docs[doc][param];
+        }
+    }
+    std::vector<double> results(num_docs);
+    ff.eval_batch(ctx, &my_params[0], num_docs, &results[0]);
+    return results;
+}
+
+std::vector<std::vector<double>> make_batch_inputs(size_t num_docs, size_t num_params) {
+    std::vector<std::vector<double>> docs;
+    uint32_t seed = 1234;
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        docs.emplace_back();
+        for (size_t param = 0; param < num_params; ++param) {
+            seed = (seed * 1103515245) + 12345;
+            uint32_t value = ((seed >> 16) % 1000);
+            if (value < 50) {
+                docs.back().push_back(std::numeric_limits<double>::quiet_NaN());
+            } else {
+                docs.back().push_back(double(value) / 1000.0);
+            }
+        }
+    }
+    return docs;
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that tree stats can be calculated") {
@@ -337,6 +369,33 @@ TEST("require that FastForest model evaluation works") {
     EXPECT_EQUAL(eval_ff(*forest, *ctx, p2), f(&p2[0]));
     EXPECT_EQUAL(eval_ff(*forest, *ctx, pn), f(&pn[0]));
     EXPECT_EQUAL(eval_ff(*forest, *ctx, p1), f(&p1[0]));
+    auto results = eval_ff_batch(*forest, *ctx, {p1, p2, pn, p1});
+    ASSERT_EQUAL(results.size(), 4u);
+    EXPECT_EQUAL(results[0], f(&p1[0]));
+    EXPECT_EQUAL(results[1], f(&p2[0]));
+    EXPECT_EQUAL(results[2], f(&pn[0]));
+    EXPECT_EQUAL(results[3], f(&p1[0]));
+}
+
+TEST("require that fast forest batch evaluation matches single document evaluation") {
+    for (size_t tree_size: std::vector<size_t>({7,15,30,61,127})) {
+        vespalib::string expression = Model().max_features(35).less_percent(100).invert_percent(50).make_forest(127, tree_size);
+        auto function = Function::parse(expression);
+        auto forest = FastForest::try_convert(*function);
+        if ((tree_size <= 64) || is_little_endian()) {
+            ASSERT_TRUE(forest);
+            TEST_STATE(forest->impl_name().c_str());
+            auto ctx = forest->create_context();
+            for (size_t num_docs: std::vector<size_t>({1, 3, 8, 17, FastForest::max_batch_size})) {
+                auto docs = make_batch_inputs(num_docs, function->num_params());
+                auto results = eval_ff_batch(*forest, *ctx, docs);
+                ASSERT_EQUAL(results.size(), num_docs);
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    EXPECT_EQUAL(results[doc], eval_ff(*forest, *ctx, docs[doc]));
+                }
+            }
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,123 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/function.h>
+#include <vespa/eval/eval/interpreted_function.h>
+#include <vespa/eval/eval/make_tensor_function.h>
+#include <vespa/eval/eval/node_types.h>
+#include <vespa/eval/eval/optimize_tensor_function.h>
+#include <vespa/eval/eval/parallel_work.h>
+#include <vespa/eval/eval/value_codec.h>
+#include <vespa/eval/eval/test/gen_spec.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
+#include <vespa/vespalib/util/stash.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <atomic>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+
+const ValueBuilderFactory &prod_factory = FastValueBuilderFactory::get();
+
+// small numbers to get exact results also for float cells
+GenSpec G(const std::vector<double> &seq) { return GenSpec().seq(Seq(seq)); }
+
+struct MyThreadBundle : ThreadBundle {
+    SimpleThreadBundle bundle;
+    size_t run_cnt;
+    MyThreadBundle(size_t size) : bundle(size), run_cnt(0) {}
+    size_t size() const override { return bundle.size(); }
+    void run(const std::vector<Runnable*> &targets) override {
+        ++run_cnt;
+        bundle.run(targets);
+    }
+};
+
+TensorSpec eval_expr(const vespalib::string &expr, const std::vector<GenSpec> &params, ThreadBundle *bundle) {
+    auto fun = Function::parse(expr);
+    EXPECT_FALSE(fun->has_error());
+    std::vector<Value::UP> values;
+    std::vector<Value::CREF> refs;
+    std::vector<ValueType> types;
+    for (const auto &param: params) {
+        values.push_back(value_from_spec(param.gen(), prod_factory));
+        refs.push_back(*values.back());
+        types.push_back(values.back()->type());
+    }
+    NodeTypes node_types(*fun, types);
+    Stash stash;
+    const auto &plain = make_tensor_function(prod_factory, fun->root(), node_types, stash);
+    const auto &optimized = optimize_tensor_function(prod_factory, plain, stash);
+    InterpretedFunction ifun(prod_factory, optimized);
+    auto ctx = bundle ? std::make_unique<InterpretedFunction::Context>(ifun, *bundle)
+                      : std::make_unique<InterpretedFunction::Context>(ifun);
+    SimpleObjectParams lazy_params(refs);
+    return spec_from_value(ifun.eval(*ctx, lazy_params));
+}
+
+void verify(const vespalib::string &expr, const std::vector<GenSpec> &params, bool expect_parallel) {
+    SCOPED_TRACE(expr);
+    MyThreadBundle bundle(4);
+    auto expect = eval_expr(expr, params, nullptr);
+    auto actual = eval_expr(expr, params, &bundle);
+    EXPECT_EQ(actual, expect);
+    EXPECT_EQ(bundle.run_cnt > 0, expect_parallel);
+}
+
+TEST(ParallelWorkTest, work_is_split_into_consecutive_ranges) {
+    MyThreadBundle bundle(4);
+    std::vector<std::atomic<size_t>> hits(1000);
+    auto fun = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ++hits[i];
+        }
+    };
+    ParallelWork::run(&bundle, hits.size(), ParallelWork::min_work_per_thread, fun);
+    EXPECT_EQ(bundle.run_cnt, 1);
+    for (const auto &hit: hits) {
+        EXPECT_EQ(hit, 1);
+    }
+}
+
+TEST(ParallelWorkTest, number_of_threads_depends_on_amount_of_work) {
+    MyThreadBundle bundle(4);
+    size_t min_work = ParallelWork::min_work_per_thread;
+    EXPECT_EQ(ParallelWork::num_threads(nullptr, 1000, min_work), 1);
+    EXPECT_EQ(ParallelWork::num_threads(&bundle, 1000, 1), 1);
+    EXPECT_EQ(ParallelWork::num_threads(&bundle, 2, min_work), 2);
+    EXPECT_EQ(ParallelWork::num_threads(&bundle, 3, min_work - 1), 2);
+    EXPECT_EQ(ParallelWork::num_threads(&bundle, 1000, min_work), 4);
+}
+
+TEST(ParallelWorkTest, large_matmul_can_be_evaluated_in_parallel) {
+    auto a = G({1, 2, 3}).idx("a", 300).idx("x", 256);
+    auto b = G({3, 1, 2, 1}).idx("b", 200).idx("x", 256);
+    auto c = G({2, 3, 1, 1, 1}).idx("x", 256).idx("y", 300);
+    auto d = G({1, 1, 3}).idx("x", 256).idx("z", 200);
+    verify("reduce(a*b,sum,x)", {a, b}, true);
+    verify("reduce(a*c,sum,x)", {a, c}, true);
+    verify("reduce(c*d,sum,x)", {c, d}, true);
+    verify("reduce(c*d,sum,x)", {c.cpy().cells_float(), d}, true);
+    verify("reduce(a*b,sum,x)", {a.cpy().cells_float(), b.cpy().cells_float()}, true);
+    verify("reduce(a*b,sum,x)", {a.cpy().cells_float(), b}, true);
+    verify("reduce(a*b,sum,x)", {G({1, 2}).idx("a", 3).idx("x", 256), G({2, 1}).idx("b", 2).idx("x", 256)}, false);
+}
+
+TEST(ParallelWorkTest, large_multi_matmul_can_be_evaluated_in_parallel) {
+    auto a = G({1, 2, 3}).idx("B", 3).idx("a", 100).idx("x", 128);
+    auto b = G({3, 1, 2, 1}).idx("B", 3).idx("b", 150).idx("x", 128);
+    verify("reduce(a*b,sum,x)", {a, b}, true);
+    verify("reduce(a*b,sum,x)", {a.cpy().cells_float(), b.cpy().cells_float()}, true);
+}
+
+TEST(ParallelWorkTest, large_reduce_of_indexed_dimensions_in_mixed_tensor_can_be_evaluated_in_parallel) {
+    auto a = GenSpec(1.0).map("m", 256).idx("x", 64).idx("y", 32);
+    verify("reduce(a,sum,x)", {a}, true);
+    verify("reduce(a,avg,x,y)", {a}, true);
+    verify("reduce(a,median,y)", {a}, true);
+    verify("reduce(a,sum,m)", {a}, false);
+    verify("reduce(a,sum,x)", {GenSpec(1.0).map("m", 4).idx("x", 64).idx("y", 32)}, false);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
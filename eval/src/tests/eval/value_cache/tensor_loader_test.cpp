@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
+#include <vespa/eval/eval/value_cache/mapped_constant_value.h>
 #include <vespa/eval/eval/simple_value.h>
 #include <vespa/eval/eval/value_codec.h>
 #include <vespa/eval/eval/tensor_spec.h>
@@ -71,6 +72,21 @@ TEST_F("require that a binary tensor can be loaded", ConstantTensorLoader(factor
     TEST_DO(verify_tensor(make_dense_tensor(), f1.create(TEST_PATH("dense.tbf"), "tensor(x[2],y[2])")));
 }
 
+TEST_F("require that a memory mapped dense tensor can be loaded", ConstantTensorLoader(factory)) {
+    MappedConstantValue::save(*value_from_spec(make_dense_tensor(), factory), "dense.tmf");
+    auto actual = f1.create("dense.tmf", "tensor(x[2],y[2])");
+    ASSERT_EQUAL(make_dense_tensor().type(), actual->type().to_spec());
+    EXPECT_TRUE(dynamic_cast<const DenseValueView *>(&actual->value()));
+    EXPECT_EQUAL(make_dense_tensor(), spec_from_value(actual->value()));
+}
+
+TEST_F("require that a memory mapped tensor of wrong type gives bad constant value", ConstantTensorLoader(factory)) {
+    MappedConstantValue::save(*value_from_spec(make_dense_tensor(), factory), "dense.tmf");
+    TEST_DO(verify_invalid(f1.create("dense.tmf", "tensor<float>(x[2],y[2])")));
+    TEST_DO(verify_invalid(f1.create("dense.tmf", "tensor(x[2],y[3])")));
+    TEST_DO(verify_invalid(f1.create("missing_file.tmf", "tensor(x[2],y[2])")));
+}
+
 TEST_F("require that lz4 compressed sparse tensor can be loaded", ConstantTensorLoader(factory)) {
     TEST_DO(verify_tensor(make_sparse_tensor(), f1.create(TEST_PATH("sparse.json.lz4"), "tensor(x{},y{})")));
 }
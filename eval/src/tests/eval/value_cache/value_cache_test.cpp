@@ -4,6 +4,8 @@
 #include <vespa/eval/eval/value_cache/constant_value.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/value_type.h>
+#include <vespa/vespalib/util/gate.h>
+#include <atomic>
 
 using namespace vespalib::eval;
 
@@ -23,6 +25,20 @@ struct MyFactory : ConstantValueFactory {
     }
 };
 
+struct BlockingFactory : ConstantValueFactory {
+    mutable std::atomic<size_t> create_cnt = 0;
+    mutable vespalib::Gate loading;
+    mutable vespalib::Gate unblock;
+    ConstantValue::UP create(const vespalib::string &path, const vespalib::string &type) const override {
+        ++create_cnt;
+        if (type == "slow") {
+            loading.countDown();
+            unblock.await();
+        }
+        return std::make_unique<MyValue>(double(atoi(path.c_str())));
+    }
+};
+
 TEST_FF("require that values can be created", MyFactory(), ConstantValueCache(f1)) {
     ConstantValue::UP res = f2.create("1", "type");
     EXPECT_TRUE(res->type().is_double());
@@ -64,4 +80,22 @@ TEST_FF("require that type spec is part of cache key", MyFactory(), ConstantValu
     EXPECT_EQUAL(3u, f1.create_cnt);
 }
 
+TEST_MT_FF("require that values are created outside the cache lock", 3, BlockingFactory(), ConstantValueCache(f1)) {
+    ConstantValue::UP res;
+    if (thread_id == 0) {
+        res = f2.create("1", "slow");
+        EXPECT_EQUAL(1.0, res->value().as_double());
+    } else if (thread_id == 1) {
+        f1.loading.await();
+        EXPECT_EQUAL(2.0, f2.create("2", "fast")->value().as_double());
+        f1.unblock.countDown();
+    } else {
+        f1.loading.await();
+        res = f2.create("1", "slow");
+        EXPECT_EQUAL(1.0, res->value().as_double());
+    }
+    TEST_BARRIER();
+    EXPECT_EQUAL(2u, f1.create_cnt);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
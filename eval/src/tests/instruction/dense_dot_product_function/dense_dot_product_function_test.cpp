@@ -83,6 +83,19 @@ TEST("require that dot product with equal sizes is correct") {
     TEST_DO(assertDotProduct(1024 + 3));
 }
 
+TEST("require that int8 dot product is exact beyond float precision") {
+    // 2049 * 127 * 127 is odd and above 2^24, so it cannot be represented as float
+    size_t num_cells = 2049;
+    EvalFixture::ParamRepo param_repo;
+    param_repo.add("a", GenSpec().idx("x", num_cells).cells(CellType::INT8).seq(Seq({127})));
+    param_repo.add("b", GenSpec().idx("x", num_cells).cells(CellType::INT8).seq(Seq({127})));
+    vespalib::string expr = "reduce(a*b,sum,x)";
+    EvalFixture evaluator(prod_factory, expr, param_repo, true);
+    // doubles are compared approximately, so check the exact value as an integer
+    EXPECT_EQUAL(int64_t(evaluator.result().as_double()), int64_t(num_cells * 127 * 127));
+    EXPECT_EQUAL(evaluator.find_all<DenseDotProductFunction>().size(), 1u);
+}
+
 //-----------------------------------------------------------------------------
 
 struct FunInfo {
@@ -0,0 +1,110 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <vespa/eval/instruction/dense_fused_function.h>
+#include <vespa/eval/eval/test/eval_fixture.h>
+#include <vespa/eval/eval/test/gen_spec.h>
+#include <vespa/vespalib/util/require.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+using namespace vespalib::eval::tensor_function;
+
+struct FunInfo {
+    using LookFor = DenseFusedFunction;
+    size_t num_inputs;
+    size_t num_ops;
+    std::optional<Aggr> aggr;
+    void verify(const LookFor &fun) const {
+        EXPECT_TRUE(fun.result_is_mutable());
+        EXPECT_EQ(fun.num_inputs(), num_inputs);
+        EXPECT_EQ(fun.num_ops(), num_ops);
+        EXPECT_EQ(fun.aggr(), aggr);
+    }
+};
+
+struct DumpInfo {
+    using LookFor = DenseFusedFunction;
+    std::vector<vespalib::string> expect;
+    void verify(const LookFor &fun) const {
+        auto dump = fun.as_string();
+        for (const auto &str: expect) {
+            EXPECT_NE(dump.find(str), vespalib::string::npos) << "'" << str << "' not found in:\n" << dump;
+        }
+    }
+};
+
+void verify_optimized(const vespalib::string &expr, size_t num_params, FunInfo info) {
+    SCOPED_TRACE(expr.c_str());
+    CellTypeSpace stable_types(CellTypeUtils::list_stable_types(), num_params);
+    CellTypeSpace unstable_types(CellTypeUtils::list_unstable_types(), num_params);
+    EvalFixture::verify<FunInfo>(expr, {info}, stable_types);
+    EvalFixture::verify<FunInfo>(expr, {info}, unstable_types);
+}
+
+void verify_not_optimized(const vespalib::string &expr, size_t num_params) {
+    SCOPED_TRACE(expr.c_str());
+    CellTypeSpace just_double({CellType::DOUBLE}, num_params);
+    EvalFixture::verify<FunInfo>(expr, {}, just_double);
+}
+
+TEST(FusedTest, map_join_chains_can_be_fused) {
+    verify_optimized("map(x5y3$1+x5y3$2,f(x)(x*2))", 2, {2, 2, std::nullopt});
+    verify_optimized("map(map(x5y3,f(x)(x+1)),f(x)(x*3))", 1, {1, 2, std::nullopt});
+    verify_optimized("(x5y3$1-x5y3$2)*x5y3$3", 3, {3, 2, std::nullopt});
+    verify_optimized("join(x200$1,x200$2,f(x,y)(x*y+1))/x200$3", 3, {3, 2, std::nullopt});
+}
+
+TEST(FusedTest, numbers_can_be_joined_into_fused_chains) {
+    verify_optimized("(x5y3*2.5)+3", 1, {3, 2, std::nullopt});
+    verify_optimized("map(7-x5y3,f(x)(x*x))", 1, {2, 2, std::nullopt});
+}
+
+TEST(FusedTest, full_reduce_can_be_fused_with_map_join_chains) {
+    verify_optimized("reduce(map(x5y3,f(x)(x*x)),sum)", 1, {1, 1, Aggr::SUM});
+    verify_optimized("reduce(map(join(x200$1,x200$2,f(x,y)(x-y)),f(x)(x*x)),sum)", 2, {2, 2, Aggr::SUM});
+    verify_optimized("reduce(x5y3$1-x5y3$2,max)", 2, {2, 1, Aggr::MAX});
+    verify_optimized("reduce(x5y3$1-x5y3$2,avg,x,y)", 2, {2, 1, Aggr::AVG});
+    verify_optimized("reduce(x5y3$1-x5y3$2,count)", 2, {2, 1, Aggr::COUNT});
+    verify_optimized("reduce(x5y3$1-x5y3$2,prod)", 2, {2, 1, Aggr::PROD});
+    verify_optimized("reduce(x5y3$1-x5y3$2,min)", 2, {2, 1, Aggr::MIN});
+}
+
+TEST(FusedTest, single_operations_are_not_fused) {
+    verify_not_optimized("map(x5y3,f(x)(x*2))", 1);
+    verify_not_optimized("x5y3$1+x5y3$2", 2);
+    verify_not_optimized("reduce(x5y3,sum)", 1);
+}
+
+TEST(FusedTest, dot_product_is_not_fused) {
+    verify_not_optimized("reduce(x5$1*x5$2,sum)", 2);
+}
+
+TEST(FusedTest, partial_reduce_is_not_fused) {
+    verify_optimized("reduce(map(x5y3$1+x5y3$2,f(x)(x*2)),sum,x)", 2, {2, 2, std::nullopt});
+    verify_not_optimized("reduce(map(x5y3,f(x)(x*2)),sum,x)", 1);
+}
+
+TEST(FusedTest, median_reduce_is_not_fused) {
+    verify_not_optimized("reduce(map(x5y3,f(x)(x*2)),median)", 1);
+}
+
+TEST(FusedTest, operations_on_different_dimensions_are_not_fused) {
+    verify_not_optimized("map(x5+y3,f(x)(x*2))", 2);
+    verify_not_optimized("map(x5y3+y3,f(x)(x*2))", 2);
+}
+
+TEST(FusedTest, sparse_and_mixed_operations_are_not_fused) {
+    verify_not_optimized("map(x3_1$1+x3_1$2,f(x)(x*2))", 2);
+    verify_not_optimized("map(x3_1y5$1+x3_1y5$2,f(x)(x*2))", 2);
+}
+
+TEST(FusedTest, fused_function_dump_contains_program_and_aggregator) {
+    CellTypeSpace just_double({CellType::DOUBLE}, 2);
+    DumpInfo info{{"num_ops: 2", "program: 'input(0) input(1) join map'", "aggr: 'sum'"}};
+    EvalFixture::verify<DumpInfo>("reduce(map(x5$1+x5$2,f(x)(x*2)),sum)", {info}, just_double);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
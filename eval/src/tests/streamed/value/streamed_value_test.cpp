@@ -125,6 +125,28 @@ TEST(StreamedValueTest, streamed_value_can_be_built_and_inspected) {
     EXPECT_EQ(result["bb"], 3);
 }
 
+TEST(StreamedValueTest, streamed_value_can_look_up_full_addresses) {
+    auto value = value_from_spec(G().map("x", {"a","b","c"}).idx("y", 2).map("z", {"i","j"}), StreamedValueBuilderFactory::get());
+    EXPECT_EQ(value->index().size(), 6);
+    std::vector<size_t> view_dims = { 0, 1 };
+    Handle b_handle("b");
+    Handle j_handle("j");
+    Handle k_handle("k");
+    string_id b = b_handle.id();
+    string_id j = j_handle.id();
+    string_id k = k_handle.id();
+    size_t subspace;
+    for (size_t i = 0; i < 2; ++i) {
+        auto view = value->index().create_view(view_dims);
+        view->lookup(CPA{&b, &j});
+        ASSERT_TRUE(view->next_result(PA{}, subspace));
+        EXPECT_EQ(subspace, 3);
+        EXPECT_FALSE(view->next_result(PA{}, subspace));
+        view->lookup(CPA{&b, &k});
+        EXPECT_FALSE(view->next_result(PA{}, subspace));
+    }
+}
+
 GenSpec::seq_t N_16ths = [] (size_t i) noexcept { return (i + 1.0) / 16.0; };
 
 TEST(StreamedValueTest, new_generic_join_works_for_streamed_values) {
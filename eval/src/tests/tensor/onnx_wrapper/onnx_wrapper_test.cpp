@@ -225,6 +225,63 @@ TEST(OnnxTest, dynamic_onnx_model_can_be_evaluated)
     //-------------------------------------------------------------------------
 }
 
+TEST(OnnxTest, dynamic_onnx_model_can_be_evaluated_in_batch)
+{
+    Onnx model(dynamic_model, Onnx::Optimize::ENABLE);
+    Onnx::WirePlanner planner;
+    ValueType query_type = ValueType::from_spec("tensor<float>(a[1],b[4])");
+    ValueType attribute_type = ValueType::from_spec("tensor<float>(a[4],b[1])");
+    ValueType bias_type = ValueType::from_spec("tensor<float>(a[1],b[2])");
+    EXPECT_TRUE(planner.bind_input_type(query_type, model.inputs()[0]));
+    EXPECT_TRUE(planner.bind_input_type(attribute_type, model.inputs()[1]));
+    EXPECT_TRUE(planner.bind_input_type(bias_type, model.inputs()[2]));
+    Onnx::WireInfo wire_info = planner.get_wire_info(model);
+
+    Onnx::BatchPlanner batch_planner(model, wire_info);
+    ASSERT_TRUE(batch_planner.can_batch());
+    EXPECT_TRUE(batch_planner.is_batched_input(0));
+    EXPECT_FALSE(batch_planner.is_batched_input(1));
+    EXPECT_TRUE(batch_planner.is_batched_input(2));
+    Onnx::WireInfo batch_info = batch_planner.get_wire_info(3);
+    EXPECT_EQ(batch_info.vespa_inputs[0].to_spec(), "tensor<float>(a[3],b[4])");
+    EXPECT_EQ(batch_info.vespa_inputs[1].to_spec(), "tensor<float>(a[4],b[1])");
+    EXPECT_EQ(batch_info.vespa_inputs[2].to_spec(), "tensor<float>(a[3],b[2])");
+    EXPECT_EQ(batch_info.vespa_outputs[0].to_spec(), "tensor<float>(d0[3],d1[1])");
+    Onnx::EvalContext ctx(model, batch_info);
+
+    std::vector<float> query_values({1.0, 2.0, 3.0, 4.0,
+                                     2.0, 2.0, 3.0, 4.0,
+                                     3.0, 2.0, 3.0, 4.0});
+    std::vector<float> attribute_values({5.0, 6.0, 7.0, 8.0});
+    std::vector<float> bias_values({4.0, 5.0,
+                                    5.0, 6.0,
+                                    6.0, 7.0});
+    DenseValueView query(batch_info.vespa_inputs[0], TypedCells(query_values));
+    DenseValueView attribute(batch_info.vespa_inputs[1], TypedCells(attribute_values));
+    DenseValueView bias(batch_info.vespa_inputs[2], TypedCells(bias_values));
+    ctx.bind_param(0, query);
+    ctx.bind_param(1, attribute);
+    ctx.bind_param(2, bias);
+    ctx.eval();
+    auto cells = ctx.get_result(0).cells();
+    ASSERT_EQ(cells.size, 3);
+    EXPECT_EQ(cells.typify<float>()[0], 79.0);
+    EXPECT_EQ(cells.typify<float>()[1], 86.0);
+    EXPECT_EQ(cells.typify<float>()[2], 93.0);
+}
+
+TEST(OnnxTest, models_without_symbolic_batch_dimension_cannot_be_batched)
+{
+    Onnx model(simple_model, Onnx::Optimize::ENABLE);
+    Onnx::WirePlanner planner;
+    EXPECT_TRUE(planner.bind_input_type(ValueType::from_spec("tensor<float>(a[1],b[4])"), model.inputs()[0]));
+    EXPECT_TRUE(planner.bind_input_type(ValueType::from_spec("tensor<float>(a[4],b[1])"), model.inputs()[1]));
+    EXPECT_TRUE(planner.bind_input_type(ValueType::from_spec("tensor<float>(a[1],b[1])"), model.inputs()[2]));
+    Onnx::WireInfo wire_info = planner.get_wire_info(model);
+    Onnx::BatchPlanner batch_planner(model, wire_info);
+    EXPECT_FALSE(batch_planner.can_batch());
+}
+
 TEST(OnnxTest, int_types_onnx_model_can_be_evaluated)
 {
     Onnx model(int_types_model, Onnx::Optimize::ENABLE);
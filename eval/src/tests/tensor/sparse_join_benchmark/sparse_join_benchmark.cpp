@@ -0,0 +1,182 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+// Microbenchmark measuring hash lookups in FastAddrMap, both one
+// address at a time and in batches, as well as the optimized sparse
+// tensor instructions built on top of it (dot product, full overlap
+// join and merge). Run with --smoke-test to only verify that all
+// benchmarks run and produce the expected results.
+
+#include <vespa/eval/eval/fast_addr_map.h>
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/function.h>
+#include <vespa/eval/eval/interpreted_function.h>
+#include <vespa/eval/eval/make_tensor_function.h>
+#include <vespa/eval/eval/node_types.h>
+#include <vespa/eval/eval/optimize_tensor_function.h>
+#include <vespa/eval/eval/value_codec.h>
+#include <vespa/eval/eval/test/gen_spec.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/shared_string_repo.h>
+#include <vespa/vespalib/util/stash.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib;
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+
+using Handles = SharedStringRepo::Handles;
+using vespalib::make_string_short::fmt;
+
+const ValueBuilderFactory &prod_factory = FastValueBuilderFactory::get();
+
+double budget = 5.0;
+
+//-----------------------------------------------------------------------------
+
+struct MyAddrs {
+    size_t num_dims;
+    Handles handles;
+    MyAddrs(size_t num_dims_in, size_t num_addrs, size_t offset)
+        : num_dims(num_dims_in), handles()
+    {
+        for (size_t i = 0; i < num_addrs; ++i) {
+            for (size_t d = 0; d < num_dims; ++d) {
+                handles.add(fmt("label_%zu_%zu", (i + offset), d));
+            }
+        }
+    }
+    size_t size() const { return handles.view().size() / num_dims; }
+    ConstArrayRef<string_id> get_addr(size_t i) const {
+        return {&handles.view()[i * num_dims], num_dims};
+    }
+    void fill(FastAddrMap &map) const {
+        for (size_t i = 0; i < size(); ++i) {
+            map.add_mapping(FastAddrMap::hash_labels(get_addr(i)));
+        }
+    }
+};
+
+void benchmark_lookup(size_t num_dims, size_t small_size, size_t big_size) {
+    // half of the small addresses are also present in the big map
+    MyAddrs small_addrs(num_dims, small_size, big_size - (small_size / 2));
+    MyAddrs big_addrs(num_dims, big_size, 0);
+    FastAddrMap small_map(num_dims, small_addrs.handles.view(), small_size);
+    FastAddrMap big_map(num_dims, big_addrs.handles.view(), big_size);
+    small_addrs.fill(small_map);
+    big_addrs.fill(big_map);
+    size_t single_hits = 0;
+    size_t batch_hits = 0;
+    auto single = [&]() {
+                      for (size_t i = 0; i < small_map.size(); ++i) {
+                          if (big_map.lookup(small_map.get_addr(i)) != FastAddrMap::npos()) {
+                              ++single_hits;
+                          }
+                      }
+                  };
+    auto batch = [&]() {
+                     big_map.lookup_each(small_map, [&](auto, auto, auto big_subspace) {
+                                             if (big_subspace != FastAddrMap::npos()) {
+                                                 ++batch_hits;
+                                             }
+                                         });
+                 };
+    BenchmarkTimer single_timer(budget);
+    BenchmarkTimer batch_timer(budget);
+    size_t loops = 0;
+    while (single_timer.has_budget() || batch_timer.has_budget()) {
+        single_timer.before();
+        single();
+        single_timer.after();
+        batch_timer.before();
+        batch();
+        batch_timer.after();
+        ++loops;
+    }
+    EXPECT_EQ(single_hits, loops * (small_size / 2));
+    EXPECT_EQ(batch_hits, loops * (small_size / 2));
+    double single_ns = single_timer.min_time() * 1000.0 * 1000.0 * 1000.0 / small_size;
+    double batch_ns = batch_timer.min_time() * 1000.0 * 1000.0 * 1000.0 / small_size;
+    fprintf(stderr, "lookup %zu dims, %zu in %zu: single: %g ns, batch: %g ns (per address)\n",
+            num_dims, small_size, big_size, single_ns, batch_ns);
+}
+
+TEST(FastAddrMapBench, lookup) {
+    for (size_t num_dims: {1, 3}) {
+        benchmark_lookup(num_dims, 16, 1000);
+        benchmark_lookup(num_dims, 1000, 1000);
+        benchmark_lookup(num_dims, 1000, 100000);
+        benchmark_lookup(num_dims, 100000, 100000);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void benchmark_expr(const vespalib::string &desc, const vespalib::string &expr, const std::vector<GenSpec> &params) {
+    auto fun = Function::parse(expr);
+    ASSERT_FALSE(fun->has_error());
+    std::vector<Value::UP> values;
+    std::vector<Value::CREF> refs;
+    std::vector<ValueType> types;
+    for (const auto &param: params) {
+        values.push_back(value_from_spec(param.gen(), prod_factory));
+        refs.push_back(*values.back());
+        types.push_back(values.back()->type());
+    }
+    NodeTypes node_types(*fun, types);
+    Stash stash;
+    const auto &plain = make_tensor_function(prod_factory, fun->root(), node_types, stash);
+    const auto &optimized = optimize_tensor_function(prod_factory, plain, stash);
+    InterpretedFunction ifun(prod_factory, optimized);
+    InterpretedFunction::Context ctx(ifun);
+    InterpretedFunction generic_ifun(prod_factory, plain);
+    InterpretedFunction::Context generic_ctx(generic_ifun);
+    SimpleObjectParams lazy_params(refs);
+    EXPECT_EQ(spec_from_value(ifun.eval(ctx, lazy_params)), spec_from_value(generic_ifun.eval(generic_ctx, lazy_params)));
+    BenchmarkTimer timer(budget);
+    while (timer.has_budget()) {
+        timer.before();
+        ifun.eval(ctx, lazy_params);
+        timer.after();
+    }
+    fprintf(stderr, "%s: %g us\n", desc.c_str(), timer.min_time() * 1000.0 * 1000.0);
+}
+
+GenSpec sparse(const vespalib::string &dims, size_t size, size_t stride) {
+    GenSpec spec = GenSpec().cells_float();
+    for (char dim: dims) {
+        spec.map(vespalib::string(1, dim), size, stride);
+    }
+    return spec;
+}
+
+TEST(SparseInstructionBench, dot_product) {
+    benchmark_expr("sparse dot product 1 dim 64 vs 100k", "reduce(a*b,sum)", {sparse("x", 64, 7), sparse("x", 100000, 1)});
+    benchmark_expr("sparse dot product 1 dim 10k vs 10k", "reduce(a*b,sum)", {sparse("x", 10000, 2), sparse("x", 10000, 3)});
+    benchmark_expr("sparse dot product 2 dims 1k vs 10k", "reduce(a*b,sum)", {sparse("xy", 32, 3), sparse("xy", 100, 1)});
+}
+
+TEST(SparseInstructionBench, full_overlap_join) {
+    benchmark_expr("sparse full overlap join 1 dim 64 vs 100k", "a*b", {sparse("x", 64, 7), sparse("x", 100000, 1)});
+    benchmark_expr("sparse full overlap join 1 dim 10k vs 10k", "a*b", {sparse("x", 10000, 2), sparse("x", 10000, 3)});
+    benchmark_expr("sparse full overlap join 2 dims 1k vs 10k", "a*b", {sparse("xy", 32, 3), sparse("xy", 100, 1)});
+}
+
+TEST(SparseInstructionBench, merge) {
+    benchmark_expr("sparse merge 1 dim 64 vs 100k", "merge(a,b,f(x,y)(max(x,y)))", {sparse("x", 64, 7), sparse("x", 100000, 1)});
+    benchmark_expr("sparse merge 1 dim 10k vs 10k", "merge(a,b,f(x,y)(max(x,y)))", {sparse("x", 10000, 2), sparse("x", 10000, 3)});
+    benchmark_expr("sparse merge 2 dims 1k vs 10k", "merge(a,b,f(x,y)(max(x,y)))", {sparse("xy", 32, 3), sparse("xy", 100, 1)});
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+    const std::string smoke_test_option = "--smoke-test";
+    if ((argc > 1) && (argv[1] == smoke_test_option)) {
+        budget = 0.001;
+        ++argv;
+        --argc;
+    }
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
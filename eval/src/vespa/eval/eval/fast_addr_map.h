@@ -5,17 +5,26 @@
 #include "memory_usage_stuff.h"
 #include <vespa/vespalib/util/arrayref.h>
 #include <vespa/vespalib/util/string_id.h>
-#include <vespa/vespalib/stllike/identity.h>
-#include <vespa/vespalib/stllike/hashtable.h>
+#include <vespa/vespalib/stllike/swiss_table.h>
+#include <algorithm>
 #include <vector>
 
 namespace vespalib::eval {
 
 /**
- * A wrapper around vespalib::hashtable, using it to map a list of
- * labels (a sparse address) to an integer value (dense subspace
- * index). Labels are represented by string enum values stored and
- * handled outside this class.
+ * A hash map from a list of labels (a sparse address) to an integer
+ * value (dense subspace index). Labels are represented by string
+ * enum values stored and handled outside this class.
+ *
+ * The map uses open addressing with a separate array of control
+ * bytes (one per slot) in the style of a Swiss table. Each control
+ * byte is either empty or holds 7 bits of the hash of the entry in
+ * that slot. Lookups compare a group of 16 control bytes at a time
+ * (see vespalib::swiss::Group) and only inspect entries whose control
+ * byte matches. When all addresses of another map are looked up in
+ * a large map (as done when joining or merging sparse tensors), this
+ * is done in batches; hashing a batch of addresses and prefetching
+ * their probe locations before probing.
  **/
 class FastAddrMap
 {
@@ -47,18 +56,12 @@ public:
         constexpr bool valid() const { return (idx != npos()); }
     };
 
-    // sparse hash set entry
+    // hash table entry
     struct Entry {
         Tag tag;
         uint32_t hash;
     };
 
-    // alternative key(s) used for lookup in sparse hash set
-    template <typename T> struct AltKey {
-        ConstArrayRef<T> key;
-        uint32_t hash;
-    };
-
     // view able to convert tags into sparse addresses
     struct LabelView {
         size_t addr_size;
@@ -70,44 +73,153 @@ public:
         }
     };
 
-    // hashing functor for sparse hash set
-    struct Hash {
-        template <typename T>
-        constexpr uint32_t operator()(const AltKey<T> &key) const { return key.hash; }
-        constexpr uint32_t operator()(const Entry &entry) const { return entry.hash; }
-        constexpr uint32_t operator()(string_id label) const { return label.value(); }
-    };
+private:
+    static constexpr size_t group_size = swiss::group_size;
+    static constexpr size_t batch_size = 16;
+    static constexpr size_t min_batch_capacity = 4096;
+    static constexpr size_t min_capacity = 2;
+    static constexpr uint8_t ctrl_empty = swiss::ctrl_empty;
 
-    // equality functor for sparse hash set
-    struct Equal {
-        const LabelView &label_view;
-        Equal(const LabelView &label_view_in) : label_view(label_view_in) {}
-        template <typename T>
-        bool operator()(const Entry &a, const AltKey<T> &b) const {
-            if (a.hash != b.hash) {
-                return false;
+    // a group of control bytes probed together
+    using Group = swiss::Group;
+
+    // the hash is mixed and split into h1 (where probing starts)
+    // and h2 (the 7 bits stored in the control byte)
+    static constexpr uint64_t mix_hash(uint32_t hash) { return (uint64_t(hash) * 0x9e3779b97f4a7c15ull); }
+    static constexpr size_t h1(uint64_t mixed) { return (mixed >> 32); }
+    static constexpr uint8_t h2(uint64_t mixed) { return ((mixed >> 25) & 0x7f); }
+
+    LabelView            _labels;
+    size_t               _size;
+    size_t               _mask;
+    uint32_t             _window;
+    std::vector<uint8_t> _ctrl;
+    std::vector<Entry>   _slots;
+
+    static size_t capacity_for(size_t num_entries) {
+        size_t capacity = min_capacity;
+        while (((capacity * 7) / 8) < num_entries) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+    size_t capacity() const { return (_mask + 1); }
+    void init_table(size_t new_capacity) {
+        _mask = (new_capacity - 1);
+        _window = (new_capacity < group_size) ? ((1u << new_capacity) - 1) : ((1u << group_size) - 1);
+        _ctrl.assign(new_capacity + group_size, ctrl_empty);
+        _slots.assign(new_capacity, Entry{Tag::make_invalid(), 0});
+    }
+    void set_ctrl(size_t slot, uint8_t value) {
+        _ctrl[slot] = value;
+        if (slot < group_size) {
+            // mirror the start of the table to allow unaligned group loads
+            _ctrl[capacity() + slot] = value;
+        }
+    }
+    void insert_entry(Entry entry) {
+        uint64_t mixed = mix_hash(entry.hash);
+        size_t pos = (h1(mixed) & _mask);
+        for (size_t step = group_size; true; step += group_size) {
+            uint32_t bits = (Group(&_ctrl[pos]).match_empty() & _window);
+            if (bits != 0) {
+                size_t slot = ((pos + __builtin_ctz(bits)) & _mask);
+                set_ctrl(slot, h2(mixed));
+                _slots[slot] = entry;
+                return;
+            }
+            pos = ((pos + step) & _mask);
+        }
+    }
+    void grow() {
+        std::vector<uint8_t> old_ctrl;
+        std::vector<Entry> old_slots;
+        old_ctrl.swap(_ctrl);
+        old_slots.swap(_slots);
+        init_table(old_slots.size() * 2);
+        for (size_t i = 0; i < old_slots.size(); ++i) {
+            if (old_ctrl[i] != ctrl_empty) {
+                insert_entry(old_slots[i]);
             }
-            auto a_key = label_view.get_addr(a.tag.idx);
-            for (size_t i = 0; i < a_key.size(); ++i) {
-                if (a_key[i] != self(b.key[i])) {
-                    return false;
+        }
+    }
+    template <typename EQ>
+    size_t find(uint32_t hash, EQ &&eq) const {
+        uint64_t mixed = mix_hash(hash);
+        uint8_t ctrl = h2(mixed);
+        size_t pos = (h1(mixed) & _mask);
+        for (size_t step = group_size; true; step += group_size) {
+            Group group(&_ctrl[pos]);
+            for (uint32_t bits = (group.match(ctrl) & _window); bits != 0; bits &= (bits - 1)) {
+                const Entry &entry = _slots[(pos + __builtin_ctz(bits)) & _mask];
+                if ((entry.hash == hash) && eq(entry.tag.idx)) {
+                    return entry.tag.idx;
                 }
             }
-            return true;
+            if ((group.match_empty() & _window) != 0) {
+                return npos();
+            }
+            pos = ((pos + step) & _mask);
         }
-        bool operator()(const Entry &a, string_id b) const { return (a.hash == b.value()); }
-    };
-
-    using HashType = hashtable<Entry, Entry, Hash, Equal, Identity, hashtable_base::and_modulator>;
-
-private:
-    LabelView _labels;
-    HashType _map;
+    }
+    template <typename T>
+    size_t find_addr(ConstArrayRef<T> addr, uint32_t hash) const {
+        return find(hash, [&](uint32_t idx)
+                    {
+                        auto my_addr = _labels.get_addr(idx);
+                        for (size_t i = 0; i < my_addr.size(); ++i) {
+                            if (my_addr[i] != self(addr[i])) {
+                                return false;
+                            }
+                        }
+                        return true;
+                    });
+    }
+    template <bool single_dim, typename F>
+    void lookup_each_impl(const FastAddrMap &other, F &f) const {
+        const size_t num_subspaces = other.size();
+        if (capacity() < min_batch_capacity) {
+            // small tables stay in cache; probe directly
+            for (size_t i = 0; i < num_subspaces; ++i) {
+                uint32_t hash = single_dim ? hash_label(other.labels()[i]) : hash_labels(other.get_addr(i));
+                size_t my_subspace = single_dim
+                    ? find(hash, [](uint32_t) noexcept { return true; })
+                    : find_addr(other.get_addr(i), hash);
+                f(i, hash, my_subspace);
+            }
+            return;
+        }
+        uint32_t hashes[batch_size];
+        for (size_t begin = 0; begin < num_subspaces; begin += batch_size) {
+            size_t end = std::min(num_subspaces, begin + batch_size);
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t hash = single_dim ? hash_label(other.labels()[i]) : hash_labels(other.get_addr(i));
+                size_t pos = (h1(mix_hash(hash)) & _mask);
+                __builtin_prefetch(&_ctrl[pos]);
+                __builtin_prefetch(&_slots[pos]);
+                hashes[i - begin] = hash;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t hash = hashes[i - begin];
+                size_t my_subspace = single_dim
+                    ? find(hash, [](uint32_t) noexcept { return true; })
+                    : find_addr(other.get_addr(i), hash);
+                f(i, hash, my_subspace);
+            }
+        }
+    }
 
 public:
     FastAddrMap(size_t num_mapped_dims, const std::vector<string_id> &labels_in, size_t expected_subspaces)
         : _labels(num_mapped_dims, labels_in),
-          _map(expected_subspaces * 2, Hash(), Equal(_labels)) {}
+          _size(0),
+          _mask(0),
+          _window(0),
+          _ctrl(),
+          _slots()
+    {
+        init_table(capacity_for(expected_subspaces));
+    }
     ~FastAddrMap();
     FastAddrMap(const FastAddrMap &) = delete;
     FastAddrMap &operator=(const FastAddrMap &) = delete;
@@ -115,20 +227,17 @@ public:
     FastAddrMap &operator=(FastAddrMap &&) = delete;
     static constexpr size_t npos() { return -1; }
     ConstArrayRef<string_id> get_addr(size_t idx) const { return _labels.get_addr(idx); }
-    size_t size() const { return _map.size(); }
+    size_t size() const { return _size; }
     constexpr size_t addr_size() const { return _labels.addr_size; }
     const std::vector<string_id> &labels() const { return _labels.labels; }
     template <typename T>
     size_t lookup(ConstArrayRef<T> addr, uint32_t hash) const {
         // assert(addr_size() == addr.size());
-        AltKey<T> key{addr, hash};
-        auto pos = _map.find(key);
-        return (pos == _map.end()) ? npos() : pos->tag.idx;
+        return find_addr(addr, hash);
     }
     size_t lookup_singledim(string_id addr) const {
         // assert(addr_size() == 1);
-        auto pos = _map.find(addr);
-        return (pos == _map.end()) ? npos() : pos->tag.idx;
+        return find(hash_label(addr), [](uint32_t) noexcept { return true; });
     }
     template <typename T>
     size_t lookup(ConstArrayRef<T> addr) const {
@@ -136,27 +245,38 @@ public:
             ? lookup_singledim(self(addr[0]))
             : lookup(addr, hash_labels(addr));
     }
+    // Look up the addresses of all subspaces in another map with
+    // the same number of mapped dimensions, in subspace order. The
+    // callback is called as f(other_subspace, hash, my_subspace),
+    // where my_subspace is npos() if the address was not found.
+    template <typename F>
+    void lookup_each(const FastAddrMap &other, F &&f) const {
+        // assert(addr_size() == other.addr_size());
+        if (addr_size() == 1) {
+            lookup_each_impl<true>(other, f);
+        } else {
+            lookup_each_impl<false>(other, f);
+        }
+    }
     void add_mapping(uint32_t hash) {
-        uint32_t idx = _map.size();
-        _map.force_insert(Entry{{idx}, hash});
+        if (_size >= ((capacity() * 7) / 8)) {
+            grow();
+        }
+        uint32_t idx = _size++;
+        insert_entry(Entry{{idx}, hash});
     }
     template <typename F>
     void each_map_entry(F &&f) const {
-        _map.for_each([&](const auto &entry)
-                      {
-                          f(entry.tag.idx, entry.hash);
-                      });
+        for (size_t i = 0; i < _slots.size(); ++i) {
+            if (_ctrl[i] != ctrl_empty) {
+                f(_slots[i].tag.idx, _slots[i].hash);
+            }
+        }
     }
     MemoryUsage estimate_extra_memory_usage() const {
         MemoryUsage extra_usage;
-        size_t map_self_size = sizeof(_map);
-        size_t map_used = _map.getMemoryUsed();
-        size_t map_allocated = _map.getMemoryConsumption();
-        // avoid double-counting the map itself
-        map_used = std::min(map_used, map_used - map_self_size);
-        map_allocated = std::min(map_allocated, map_allocated - map_self_size);
-        extra_usage.incUsedBytes(map_used);
-        extra_usage.incAllocatedBytes(map_allocated);
+        extra_usage.incUsedBytes(_ctrl.size() + (_size * sizeof(Entry)));
+        extra_usage.incAllocatedBytes(_ctrl.capacity() + (_slots.capacity() * sizeof(Entry)));
         return extra_usage;
     }
 };
@@ -146,7 +146,8 @@ constexpr size_t max_leafs() { return (sizeof(T) * bits_per_byte); }
 template <typename T>
 struct FixedContext : FastForest::Context {
     std::vector<T> masks;
-    FixedContext(size_t num_trees) : masks(num_trees) {}
+    std::vector<T> batch_masks;
+    FixedContext(size_t num_trees) : masks(num_trees), batch_masks() {}
 };
 
 template <typename T>
@@ -197,9 +198,14 @@ struct FixedForest : FastForest {
     static void apply_masks(T *ctx_masks, const DMask *pos, const DMask *end);
     double get_result(const T *ctx_masks) const;
 
+    static void apply_batch_masks(T *ctx_masks, size_t num_docs, const Mask *pos, const Mask *end, const float *limits);
+    static void apply_batch_masks(T *ctx_masks, size_t num_docs, const DMask *pos, const DMask *end, uint64_t docs);
+    void get_batch_result(const T *ctx_masks, size_t num_docs, double *results) const;
+
     vespalib::string impl_name() const override { return fixed_impl_name<T>(); }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, const float *params, size_t num_docs, double *results) const override;
 };
 
 template <typename T>
@@ -306,6 +312,67 @@ FixedForest<T>::get_result(const T *ctx_masks) const
     return (result1 + result2);
 }
 
+template <typename T>
+void
+FixedForest<T>::apply_batch_masks(T *ctx_masks, size_t num_docs, const Mask *pos, const Mask *end, const float *limits)
+{
+    // Masks are sorted on value; when no document in the batch
+    // reaches the current value, no document reaches the rest either.
+    for (; pos < end; ++pos) {
+        // branch-free formulation to allow the loop to be vectorized
+        T *dst = ctx_masks + (pos->tree * num_docs);
+        const float value = pos->value;
+        const T clear_bits = T(~pos->bits);
+        T any = 0;
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            T hit = T(0) - T(value <= limits[doc]); // false for NaN
+            dst[doc] &= T(~(hit & clear_bits));
+            any |= hit;
+        }
+        if (any == 0) {
+            return;
+        }
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::apply_batch_masks(T *ctx_masks, size_t num_docs, const DMask *pos, const DMask *end, uint64_t docs)
+{
+    for (; pos < end; ++pos) {
+        T *dst = ctx_masks + (pos->tree * num_docs);
+        for (uint64_t left = docs; left != 0; left &= (left - 1)) {
+            dst[get_lsb(left)] &= pos->bits;
+        }
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::get_batch_result(const T *ctx_masks, size_t num_docs, double *results) const
+{
+    // Trees are summed in the same order as for single document
+    // evaluation to produce identical results.
+    double result1[max_batch_size];
+    double result2[max_batch_size];
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        result1[doc] = 0.0;
+        result2[doc] = 0.0;
+    }
+    const float *leafs = &_padded_leafs[0];
+    size_t leaf_cnt = _max_leafs;
+    size_t unrolled_trees = (_num_trees - (_num_trees % 4));
+    for (size_t tree = 0; tree < _num_trees; ++tree, ctx_masks += num_docs, leafs += leaf_cnt) {
+        double *dst = ((tree < unrolled_trees) && ((tree % 2) == 1)) ? result2 : result1;
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            dst[doc] += leafs[get_lsb(ctx_masks[doc])];
+        }
+    }
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        results[doc] = (result1[doc] + result2[doc]);
+    }
+}
+
 template <typename T>
 FastForest::Context::UP
 FixedForest<T>::create_context() const
@@ -335,13 +402,44 @@ FixedForest<T>::eval(Context &context, const float *params) const
     return get_result(ctx_masks);
 }
 
+template <typename T>
+void
+FixedForest<T>::eval_batch(Context &context, const float *params, size_t num_docs, double *results) const
+{
+    assert(num_docs <= max_batch_size);
+    auto &batch_masks = static_cast<FixedContext<T>&>(context).batch_masks;
+    batch_masks.resize(_num_trees * num_docs);
+    T *ctx_masks = &batch_masks[0];
+    memset(ctx_masks, 0xff, batch_masks.size() * sizeof(T));
+    const Mask *mask_pos = &_masks[0];
+    for (size_t param = 0; param < _mask_sizes.size(); ++param) {
+        const float *limits = params + (param * num_docs);
+        uint64_t nan_docs = 0;
+        for (size_t doc = 0; doc < num_docs; ++doc) {
+            if (std::isnan(limits[doc])) {
+                nan_docs |= (uint64_t(1) << doc);
+            }
+        }
+        uint32_t size = _mask_sizes[param];
+        apply_batch_masks(ctx_masks, num_docs, mask_pos, mask_pos + size, limits);
+        if (nan_docs != 0) {
+            apply_batch_masks(ctx_masks, num_docs,
+                              &_default_masks[_default_offsets[param]],
+                              &_default_masks[_default_offsets[param + 1]], nan_docs);
+        }
+        mask_pos += size;
+    }
+    get_batch_result(ctx_masks, num_docs, results);
+}
+
 //-----------------------------------------------------------------------------
 // implementation using multiple words for each tree
 //-----------------------------------------------------------------------------
 
 struct MultiWordContext : FastForest::Context {
     std::vector<uint32_t> words;
-    MultiWordContext(size_t size) : words(size) {}
+    std::vector<float> params;
+    MultiWordContext(size_t size) : words(size), params() {}
 };
 
 struct MultiWordForest : FastForest {
@@ -440,6 +538,7 @@ struct MultiWordForest : FastForest {
     vespalib::string impl_name() const override { return "ff-multiword"; }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, const float *params, size_t num_docs, double *results) const override;
 };
 
 MultiWordForest::MultiWordForest(const State &state)
@@ -620,6 +719,23 @@ MultiWordForest::eval(Context &context, const float *params) const
     return get_result(ctx_words);
 }
 
+void
+MultiWordForest::eval_batch(Context &context, const float *params, size_t num_docs, double *results) const
+{
+    // Trees are too large for per-document masks to stay in cache
+    // across a batch; evaluate one document at a time instead.
+    assert(num_docs <= max_batch_size);
+    auto &doc_params = static_cast<MultiWordContext&>(context).params;
+    size_t num_params = _mask_sizes.size();
+    doc_params.resize(num_params);
+    for (size_t doc = 0; doc < num_docs; ++doc) {
+        for (size_t param = 0; param < num_params; ++param) {
+            doc_params[param] = params[(param * num_docs) + doc];
+        }
+        results[doc] = eval(context, &doc_params[0]);
+    }
+}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -17,6 +17,12 @@ namespace vespalib::eval::gbdt {
  * Comparisons must be on the form 'feature < const' or '!(feature >=
  * const)'. The inverted form is used to signal that the true branch
  * should be selected when the feature value is missing (NaN).
+ *
+ * Multiple documents may be evaluated at once with eval_batch. The
+ * parameters are then given column-major; the value of parameter 'p'
+ * for document 'd' is found at 'params[p * num_docs + d]'. This lets
+ * each comparison be checked against all documents in the batch
+ * before moving on to the next one.
  **/
 class FastForest
 {
@@ -32,10 +38,12 @@ public:
         virtual ~Context();
         using UP = std::unique_ptr<Context>;
     };
+    static constexpr size_t max_batch_size = 64;
     static UP try_convert(const Function &fun, size_t min_fixed = 8, size_t max_fixed = 64);
     virtual vespalib::string impl_name() const = 0;
     virtual Context::UP create_context() const = 0;
     virtual double eval(Context &context, const float *params) const = 0;
+    virtual void eval_batch(Context &context, const float *params, size_t num_docs, double *results) const = 0;
     double estimate_cost_us(const std::vector<double> &params, double budget = 5.0) const;
 };
 
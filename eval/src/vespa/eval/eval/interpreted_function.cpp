@@ -40,7 +40,8 @@ InterpretedFunction::State::State(const ValueBuilderFactory &factory_in)
       stash(),
       stack(),
       program_offset(0),
-      if_cnt(0)
+      if_cnt(0),
+      thread_bundle(nullptr)
 {
 }
 
@@ -60,6 +61,12 @@ InterpretedFunction::Context::Context(const InterpretedFunction &ifun)
 {
 }
 
+InterpretedFunction::Context::Context(const InterpretedFunction &ifun, ThreadBundle &thread_bundle)
+    : _state(ifun._factory)
+{
+    _state.thread_bundle = &thread_bundle;
+}
+
 InterpretedFunction::Instruction
 InterpretedFunction::Instruction::nop()
 {
@@ -8,6 +8,8 @@
 #include "lazy_params.h"
 #include <vespa/vespalib/util/stash.h>
 
+namespace vespalib { struct ThreadBundle; }
+
 namespace vespalib::eval {
 
 namespace nodes { struct Node; }
@@ -22,7 +24,11 @@ class TensorSpec;
  * run-time state related to the evaluation of an interpreted
  * function. The result of an evaluation is only valid until either
  * the context is destructed or the context is re-used to perform
- * another evaluation.
+ * another evaluation. A context may be given a thread bundle, which
+ * is then used by large instructions to split their work across
+ * multiple threads. The bundle must be idle while the function is
+ * evaluated; rank programs are evaluated by the match threads of a
+ * bundle themselves, so they do not pass one.
  **/
 class InterpretedFunction
 {
@@ -34,6 +40,7 @@ public:
         std::vector<Value::CREF>   stack;
         uint32_t                   program_offset;
         uint32_t                   if_cnt;
+        ThreadBundle              *thread_bundle;
 
         State(const ValueBuilderFactory &factory_in);
         ~State();
@@ -60,6 +67,7 @@ public:
         State _state;
     public:
         explicit Context(const InterpretedFunction &ifun);
+        Context(const InterpretedFunction &ifun, ThreadBundle &thread_bundle);
         uint32_t if_cnt() const { return _state.if_cnt; }
     };
     using op_function = void (*)(State &, uint64_t);
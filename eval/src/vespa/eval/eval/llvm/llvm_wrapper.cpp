@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include "llvm_wrapper.h"
+#include "object_code_cache.h"
 #include <vespa/eval/eval/node_visitor.h>
 #include <vespa/eval/eval/node_traverser.h>
 #include <llvm/IR/Verifier.h>
@@ -85,6 +86,7 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
     const gbdt::Optimize::Chain &forest_optimizers;
     std::vector<gbdt::Forest::UP> &forests;
     std::vector<PluginState::UP> &plugin_state;
+    std::vector<std::pair<llvm::GlobalValue*,void*>> *injected;
 
     llvm::FunctionType *make_call_1_fun_t() {
         std::vector<llvm::Type*> param_types;
@@ -141,7 +143,8 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
                     PassParams pass_params_in,
                     const gbdt::Optimize::Chain &forest_optimizers_in,
                     std::vector<gbdt::Forest::UP> &forests_out,
-                    std::vector<PluginState::UP> &plugin_state_out)
+                    std::vector<PluginState::UP> &plugin_state_out,
+                    std::vector<std::pair<llvm::GlobalValue*,void*>> *injected_out)
         : context(context_in),
           module(module_in),
           builder(context),
@@ -154,7 +157,8 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
           forest_end(nullptr),
           forest_optimizers(forest_optimizers_in),
           forests(forests_out),
-          plugin_state(plugin_state_out)
+          plugin_state(plugin_state_out),
+          injected(injected_out)
     {
         std::vector<llvm::Type*> param_types;
         if (pass_params == PassParams::SEPARATE) {
@@ -179,6 +183,29 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
 
     //-------------------------------------------------------------------------
 
+    // Native pointers are baked into the code as constants, unless
+    // the object code is cached. Then they are referenced through
+    // named external symbols that are bound to their actual address
+    // when the module is compiled. This keeps the generated object
+    // code independent of the process it was generated in.
+    llvm::Value *inject(void *ptr, llvm::PointerType *type) {
+        if (injected == nullptr) {
+            return builder.CreateIntToPtr(builder.getInt64((uint64_t)ptr), type, "inject");
+        }
+        auto name = vespalib::make_string("vespalib_eval_inject_%zu", injected->size());
+        llvm::Type *target_type = type->getPointerElementType();
+        llvm::GlobalValue *symbol = nullptr;
+        if (auto function_type = llvm::dyn_cast<llvm::FunctionType>(target_type)) {
+            symbol = llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, name.c_str(), &module);
+        } else {
+            symbol = new llvm::GlobalVariable(module, target_type, true, llvm::GlobalValue::ExternalLinkage, nullptr, name.c_str());
+        }
+        injected->emplace_back(symbol, ptr);
+        return symbol;
+    }
+
+    //-------------------------------------------------------------------------
+
     llvm::Value *get_param(size_t idx) {
         assert(idx < num_params);
         if (pass_params == PassParams::SEPARATE) {
@@ -242,15 +269,15 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
         void *eval_ptr = (void *) optimize_result.eval;
         gbdt::Forest *forest = forests.back().get();
         llvm::PointerType *eval_funptr_t = make_eval_forest_funptr_t();
-        llvm::Value *eval_fun = builder.CreateIntToPtr(builder.getInt64((uint64_t)eval_ptr), eval_funptr_t, "inject_eval");
-        llvm::Value *ctx = builder.CreateIntToPtr(builder.getInt64((uint64_t)forest), builder.getInt8Ty()->getPointerTo(), "inject_ctx");
+        llvm::Value *eval_fun = inject(eval_ptr, eval_funptr_t);
+        llvm::Value *ctx = inject(forest, builder.getInt8Ty()->getPointerTo());
         if (pass_params == PassParams::ARRAY) {
             push(builder.CreateCall(llvm::cast<llvm::FunctionType>(eval_fun->getType()->getPointerElementType()),
                                     eval_fun, {ctx, params[0]}, "call_eval"));
         } else {
             assert(pass_params == PassParams::LAZY);
             llvm::PointerType *proxy_funptr_t = make_eval_forest_proxy_funptr_t();
-            llvm::Value *proxy_fun = builder.CreateIntToPtr(builder.getInt64((uint64_t)vespalib_eval_forest_proxy), proxy_funptr_t, "inject_eval_proxy");
+            llvm::Value *proxy_fun = inject((void *) vespalib_eval_forest_proxy, proxy_funptr_t);
             push(builder.CreateCall(llvm::cast<llvm::FunctionType>(proxy_fun->getType()->getPointerElementType()),
                                     proxy_fun, {eval_fun, ctx, params[0], params[1], builder.getInt64(stats.num_params)}));
         }
@@ -404,8 +431,8 @@ struct FunctionBuilder : public NodeVisitor, public NodeTraverser {
             void *call_ptr = (void *) SetMemberHash::check_membership;
             PluginState *state = plugin_state.back().get();
             llvm::PointerType *funptr_t = make_check_membership_funptr_t();
-            llvm::Value *call_fun = builder.CreateIntToPtr(builder.getInt64((uint64_t)call_ptr), funptr_t, "inject_call_addr");
-            llvm::Value *ctx = builder.CreateIntToPtr(builder.getInt64((uint64_t)state), builder.getInt8Ty()->getPointerTo(), "inject_ctx");
+            llvm::Value *call_fun = inject(call_ptr, funptr_t);
+            llvm::Value *ctx = inject(state, builder.getInt8Ty()->getPointerTo());
             push(builder.CreateCall(llvm::cast<llvm::FunctionType>(call_fun->getType()->getPointerElementType()),
                                     call_fun, {ctx, lhs}, "call_check_membership"));
         } else {
@@ -676,7 +703,9 @@ LLVMWrapper::LLVMWrapper()
       _engine(),
       _functions(),
       _forests(),
-      _plugin_state()
+      _plugin_state(),
+      _injected(),
+      _object_cache(ObjectCodeCache::get())
 {
     _context = std::make_unique<llvm::LLVMContext>();
     _module = std::make_unique<llvm::Module>("LLVMWrapper", *_context);
@@ -690,7 +719,8 @@ LLVMWrapper::make_function(size_t num_params, PassParams pass_params, const Node
     FunctionBuilder builder(*_context, *_module,
                             vespalib::make_string("f%zu", function_id),
                             num_params, pass_params,
-                            forest_optimizers, _forests, _plugin_state);
+                            forest_optimizers, _forests, _plugin_state,
+                            _object_cache ? &_injected : nullptr);
     builder.build_root(root);
     _functions.push_back(builder.build());
     return function_id;
@@ -703,7 +733,8 @@ LLVMWrapper::make_forest_fragment(size_t num_params, const std::vector<const Nod
     FunctionBuilder builder(*_context, *_module,
                             vespalib::make_string("f%zu", function_id),
                             num_params, PassParams::ARRAY,
-                            gbdt::Optimize::none, _forests, _plugin_state);
+                            gbdt::Optimize::none, _forests, _plugin_state,
+                            _object_cache ? &_injected : nullptr);
     builder.build_forest_fragment(fragment);
     _functions.push_back(builder.build());
     return function_id;
@@ -715,9 +746,25 @@ LLVMWrapper::compile(llvm::raw_ostream * dumpStream)
     if (dumpStream) {
         _module->print(*dumpStream, nullptr);
     }
-    _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
+    if (!_object_cache) {
+        _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).create());
+        assert(_engine && "llvm jit not available for your platform");
+        _engine->finalizeObject();
+        return;
+    }
+    _module->setModuleIdentifier(ObjectCodeCache::make_key(*_module).c_str());
+    // injected symbols may be anywhere in the address space
+    _engine.reset(llvm::EngineBuilder(std::move(_module))
+                  .setOptLevel(llvm::CodeGenOpt::Aggressive)
+                  .setCodeModel(llvm::CodeModel::Large)
+                  .create());
     assert(_engine && "llvm jit not available for your platform");
+    for (const auto &entry: _injected) {
+        _engine->addGlobalMapping(entry.first, entry.second);
+    }
+    _engine->setObjectCache(_object_cache.get());
     _engine->finalizeObject();
+    _engine->setObjectCache(nullptr);
 }
 
 void *
@@ -729,6 +776,8 @@ LLVMWrapper::get_function_address(size_t function_id)
 LLVMWrapper::~LLVMWrapper() {
     _plugin_state.clear();
     _forests.clear();
+    _injected.clear();
+    _object_cache.reset();
     _functions.clear();
     _engine.reset();
     _module.reset();
@@ -23,6 +23,8 @@ extern "C" {
 
 namespace vespalib::eval {
 
+class ObjectCodeCache;
+
 /**
  * Simple interface used to track and clean up custom state. This is
  * typically used to destruct native objects that are invoked from
@@ -48,6 +50,8 @@ private:
     std::vector<llvm::Function*>           _functions;
     std::vector<gbdt::Forest::UP>          _forests;
     std::vector<PluginState::UP>           _plugin_state;
+    std::vector<std::pair<llvm::GlobalValue*,void*>> _injected;
+    std::shared_ptr<ObjectCodeCache>       _object_cache;
 
     void compile(llvm::raw_ostream * dumpStream);
 public:
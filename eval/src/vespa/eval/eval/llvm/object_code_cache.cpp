@@ -0,0 +1,189 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "object_code_cache.h"
+#include <vespa/vespalib/util/stringfmt.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <xxhash.h>
+#include <algorithm>
+#include <vector>
+#include <utime.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".eval.eval.llvm.object_code_cache");
+
+namespace vespalib::eval {
+
+namespace {
+
+std::mutex bound_lock;
+ObjectCodeCache::SP bound_cache;
+
+} // namespace vespalib::eval::<unnamed>
+
+vespalib::string
+ObjectCodeCache::file_name(const llvm::Module &module) const
+{
+    return _dir + "/" + module.getModuleIdentifier() + ".o";
+}
+
+ObjectCodeCache::ObjectCodeCache(const vespalib::string &dir, size_t max_size)
+    : _dir(dir),
+      _max_size(max_size),
+      _prune_lock(),
+      _num_loaded(0),
+      _num_stored(0),
+      _num_removed(0)
+{
+}
+
+ObjectCodeCache::~ObjectCodeCache() = default;
+
+void
+ObjectCodeCache::notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj)
+{
+    if (auto err = llvm::sys::fs::create_directories(_dir.c_str())) {
+        LOG(warning, "could not create object code cache directory '%s': %s", _dir.c_str(), err.message().c_str());
+        return;
+    }
+    // write to a temporary file first to never expose partial objects
+    int fd = -1;
+    llvm::SmallString<256> tmp_name;
+    vespalib::string pattern = file_name(*module) + ".%%%%%%%%.tmp";
+    if (auto err = llvm::sys::fs::createUniqueFile(pattern.c_str(), fd, tmp_name)) {
+        LOG(warning, "could not create temporary object code file in '%s': %s", _dir.c_str(), err.message().c_str());
+        return;
+    }
+    bool ok = true;
+    {
+        llvm::raw_fd_ostream out(fd, true);
+        out << obj.getBuffer();
+        out.close();
+        if (out.has_error()) {
+            LOG(warning, "could not write object code file '%s': %s", tmp_name.c_str(), out.error().message().c_str());
+            out.clear_error();
+            ok = false;
+        }
+    }
+    if (ok) {
+        if (auto err = llvm::sys::fs::rename(tmp_name, file_name(*module).c_str())) {
+            LOG(warning, "could not rename object code file '%s': %s", tmp_name.c_str(), err.message().c_str());
+            ok = false;
+        }
+    }
+    if (!ok) {
+        llvm::sys::fs::remove(tmp_name);
+        return;
+    }
+    _num_stored.fetch_add(1, std::memory_order_relaxed);
+    prune();
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+ObjectCodeCache::getObject(const llvm::Module *module)
+{
+    vespalib::string name = file_name(*module);
+    if (!llvm::sys::fs::exists(name.c_str())) {
+        return {};
+    }
+    auto buffer = llvm::MemoryBuffer::getFile(name.c_str());
+    if (!buffer) {
+        LOG(warning, "could not read object code file '%s': %s", name.c_str(), buffer.getError().message().c_str());
+        return {};
+    }
+    // the modification time tracks when an object was last used
+    utime(name.c_str(), nullptr);
+    _num_loaded.fetch_add(1, std::memory_order_relaxed);
+    return std::move(buffer.get());
+}
+
+void
+ObjectCodeCache::prune()
+{
+    struct Entry {
+        std::string name;
+        uint64_t size;
+        llvm::sys::TimePoint<> time;
+    };
+    std::lock_guard<std::mutex> guard(_prune_lock);
+    std::vector<Entry> entries;
+    uint64_t total_size = 0;
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator it(_dir.c_str(), ec), end; !ec && it != end; it.increment(ec)) {
+        if (!llvm::StringRef(it->path()).endswith(".o")) {
+            continue;
+        }
+        auto status = it->status();
+        if (!status) {
+            continue;
+        }
+        entries.push_back(Entry{it->path(), status->getSize(), status->getLastModificationTime()});
+        total_size += entries.back().size;
+    }
+    if (total_size <= _max_size) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto &a, const auto &b){ return (a.time < b.time); });
+    for (const auto &entry: entries) {
+        if (total_size <= _max_size) {
+            break;
+        }
+        if (auto err = llvm::sys::fs::remove(entry.name)) {
+            LOG(warning, "could not remove object code file '%s': %s", entry.name.c_str(), err.message().c_str());
+            continue;
+        }
+        total_size -= entry.size;
+        _num_removed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+vespalib::string
+ObjectCodeCache::make_key(const llvm::Module &module)
+{
+    std::string ir;
+    llvm::raw_string_ostream out(ir);
+    module.print(out, nullptr);
+    out << "\n" << LLVM_VERSION_STRING << "\n" << llvm::sys::getHostCPUName() << "\n";
+    llvm::StringMap<bool> features;
+    if (llvm::sys::getHostCPUFeatures(features)) {
+        std::vector<llvm::StringRef> enabled;
+        for (const auto &feature: features) {
+            if (feature.getValue()) {
+                enabled.push_back(feature.getKey());
+            }
+        }
+        std::sort(enabled.begin(), enabled.end());
+        for (const auto &name: enabled) {
+            out << "+" << name;
+        }
+        out << "\n";
+    }
+    out.flush();
+    XXH128_hash_t hash = XXH3_128bits(ir.data(), ir.size());
+    return make_string("%016" PRIx64 "%016" PRIx64, uint64_t(hash.high64), uint64_t(hash.low64));
+}
+
+void
+ObjectCodeCache::bind(const vespalib::string &dir, size_t max_size)
+{
+    SP cache = dir.empty() ? SP() : std::make_shared<ObjectCodeCache>(dir, max_size);
+    if (cache) {
+        cache->prune();
+    }
+    std::lock_guard<std::mutex> guard(bound_lock);
+    bound_cache = std::move(cache);
+}
+
+ObjectCodeCache::SP
+ObjectCodeCache::get()
+{
+    std::lock_guard<std::mutex> guard(bound_lock);
+    return bound_cache;
+}
+
+}
@@ -0,0 +1,62 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace llvm { class Module; }
+
+namespace vespalib::eval {
+
+/**
+ * Persistent cache of machine code generated by LLVM, used to avoid
+ * recompiling the same functions every time the process is
+ * restarted. Object files are stored in a directory, named by a hash
+ * of the textual IR of the module being compiled together with the
+ * LLVM version and the host cpu (name and features). The cache is
+ * disabled unless a directory has been bound to it. When the total
+ * size of the cached objects exceeds a limit, the least recently used
+ * objects are removed. Note that the generated code must not contain
+ * process specific addresses; native objects are referenced through
+ * named symbols that are resolved at load time.
+ **/
+class ObjectCodeCache : public llvm::ObjectCache
+{
+private:
+    vespalib::string    _dir;
+    size_t              _max_size;
+    std::mutex          _prune_lock;
+    std::atomic<size_t> _num_loaded;
+    std::atomic<size_t> _num_stored;
+    std::atomic<size_t> _num_removed;
+
+    vespalib::string file_name(const llvm::Module &module) const;
+
+public:
+    using SP = std::shared_ptr<ObjectCodeCache>;
+    static constexpr size_t default_max_size = 256 * 1024 * 1024;
+    ObjectCodeCache(const vespalib::string &dir, size_t max_size);
+    ~ObjectCodeCache() override;
+    const vespalib::string &dir() const { return _dir; }
+    size_t num_loaded() const { return _num_loaded.load(std::memory_order_relaxed); }
+    size_t num_stored() const { return _num_stored.load(std::memory_order_relaxed); }
+    size_t num_removed() const { return _num_removed.load(std::memory_order_relaxed); }
+
+    // remove least recently used objects until the cache fits within its max size
+    void prune();
+    void notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj) override;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override;
+
+    // calculate the key identifying the object code of a module
+    static vespalib::string make_key(const llvm::Module &module);
+
+    // use the given directory for caching (empty string to disable)
+    static void bind(const vespalib::string &dir, size_t max_size = default_max_size);
+    static SP get();
+};
+
+}
@@ -27,6 +27,7 @@
 #include <vespa/eval/instruction/vector_from_doubles_function.h>
 #include <vespa/eval/instruction/dense_tensor_create_function.h>
 #include <vespa/eval/instruction/dense_tensor_peek_function.h>
+#include <vespa/eval/instruction/dense_fused_function.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".eval.eval.optimize_tensor_function");
@@ -55,6 +56,15 @@ const TensorFunction &optimize_for_factory(const ValueBuilderFactory &, const Te
             nodes.pop_back();
         }
     }
+    {
+        // top-down to fuse the longest possible chains
+        std::vector<Child::CREF> nodes({root});
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const Child &child = nodes[i].get();
+            child.set(DenseFusedFunction::optimize(child.get(), stash));
+            child.get().push_children(nodes);
+        }
+    }
     {
         std::vector<Child::CREF> nodes({root});
         for (size_t i = 0; i < nodes.size(); ++i) {
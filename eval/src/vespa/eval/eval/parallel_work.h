@@ -0,0 +1,60 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/runnable.h>
+#include <vespa/vespalib/util/thread_bundle.h>
+#include <algorithm>
+#include <vector>
+
+namespace vespalib::eval {
+
+/**
+ * Utility used by instructions to split a number of independent
+ * units of work into consecutive ranges that are handled by the
+ * threads of a thread bundle. Work is only split when there is
+ * enough of it to keep each thread busy for a while; otherwise all
+ * units are handled by the calling thread. The work function is
+ * called with the [begin,end) range of units to handle, and must
+ * only write to memory owned by those units.
+ **/
+struct ParallelWork {
+    // minimal amount of work (typically number of multiply-adds
+    // or sampled cells) needed to involve another thread
+    static constexpr size_t min_work_per_thread = 256 * 1024;
+
+    static size_t num_threads(const ThreadBundle *bundle, size_t num_units, size_t work_per_unit) {
+        if (bundle == nullptr) {
+            return 1;
+        }
+        size_t max_threads = (num_units * work_per_unit) / min_work_per_thread;
+        return std::max(size_t(1), std::min({bundle->size(), num_units, max_threads}));
+    }
+
+    template <typename F>
+    static void run(ThreadBundle *bundle, size_t num_units, size_t work_per_unit, F &&fun) {
+        size_t n = num_threads(bundle, num_units, work_per_unit);
+        if (n == 1) {
+            fun(size_t(0), num_units);
+            return;
+        }
+        struct Part : Runnable {
+            F &fun;
+            size_t begin;
+            size_t end;
+            Part(F &fun_in, size_t begin_in, size_t end_in) : fun(fun_in), begin(begin_in), end(end_in) {}
+            void run() override { fun(begin, end); }
+        };
+        std::vector<Part> parts;
+        std::vector<Runnable*> targets;
+        parts.reserve(n);
+        targets.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            parts.emplace_back(fun, (num_units * i) / n, (num_units * (i + 1)) / n);
+            targets.push_back(&parts.back());
+        }
+        bundle->run(targets);
+    }
+};
+
+}
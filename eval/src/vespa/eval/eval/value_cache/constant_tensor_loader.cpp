@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "constant_tensor_loader.h"
+#include "mapped_constant_value.h"
 #include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/eval/value_codec.h>
 #include <vespa/vespalib/objects/nbostream.h>
@@ -77,6 +78,9 @@ ConstantTensorLoader::create(const vespalib::string &path, const vespalib::strin
         LOG(warning, "invalid type specification: %s", type.c_str());
         return std::make_unique<BadConstantValue>();
     }
+    if (ends_with(path, MappedConstantValue::file_suffix)) {
+        return MappedConstantValue::load(path, value_type);
+    }
     if (ends_with(path, ".tbf")) {
         vespalib::MappedFileInput file(path);
         vespalib::Memory content = file.get();
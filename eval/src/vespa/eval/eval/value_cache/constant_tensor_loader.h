@@ -11,7 +11,9 @@ namespace eval {
 /**
  * A ConstantValueFactory that will load constant tensor values from
  * file. The file is expected to be in json format with the same
- * structure used when feeding.
+ * structure used when feeding. Dense tensors stored in the format
+ * used by MappedConstantValue (.tmf files) are memory mapped instead
+ * of being copied onto the heap.
  **/
 class ConstantTensorLoader : public ConstantValueFactory
 {
@@ -24,16 +24,28 @@ ConstantValue::UP
 ConstantValueCache::create(const vespalib::string &path, const vespalib::string &type) const
 {
     Cache::Key key = std::make_pair(path, type);
-    std::lock_guard<std::mutex> guard(_cache->lock);
+    std::unique_lock<std::mutex> guard(_cache->lock);
     auto pos = _cache->cached.find(key);
     if (pos != _cache->cached.end()) {
         ++(pos->second.num_refs);
+        _cache->cond.wait(guard, [&pos]{ return bool(pos->second.const_value); });
         return std::make_unique<Token>(_cache, pos);
-    } else {
-        auto res = _cache->cached.emplace(std::move(key), _factory.create(path, type));
-        assert(res.second);
-        return std::make_unique<Token>(_cache, res.first);
     }
+    auto res = _cache->cached.emplace(std::move(key), Cache::Value());
+    assert(res.second);
+    // the empty entry is a placeholder for the value while it is created
+    guard.unlock();
+    ConstantValue::UP const_value;
+    try {
+        const_value = _factory.create(path, type);
+    } catch (...) {
+        // waiting requests must be woken up; report failure like the loaders do
+        const_value = std::make_unique<BadConstantValue>();
+    }
+    guard.lock();
+    res.first->second.const_value = std::move(const_value);
+    _cache->cond.notify_all();
+    return std::make_unique<Token>(_cache, res.first);
 }
 
 } // namespace vespalib::eval
@@ -4,6 +4,7 @@
 
 #include "constant_value.h"
 
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -15,7 +16,9 @@ namespace eval {
  * A cache enabling clients to share the constant values created by an
  * underlying factory. The returned wrappers are used to ensure
  * appropriate lifetime of created values. Used values are kept in the
- * cache and unused values are evicted from the cache.
+ * cache and unused values are evicted from the cache. Values are
+ * created outside the cache lock; concurrent requests for a value
+ * that is being created wait for it instead of creating it again.
  **/
 class ConstantValueCache : public ConstantValueFactory
 {
@@ -26,11 +29,11 @@ private:
         struct Value {
             size_t num_refs;
             ConstantValue::UP const_value;
-            Value(ConstantValue::UP const_value_in)
-                : num_refs(1), const_value(std::move(const_value_in)) {}
+            Value() : num_refs(1), const_value() {}
         };
         using Map = std::map<Key,Value>;
         std::mutex lock;
+        std::condition_variable cond;
         Map cached;
     };
 
@@ -0,0 +1,119 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mapped_constant_value.h"
+#include <vespa/vespalib/io/fileutil.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.eval.value_cache.mapped_constant_value");
+
+namespace vespalib::eval {
+
+namespace {
+
+constexpr uint32_t file_magic = 0x564d5446; // 'VTMF'
+constexpr size_t cells_alignment = 64;
+
+size_t cells_offset_for(size_t spec_size) {
+    size_t header_size = (2 * sizeof(uint32_t)) + spec_size;
+    return ((header_size + cells_alignment - 1) / cells_alignment) * cells_alignment;
+}
+
+bool is_dense_constant(const ValueType &type) {
+    return (!type.is_error() && (type.count_mapped_dimensions() == 0));
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+MappedConstantValue::MappedConstantValue(const ValueType &type, void *data, size_t size, size_t cells_offset)
+    : _type(type),
+      _data(data),
+      _size(size),
+      _value()
+{
+    TypedCells cells(static_cast<const char *>(_data) + cells_offset, _type.cell_type(), _type.dense_subspace_size());
+    _value = std::make_unique<DenseValueView>(_type, cells);
+}
+
+MappedConstantValue::~MappedConstantValue()
+{
+    _value.reset();
+    munmap(_data, _size);
+}
+
+ConstantValue::UP
+MappedConstantValue::load(const vespalib::string &path, const ValueType &type)
+{
+    if (!is_dense_constant(type)) {
+        LOG(warning, "mapped constants must be dense, type was %s: %s", type.to_spec().c_str(), path.c_str());
+        return std::make_unique<BadConstantValue>();
+    }
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        LOG(warning, "could not open file: %s", path.c_str());
+        return std::make_unique<BadConstantValue>();
+    }
+    void *data = MAP_FAILED;
+    size_t size = 0;
+    struct stat info;
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+        size = info.st_size;
+        data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOG(warning, "could not map file: %s", path.c_str());
+        return std::make_unique<BadConstantValue>();
+    }
+    const char *pos = static_cast<const char *>(data);
+    uint32_t magic = 0;
+    uint32_t spec_size = 0;
+    bool ok = (size >= (2 * sizeof(uint32_t)));
+    if (ok) {
+        memcpy(&magic, pos, sizeof(uint32_t));
+        memcpy(&spec_size, pos + sizeof(uint32_t), sizeof(uint32_t));
+        ok = ((magic == file_magic) && (size >= cells_offset_for(spec_size)));
+    }
+    if (ok) {
+        vespalib::string spec(pos + (2 * sizeof(uint32_t)), spec_size);
+        size_t cells_size = CellTypeUtils::mem_size(type.cell_type(), type.dense_subspace_size());
+        ok = ((spec == type.to_spec()) && (size == (cells_offset_for(spec_size) + cells_size)));
+    }
+    if (!ok) {
+        LOG(warning, "file does not contain a mapped tensor of type %s: %s", type.to_spec().c_str(), path.c_str());
+        munmap(data, size);
+        return std::make_unique<BadConstantValue>();
+    }
+    return ConstantValue::UP(new MappedConstantValue(type, data, size, cells_offset_for(spec_size)));
+}
+
+void
+MappedConstantValue::save(const Value &value, const vespalib::string &path)
+{
+    const ValueType &type = value.type();
+    if (!is_dense_constant(type)) {
+        throw IllegalArgumentException(make_string("mapped constants must be dense, type was %s",
+                                                   type.to_spec().c_str()), VESPA_STRLOC);
+    }
+    vespalib::string spec = type.to_spec();
+    uint32_t spec_size = spec.size();
+    std::vector<char> header(cells_offset_for(spec_size), 0);
+    memcpy(&header[0], &file_magic, sizeof(uint32_t));
+    memcpy(&header[sizeof(uint32_t)], &spec_size, sizeof(uint32_t));
+    memcpy(&header[2 * sizeof(uint32_t)], spec.data(), spec_size);
+    TypedCells cells = value.cells();
+    File file(path);
+    file.open(File::CREATE | File::TRUNC);
+    file.write(header.data(), header.size(), 0);
+    file.write(cells.data, CellTypeUtils::mem_size(cells.type, cells.size), header.size());
+    file.close();
+}
+
+}
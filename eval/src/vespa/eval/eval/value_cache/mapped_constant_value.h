@@ -0,0 +1,45 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "constant_value.h"
+#include <vespa/vespalib/stllike/string.h>
+
+namespace vespalib::eval {
+
+/**
+ * A dense constant value whose cells are used directly from a memory
+ * mapped file. Since the file is mapped read-only and shared, the
+ * cells are only paged in when used, and the same physical memory is
+ * used by everyone mapping the same file.
+ *
+ * The file format is a 'VTMF' magic number, followed by the length of
+ * the tensor type spec, the type spec itself and padding up to the
+ * next multiple of 64 bytes. The cells follow directly after the
+ * header. All numbers (including the cells) are stored in host byte
+ * order; files written on a host with a different byte order will be
+ * rejected due to the magic number not matching.
+ **/
+class MappedConstantValue : public ConstantValue
+{
+private:
+    ValueType _type;
+    void     *_data;
+    size_t    _size;
+    Value::UP _value;
+
+    MappedConstantValue(const ValueType &type, void *data, size_t size, size_t cells_offset);
+public:
+    static constexpr const char *file_suffix = ".tmf";
+    ~MappedConstantValue() override;
+    const ValueType &type() const override { return _type; }
+    const Value &value() const override { return *_value; }
+
+    // map the given file, expecting a dense tensor of the given type
+    static ConstantValue::UP load(const vespalib::string &path, const ValueType &type);
+
+    // write a dense value to the given file; throws on io errors
+    static void save(const Value &value, const vespalib::string &path);
+};
+
+}
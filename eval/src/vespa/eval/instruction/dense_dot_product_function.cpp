@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_dot_product_function.h"
+#include "quantized_cells.h"
 #include <vespa/eval/eval/operation.h>
 #include <vespa/eval/eval/value.h>
 #include <cblas.h>
@@ -39,6 +40,15 @@ void my_cblas_float_dot_product_op(InterpretedFunction::State &state, uint64_t)
     state.pop_pop_push(state.stash.create<DoubleValue>(result));
 }
 
+template <typename CT>
+void my_quantized_dot_product_op(InterpretedFunction::State &state, uint64_t) {
+    auto lhs_cells = state.peek(1).cells().typify<CT>();
+    auto rhs_cells = state.peek(0).cells().typify<CT>();
+    double result = quantized_cells::dot_product(hwaccelrated::IAccelrated::getAccelerator(),
+                                                 lhs_cells.cbegin(), rhs_cells.cbegin(), lhs_cells.size());
+    state.pop_pop_push(state.stash.create<DoubleValue>(result));
+}
+
 struct MyDotProductOp {
     template <typename LCT, typename RCT>
     static auto invoke() { return my_dot_product_op<LCT,RCT>; }
@@ -52,6 +62,12 @@ InterpretedFunction::op_function my_select(CellType lct, CellType rct) {
         if (lct == CellType::FLOAT) {
             return my_cblas_float_dot_product_op;
         }
+        if (lct == CellType::BFLOAT16) {
+            return my_quantized_dot_product_op<BFloat16>;
+        }
+        if (lct == CellType::INT8) {
+            return my_quantized_dot_product_op<Int8Float>;
+        }
     }
     using MyTypify = TypifyCellType;
     return typify_invoke<2,MyTypify,MyDotProductOp>(lct, rct);
@@ -0,0 +1,283 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_fused_function.h"
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/visit_stuff.h>
+#include <vespa/vespalib/objects/objectvisitor.h>
+#include <vespa/vespalib/objects/visit.hpp>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <array>
+
+namespace vespalib::eval {
+
+using namespace tensor_function;
+using State = InterpretedFunction::State;
+using Step = DenseFusedFunction::Step;
+using Child = TensorFunction::Child;
+
+namespace {
+
+template <typename CT>
+void my_load_cells(const Value &value, size_t offset, size_t n, double *dst) {
+    const CT *src = value.cells().typify<CT>().cbegin() + offset;
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+void my_load_number(const Value &value, size_t, size_t n, double *dst) {
+    std::fill(dst, dst + n, value.as_double());
+}
+
+struct MyGetLoadFun {
+    template <typename CT> static auto invoke() { return my_load_cells<CT>; }
+};
+
+void round_to_float(double *values, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = float(values[i]);
+    }
+}
+
+// calculate a block of (at most block_size) cells, leaving the result in 'stack[0]'
+void calc_block(const State &state, const DenseFusedFunction::Self &self, size_t offset, size_t n,
+                double (&stack)[DenseFusedFunction::max_stack_size][DenseFusedFunction::block_size])
+{
+    size_t sp = 0;
+    for (const Step &step: self.program) {
+        switch (step.kind) {
+        case Step::Kind::INPUT:
+            step.load_fun(state.peek(self.num_inputs - 1 - step.input_idx), offset, n, stack[sp++]);
+            break;
+        case Step::Kind::MAP: {
+            double *a = stack[sp - 1];
+            for (size_t i = 0; i < n; ++i) {
+                a[i] = step.map_fun(a[i]);
+            }
+            if (step.round_to_float) {
+                round_to_float(a, n);
+            }
+            break;
+        }
+        case Step::Kind::JOIN: {
+            double *a = stack[sp - 2];
+            const double *b = stack[sp - 1];
+            for (size_t i = 0; i < n; ++i) {
+                a[i] = step.join_fun(a[i], b[i]);
+            }
+            if (step.round_to_float) {
+                round_to_float(a, n);
+            }
+            --sp;
+            break;
+        }
+        }
+    }
+}
+
+template <typename OCT>
+void my_fused_op(State &state, uint64_t param) {
+    const auto &self = unwrap_param<DenseFusedFunction::Self>(param);
+    ArrayRef<OCT> dst_cells = state.stash.create_uninitialized_array<OCT>(self.num_cells);
+    double stack[DenseFusedFunction::max_stack_size][DenseFusedFunction::block_size];
+    for (size_t offset = 0; offset < self.num_cells; offset += DenseFusedFunction::block_size) {
+        size_t n = std::min(DenseFusedFunction::block_size, self.num_cells - offset);
+        calc_block(state, self, offset, n, stack);
+        OCT *dst = dst_cells.begin() + offset;
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = stack[0][i];
+        }
+    }
+    state.pop_n_push(self.num_inputs, state.stash.create<DenseValueView>(self.result_type, TypedCells(dst_cells)));
+}
+
+template <typename AGGR>
+void my_fused_reduce_op(State &state, uint64_t param) {
+    const auto &self = unwrap_param<DenseFusedFunction::Self>(param);
+    std::array<AGGR,8> aggrs;
+    double stack[DenseFusedFunction::max_stack_size][DenseFusedFunction::block_size];
+    for (size_t offset = 0; offset < self.num_cells; offset += DenseFusedFunction::block_size) {
+        size_t n = std::min(DenseFusedFunction::block_size, self.num_cells - offset);
+        calc_block(state, self, offset, n, stack);
+        for (size_t i = 0; i < n; ++i) {
+            aggrs[i & 7].sample(stack[0][i]);
+        }
+    }
+    aggrs[0].merge(aggrs[4]);
+    aggrs[1].merge(aggrs[5]);
+    aggrs[2].merge(aggrs[6]);
+    aggrs[3].merge(aggrs[7]);
+    aggrs[0].merge(aggrs[2]);
+    aggrs[1].merge(aggrs[3]);
+    aggrs[0].merge(aggrs[1]);
+    state.pop_n_push(self.num_inputs, state.stash.create<DoubleValue>(aggrs[0].result()));
+}
+
+struct MyGetFusedFun {
+    template <typename OCT> static auto invoke() { return my_fused_op<OCT>; }
+};
+
+struct MyGetFusedReduceFun {
+    template <typename AGGR> static auto invoke() {
+        return my_fused_reduce_op<typename AGGR::template templ<double>>;
+    }
+};
+
+bool is_fused_type(const ValueType &type) {
+    return (type.is_dense() &&
+            ((type.cell_type() == CellType::DOUBLE) ||
+             (type.cell_type() == CellType::FLOAT)));
+}
+
+bool is_fused_input(const ValueType &type, const ValueType &res_type) {
+    return (type.is_double() || (type.dimensions() == res_type.dimensions()));
+}
+
+bool is_fused_op(const TensorFunction &node) {
+    const auto &res_type = node.result_type();
+    if (!is_fused_type(res_type)) {
+        return false;
+    }
+    if (auto map = as<Map>(node)) {
+        return (map->child().result_type().dimensions() == res_type.dimensions());
+    }
+    if (auto join = as<Join>(node)) {
+        return (is_fused_input(join->lhs().result_type(), res_type) &&
+                is_fused_input(join->rhs().result_type(), res_type));
+    }
+    return false;
+}
+
+struct ProgramBuilder {
+    std::vector<Child> inputs;
+    std::vector<Step> program;
+    size_t num_ops = 0;
+    size_t stack_size = 0;
+    size_t max_stack_size = 0;
+
+    void add_input(const TensorFunction &node) {
+        const auto &type = node.result_type();
+        auto load_fun = type.is_double()
+                        ? my_load_number
+                        : typify_invoke<1,TypifyCellType,MyGetLoadFun>(type.cell_type());
+        program.push_back(Step::input(inputs.size(), load_fun));
+        inputs.emplace_back(node);
+        max_stack_size = std::max(max_stack_size, ++stack_size);
+    }
+
+    void add(const TensorFunction &node) {
+        if (!is_fused_op(node)) {
+            add_input(node);
+            return;
+        }
+        bool round = (node.result_type().cell_type() == CellType::FLOAT);
+        if (auto map = as<Map>(node)) {
+            add(map->child());
+            program.push_back(Step::map(map->function(), round));
+        } else {
+            auto join = as<Join>(node);
+            add(join->lhs());
+            add(join->rhs());
+            program.push_back(Step::join(join->function(), round));
+            --stack_size;
+        }
+        ++num_ops;
+    }
+};
+
+vespalib::string program_as_string(const std::vector<Step> &program) {
+    vespalib::string str;
+    for (const Step &step: program) {
+        if (!str.empty()) {
+            str.push_back(' ');
+        }
+        switch (step.kind) {
+        case Step::Kind::INPUT: str += make_string("input(%zu)", step.input_idx); break;
+        case Step::Kind::MAP:   str += "map"; break;
+        case Step::Kind::JOIN:  str += "join"; break;
+        }
+    }
+    return str;
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+DenseFusedFunction::Self::Self(const ValueType &result_type_in, size_t num_cells_in,
+                               size_t num_inputs_in, std::vector<Step> program_in)
+    : result_type(result_type_in),
+      num_cells(num_cells_in),
+      num_inputs(num_inputs_in),
+      program(std::move(program_in))
+{
+}
+
+DenseFusedFunction::Self::~Self() = default;
+
+DenseFusedFunction::DenseFusedFunction(const ValueType &result_type, size_t num_cells,
+                                       std::vector<Child> inputs, std::vector<Step> program,
+                                       std::optional<Aggr> aggr)
+    : TensorFunction(),
+      _self(result_type, num_cells, inputs.size(), std::move(program)),
+      _inputs(std::move(inputs)),
+      _aggr(aggr)
+{
+}
+
+DenseFusedFunction::~DenseFusedFunction() = default;
+
+void
+DenseFusedFunction::push_children(std::vector<Child::CREF> &children) const
+{
+    for (const Child &input: _inputs) {
+        children.emplace_back(input);
+    }
+}
+
+InterpretedFunction::Instruction
+DenseFusedFunction::compile_self(const ValueBuilderFactory &, Stash &) const
+{
+    auto op = _aggr.has_value()
+              ? typify_invoke<1,TypifyAggr,MyGetFusedReduceFun>(_aggr.value())
+              : typify_invoke<1,TypifyCellType,MyGetFusedFun>(result_type().cell_type());
+    return InterpretedFunction::Instruction(op, wrap_param<DenseFusedFunction::Self>(_self));
+}
+
+void
+DenseFusedFunction::visit_self(vespalib::ObjectVisitor &visitor) const
+{
+    TensorFunction::visit_self(visitor);
+    visitor.visitInt("num_ops", num_ops());
+    visitor.visitString("program", program_as_string(_self.program));
+    if (_aggr.has_value()) {
+        ::visit(visitor, "aggr", _aggr.value());
+    }
+}
+
+const TensorFunction &
+DenseFusedFunction::optimize(const TensorFunction &expr, Stash &stash)
+{
+    const TensorFunction *root = &expr;
+    std::optional<Aggr> aggr;
+    if (auto reduce = as<Reduce>(expr)) {
+        if (!expr.result_type().is_double() || aggr::is_complex(reduce->aggr())) {
+            return expr;
+        }
+        root = &reduce->child();
+        aggr = reduce->aggr();
+    }
+    if (!is_fused_op(*root)) {
+        return expr;
+    }
+    ProgramBuilder builder;
+    builder.add(*root);
+    size_t min_ops = aggr.has_value() ? 1 : 2;
+    if ((builder.num_ops < min_ops) || (builder.max_stack_size > max_stack_size)) {
+        return expr;
+    }
+    size_t num_cells = root->result_type().dense_subspace_size();
+    return stash.create<DenseFusedFunction>(expr.result_type(), num_cells, std::move(builder.inputs),
+                                            std::move(builder.program), aggr);
+}
+
+} // namespace vespalib::eval
@@ -0,0 +1,76 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <optional>
+
+namespace vespalib::eval {
+
+/**
+ * Tensor function fusing a chain of cell-wise map and join
+ * operations on dense tensors into a single instruction. All tensors
+ * in the chain must have the same dimensions, but numbers may also be
+ * joined in. The chain may be followed by a reduce of all dimensions
+ * into a number. Instead of creating a new tensor for each
+ * intermediate result, the cells are calculated in small blocks where
+ * all operations are applied to a block before moving on to the next
+ * one. Intermediate values are rounded to the cell type of the
+ * operation producing them, giving the same results as the unfused
+ * operations.
+ **/
+class DenseFusedFunction : public TensorFunction
+{
+public:
+    using map_fun_t = operation::op1_t;
+    using join_fun_t = operation::op2_t;
+    using load_fun_t = void (*)(const Value &value, size_t offset, size_t n, double *dst);
+
+    // the fused operations are run as a small stack machine
+    struct Step {
+        enum class Kind { INPUT, MAP, JOIN };
+        Kind kind;
+        size_t input_idx;
+        load_fun_t load_fun;
+        map_fun_t map_fun;
+        join_fun_t join_fun;
+        bool round_to_float;
+        static Step input(size_t idx, load_fun_t fun) { return {Kind::INPUT, idx, fun, nullptr, nullptr, false}; }
+        static Step map(map_fun_t fun, bool round) { return {Kind::MAP, 0, nullptr, fun, nullptr, round}; }
+        static Step join(join_fun_t fun, bool round) { return {Kind::JOIN, 0, nullptr, nullptr, fun, round}; }
+    };
+
+    static constexpr size_t block_size = 64;
+    static constexpr size_t max_stack_size = 8;
+
+    struct Self {
+        ValueType result_type;
+        size_t num_cells;
+        size_t num_inputs;
+        std::vector<Step> program;
+        Self(const ValueType &result_type_in, size_t num_cells_in, size_t num_inputs_in, std::vector<Step> program_in);
+        ~Self();
+    };
+
+private:
+    Self _self;
+    std::vector<Child> _inputs;
+    std::optional<Aggr> _aggr;
+
+public:
+    DenseFusedFunction(const ValueType &result_type, size_t num_cells,
+                       std::vector<Child> inputs, std::vector<Step> program,
+                       std::optional<Aggr> aggr);
+    ~DenseFusedFunction() override;
+    const ValueType &result_type() const override { return _self.result_type; }
+    size_t num_inputs() const { return _inputs.size(); }
+    size_t num_ops() const { return (_self.program.size() - _inputs.size()); }
+    const std::optional<Aggr> &aggr() const { return _aggr; }
+    void push_children(std::vector<Child::CREF> &children) const override;
+    InterpretedFunction::Instruction compile_self(const ValueBuilderFactory &factory, Stash &stash) const override;
+    bool result_is_mutable() const override { return true; }
+    void visit_self(vespalib::ObjectVisitor &visitor) const override;
+    static const TensorFunction &optimize(const TensorFunction &expr, Stash &stash);
+};
+
+} // namespace vespalib::eval
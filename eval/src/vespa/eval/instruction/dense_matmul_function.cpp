@@ -1,9 +1,11 @@
 // Copyright 2020 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_matmul_function.h"
+#include "quantized_cells.h"
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/parallel_work.h>
 #include <cassert>
 #include <cblas.h>
 
@@ -31,17 +33,20 @@ void my_matmul_op(InterpretedFunction::State &state, uint64_t param) {
     auto lhs_cells = state.peek(1).cells().typify<LCT>();
     auto rhs_cells = state.peek(0).cells().typify<RCT>();
     auto dst_cells = state.stash.create_uninitialized_array<OCT>(self.lhs_size * self.rhs_size);
-    OCT *dst = dst_cells.begin();
-    const LCT *lhs = lhs_cells.cbegin();
-    for (size_t i = 0; i < self.lhs_size; ++i) {
-        const RCT *rhs = rhs_cells.cbegin();
-        for (size_t j = 0; j < self.rhs_size; ++j) {
-            *dst++ = my_dot_product<LCT,RCT,OCT,lhs_common_inner,rhs_common_inner>(lhs, rhs,
-                                                                                   self.lhs_size, self.common_size, self.rhs_size);
-            rhs += (rhs_common_inner ? self.common_size : 1);
+    auto calc_rows = [&](size_t begin, size_t end) {
+        OCT *dst = dst_cells.begin() + (begin * self.rhs_size);
+        const LCT *lhs = lhs_cells.cbegin() + (begin * (lhs_common_inner ? self.common_size : 1));
+        for (size_t i = begin; i < end; ++i) {
+            const RCT *rhs = rhs_cells.cbegin();
+            for (size_t j = 0; j < self.rhs_size; ++j) {
+                *dst++ = my_dot_product<LCT,RCT,OCT,lhs_common_inner,rhs_common_inner>(lhs, rhs,
+                                                                                       self.lhs_size, self.common_size, self.rhs_size);
+                rhs += (rhs_common_inner ? self.common_size : 1);
+            }
+            lhs += (lhs_common_inner ? self.common_size : 1);
         }
-        lhs += (lhs_common_inner ? self.common_size : 1);
-    }
+    };
+    ParallelWork::run(state.thread_bundle, self.lhs_size, self.common_size * self.rhs_size, calc_rows);
     state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type, TypedCells(dst_cells)));
 }
 
@@ -51,25 +56,34 @@ void my_cblas_double_matmul_op(InterpretedFunction::State &state, uint64_t param
     auto lhs_cells = state.peek(1).cells().typify<double>();
     auto rhs_cells = state.peek(0).cells().typify<double>();
     auto dst_cells = state.stash.create_array<double>(self.lhs_size * self.rhs_size);
-    cblas_dgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
-                self.lhs_size, self.rhs_size, self.common_size, 1.0,
-                lhs_cells.cbegin(), lhs_common_inner ? self.common_size : self.lhs_size,
-                rhs_cells.cbegin(), rhs_common_inner ? self.common_size : self.rhs_size,
-                0.0, dst_cells.begin(), self.rhs_size);
+    auto calc_rows = [&](size_t begin, size_t end) {
+        cblas_dgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
+                    end - begin, self.rhs_size, self.common_size, 1.0,
+                    lhs_cells.cbegin() + (begin * (lhs_common_inner ? self.common_size : 1)),
+                    lhs_common_inner ? self.common_size : self.lhs_size,
+                    rhs_cells.cbegin(), rhs_common_inner ? self.common_size : self.rhs_size,
+                    0.0, dst_cells.begin() + (begin * self.rhs_size), self.rhs_size);
+    };
+    ParallelWork::run(state.thread_bundle, self.lhs_size, self.common_size * self.rhs_size, calc_rows);
     state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type, TypedCells(dst_cells)));
 }
 
-template <bool lhs_common_inner, bool rhs_common_inner>
+// quantized cells are converted to float before multiplying
+template <typename CT, bool lhs_common_inner, bool rhs_common_inner>
 void my_cblas_float_matmul_op(InterpretedFunction::State &state, uint64_t param) {
     const DenseMatMulFunction::Self &self = unwrap_param<DenseMatMulFunction::Self>(param);
-    auto lhs_cells = state.peek(1).cells().typify<float>();
-    auto rhs_cells = state.peek(0).cells().typify<float>();
+    auto lhs_cells = quantized_cells::as_float<CT>(state.peek(1), state.stash);
+    auto rhs_cells = quantized_cells::as_float<CT>(state.peek(0), state.stash);
     auto dst_cells = state.stash.create_array<float>(self.lhs_size * self.rhs_size);
-    cblas_sgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
-                self.lhs_size, self.rhs_size, self.common_size, 1.0,
-                lhs_cells.cbegin(), lhs_common_inner ? self.common_size : self.lhs_size,
-                rhs_cells.cbegin(), rhs_common_inner ? self.common_size : self.rhs_size,
-                0.0, dst_cells.begin(), self.rhs_size);
+    auto calc_rows = [&](size_t begin, size_t end) {
+        cblas_sgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
+                    end - begin, self.rhs_size, self.common_size, 1.0,
+                    lhs_cells.cbegin() + (begin * (lhs_common_inner ? self.common_size : 1)),
+                    lhs_common_inner ? self.common_size : self.lhs_size,
+                    rhs_cells.cbegin(), rhs_common_inner ? self.common_size : self.rhs_size,
+                    0.0, dst_cells.begin() + (begin * self.rhs_size), self.rhs_size);
+    };
+    ParallelWork::run(state.thread_bundle, self.lhs_size, self.common_size * self.rhs_size, calc_rows);
     state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type, TypedCells(dst_cells)));
 }
 
@@ -121,7 +135,10 @@ struct SelectDenseMatmul {
         if (std::is_same_v<LCT,double> && std::is_same_v<RCT,double>) {
             return my_cblas_double_matmul_op<LhsCommonInner::value, RhsCommonInner::value>;
         } else if (std::is_same_v<LCT,float> && std::is_same_v<RCT,float>) {
-            return my_cblas_float_matmul_op<LhsCommonInner::value, RhsCommonInner::value>;
+            return my_cblas_float_matmul_op<float, LhsCommonInner::value, RhsCommonInner::value>;
+        } else if constexpr (std::is_same_v<LCT,RCT> && quantized_cells::is_quantized<LCT>()) {
+            assert((std::is_same_v<OCT,float>));
+            return my_cblas_float_matmul_op<LCT, LhsCommonInner::value, RhsCommonInner::value>;
         } else {
             return my_matmul_op<LCT, RCT, OCT, LhsCommonInner::value, RhsCommonInner::value>;
         }
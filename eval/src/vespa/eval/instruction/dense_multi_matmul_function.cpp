@@ -1,9 +1,11 @@
 // Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_multi_matmul_function.h"
+#include "quantized_cells.h"
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/parallel_work.h>
 #include <cassert>
 #include <cblas.h>
 
@@ -17,54 +19,75 @@ using DimList = std::vector<Dim>;
 
 namespace {
 
-void my_cblas_double_multi_matmul_op(InterpretedFunction::State &state, uint64_t param) {
-    using CT = double;
-    const DenseMultiMatMulFunction &self = unwrap_param<DenseMultiMatMulFunction>(param);
-    size_t lhs_block_size = self.lhs_size() * self.common_size();
-    size_t rhs_block_size = self.rhs_size() * self.common_size();
-    size_t dst_block_size = self.lhs_size() * self.rhs_size();
-    size_t num_blocks = self.matmul_cnt();
-    const CT *lhs = state.peek(1).cells().typify<CT>().cbegin();
-    const CT *rhs = state.peek(0).cells().typify<CT>().cbegin();
-    auto dst_cells = state.stash.create_array<CT>(dst_block_size * num_blocks);
-    CT *dst = dst_cells.begin();
-    for (size_t i = 0; i < num_blocks; ++i, lhs += lhs_block_size, rhs += rhs_block_size, dst += dst_block_size) {
-        cblas_dgemm(CblasRowMajor, self.lhs_common_inner() ? CblasNoTrans : CblasTrans, self.rhs_common_inner() ? CblasTrans : CblasNoTrans,
-                    self.lhs_size(), self.rhs_size(), self.common_size(), 1.0,
-                    lhs, self.lhs_common_inner() ? self.common_size() : self.lhs_size(),
-                    rhs, self.rhs_common_inner() ? self.common_size() : self.rhs_size(),
-                    0.0, dst, self.rhs_size());
+// calculate some rows of a single matmul
+void my_cblas_matmul_rows(const DenseMultiMatMulFunction &self, const double *lhs, const double *rhs, double *dst, size_t num_rows) {
+    cblas_dgemm(CblasRowMajor, self.lhs_common_inner() ? CblasNoTrans : CblasTrans, self.rhs_common_inner() ? CblasTrans : CblasNoTrans,
+                num_rows, self.rhs_size(), self.common_size(), 1.0,
+                lhs, self.lhs_common_inner() ? self.common_size() : self.lhs_size(),
+                rhs, self.rhs_common_inner() ? self.common_size() : self.rhs_size(),
+                0.0, dst, self.rhs_size());
+}
+
+void my_cblas_matmul_rows(const DenseMultiMatMulFunction &self, const float *lhs, const float *rhs, float *dst, size_t num_rows) {
+    cblas_sgemm(CblasRowMajor, self.lhs_common_inner() ? CblasNoTrans : CblasTrans, self.rhs_common_inner() ? CblasTrans : CblasNoTrans,
+                num_rows, self.rhs_size(), self.common_size(), 1.0,
+                lhs, self.lhs_common_inner() ? self.common_size() : self.lhs_size(),
+                rhs, self.rhs_common_inner() ? self.common_size() : self.rhs_size(),
+                0.0, dst, self.rhs_size());
+}
+
+// quantized cells are converted to float before multiplying
+template <typename CT>
+auto my_input_cells(const Value &value, Stash &stash) {
+    if constexpr (std::is_same_v<CT,double>) {
+        return value.cells().typify<double>();
+    } else {
+        return quantized_cells::as_float<CT>(value, stash);
     }
-    state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type(), TypedCells(dst_cells)));
 }
 
-void my_cblas_float_multi_matmul_op(InterpretedFunction::State &state, uint64_t param) {
-    using CT = float;
+template <typename CT>
+void my_cblas_multi_matmul_op(InterpretedFunction::State &state, uint64_t param) {
+    using OCT = std::conditional_t<std::is_same_v<CT,double>, double, float>;
     const DenseMultiMatMulFunction &self = unwrap_param<DenseMultiMatMulFunction>(param);
     size_t lhs_block_size = self.lhs_size() * self.common_size();
     size_t rhs_block_size = self.rhs_size() * self.common_size();
     size_t dst_block_size = self.lhs_size() * self.rhs_size();
     size_t num_blocks = self.matmul_cnt();
-    const CT *lhs = state.peek(1).cells().typify<CT>().cbegin();
-    const CT *rhs = state.peek(0).cells().typify<CT>().cbegin();
-    auto dst_cells = state.stash.create_array<CT>(dst_block_size * num_blocks);
-    CT *dst = dst_cells.begin();
-    for (size_t i = 0; i < num_blocks; ++i, lhs += lhs_block_size, rhs += rhs_block_size, dst += dst_block_size) {
-        cblas_sgemm(CblasRowMajor, self.lhs_common_inner() ? CblasNoTrans : CblasTrans, self.rhs_common_inner() ? CblasTrans : CblasNoTrans,
-                    self.lhs_size(), self.rhs_size(), self.common_size(), 1.0,
-                    lhs, self.lhs_common_inner() ? self.common_size() : self.lhs_size(),
-                    rhs, self.rhs_common_inner() ? self.common_size() : self.rhs_size(),
-                    0.0, dst, self.rhs_size());
-    }
+    const OCT *lhs = my_input_cells<CT>(state.peek(1), state.stash).cbegin();
+    const OCT *rhs = my_input_cells<CT>(state.peek(0), state.stash).cbegin();
+    auto dst_cells = state.stash.create_array<OCT>(dst_block_size * num_blocks);
+    OCT *dst = dst_cells.begin();
+    // each unit of work is a single row in one of the matmuls
+    auto calc_rows = [&](size_t begin, size_t end) {
+        while (begin < end) {
+            size_t block = begin / self.lhs_size();
+            size_t row = begin % self.lhs_size();
+            size_t num_rows = std::min(end - begin, self.lhs_size() - row);
+            my_cblas_matmul_rows(self,
+                                 lhs + (block * lhs_block_size) + (row * (self.lhs_common_inner() ? self.common_size() : 1)),
+                                 rhs + (block * rhs_block_size),
+                                 dst + (block * dst_block_size) + (row * self.rhs_size()),
+                                 num_rows);
+            begin += num_rows;
+        }
+    };
+    ParallelWork::run(state.thread_bundle, num_blocks * self.lhs_size(), self.common_size() * self.rhs_size(), calc_rows);
     state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type(), TypedCells(dst_cells)));
 }
 
 InterpretedFunction::op_function my_select(CellType cell_type) {
     if (cell_type == CellType::DOUBLE) {
-        return my_cblas_double_multi_matmul_op;
+        return my_cblas_multi_matmul_op<double>;
     }
     if (cell_type == CellType::FLOAT) {
-        return my_cblas_float_multi_matmul_op;
+        return my_cblas_multi_matmul_op<float>;
+    }
+    if (cell_type == CellType::BFLOAT16) {
+        return my_cblas_multi_matmul_op<BFloat16>;
+    }
+    if (cell_type == CellType::INT8) {
+        return my_cblas_multi_matmul_op<Int8Float>;
     }
     abort();
 }
@@ -114,9 +137,7 @@ struct DimPrefix {
 };
 
 bool check_input_type(const ValueType &type, const DimList &relevant) {
-    return (type.is_dense() &&
-            (relevant.size() >= 2) &&
-            ((type.cell_type() == CellType::FLOAT) || (type.cell_type() == CellType::DOUBLE)));
+    return (type.is_dense() && (relevant.size() >= 2));
 }
 
 bool is_multi_matmul(const ValueType &a, const ValueType &b, const vespalib::string &reduce_dim) {
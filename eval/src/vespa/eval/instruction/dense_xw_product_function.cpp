@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_xw_product_function.h"
+#include "quantized_cells.h"
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
@@ -69,6 +70,31 @@ void my_cblas_float_xw_product_op(InterpretedFunction::State &state, uint64_t pa
     state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type, TypedCells(dst_cells)));
 }
 
+template <typename CT, bool common_inner>
+void my_quantized_xw_product_op(InterpretedFunction::State &state, uint64_t param) {
+    const DenseXWProductFunction::Self &self = unwrap_param<DenseXWProductFunction::Self>(param);
+    auto vector_cells = state.peek(1).cells().typify<CT>();
+    auto matrix_cells = state.peek(0).cells().typify<CT>();
+    auto dst_cells = state.stash.create_array<float>(self.result_size);
+    const CT *matrix = matrix_cells.cbegin();
+    if (common_inner) {
+        const auto &accel = hwaccelrated::IAccelrated::getAccelerator();
+        for (float &dst: dst_cells) {
+            dst = float(quantized_cells::dot_product(accel, vector_cells.cbegin(), matrix, self.vector_size));
+            matrix += self.vector_size;
+        }
+    } else {
+        // scale and add matrix rows to keep memory access sequential
+        for (const CT &vector_cell: vector_cells) {
+            float factor = vector_cell;
+            for (float &dst: dst_cells) {
+                dst += factor * float(*matrix++);
+            }
+        }
+    }
+    state.pop_pop_push(state.stash.create<DenseValueView>(self.result_type, TypedCells(dst_cells)));
+}
+
 bool isDenseTensor(const ValueType &type, size_t d) {
     return (type.is_dense() && (type.dimensions().size() == d));
 }
@@ -110,6 +136,9 @@ struct MyXWProductOp {
         } else if (std::is_same_v<LCT,float> && std::is_same_v<RCT,float>) {
             assert((std::is_same_v<OCT,float>));
             return my_cblas_float_xw_product_op<CommonInner::value>;
+        } else if constexpr (std::is_same_v<LCT,RCT> && quantized_cells::is_quantized<LCT>()) {
+            assert((std::is_same_v<OCT,float>));
+            return my_quantized_xw_product_op<LCT, CommonInner::value>;
         } else {
             return my_xw_product_op<LCT, RCT, OCT, CommonInner::value>;
         }
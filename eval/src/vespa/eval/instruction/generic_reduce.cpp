@@ -4,6 +4,7 @@
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/wrap_param.h>
 #include <vespa/eval/eval/array_array_map.h>
+#include <vespa/eval/eval/parallel_work.h>
 #include <vespa/vespalib/util/stash.h>
 #include <vespa/vespalib/util/typify.h>
 #include <vespa/vespalib/util/overload.h>
@@ -119,31 +120,42 @@ void my_generic_dense_reduce_op(State &state, uint64_t param_in) {
     size_t num_subspaces = index.size();
     size_t out_cells_size = forward_index ? (param.dense_plan.out_size * num_subspaces) : param.dense_plan.out_size;
     auto out_cells = state.stash.create_uninitialized_array<OCT>(out_cells_size);
-    if (num_subspaces > 0) {
+    // reduce subspaces [begin,end); with a forwarded index each
+    // subspace has its own output cells and may be reduced separately
+    auto reduce_subspaces = [&](size_t begin, size_t end) {
+        size_t out_begin = forward_index ? (begin * param.dense_plan.out_size) : 0;
+        size_t out_end = forward_index ? (end * param.dense_plan.out_size) : out_cells_size;
         if constexpr (aggr::is_simple(AGGR::enum_value())) {
-            OCT *dst = out_cells.begin();
-            std::fill(out_cells.begin(), out_cells.end(), AGGR::null_value());
+            OCT *dst = out_cells.begin() + out_begin;
+            std::fill(out_cells.begin() + out_begin, out_cells.begin() + out_end, AGGR::null_value());
             auto combine = [&](size_t src_idx, size_t dst_idx) { dst[dst_idx] = AGGR::combine(dst[dst_idx], cells[src_idx]); };
-            for (size_t i = 0; i < num_subspaces; ++i) {
+            for (size_t i = begin; i < end; ++i) {
                 param.dense_plan.execute(i * param.dense_plan.in_size, combine);
                 if (forward_index) {
                     dst += param.dense_plan.out_size;
                 }
             }
         } else {
-            std::vector<AGGR> aggr_state(out_cells_size);
+            std::vector<AGGR> aggr_state(out_end - out_begin);
             AGGR *dst = &aggr_state[0];
             auto sample = [&](size_t src_idx, size_t dst_idx) { dst[dst_idx].sample(cells[src_idx]); };
-            for (size_t i = 0; i < num_subspaces; ++i) {
+            for (size_t i = begin; i < end; ++i) {
                 param.dense_plan.execute(i * param.dense_plan.in_size, sample);
                 if (forward_index) {
                     dst += param.dense_plan.out_size;
                 }
             }
             for (size_t i = 0; i < aggr_state.size(); ++i) {
-                out_cells[i] = aggr_state[i].result();
+                out_cells[out_begin + i] = aggr_state[i].result();
             }
         }
+    };
+    if (num_subspaces > 0) {
+        if (forward_index) {
+            ParallelWork::run(state.thread_bundle, num_subspaces, param.dense_plan.in_size, reduce_subspaces);
+        } else {
+            reduce_subspaces(0, num_subspaces);
+        }
     } else if (!forward_index) {
         std::fill(out_cells.begin(), out_cells.end(), OCT{});
     }
@@ -0,0 +1,53 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/int8float.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <vespa/vespalib/util/bfloat16.h>
+#include <vespa/vespalib/util/stash.h>
+#include <type_traits>
+
+namespace vespalib::eval::quantized_cells {
+
+/**
+ * Utilities used by dense linear algebra instructions to handle
+ * quantized (int8 and bfloat16) cells. Dot products are calculated
+ * directly on the quantized cells using the accelerated kernels in
+ * vespalib::hwaccelrated, while inputs to BLAS routines are
+ * converted to float up front. Dot products are returned as double
+ * to keep int8 results exact also for large vectors; callers storing
+ * float cells convert the final result only.
+ **/
+
+template <typename CT>
+constexpr bool is_quantized() {
+    return (std::is_same_v<CT,Int8Float> || std::is_same_v<CT,BFloat16>);
+}
+
+inline double dot_product(const hwaccelrated::IAccelrated &accel, const Int8Float *lhs, const Int8Float *rhs, size_t size) {
+    static_assert(sizeof(Int8Float) == sizeof(int8_t));
+    return accel.dotProduct(reinterpret_cast<const int8_t *>(lhs), reinterpret_cast<const int8_t *>(rhs), size);
+}
+
+inline double dot_product(const hwaccelrated::IAccelrated &accel, const BFloat16 *lhs, const BFloat16 *rhs, size_t size) {
+    return accel.dotProduct(lhs, rhs, size);
+}
+
+// the cells of a dense value as float, converted into the stash unless already float
+template <typename CT>
+ConstArrayRef<float> as_float(const Value &value, Stash &stash) {
+    auto cells = value.cells().typify<CT>();
+    if constexpr (std::is_same_v<CT,float>) {
+        return cells;
+    } else {
+        ArrayRef<float> dst = stash.create_uninitialized_array<float>(cells.size());
+        for (size_t i = 0; i < cells.size(); ++i) {
+            dst[i] = cells[i];
+        }
+        return dst;
+    }
+}
+
+}
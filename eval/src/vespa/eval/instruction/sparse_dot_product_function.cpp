@@ -35,7 +35,7 @@ double my_sparse_dot_product_fallback(const Value::Index &lhs_idx, const Value::
     return result;
 }
 
-template <typename CT, bool single_dim>
+template <typename CT>
 double my_fast_sparse_dot_product(const FastAddrMap *small_map, const FastAddrMap *big_map,
                                   const CT *small_cells, const CT *big_cells)
 {
@@ -44,44 +44,32 @@ double my_fast_sparse_dot_product(const FastAddrMap *small_map, const FastAddrMa
         std::swap(small_map, big_map);
         std::swap(small_cells, big_cells);
     }
-    if constexpr (single_dim) {
-        const auto &labels = small_map->labels();
-        for (size_t i = 0; i < labels.size(); ++i) {
-            auto big_subspace = big_map->lookup_singledim(labels[i]);
-            if (big_subspace != FastAddrMap::npos()) {
-                result += (small_cells[i] * big_cells[big_subspace]);
-            }
-        }
-    } else {
-        small_map->each_map_entry([&](auto small_subspace, auto hash) {
-                    auto small_addr = small_map->get_addr(small_subspace);
-                    auto big_subspace = big_map->lookup(small_addr, hash);
-                    if (big_subspace != FastAddrMap::npos()) {
-                        result += (small_cells[small_subspace] * big_cells[big_subspace]);
-                    }
-                });
-    }
+    big_map->lookup_each(*small_map, [&](auto small_subspace, auto, auto big_subspace) {
+                if (big_subspace != FastAddrMap::npos()) {
+                    result += (small_cells[small_subspace] * big_cells[big_subspace]);
+                }
+            });
     return result;
 }
 
-template <typename CT, bool single_dim>
+template <typename CT>
 void my_sparse_dot_product_op(InterpretedFunction::State &state, uint64_t num_mapped_dims) {
     const auto &lhs_idx = state.peek(1).index();
     const auto &rhs_idx = state.peek(0).index();
     const CT *lhs_cells = state.peek(1).cells().typify<CT>().cbegin();
     const CT *rhs_cells = state.peek(0).cells().typify<CT>().cbegin();
     double result = __builtin_expect(are_fast(lhs_idx, rhs_idx), true)
-                    ? my_fast_sparse_dot_product<CT,single_dim>(&as_fast(lhs_idx).map, &as_fast(rhs_idx).map, lhs_cells, rhs_cells)
+                    ? my_fast_sparse_dot_product<CT>(&as_fast(lhs_idx).map, &as_fast(rhs_idx).map, lhs_cells, rhs_cells)
                     : my_sparse_dot_product_fallback<CT>(lhs_idx, rhs_idx, lhs_cells, rhs_cells, num_mapped_dims);
     state.pop_pop_push(state.stash.create<DoubleValue>(result));
 }
 
 struct MyGetFun {
-    template <typename CT, typename SINGLE_DIM>
-    static auto invoke() { return my_sparse_dot_product_op<CT,SINGLE_DIM::value>; }
+    template <typename CT>
+    static auto invoke() { return my_sparse_dot_product_op<CT>; }
 };
 
-using MyTypify = TypifyValue<TypifyCellType,TypifyBool>;
+using MyTypify = TypifyValue<TypifyCellType>;
 
 } // namespace <unnamed>
 
@@ -95,8 +83,7 @@ InterpretedFunction::Instruction
 SparseDotProductFunction::compile_self(const ValueBuilderFactory &, Stash &) const
 {
     size_t num_dims = lhs().result_type().count_mapped_dimensions();
-    auto op = typify_invoke<2,MyTypify,MyGetFun>(lhs().result_type().cell_type(),
-                                                 (num_dims == 1));
+    auto op = typify_invoke<1,MyTypify,MyGetFun>(lhs().result_type().cell_type());
     return InterpretedFunction::Instruction(op, num_dims);
 }
 
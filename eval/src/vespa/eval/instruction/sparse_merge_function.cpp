@@ -22,46 +22,28 @@ const Value& my_fast_sparse_merge(const FastAddrMap &a_map, const FastAddrMap &b
     Fun fun(params.function);
     size_t guess_size = a_map.size() + b_map.size();
     auto &result = stash.create<FastValue<CT,true>>(params.res_type, params.num_mapped_dimensions, 1u, guess_size);
-    if constexpr (single_dim) {
-        string_id cur_label;
-        ConstArrayRef<string_id> addr(&cur_label, 1);
-        const auto &a_labels = a_map.labels();
-        for (size_t i = 0; i < a_labels.size(); ++i) {
-            cur_label = a_labels[i];
-            result.add_mapping(addr, cur_label.hash());
-            result.my_cells.push_back_fast(a_cells[i]);
+    // result subspaces start out as a copy of the subspaces in a
+    for (size_t i = 0; i < a_map.size(); ++i) {
+        if constexpr (single_dim) {
+            result.add_singledim_mapping(a_map.labels()[i]);
+        } else {
+            result.add_mapping(a_map.get_addr(i));
         }
-        const auto &b_labels = b_map.labels();
-        for (size_t i = 0; i < b_labels.size(); ++i) {
-            cur_label = b_labels[i];
-            auto result_subspace = result.my_index.map.lookup_singledim(cur_label);
-            if (result_subspace == FastAddrMap::npos()) {
-                result.add_mapping(addr, cur_label.hash());
-                result.my_cells.push_back_fast(b_cells[i]);
-            } else {
-                CT *out_cell = result.my_cells.get(result_subspace);
-                out_cell[0] = fun(out_cell[0], b_cells[i]);
-            }
-        }
-    } else {
-        a_map.each_map_entry([&](auto lhs_subspace, auto hash)
-        {
-            result.add_mapping(a_map.get_addr(lhs_subspace), hash);
-            result.my_cells.push_back_fast(a_cells[lhs_subspace]);
-        });
-        b_map.each_map_entry([&](auto rhs_subspace, auto hash)
-        {
-            auto rhs_addr = b_map.get_addr(rhs_subspace);
-            auto result_subspace = result.my_index.map.lookup(rhs_addr, hash);
-            if (result_subspace == FastAddrMap::npos()) {
-                result.add_mapping(rhs_addr, hash);
-                result.my_cells.push_back_fast(b_cells[rhs_subspace]);
-            } else {
-                CT *out_cell = result.my_cells.get(result_subspace);
-                out_cell[0] = fun(out_cell[0], b_cells[rhs_subspace]);
-            }
-        });
+        result.my_cells.push_back_fast(a_cells[i]);
     }
+    a_map.lookup_each(b_map, [&](auto b_subspace, auto hash, auto a_subspace) {
+                if (a_subspace == FastAddrMap::npos()) {
+                    if constexpr (single_dim) {
+                        result.add_singledim_mapping(b_map.labels()[b_subspace]);
+                    } else {
+                        result.add_mapping(b_map.get_addr(b_subspace), hash);
+                    }
+                    result.my_cells.push_back_fast(b_cells[b_subspace]);
+                } else {
+                    CT *out_cell = result.my_cells.get(a_subspace);
+                    out_cell[0] = fun(out_cell[0], b_cells[b_subspace]);
+                }
+            });
     return result;
 }
 
@@ -219,6 +219,22 @@ std::vector<int64_t> extract_sizes(const ValueType &type) {
     return sizes;
 }
 
+bool has_symbol(const Onnx::TensorInfo &info, const vespalib::string &symbol, size_t first_dim) {
+    for (size_t i = first_dim; i < info.dimensions.size(); ++i) {
+        if (info.dimensions[i].name == symbol) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ValueType make_batch_type(const ValueType &type, size_t batch_size) {
+    auto dimensions = type.dimensions();
+    assert(!dimensions.empty() && (dimensions[0].size == 1));
+    dimensions[0].size = batch_size;
+    return ValueType::make_type(type.cell_type(), std::move(dimensions));
+}
+
 }
 
 vespalib::string
@@ -349,6 +365,64 @@ Onnx::WirePlanner::get_wire_info(const Onnx &model) const
 
 //-----------------------------------------------------------------------------
 
+Onnx::BatchPlanner::BatchPlanner(const Onnx &model, const WireInfo &wire_info)
+    : _wire_info(wire_info),
+      _batched_inputs(model.inputs().size(), false),
+      _can_batch(false)
+{
+    vespalib::string symbol;
+    for (size_t i = 0; i < model.inputs().size(); ++i) {
+        const auto &dim = model.inputs()[i].dimensions[0];
+        if (dim.is_symbolic() && (wire_info.vespa_inputs[i].dimensions()[0].size == 1)) {
+            if (symbol.empty()) {
+                symbol = dim.name;
+            }
+            _batched_inputs[i] = (dim.name == symbol);
+        }
+    }
+    if (symbol.empty() || model.outputs().empty()) {
+        return;
+    }
+    for (const auto &input: model.inputs()) {
+        if (has_symbol(input, symbol, 1)) {
+            return;
+        }
+    }
+    for (const auto &output: model.outputs()) {
+        if ((output.dimensions[0].name != symbol) || has_symbol(output, symbol, 1)) {
+            return;
+        }
+    }
+    for (const auto &type: wire_info.vespa_outputs) {
+        if (type.dimensions()[0].size != 1) {
+            return;
+        }
+    }
+    _can_batch = true;
+}
+
+Onnx::BatchPlanner::~BatchPlanner() = default;
+
+Onnx::WireInfo
+Onnx::BatchPlanner::get_wire_info(size_t batch_size) const
+{
+    assert(_can_batch);
+    WireInfo info(_wire_info);
+    for (size_t i = 0; i < info.vespa_inputs.size(); ++i) {
+        if (_batched_inputs[i]) {
+            info.vespa_inputs[i] = make_batch_type(info.vespa_inputs[i], batch_size);
+            info.onnx_inputs[i].dimensions[0] = batch_size;
+        }
+    }
+    for (size_t i = 0; i < info.vespa_outputs.size(); ++i) {
+        info.vespa_outputs[i] = make_batch_type(info.vespa_outputs[i], batch_size);
+        info.onnx_outputs[i].dimensions[0] = batch_size;
+    }
+    return info;
+}
+
+//-----------------------------------------------------------------------------
+
 Ort::AllocatorWithDefaultOptions Onnx::EvalContext::_alloc;
 
 template <typename T>
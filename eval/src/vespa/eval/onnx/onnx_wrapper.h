@@ -93,6 +93,25 @@ public:
         WireInfo get_wire_info(const Onnx &model) const;
     };
 
+    // planning how to evaluate multiple documents in a single model
+    // run. Inputs whose outermost dimension is symbolic and bound to
+    // size 1 are stacked along that dimension; the symbol is the
+    // batch dimension. All outputs must also have the batch dimension
+    // as their outermost dimension, while inputs without it are
+    // shared by all documents in the batch.
+    class BatchPlanner {
+    private:
+        const WireInfo   &_wire_info;
+        std::vector<bool> _batched_inputs;
+        bool              _can_batch;
+    public:
+        BatchPlanner(const Onnx &model, const WireInfo &wire_info);
+        ~BatchPlanner();
+        bool can_batch() const { return _can_batch; }
+        bool is_batched_input(size_t i) const { return _batched_inputs[i]; }
+        WireInfo get_wire_info(size_t batch_size) const;
+    };
+
     // evaluation context; use one per thread and keep model/wire_info alive
     // all parameter values are expected to be bound per evaluation
     // output values are pre-allocated and will not change
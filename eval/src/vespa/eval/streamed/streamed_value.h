@@ -14,7 +14,8 @@ namespace vespalib::eval {
  *  A very simple Value implementation.
  *  Cheap to construct from serialized data,
  *  and cheap to serialize or iterate through.
- *  Slow for full or partial lookups.
+ *  Slow for partial lookups; full lookups use a hash map
+ *  that is built the first time it is needed.
  **/
 template <typename T>
 class StreamedValue : public Value
@@ -2,6 +2,7 @@
 
 #include "streamed_value_index.h"
 #include "streamed_value_utils.h"
+#include <vespa/eval/eval/fast_addr_map.h>
 
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/stringfmt.h>
@@ -85,11 +86,64 @@ struct StreamedIterationView : Value::Index::View
     }
 };
 
+struct StreamedLookupView : Value::Index::View
+{
+    const FastAddrMap &map;
+    size_t subspace;
+
+    StreamedLookupView(const FastAddrMap &map_in)
+      : map(map_in), subspace(FastAddrMap::npos())
+    {}
+
+    void lookup(ConstArrayRef<const string_id*> addr) override {
+        subspace = map.lookup(addr);
+    }
+
+    bool next_result(ConstArrayRef<string_id*>, size_t &idx_out) override {
+        if (subspace == FastAddrMap::npos()) {
+            return false;
+        }
+        idx_out = subspace;
+        subspace = FastAddrMap::npos();
+        return true;
+    }
+};
+
 } // namespace <unnamed>
 
+StreamedValueIndex::StreamedValueIndex(uint32_t num_mapped_dims, uint32_t num_subspaces, const std::vector<string_id> &labels_ref)
+    : _num_mapped_dims(num_mapped_dims),
+      _num_subspaces(num_subspaces),
+      _labels_ref(labels_ref),
+      _lookup_map_once(),
+      _lookup_map()
+{
+}
+
+StreamedValueIndex::~StreamedValueIndex() = default;
+
+const FastAddrMap &
+StreamedValueIndex::lookup_map() const
+{
+    std::call_once(_lookup_map_once, [this]()
+                   {
+                       assert(_labels_ref.size() == size_t(_num_mapped_dims) * _num_subspaces);
+                       auto map = std::make_unique<FastAddrMap>(_num_mapped_dims, _labels_ref, _num_subspaces);
+                       for (size_t i = 0; i < _num_subspaces; ++i) {
+                           ConstArrayRef<string_id> addr(&_labels_ref[i * _num_mapped_dims], _num_mapped_dims);
+                           map->add_mapping(FastAddrMap::hash_labels(addr));
+                       }
+                       _lookup_map = std::move(map);
+                   });
+    return *_lookup_map;
+}
+
 std::unique_ptr<Value::Index::View>
 StreamedValueIndex::create_view(ConstArrayRef<size_t> dims) const
 {
+    if (!dims.empty() && (dims.size() == _num_mapped_dims)) {
+        return std::make_unique<StreamedLookupView>(lookup_map());
+    }
     LabelBlockStream label_stream(_num_subspaces, _labels_ref, _num_mapped_dims);
     if (dims.empty()) {
         return std::make_unique<StreamedIterationView>(std::move(label_stream));
@@ -4,12 +4,18 @@
 
 #include <vespa/eval/eval/value.h>
 #include <vespa/vespalib/util/shared_string_repo.h>
+#include <memory>
+#include <mutex>
 
 namespace vespalib::eval {
 
+class FastAddrMap;
+
  /**
   *  Implements Value::Index by reading a stream of serialized
-  *  labels.
+  *  labels. Iteration and partial lookups scan the labels
+  *  directly. A hash map over the labels is built the first time
+  *  full addresses are looked up, and is kept for later lookups.
   **/
 class StreamedValueIndex : public Value::Index
 {
@@ -17,13 +23,14 @@ private:
     uint32_t _num_mapped_dims;
     uint32_t _num_subspaces;
     const std::vector<string_id> &_labels_ref;
+    mutable std::once_flag _lookup_map_once;
+    mutable std::unique_ptr<FastAddrMap> _lookup_map;
+
+    const FastAddrMap &lookup_map() const;
 
 public:
-    StreamedValueIndex(uint32_t num_mapped_dims, uint32_t num_subspaces, const std::vector<string_id> &labels_ref)
-        : _num_mapped_dims(num_mapped_dims),
-          _num_subspaces(num_subspaces),
-          _labels_ref(labels_ref)
-    {}
+    StreamedValueIndex(uint32_t num_mapped_dims, uint32_t num_subspaces, const std::vector<string_id> &labels_ref);
+    ~StreamedValueIndex() override;
 
     // index API:
     size_t size() const override { return _num_subspaces; }
@@ -21,7 +21,8 @@ Config::Config() noexcept :
     _predicateParams(),
     _tensorType(vespalib::eval::ValueType::error_type()),
     _distance_metric(DistanceMetric::Euclidean),
-    _hnsw_index_params()
+    _hnsw_index_params(),
+    _mmap_policy()
 {
 }
 
@@ -42,7 +43,8 @@ Config::Config(BasicType bt, CollectionType ct, bool fastSearch_, bool huge_) no
       _predicateParams(),
       _tensorType(vespalib::eval::ValueType::error_type()),
       _distance_metric(DistanceMetric::Euclidean),
-      _hnsw_index_params()
+      _hnsw_index_params(),
+      _mmap_policy()
 {
 }
 
@@ -72,7 +74,14 @@ Config::operator==(const Config &b) const
            (_basicType.type() != BasicType::Type::TENSOR ||
             _tensorType == b._tensorType) &&
             _distance_metric == b._distance_metric &&
-            _hnsw_index_params == b._hnsw_index_params;
+            _hnsw_index_params == b._hnsw_index_params &&
+            _mmap_policy == b._mmap_policy;
+}
+
+const vespalib::alloc::MemoryAllocator *
+Config::get_memory_allocator() const
+{
+    return vespalib::alloc::MmapPolicyAllocator::get_allocator(_mmap_policy);
 }
 
 }
@@ -10,6 +10,7 @@
 #include <vespa/searchcommon/common/growstrategy.h>
 #include <vespa/searchcommon/common/dictionary_config.h>
 #include <vespa/eval/eval/value_type.h>
+#include <vespa/vespalib/util/mmap_policy_allocator.h>
 #include <cassert>
 #include <optional>
 
@@ -70,6 +71,12 @@ public:
     const CompactionStrategy &getCompactionStrategy() const { return _compactionStrategy; }
     const DictionaryConfig & get_dictionary_config() const { return _dictionary; }
     Match get_match() const { return _match; }
+    const vespalib::alloc::MmapPolicy & get_mmap_policy() const { return _mmap_policy; }
+    /**
+     * Memory allocator for large per document data, according to the
+     * mmap policy. Returns nullptr when the default allocator should be used.
+     */
+    const vespalib::alloc::MemoryAllocator * get_memory_allocator() const;
     Config & setHuge(bool v)                         { _huge = v; return *this;}
     Config & setFastSearch(bool v)                   { _fastSearch = v; return *this; }
     Config & setPredicateParams(const PredicateParams &v) { _predicateParams = v; return *this; }
@@ -124,6 +131,7 @@ public:
     }
     Config & set_dictionary_config(const DictionaryConfig & cfg) { _dictionary = cfg; return *this; }
     Config & set_match(Match match) { _match = match; return *this; }
+    Config & set_mmap_policy(const vespalib::alloc::MmapPolicy & policy) { _mmap_policy = policy; return *this; }
     bool operator!=(const Config &b) const { return !(operator==(b)); }
     bool operator==(const Config &b) const;
 
@@ -145,6 +153,7 @@ private:
     vespalib::eval::ValueType      _tensorType;
     DistanceMetric                 _distance_metric;
     std::optional<HnswIndexParams> _hnsw_index_params;
+    vespalib::alloc::MmapPolicy    _mmap_policy;
 };
 
 }
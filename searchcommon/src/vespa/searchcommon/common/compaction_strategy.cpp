@@ -8,6 +8,7 @@ std::ostream& operator<<(std::ostream& os, const CompactionStrategy& compaction_
 {
     os << "{maxDeadBytesRatio=" << compaction_strategy.getMaxDeadBytesRatio() <<
         ", maxDeadAddressSpaceRatio=" << compaction_strategy.getMaxDeadAddressSpaceRatio() <<
+        ", maxCompactEntriesPerSlice=" << compaction_strategy.getMaxCompactEntriesPerSlice() <<
         "}";
     return os;
 }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
 
 namespace search {
@@ -14,22 +15,33 @@ class CompactionStrategy
 private:
     double _maxDeadBytesRatio; // Max ratio of dead bytes before compaction
     double _maxDeadAddressSpaceRatio; // Max ratio of dead address space before compaction
+    uint32_t _maxCompactEntriesPerSlice; // Max entries to move per compaction slice (0 means compact all at once)
 public:
     CompactionStrategy() noexcept
         : _maxDeadBytesRatio(0.05),
-          _maxDeadAddressSpaceRatio(0.2)
+          _maxDeadAddressSpaceRatio(0.2),
+          _maxCompactEntriesPerSlice(0)
     {
     }
     CompactionStrategy(double maxDeadBytesRatio, double maxDeadAddressSpaceRatio) noexcept
         : _maxDeadBytesRatio(maxDeadBytesRatio),
-          _maxDeadAddressSpaceRatio(maxDeadAddressSpaceRatio)
+          _maxDeadAddressSpaceRatio(maxDeadAddressSpaceRatio),
+          _maxCompactEntriesPerSlice(0)
+    {
+    }
+    CompactionStrategy(double maxDeadBytesRatio, double maxDeadAddressSpaceRatio, uint32_t maxCompactEntriesPerSlice) noexcept
+        : _maxDeadBytesRatio(maxDeadBytesRatio),
+          _maxDeadAddressSpaceRatio(maxDeadAddressSpaceRatio),
+          _maxCompactEntriesPerSlice(maxCompactEntriesPerSlice)
     {
     }
     double getMaxDeadBytesRatio() const { return _maxDeadBytesRatio; }
     double getMaxDeadAddressSpaceRatio() const { return _maxDeadAddressSpaceRatio; }
+    uint32_t getMaxCompactEntriesPerSlice() const { return _maxCompactEntriesPerSlice; }
     bool operator==(const CompactionStrategy & rhs) const {
         return _maxDeadBytesRatio == rhs._maxDeadBytesRatio &&
-            _maxDeadAddressSpaceRatio == rhs._maxDeadAddressSpaceRatio;
+            _maxDeadAddressSpaceRatio == rhs._maxDeadAddressSpaceRatio &&
+            _maxCompactEntriesPerSlice == rhs._maxCompactEntriesPerSlice;
     }
     bool operator!=(const CompactionStrategy & rhs) const { return !(operator==(rhs)); }
 
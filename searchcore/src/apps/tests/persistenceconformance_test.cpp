@@ -7,6 +7,8 @@
 #include <vespa/config-rank-profiles.h>
 #include <vespa/config-summarymap.h>
 #include <vespa/document/base/testdocman.h>
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
 #include <vespa/fastos/file.h>
 #include <vespa/persistence/conformancetest/conformancetest.h>
 #include <vespa/persistence/dummyimpl/dummy_bucket_executor.h>
@@ -170,6 +172,7 @@ private:
     vespalib::string          _tlsSpec;
     matching::QueryLimiter    _queryLimiter;
     vespalib::Clock           _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
     mutable DummyWireService  _metricsWireService;
     mutable MemoryConfigStores _config_stores;
     vespalib::ThreadStackExecutor _summaryExecutor;
@@ -199,7 +202,8 @@ public:
                                                   tuneFileDocDB, HwInfo());
         mgr.forwardConfig(b);
         mgr.nextGeneration(0ms);
-        return DocumentDB::create(_baseDir, mgr.getConfig(), _tlsSpec, _queryLimiter, _clock, docType, bucketSpace,
+        return DocumentDB::create(_baseDir, mgr.getConfig(), _tlsSpec, _queryLimiter, _clock, _constantValueFactory,
+                                  docType, bucketSpace,
                                   *b->getProtonConfigSP(), const_cast<DocumentDBFactory &>(*this),
                                   _summaryExecutor, _summaryExecutor, _bucketExecutor, _tls, _metricsWireService,
                                   _fileHeaderContext, _config_stores.getConfigStore(docType.toString()),
@@ -215,6 +219,7 @@ DocumentDBFactory::DocumentDBFactory(const vespalib::string &baseDir, int tlsLis
       _tlsSpec(vespalib::make_string("tcp/localhost:%d", tlsListenPort)),
       _queryLimiter(),
       _clock(),
+      _constantValueFactory(vespalib::eval::FastValueBuilderFactory::get()),
       _metricsWireService(),
       _summaryExecutor(8, 128_Ki),
       _bucketExecutor(2)
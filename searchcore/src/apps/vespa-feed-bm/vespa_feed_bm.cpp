@@ -33,6 +33,8 @@
 #include <vespa/document/test/make_bucket_space.h>
 #include <vespa/document/update/assignvalueupdate.h>
 #include <vespa/document/update/documentupdate.h>
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
 #include <vespa/fastos/app.h>
 #include <vespa/messagebus/config-messagebus.h>
 #include <vespa/messagebus/testlib/slobrok.h>
@@ -656,6 +658,7 @@ struct PersistenceProviderFixture {
     vespalib::string                           _tls_spec;
     matching::QueryLimiter                     _query_limiter;
     vespalib::Clock                            _clock;
+    vespalib::eval::ConstantTensorLoader       _constant_value_factory;
     DummyWireService                           _metrics_wire_service;
     MemoryConfigStores                         _config_stores;
     vespalib::ThreadStackExecutor              _summary_executor;
@@ -726,6 +729,7 @@ PersistenceProviderFixture::PersistenceProviderFixture(const BMParams& params)
       _tls_spec(vespalib::make_string("tcp/localhost:%d", _tls_listen_port)),
       _query_limiter(),
       _clock(),
+      _constant_value_factory(vespalib::eval::FastValueBuilderFactory::get()),
       _metrics_wire_service(),
       _config_stores(),
       _summary_executor(8, 128_Ki),
@@ -803,7 +807,8 @@ PersistenceProviderFixture::create_document_db(const BMParams & params)
                                                               tuneFileDocDB, HwInfo());
     mgr.forwardConfig(bootstrap_config);
     mgr.nextGeneration(0ms);
-    _document_db = DocumentDB::create(_base_dir, mgr.getConfig(), _tls_spec, _query_limiter, _clock, _doc_type_name,
+    _document_db = DocumentDB::create(_base_dir, mgr.getConfig(), _tls_spec, _query_limiter, _clock,
+                                      _constant_value_factory, _doc_type_name,
                                       _bucket_space, *bootstrap_config->getProtonConfigSP(), _document_db_owner,
                                       _summary_executor, _summary_executor, *_persistence_engine, _tls,
                                       _metrics_wire_service, _file_header_context,
@@ -2,10 +2,12 @@
 
 #include <tests/proton/common/dummydbowner.h>
 #include <vespa/config/helper/configgetter.hpp>
+#include <vespa/eval/eval/fast_value.h>
 #include <vespa/eval/eval/simple_value.h>
 #include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/test/value_compare.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/test/make_bucket_space.h>
 #include <vespa/searchcore/proton/attribute/attribute_writer.h>
@@ -179,6 +181,7 @@ public:
     bool _mkdirOk;
     matching::QueryLimiter _queryLimiter;
     vespalib::Clock _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
     DummyWireService _dummy;
     config::DirSpec _spec;
     DocumentDBConfigHelper _configMgr;
@@ -199,6 +202,7 @@ public:
           _mkdirOk(FastOS_File::MakeDirectory("tmpdb")),
           _queryLimiter(),
           _clock(),
+          _constantValueFactory(vespalib::eval::FastValueBuilderFactory::get()),
           _dummy(),
           _spec(TEST_PATH("")),
           _configMgr(_spec, getDocTypeName()),
@@ -222,6 +226,7 @@ public:
             LOG_ABORT("should not be reached");
         }
         _ddb = DocumentDB::create("tmpdb", _configMgr.getConfig(), "tcp/localhost:9013", _queryLimiter, _clock,
+                                  _constantValueFactory,
                                   DocTypeName(docTypeName), makeBucketSpace(), *b->getProtonConfigSP(), *this,
                                   _summaryExecutor, _summaryExecutor, _bucketExecutor, _tls, _dummy, _fileHeaderContext,
                                   std::make_unique<MemoryConfigStore>(),
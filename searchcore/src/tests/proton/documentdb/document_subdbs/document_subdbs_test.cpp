@@ -27,6 +27,8 @@
 #include <vespa/searchcore/proton/test/test.h>
 #include <vespa/searchcore/proton/test/thread_utils.h>
 #include <vespa/vespalib/util/idestructorcallback.h>
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
 #include <vespa/searchlib/index/docbuilder.h>
 #include <vespa/searchlib/test/directory_handler.h>
 #include <vespa/vespalib/test/insertion_operators.h>
@@ -215,6 +217,7 @@ struct MySearchableContext
     MyFastAccessContext _fastUpdCtx;
     QueryLimiter _queryLimiter;
     vespalib::Clock _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
     SearchableContext _ctx;
     MySearchableContext(IThreadingService &writeService,
                         std::shared_ptr<bucketdb::BucketDBOwner> bucketDB,
@@ -234,8 +237,9 @@ MySearchableContext::MySearchableContext(IThreadingService &writeService,
                                          IBucketDBHandlerInitializer & bucketDBHandlerInitializer)
     : _fastUpdCtx(writeService, bucketDB, bucketDBHandlerInitializer),
       _queryLimiter(), _clock(),
-      _ctx(_fastUpdCtx._ctx, _queryLimiter,
-           _clock, dynamic_cast<vespalib::SyncableThreadExecutor &>(writeService.shared()))
+      _constantValueFactory(vespalib::eval::FastValueBuilderFactory::get()),
+      _ctx(_fastUpdCtx._ctx, _queryLimiter, _clock, _constantValueFactory,
+           dynamic_cast<vespalib::SyncableThreadExecutor &>(writeService.shared()))
 {}
 MySearchableContext::~MySearchableContext() = default;
 
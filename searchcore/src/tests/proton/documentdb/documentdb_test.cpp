@@ -3,6 +3,8 @@
 #include <tests/proton/common/dummydbowner.h>
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
 #include <vespa/fastos/file.h>
 #include <vespa/document/test/make_bucket_space.h>
 #include <vespa/searchcore/proton/attribute/flushableattribute.h>
@@ -78,6 +80,7 @@ struct Fixture {
     TransLogServer _tls;
     matching::QueryLimiter _queryLimiter;
     vespalib::Clock _clock;
+    vespalib::eval::ConstantTensorLoader _constantValueFactory;
 
     Fixture();
     ~Fixture();
@@ -93,7 +96,8 @@ Fixture::Fixture()
       _fileHeaderContext(),
       _tls("tmp", 9014, ".", _fileHeaderContext),
       _queryLimiter(),
-      _clock()
+      _clock(),
+      _constantValueFactory(vespalib::eval::FastValueBuilderFactory::get())
 {
     auto documenttypesConfig = std::make_shared<DocumenttypesConfig>();
     DocumentType docType("typea", 0);
@@ -108,8 +112,8 @@ Fixture::Fixture()
                               tuneFileDocumentDB, HwInfo());
     mgr.forwardConfig(b);
     mgr.nextGeneration(0ms);
-    _db = DocumentDB::create(".", mgr.getConfig(), "tcp/localhost:9014", _queryLimiter, _clock, DocTypeName("typea"),
-                             makeBucketSpace(),
+    _db = DocumentDB::create(".", mgr.getConfig(), "tcp/localhost:9014", _queryLimiter, _clock, _constantValueFactory,
+                             DocTypeName("typea"), makeBucketSpace(),
                              *b->getProtonConfigSP(), _myDBOwner, _summaryExecutor, _summaryExecutor, _bucketExecutor, _tls, _dummy,
                              _fileHeaderContext, std::make_unique<MemoryConfigStore>(),
                              std::make_shared<vespalib::ThreadStackExecutor>(16, 128_Ki), _hwInfo);
@@ -28,7 +28,9 @@
 #include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/searchlib/query/tree/querybuilder.h>
 #include <vespa/searchlib/query/tree/stackdumpcreator.h>
+#include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/searchlib/queryeval/isourceselector.h>
+#include <vespa/searchlib/queryeval/leaf_blueprints.h>
 #include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <vespa/searchcore/proton/matching/match_params.h>
 #include <vespa/searchcore/proton/matching/match_tools.h>
@@ -37,6 +39,7 @@
 #include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/eval/value_codec.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/stash.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP("matching_test");
@@ -947,4 +950,81 @@ TEST("require that docsum matcher can extract matching elements from single attr
     EXPECT_EQUAL(list[1], 3u);
 }
 
+using Log = std::vector<vespalib::string>;
+
+// lives in the arena bound when it was created; logs when the arena goes away
+struct ArenaSentinel {
+    Log &log;
+    vespalib::string name;
+    ArenaSentinel(Log &log_in, const vespalib::string &name_in) : log(log_in), name(name_in) {}
+    ~ArenaSentinel() { log.push_back(name + " arena destroyed"); }
+};
+
+void add_arena_sentinel(Log &log, const vespalib::string &name) {
+    vespalib::Stash *arena = vespalib::StashScope::current();
+    if (arena == nullptr) {
+        log.push_back(name + " without arena");
+    } else {
+        arena->create<ArenaSentinel>(log, name);
+    }
+}
+
+struct TrackedIterator : EmptySearch {
+    Log &log;
+    TrackedIterator(Log &log_in) : log(log_in) { add_arena_sentinel(log, "iterator"); }
+    ~TrackedIterator() override { log.push_back("iterator destroyed"); }
+};
+
+struct TrackedBlueprint : SimpleLeafBlueprint {
+    Log &log;
+    TrackedBlueprint(Log &log_in, const FieldSpec &field) : SimpleLeafBlueprint(field), log(log_in) {
+        setEstimate(HitEstimate(10, false));
+        add_arena_sentinel(log, "blueprint");
+    }
+    ~TrackedBlueprint() override { log.push_back("blueprint destroyed"); }
+    SearchIterator::UP createLeafSearch(const TermFieldMatchDataArray &, bool) const override {
+        return std::make_unique<TrackedIterator>(log);
+    }
+};
+
+struct TrackedSearchable : Searchable {
+    Log &log;
+    TrackedSearchable(Log &log_in) : log(log_in) {}
+    using Searchable::createBlueprint;
+    search::queryeval::Blueprint::UP createBlueprint(const IRequestContext &, const FieldSpec &field, const Node &) override {
+        return std::make_unique<TrackedBlueprint>(log, field);
+    }
+};
+
+struct TrackedSearchContext : proton::matching::ISearchContext {
+    proton::matching::ISearchContext &inner;
+    TrackedSearchable attributes;
+    TrackedSearchContext(proton::matching::ISearchContext &inner_in, Log &log) : inner(inner_in), attributes(log) {}
+    IndexSearchable &getIndexes() override { return inner.getIndexes(); }
+    Searchable &getAttributes() override { return attributes; }
+    uint32_t getDocIdLimit() override { return inner.getDocIdLimit(); }
+};
+
+TEST("require that blueprints and iterators live in arenas destroyed after them") {
+    MyWorld world;
+    world.basicSetup();
+    Log log;
+    TrackedSearchContext search_context(world.searchContext, log);
+    Matcher::SP matcher = world.createMatcher();
+    SearchRequest::SP request = world.createSimpleRequest("a1", "tracked");
+    Properties overrides;
+    auto mtf = matcher->create_match_tools_factory(*request, search_context, world.attributeContext,
+                                                   world.metaStore, overrides, true);
+    ASSERT_TRUE(mtf->valid());
+    auto match_tools = mtf->createMatchTools();
+    match_tools->setup_first_phase();
+    EXPECT_TRUE(log.empty());
+    // iterators live in the arena of the match tools, not the one of the factory
+    match_tools.reset();
+    EXPECT_TRUE((log == Log{"iterator destroyed", "iterator arena destroyed"}));
+    mtf.reset();
+    EXPECT_TRUE((log == Log{"iterator destroyed", "iterator arena destroyed",
+                            "blueprint destroyed", "blueprint arena destroyed"}));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,11 +8,15 @@
 #include <vespa/searchcore/proton/server/feedstates.h>
 #include <vespa/searchcore/proton/server/ireplayconfig.h>
 #include <vespa/searchcore/proton/server/memoryconfigstore.h>
+#include <vespa/searchcore/proton/feedoperation/newconfigoperation.h>
 #include <vespa/searchcore/proton/feedoperation/removeoperation.h>
 #include <vespa/searchcore/proton/test/dummy_feed_view.h>
 #include <vespa/searchlib/common/serialnum.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/foreground_thread_executor.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/buffer.h>
 #include <vespa/searchcore/proton/bucketdb/bucketdbhandler.h>
@@ -30,27 +34,42 @@ using storage::spi::Timestamp;
 using vespalib::ConstBufferRef;
 using vespalib::nbostream;
 using vespalib::ForegroundThreadExecutor;
+using vespalib::ThreadStackExecutor;
 using namespace proton;
 
 namespace {
 
+// Serial numbers of replayed operations, in the order they were applied
+using ReplayLog = std::vector<SerialNum>;
+
 struct MyFeedView : public test::DummyFeedView {
     TestDocRepo repo;
     std::shared_ptr<const DocumentTypeRepo> repo_sp;
     int remove_handled;
+    ReplayLog *replay_log;
 
-    MyFeedView();
+    MyFeedView(ReplayLog &log);
     ~MyFeedView() override;
 
     const std::shared_ptr<const DocumentTypeRepo> &getDocumentTypeRepo() const override { return repo_sp; }
-    void handleRemove(FeedToken , const RemoveOperation &) override { ++remove_handled; }
+    void handleRemove(FeedToken , const RemoveOperation &op) override {
+        ++remove_handled;
+        replay_log->push_back(op.getSerialNum());
+    }
 };
 
-MyFeedView::MyFeedView() : repo_sp(repo.getTypeRepoSp()), remove_handled(0) {}
+MyFeedView::MyFeedView(ReplayLog &log) : repo_sp(repo.getTypeRepoSp()), remove_handled(0), replay_log(&log) {}
 MyFeedView::~MyFeedView() = default;
 
 struct MyReplayConfig : IReplayConfig {
-    void replayConfig(SerialNum) override {}
+    ReplayLog &replay_log;
+    explicit MyReplayConfig(ReplayLog &log) : replay_log(log) {}
+    void replayConfig(SerialNum serial_num) override { replay_log.push_back(serial_num); }
+};
+
+struct MyConfigStore : MemoryConfigStore {
+    void serializeConfig(SerialNum, nbostream &) override {}
+    void deserializeConfig(SerialNum, nbostream &) override {}
 };
 
 struct MyIncSerialNum : IIncSerialNum {
@@ -64,14 +83,16 @@ struct MyIncSerialNum : IIncSerialNum {
 
 struct Fixture
 {
+    ReplayLog replay_log;
     MyFeedView feed_view1;
     MyFeedView feed_view2;
     IFeedView *feed_view_ptr;
     MyReplayConfig replay_config;
-    MemoryConfigStore config_store;
+    MyConfigStore config_store;
     bucketdb::BucketDBOwner _bucketDB;
     bucketdb::BucketDBHandler _bucketDBHandler;
     MyIncSerialNum _inc_serial_num;
+    ThreadStackExecutor deserialize_executor;
     ReplayTransactionLogState state;
 
     Fixture();
@@ -79,15 +100,18 @@ struct Fixture
 };
 
 Fixture::Fixture()
-    : feed_view1(),
-      feed_view2(),
+    : replay_log(),
+      feed_view1(replay_log),
+      feed_view2(replay_log),
       feed_view_ptr(&feed_view1),
-      replay_config(),
+      replay_config(replay_log),
       config_store(),
       _bucketDB(),
       _bucketDBHandler(_bucketDB),
       _inc_serial_num(9u),
-      state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store, _inc_serial_num)
+      deserialize_executor(4, 128_Ki),
+      state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store, _inc_serial_num,
+            deserialize_executor)
 {
 }
 Fixture::~Fixture() = default;
@@ -114,6 +138,45 @@ RemoveOperationContext::RemoveOperationContext(search::SerialNum serial)
     packet->add(Packet::Entry(serial, FeedOperation::REMOVE, buf));
 }
 RemoveOperationContext::~RemoveOperationContext() = default;
+
+/**
+ * Builds a packet with one entry per character in the layout string;
+ * 'r' is a remove, 'c' is a new config and 'x' is a remove that cannot
+ * be deserialized. Serial numbers start at 10.
+ */
+std::unique_ptr<Packet>
+make_packet(const vespalib::string &layout, MyConfigStore &config_store)
+{
+    auto packet = std::make_unique<Packet>(0xf000);
+    DocumentId doc_id("id:ns:doctypename::bar");
+    for (size_t i = 0; i < layout.size(); ++i) {
+        SerialNum serial = 10 + i;
+        nbostream str;
+        if (layout[i] == 'c') {
+            NewConfigOperation op(serial, config_store);
+            op.serialize(str);
+            packet->add(Packet::Entry(serial, FeedOperation::NEW_CONFIG, ConstBufferRef(str.data(), str.wp())));
+        } else {
+            RemoveOperationWithDocId op(BucketFactory::getBucketId(doc_id), Timestamp(10), doc_id);
+            op.serialize(str);
+            // a truncated entry fails already when reading the bucket id
+            size_t size = (layout[i] == 'x') ? 4 : str.wp();
+            packet->add(Packet::Entry(serial, FeedOperation::REMOVE, ConstBufferRef(str.data(), size)));
+        }
+    }
+    return packet;
+}
+
+ReplayLog
+expected_log(SerialNum first, SerialNum last)
+{
+    ReplayLog log;
+    for (SerialNum serial = first; serial <= last; ++serial) {
+        log.push_back(serial);
+    }
+    return log;
+}
+
 TEST_F("require that active FeedView can change during replay", Fixture)
 {
     ForegroundThreadExecutor executor;
@@ -149,6 +212,43 @@ TEST_F("require that replay progress is tracked", Fixture)
     EXPECT_EQUAL(0.5, progress.getProgress());
 }
 
+TEST_F("require that entries beyond the deserialize window are replayed in order", Fixture)
+{
+    auto packet = make_packet(vespalib::string(50, 'r'), f.config_store);
+    auto wrap = std::make_shared<PacketWrapper>(*packet, nullptr);
+    ForegroundThreadExecutor executor;
+
+    f.state.receive(wrap, executor);
+    EXPECT_EQUAL(50, f.feed_view1.remove_handled);
+    EXPECT_TRUE(expected_log(10, 59) == f.replay_log);
+}
+
+TEST_F("require that an entry failing to deserialize is redone in order", Fixture)
+{
+    vespalib::string layout(40, 'r');
+    layout[25] = 'x';
+    auto packet = make_packet(layout, f.config_store);
+    auto wrap = std::make_shared<PacketWrapper>(*packet, nullptr);
+    ForegroundThreadExecutor executor;
+
+    EXPECT_EXCEPTION(f.state.receive(wrap, executor), vespalib::Exception, "");
+    EXPECT_EQUAL(25, f.feed_view1.remove_handled);
+    EXPECT_TRUE(expected_log(10, 34) == f.replay_log);
+}
+
+TEST_F("require that packets with new config are replayed serially and in order", Fixture)
+{
+    vespalib::string layout(40, 'r');
+    layout[20] = 'c';
+    auto packet = make_packet(layout, f.config_store);
+    auto wrap = std::make_shared<PacketWrapper>(*packet, nullptr);
+    ForegroundThreadExecutor executor;
+
+    f.state.receive(wrap, executor);
+    EXPECT_EQUAL(39, f.feed_view1.remove_handled);
+    EXPECT_TRUE(expected_log(10, 49) == f.replay_log);
+}
+
 }  // namespace
 
 TEST_MAIN() { TEST_RUN_ALL(); }
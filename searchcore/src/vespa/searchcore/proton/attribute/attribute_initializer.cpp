@@ -194,6 +194,7 @@ AttributeInitializer::loadAttribute(const AttributeVectorSP &attr,
     assert(attr->hasLoadData());
     vespalib::Timer timer;
     EventLogger::loadAttributeStart(_documentSubDbName, attr->getName());
+    attr->set_load_mapped(_tuneFileLoad.getWantMemoryMap());
     if (!attr->load()) {
         LOG(warning, "Could not load attribute vector '%s' from disk. Returning empty attribute vector",
             attr->getBaseFileName().c_str());
@@ -235,12 +236,14 @@ AttributeInitializer::AttributeInitializer(const std::shared_ptr<AttributeDirect
                                            const vespalib::string &documentSubDbName,
                                            const AttributeSpec &spec,
                                            uint64_t currentSerialNum,
-                                           const IAttributeFactory &factory)
+                                           const IAttributeFactory &factory,
+                                           const search::TuneFileAttributeLoad &tuneFileLoad)
     : _attrDir(attrDir),
       _documentSubDbName(documentSubDbName),
       _spec(spec),
       _currentSerialNum(currentSerialNum),
       _factory(factory),
+      _tuneFileLoad(tuneFileLoad),
       _header(),
       _header_ok(false)
 {
@@ -6,6 +6,7 @@
 #include "attribute_initializer_result.h"
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/searchlib/common/serialnum.h>
+#include <vespa/searchlib/common/tunefileinfo.h>
 
 namespace search::attribute { class AttributeHeader; }
 
@@ -29,6 +30,7 @@ private:
     const AttributeSpec             _spec;
     const uint64_t                  _currentSerialNum;
     const IAttributeFactory        &_factory;
+    const search::TuneFileAttributeLoad _tuneFileLoad;
     std::unique_ptr<const search::attribute::AttributeHeader> _header;
     bool                            _header_ok;
 
@@ -45,7 +47,8 @@ private:
 
 public:
     AttributeInitializer(const std::shared_ptr<AttributeDirectory> &attrDir, const vespalib::string &documentSubDbName,
-                         const AttributeSpec &spec, uint64_t currentSerialNum, const IAttributeFactory &factory);
+                         const AttributeSpec &spec, uint64_t currentSerialNum, const IAttributeFactory &factory,
+                         const search::TuneFileAttributeLoad &tuneFileLoad = search::TuneFileAttributeLoad());
     ~AttributeInitializer();
 
     AttributeInitializerResult init() const;
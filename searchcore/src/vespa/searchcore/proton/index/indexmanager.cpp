@@ -28,8 +28,10 @@ namespace proton::index {
 IndexManager::MaintainerOperations::MaintainerOperations(const FileHeaderContext &fileHeaderContext,
                                                          const TuneFileIndexManager &tuneFileIndexManager,
                                                          size_t cacheSize,
+                                                         bool hashDictionary,
                                                          IThreadingService &threadingService)
     : _cacheSize(cacheSize),
+      _hashDictionary(hashDictionary),
       _fileHeaderContext(fileHeaderContext),
       _tuneFileIndexing(tuneFileIndexManager._indexing),
       _tuneFileSearch(tuneFileIndexManager._search),
@@ -43,7 +45,7 @@ IndexManager::MaintainerOperations::createMemoryIndex(const Schema& schema,
                                                       SerialNum serialNum)
 {
     return std::make_shared<MemoryIndexWrapper>(schema, inspector, _fileHeaderContext, _tuneFileIndexing,
-                                                _threadingService, serialNum);
+                                                _threadingService, serialNum, _hashDictionary);
 }
 
 IDiskIndex::SP
@@ -84,7 +86,8 @@ IndexManager::IndexManager(const vespalib::string &baseDir,
                            const search::TuneFileIndexManager &tuneFileIndexManager,
                            const search::TuneFileAttributes &tuneFileAttributes,
                            const FileHeaderContext &fileHeaderContext) :
-    _operations(fileHeaderContext, tuneFileIndexManager, indexConfig.cacheSize, threadingService),
+    _operations(fileHeaderContext, tuneFileIndexManager, indexConfig.cacheSize, indexConfig.hashDictionary,
+                threadingService),
     _maintainer(IndexMaintainerConfig(baseDir, indexConfig.warmup, indexConfig.maxFlushed, schema, serialNum, tuneFileAttributes),
                 IndexMaintainerContext(threadingService, reconfigurer, fileHeaderContext, warmupExecutor),
                 _operations)
@@ -13,14 +13,19 @@ struct IndexConfig {
     using WarmupConfig = searchcorespi::index::WarmupConfig;
     IndexConfig() : IndexConfig(WarmupConfig(), 2, 0) { }
     IndexConfig(WarmupConfig warmup_, size_t maxFlushed_, size_t cacheSize_)
+        : IndexConfig(warmup_, maxFlushed_, cacheSize_, false)
+    { }
+    IndexConfig(WarmupConfig warmup_, size_t maxFlushed_, size_t cacheSize_, bool hashDictionary_)
         : warmup(warmup_),
           maxFlushed(maxFlushed_),
-          cacheSize(cacheSize_)
+          cacheSize(cacheSize_),
+          hashDictionary(hashDictionary_)
     { }
 
     const WarmupConfig warmup;
     const size_t       maxFlushed;
     const size_t       cacheSize;
+    const bool         hashDictionary;
 };
 
 /**
@@ -37,6 +42,7 @@ public:
         using IDiskIndex = searchcorespi::index::IDiskIndex;
         using IMemoryIndex = searchcorespi::index::IMemoryIndex;
         const size_t _cacheSize;
+        const bool _hashDictionary;
         const search::common::FileHeaderContext &_fileHeaderContext;
         const search::TuneFileIndexing _tuneFileIndexing;
         const search::TuneFileSearch _tuneFileSearch;
@@ -46,6 +52,7 @@ public:
         MaintainerOperations(const search::common::FileHeaderContext &fileHeaderContext,
                              const search::TuneFileIndexManager &tuneFileIndexManager,
                              size_t cacheSize,
+                             bool hashDictionary,
                              searchcorespi::index::IThreadingService &threadingService);
 
         IMemoryIndex::SP createMemoryIndex(const Schema& schema,
@@ -23,8 +23,19 @@ MemoryIndexWrapper::MemoryIndexWrapper(const search::index::Schema& schema,
                                        const TuneFileIndexing& tuneFileIndexing,
                                        searchcorespi::index::IThreadingService& threadingService,
                                        search::SerialNum serialNum)
+    : MemoryIndexWrapper(schema, inspector, fileHeaderContext, tuneFileIndexing, threadingService, serialNum, false)
+{
+}
+
+MemoryIndexWrapper::MemoryIndexWrapper(const search::index::Schema& schema,
+                                       const search::index::IFieldLengthInspector& inspector,
+                                       const search::common::FileHeaderContext& fileHeaderContext,
+                                       const TuneFileIndexing& tuneFileIndexing,
+                                       searchcorespi::index::IThreadingService& threadingService,
+                                       search::SerialNum serialNum,
+                                       bool hashDictionary)
     : _index(schema, inspector, threadingService.indexFieldInverter(),
-             threadingService.indexFieldWriter()),
+             threadingService.indexFieldWriter(), hashDictionary),
       _serialNum(serialNum),
       _fileHeaderContext(fileHeaderContext),
       _tuneFileIndexing(tuneFileIndexing)
@@ -30,6 +30,13 @@ public:
                        const search::TuneFileIndexing& tuneFileIndexing,
                        searchcorespi::index::IThreadingService& threadingService,
                        SerialNum serialNum);
+    MemoryIndexWrapper(const search::index::Schema& schema,
+                       const search::index::IFieldLengthInspector& inspector,
+                       const search::common::FileHeaderContext& fileHeaderContext,
+                       const search::TuneFileIndexing& tuneFileIndexing,
+                       searchcorespi::index::IThreadingService& threadingService,
+                       SerialNum serialNum,
+                       bool hashDictionary);
 
     /**
      * Implements searchcorespi::IndexSearchable
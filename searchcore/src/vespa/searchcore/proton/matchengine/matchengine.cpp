@@ -6,6 +6,8 @@
 #include <vespa/vespalib/data/smart_buffer.h>
 #include <vespa/vespalib/data/slime/binary_format.h>
 #include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/work_stealing_executor.h>
 
 #include <vespa/log/log.h>
 
@@ -35,19 +37,27 @@ public:
 
 VESPA_THREAD_STACK_TAG(match_engine_executor)
 
+std::unique_ptr<vespalib::SyncableThreadExecutor>
+make_executor(size_t numThreads, bool workStealing) {
+    if (workStealing) {
+        return std::make_unique<vespalib::WorkStealingExecutor>(numThreads, 256_Ki, match_engine_executor);
+    }
+    return std::make_unique<vespalib::ThreadStackExecutor>(numThreads, 256_Ki, match_engine_executor);
+}
+
 } // namespace anon
 
 namespace proton {
 
 using namespace vespalib::slime;
 
-MatchEngine::MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async)
+MatchEngine::MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async, bool workStealing)
     : _lock(),
       _distributionKey(distributionKey),
       _async(async),
       _closed(false),
       _handlers(),
-      _executor(std::max(size_t(1), numThreads / threadsPerSearch), 256_Ki, match_engine_executor),
+      _executor(make_executor(std::max(size_t(1), numThreads / threadsPerSearch), workStealing)),
       _threadBundlePool(std::max(size_t(1), threadsPerSearch)),
       _nodeUp(false)
 {
@@ -55,7 +65,7 @@ MatchEngine::MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t di
 
 MatchEngine::~MatchEngine()
 {
-    _executor.shutdown().sync();
+    _executor->shutdown().sync();
 }
 
 void
@@ -68,7 +78,7 @@ MatchEngine::close()
     }
 
     LOG(debug, "Handshaking with task manager.");
-    _executor.sync();
+    _executor->sync();
 }
 
 ISearchHandler::SP
@@ -106,7 +116,7 @@ MatchEngine::search(search::engine::SearchRequest::Source request,
         return ret;
     }
     if (_async) {
-        _executor.execute(std::make_unique<SearchTask>(*this, std::move(request), client));
+        _executor->execute(std::make_unique<SearchTask>(*this, std::move(request), client));
         return search::engine::SearchReply::UP();
     }
     return performSearch(std::move(request));
@@ -7,7 +7,7 @@
 #include <vespa/searchcore/proton/common/statusreport.h>
 #include <vespa/searchlib/engine/searchapi.h>
 #include <vespa/vespalib/net/state_explorer.h>
-#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/threadexecutor.h>
 #include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <mutex>
 
@@ -22,7 +22,7 @@ private:
     bool                               _async;
     bool                               _closed;
     HandlerMap<ISearchHandler>         _handlers;
-    vespalib::ThreadStackExecutor      _executor;
+    std::unique_ptr<vespalib::SyncableThreadExecutor> _executor;
     vespalib::SimpleThreadBundle::Pool _threadBundlePool;
     bool                               _nodeUp;
 
@@ -45,8 +45,9 @@ public:
      * @param threadsPerSearch number of threads used for each search
      * @param distributionKey distributionkey of this node.
      * @param async if query is dispatched to threadpool
+     * @param workStealing use a work stealing executor for the threadpool
      */
-    MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async);
+    MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async, bool workStealing = false);
     MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey)
         : MatchEngine(numThreads, threadsPerSearch, distributionKey, true)
     {}
@@ -62,12 +63,12 @@ public:
      *
      * @return executor stats
      **/
-    vespalib::ThreadStackExecutor::Stats getExecutorStats() { return _executor.getStats(); }
+    vespalib::ExecutorStats getExecutorStats() { return _executor->getStats(); }
 
     /**
      * Returns the underlying executor. Only used for state explorers.
      */
-    const vespalib::SyncableThreadExecutor& get_executor() const { return _executor; }
+    const vespalib::SyncableThreadExecutor& get_executor() const { return *_executor; }
 
     /**
      * Closes the request handler interface. This will prevent any more data
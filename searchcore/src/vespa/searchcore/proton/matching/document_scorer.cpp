@@ -26,16 +26,39 @@ extractScoreFeature(const RankProgram &rankProgram)
 
 DocumentScorer::DocumentScorer(RankProgram &rankProgram,
                                SearchIterator &searchItr)
-    : _searchItr(searchItr),
+    : _rankProgram(rankProgram),
+      _searchItr(searchItr),
       _scoreFeature(extractScoreFeature(rankProgram))
 {
 }
 
+void
+DocumentScorer::score_batch(TaggedHits::iterator begin, TaggedHits::iterator end)
+{
+    for (auto hit = begin; hit != end; ++hit) {
+        _searchItr.unpack(hit->first.first);
+        _rankProgram.add_to_batch(hit->first.first);
+    }
+    _rankProgram.evaluate_batch();
+    // rewind the search iterator to unpack the same documents again
+    _searchItr.initRange(begin->first.first, _searchItr.getEndId());
+    for (auto hit = begin; hit != end; ++hit) {
+        hit->first.second = doScore(hit->first.first);
+    }
+}
+
 void
 DocumentScorer::score(TaggedHits &hits)
 {
     auto sort_on_docid = [](const TaggedHit &a, const TaggedHit &b){ return (a.first.first < b.first.first); };
     std::sort(hits.begin(), hits.end(), sort_on_docid);
+    if (_rankProgram.has_batch_executors() && (hits.size() > 1)) {
+        for (size_t offset = 0; offset < hits.size(); offset += max_batch_size) {
+            size_t batch_end = std::min(offset + max_batch_size, hits.size());
+            score_batch(hits.begin() + offset, hits.begin() + batch_end);
+        }
+        return;
+    }
     for (auto &hit: hits) {
         hit.first.second = doScore(hit.first.first);
     }
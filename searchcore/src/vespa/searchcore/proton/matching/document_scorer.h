@@ -12,18 +12,28 @@ namespace proton::matching {
  * Class used to calculate the rank score for a set of documents using
  * a rank program for calculation and a search iterator for unpacking
  * match data. The doScore function must be called with increasing
- * docid.
+ * docid. If the rank program contains executors able to evaluate
+ * multiple documents at once (like onnx models with a batch
+ * dimension), the score function will first collect the inputs of
+ * (up to max_batch_size) hits, evaluate them together and then
+ * calculate the rank score of each hit.
  */
 class DocumentScorer
 {
 private:
+    search::fef::RankProgram &_rankProgram;
     search::queryeval::SearchIterator &_searchItr;
     search::fef::LazyValue _scoreFeature;
 
 public:
     using TaggedHit = IMatchLoopCommunicator::TaggedHit;
     using TaggedHits = IMatchLoopCommunicator::TaggedHits;
+    static constexpr size_t max_batch_size = 256;
 
+private:
+    void score_batch(TaggedHits::iterator begin, TaggedHits::iterator end);
+
+public:
     DocumentScorer(search::fef::RankProgram &rankProgram,
                    search::queryeval::SearchIterator &searchItr);
 
@@ -11,6 +11,7 @@
 #include <vespa/searchlib/attribute/attribute_operation.h>
 #include <vespa/searchlib/attribute/attribute_blueprint_params.h>
 #include <vespa/searchlib/common/bitvector.h>
+#include <vespa/vespalib/util/size_literals.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.matching.match_tools");
@@ -27,6 +28,7 @@ using namespace search::fef::indexproperties::matchphase;
 using namespace search::fef::indexproperties::matching;
 using namespace search::fef::indexproperties;
 using search::IDocumentMetaStore;
+using vespalib::StashScope;
 
 namespace proton::matching {
 
@@ -72,6 +74,8 @@ extractAttributeBlueprintParams(const RankSetup& rank_setup, const Properties &r
     return AttributeBlueprintParams(NearestNeighborBruteForceLimit::lookup(rankProperties, rank_setup.get_nearest_neighbor_brute_force_limit()));
 }
 
+constexpr size_t arena_chunk_size = 16_Ki;
+
 } // namespace proton::matching::<unnamed>
 
 void
@@ -105,7 +109,8 @@ MatchTools::MatchTools(QueryLimiter & queryLimiter,
                        const MatchDataLayout & mdl,
                        const RankSetup & rankSetup,
                        const Properties & featureOverrides)
-    : _queryLimiter(queryLimiter),
+    : _arena(arena_chunk_size),
+      _queryLimiter(queryLimiter),
       _doom(doom),
       _query(query),
       _match_limiter(match_limiter_in),
@@ -130,6 +135,7 @@ MatchTools::has_second_phase_rank() const {
 void
 MatchTools::setup_first_phase()
 {
+    StashScope arena_scope(_arena);
     setup(_rankSetup.create_first_phase_program(),
           TermwiseLimit::lookup(_queryEnv.getProperties(), _rankSetup.get_termwise_limit()));
 }
@@ -137,18 +143,21 @@ MatchTools::setup_first_phase()
 void
 MatchTools::setup_second_phase()
 {
+    StashScope arena_scope(_arena);
     setup(_rankSetup.create_second_phase_program());
 }
 
 void
 MatchTools::setup_summary()
 {
+    StashScope arena_scope(_arena);
     setup(_rankSetup.create_summary_program());
 }
 
 void
 MatchTools::setup_dump()
 {
+    StashScope arena_scope(_arena);
     setup(_rankSetup.create_dump_program());
 }
 
@@ -169,7 +178,8 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
                   const Properties           & rankProperties,
                   const Properties           & featureOverrides,
                   bool                         is_search)
-    : _queryLimiter(queryLimiter),
+    : _arena(arena_chunk_size),
+      _queryLimiter(queryLimiter),
       _requestContext(doom, attributeContext, rankProperties, extractAttributeBlueprintParams(rankSetup, rankProperties)),
       _query(),
       _match_limiter(),
@@ -180,6 +190,8 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
       _diversityParams(),
       _valid(false)
 {
+    // Blueprints created while building and preparing the query live as long as this factory
+    StashScope arena_scope(_arena);
     trace.addEvent(4, "MTF: Start");
     _query.setWhiteListBlueprint(metaStore.createWhiteListBlueprint());
     trace.addEvent(5, "MTF: Build query");
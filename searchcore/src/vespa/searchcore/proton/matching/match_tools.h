@@ -16,6 +16,7 @@
 #include <vespa/searchlib/queryeval/idiversifier.h>
 #include <vespa/vespalib/util/doom.h>
 #include <vespa/vespalib/util/clock.h>
+#include <vespa/vespalib/util/stash.h>
 
 namespace search::engine { class Trace; }
 
@@ -29,6 +30,9 @@ class MatchTools
 {
 private:
     using IRequestContext = search::queryeval::IRequestContext;
+    // Arena for the search iterators and rank programs of this match
+    // thread. Declared first to be destructed last.
+    vespalib::Stash                        _arena;
     QueryLimiter                          &_queryLimiter;
     const vespalib::Doom                  &_doom;
     const Query                           &_query;
@@ -90,6 +94,9 @@ class MatchToolsFactory
 {
 private:
     using IAttributeFunctor = search::attribute::IAttributeFunctor;
+    // Arena for the blueprints of the query. Declared first to be
+    // destructed last.
+    vespalib::Stash                   _arena;
     QueryLimiter                    & _queryLimiter;
     RequestContext                    _requestContext;
     Query                             _query;
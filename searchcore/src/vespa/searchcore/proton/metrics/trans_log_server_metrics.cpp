@@ -13,7 +13,10 @@ TransLogServerMetrics::DomainMetrics::DomainMetrics(metrics::MetricSet *parent,
             "Transaction log metrics for a document type", parent),
       entries("entries", {}, "The current number of entries in the transaction log", this),
       diskUsage("disk_usage", {}, "The disk usage (in bytes) of the transaction log", this),
-      replayTime("replay_time", {}, "The replay time (in seconds) of the transaction log during start-up", this)
+      replayTime("replay_time", {}, "The replay time (in seconds) of the transaction log during start-up", this),
+      commitBatchSize("commit.batch_size", {}, "The average number of commits written and synced together", this),
+      syncLatency("commit.sync_latency", {}, "The average latency (in seconds) of syncing the transaction log", this),
+      lastCommitStats()
 {
 }
 
@@ -25,6 +28,17 @@ TransLogServerMetrics::DomainMetrics::update(const DomainInfo &stats)
     entries.set(stats.numEntries);
     diskUsage.set(stats.byteSize);
     replayTime.set(stats.maxSessionRunTime.count());
+    const auto &commitStats = stats.commitStats;
+    size_t numBatches = commitStats.numBatches - lastCommitStats.numBatches;
+    if (numBatches > 0) {
+        size_t numChunks = commitStats.numChunks - lastCommitStats.numChunks;
+        commitBatchSize.set(double(numChunks) / numBatches);
+    }
+    size_t numSyncs = commitStats.numSyncs - lastCommitStats.numSyncs;
+    if (numSyncs > 0) {
+        syncLatency.set((commitStats.syncTime - lastCommitStats.syncTime).count() / numSyncs);
+    }
+    lastCommitStats = commitStats;
 }
 
 void
@@ -19,6 +19,9 @@ public:
         metrics::LongValueMetric entries;
         metrics::LongValueMetric diskUsage;
         metrics::DoubleValueMetric replayTime;
+        metrics::DoubleValueMetric commitBatchSize;
+        metrics::DoubleValueMetric syncLatency;
+        search::transactionlog::CommitStats lastCommitStats;
 
         typedef std::unique_ptr<DomainMetrics> UP;
         DomainMetrics(metrics::MetricSet *parent, const vespalib::string &documentType);
@@ -84,6 +84,7 @@ BootstrapConfigManager::update(const ConfigSnapshot & snapshot)
         tune._index._indexing._write.setFromConfig<ProtonConfig::Indexing::Write>(conf.indexing.write.io);
         tune._index._indexing._read.setFromConfig<ProtonConfig::Indexing::Read>(conf.indexing.read.io);
         tune._attr._write.setFromConfig<ProtonConfig::Attribute::Write>(conf.attribute.write.io);
+        tune._attr._load.setFromConfig<ProtonConfig::Attribute::Read>(conf.attribute.read.io);
         tune._index._search._read.setWantMemoryMap();
         tune._index._search._read.setFromMmapConfig<ProtonConfig::Search::Mmap>(conf.search.mmap);
         tune._summary._write.setFromConfig<ProtonConfig::Summary::Write>(conf.summary.write.io);
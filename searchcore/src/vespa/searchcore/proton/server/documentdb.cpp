@@ -72,7 +72,8 @@ constexpr uint32_t indexing_thread_stack_size = 128_Ki;
 
 index::IndexConfig
 makeIndexConfig(const ProtonConfig::Index & cfg) {
-    return index::IndexConfig(WarmupConfig(vespalib::from_s(cfg.warmup.time), cfg.warmup.unpack), cfg.maxflushed, cfg.cache.size);
+    return index::IndexConfig(WarmupConfig(vespalib::from_s(cfg.warmup.time), cfg.warmup.unpack), cfg.maxflushed, cfg.cache.size,
+                              cfg.memoryindex.hashdictionary);
 }
 
 class MetricsUpdateHook : public metrics::UpdateHook {
@@ -116,6 +117,7 @@ DocumentDB::create(const vespalib::string &baseDir,
                    const vespalib::string &tlsSpec,
                    matching::QueryLimiter &queryLimiter,
                    const vespalib::Clock &clock,
+                   const vespalib::eval::ConstantValueFactory &constantValueFactory,
                    const DocTypeName &docTypeName,
                    document::BucketSpace bucketSpace,
                    const ProtonConfig &protonCfg,
@@ -131,15 +133,17 @@ DocumentDB::create(const vespalib::string &baseDir,
                    const HwInfo &hwInfo)
 {
     return DocumentDB::SP(
-            new DocumentDB(baseDir, std::move(currentSnapshot), tlsSpec, queryLimiter, clock, docTypeName, bucketSpace,
-                           protonCfg, owner, warmupExecutor, sharedExecutor, bucketExecutor, tlsWriterFactory,
-                           metricsWireService, fileHeaderContext, std::move(config_store), initializeThreads, hwInfo));
+            new DocumentDB(baseDir, std::move(currentSnapshot), tlsSpec, queryLimiter, clock, constantValueFactory,
+                           docTypeName, bucketSpace, protonCfg, owner, warmupExecutor, sharedExecutor, bucketExecutor,
+                           tlsWriterFactory, metricsWireService, fileHeaderContext, std::move(config_store),
+                           initializeThreads, hwInfo));
 }
 DocumentDB::DocumentDB(const vespalib::string &baseDir,
                        DocumentDBConfig::SP configSnapshot,
                        const vespalib::string &tlsSpec,
                        matching::QueryLimiter &queryLimiter,
                        const vespalib::Clock &clock,
+                       const vespalib::eval::ConstantValueFactory &constantValueFactory,
                        const DocTypeName &docTypeName,
                        document::BucketSpace bucketSpace,
                        const ProtonConfig &protonCfg,
@@ -195,7 +199,7 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
       _transient_usage_provider(std::make_shared<DocumentDBResourceUsageProvider>(*this)),
       _feedHandler(std::make_unique<FeedHandler>(_writeService, tlsSpec, docTypeName, *this, _writeFilter, *this, tlsWriterFactory)),
       _subDBs(*this, *this, *_feedHandler, _docTypeName, _writeService, warmupExecutor, fileHeaderContext,
-              metricsWireService, getMetrics(), queryLimiter, clock, _configMutex, _baseDir,
+              metricsWireService, getMetrics(), queryLimiter, clock, constantValueFactory, _configMutex, _baseDir,
               DocumentSubDBCollection::Config(protonCfg.numsearcherthreads),
               hwInfo),
       _maintenanceController(_writeService.master(), sharedExecutor, _refCount, _docTypeName),
@@ -44,6 +44,7 @@ namespace metrics {
     class MetricLockGuard;
 }
 namespace storage::spi { struct BucketExecutor; }
+namespace vespalib::eval { struct ConstantValueFactory; }
 
 namespace proton {
 class AttributeConfigInspector;
@@ -210,6 +211,7 @@ private:
                const vespalib::string &tlsSpec,
                matching::QueryLimiter &queryLimiter,
                const vespalib::Clock &clock,
+               const vespalib::eval::ConstantValueFactory &constantValueFactory,
                const DocTypeName &docTypeName,
                document::BucketSpace bucketSpace,
                const ProtonConfig &protonCfg,
@@ -231,6 +233,7 @@ public:
      *
      * @param baseDir The base directory to use for persistent data.
      * @param tlsSpec The frt connection spec for the TLS.
+     * @param constantValueFactory Used to load ranking constants, shared among document databases.
      * @param docType The document type that this database will handle.
      * @param docMgrSP  The document manager holding the document type.
      * @param protonCfg The global proton config this database is a part of.
@@ -242,6 +245,7 @@ public:
            const vespalib::string &tlsSpec,
            matching::QueryLimiter &queryLimiter,
            const vespalib::Clock &clock,
+           const vespalib::eval::ConstantValueFactory &constantValueFactory,
            const DocTypeName &docTypeName,
            document::BucketSpace bucketSpace,
            const ProtonConfig &protonCfg,
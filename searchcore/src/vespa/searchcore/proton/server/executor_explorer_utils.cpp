@@ -3,10 +3,12 @@
 #include "executor_explorer_utils.h"
 #include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
+#include <vespa/vespalib/util/lockfree_single_executor.h>
 #include <vespa/vespalib/util/singleexecutor.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 
 using vespalib::BlockingThreadStackExecutor;
+using vespalib::LockFreeSingleExecutor;
 using vespalib::SingleExecutor;
 using vespalib::ThreadExecutor;
 using vespalib::ThreadStackExecutor;
@@ -43,6 +45,8 @@ convert_executor_to_slime(const ThreadExecutor* executor, Cursor& object)
     }
     if (const auto* single = dynamic_cast<const SingleExecutor*>(executor)) {
         convert_single_executor_to_slime(*single, object);
+    } else if (const auto* lockfree = dynamic_cast<const LockFreeSingleExecutor*>(executor)) {
+        convert_syncable_executor_to_slime(*lockfree, "LockFreeSingleExecutor", object);
     } else if (const auto* blocking = dynamic_cast<const BlockingThreadStackExecutor*>(executor)) {
         convert_syncable_executor_to_slime(*blocking, "BlockingThreadStackExecutor", object);
     } else if (const auto* thread = dynamic_cast<const ThreadStackExecutor*>(executor)) {
@@ -5,11 +5,13 @@
 #include <vespa/searchcore/proton/metrics/executor_threading_service_stats.h>
 #include <vespa/vespalib/util/sequencedtaskexecutor.h>
 #include <vespa/vespalib/util/singleexecutor.h>
+#include <vespa/vespalib/util/lockfree_single_executor.h>
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
 
 using vespalib::SyncableThreadExecutor;
 using vespalib::BlockingThreadStackExecutor;
 using vespalib::SingleExecutor;
+using vespalib::LockFreeSingleExecutor;
 using vespalib::SequencedTaskExecutor;
 using OptimizeFor = vespalib::Executor::OptimizeFor;
 
@@ -22,6 +24,9 @@ createExecutorWithOneThread(uint32_t stackSize, uint32_t taskLimit, OptimizeFor
                             vespalib::Runnable::init_fun_t init_function) {
     if (optimize == OptimizeFor::THROUGHPUT) {
         return std::make_unique<SingleExecutor>(std::move(init_function), taskLimit);
+    } else if (optimize == OptimizeFor::LOCKFREE) {
+        return std::make_unique<LockFreeSingleExecutor>(std::move(init_function), taskLimit,
+                                                        taskLimit * LockFreeSingleExecutor::RESERVE_FACTOR);
     } else {
         return std::make_unique<BlockingThreadStackExecutor>(1, stackSize, taskLimit, std::move(init_function));
     }
@@ -10,7 +10,11 @@
 #include <vespa/searchcore/proton/common/eventlogger.h>
 #include <vespa/vespalib/util/idestructorcallback.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <mutex>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.server.feedstates");
@@ -124,43 +128,135 @@ public:
     }
 };
 
+/**
+ * Deserializes packet entries into feed operations using a shared executor.
+ * Entries are split into chunks that are claimed both by helper tasks and by
+ * the thread waiting for the result, so completion never depends on helper
+ * tasks actually getting to run.
+ */
+class ParallelEntryDeserializer : public std::enable_shared_from_this<ParallelEntryDeserializer> {
+    const std::vector<Packet::Entry>      &_entries;
+    const document::DocumentTypeRepo      &_repo;
+    std::vector<FeedOperation::UP>         _ops;
+    std::atomic<size_t>                    _next_chunk;
+    size_t                                 _num_chunks;
+    std::mutex                             _lock;
+    std::condition_variable                _cond;
+    size_t                                 _done_chunks;
+
+    bool deserialize_chunk() {
+        size_t chunk = _next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= _num_chunks) {
+            return false;
+        }
+        size_t end = std::min(_entries.size(), (chunk + 1) * DESERIALIZE_CHUNK_SIZE);
+        for (size_t i = chunk * DESERIALIZE_CHUNK_SIZE; i < end; ++i) {
+            try {
+                _ops[i] = ReplayPacketDispatcher::deserializeEntry(_entries[i], _repo);
+            } catch (const std::exception &) {
+                // Left empty; redone in order by the replaying thread, which reports the failure.
+            }
+        }
+        std::lock_guard guard(_lock);
+        if (++_done_chunks == _num_chunks) {
+            _cond.notify_all();
+        }
+        return true;
+    }
+
+public:
+    static constexpr size_t DESERIALIZE_CHUNK_SIZE = 16;
+
+    ParallelEntryDeserializer(const std::vector<Packet::Entry> &entries, const document::DocumentTypeRepo &repo)
+        : _entries(entries),
+          _repo(repo),
+          _ops(entries.size()),
+          _next_chunk(0),
+          _num_chunks((entries.size() + DESERIALIZE_CHUNK_SIZE - 1) / DESERIALIZE_CHUNK_SIZE),
+          _lock(),
+          _cond(),
+          _done_chunks(0)
+    {}
+
+    std::vector<FeedOperation::UP> run(Executor &executor) {
+        for (size_t i = 1; i < _num_chunks; ++i) {
+            auto rejected = executor.execute(makeLambdaTask([self = shared_from_this()] () {
+                while (self->deserialize_chunk()) { }
+            }));
+            if (rejected) {
+                break;
+            }
+        }
+        while (deserialize_chunk()) { }
+        std::unique_lock guard(_lock);
+        _cond.wait(guard, [this]() { return _done_chunks == _num_chunks; });
+        return std::move(_ops);
+    }
+};
+
 class PacketDispatcher {
 public:
-    PacketDispatcher(IReplayPacketHandler *packet_handler)
-        : _packet_handler(packet_handler)
+    PacketDispatcher(IReplayPacketHandler *packet_handler, Executor &deserialize_executor)
+        : _packet_handler(packet_handler),
+          _deserialize_executor(deserialize_executor)
     {}
 
     void handlePacket(PacketWrapper & wrap);
 private:
-    void handleEntry(const Packet::Entry &entry);
+    void handleEntry(const Packet::Entry &entry, const FeedOperation *op);
+    static bool canDeserializeInParallel(const std::vector<Packet::Entry> &entries);
     IReplayPacketHandler *_packet_handler;
+    Executor             &_deserialize_executor;
 };
 
 void
 PacketDispatcher::handlePacket(PacketWrapper & wrap)
 {
     vespalib::nbostream_longlivedbuf handle(wrap.packet.getHandle().data(), wrap.packet.getHandle().size());
+    std::vector<Packet::Entry> entries;
     while ( !handle.empty() ) {
-        Packet::Entry entry;
-        entry.deserialize(handle);
-        handleEntry(entry);
+        entries.emplace_back();
+        entries.back().deserialize(handle);
+    }
+    std::vector<FeedOperation::UP> ops;
+    if (canDeserializeInParallel(entries)) {
+        auto deserializer = std::make_shared<ParallelEntryDeserializer>(entries, _packet_handler->getDeserializeRepo());
+        ops = deserializer->run(_deserialize_executor);
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        handleEntry(entries[i], (i < ops.size()) ? ops[i].get() : nullptr);
         if (wrap.progress != nullptr) {
-            handleProgress(*wrap.progress, entry.serial());
+            handleProgress(*wrap.progress, entries[i].serial());
         }
     }
     wrap.result = RPC::OK;
     wrap.gate.countDown();
 }
 
+bool
+PacketDispatcher::canDeserializeInParallel(const std::vector<Packet::Entry> &entries)
+{
+    if (entries.size() <= ParallelEntryDeserializer::DESERIALIZE_CHUNK_SIZE) {
+        return false;
+    }
+    // A new config might change the document type repo used to deserialize the entries following it.
+    return std::none_of(entries.begin(), entries.end(),
+                        [](const Packet::Entry &entry) { return entry.type() == FeedOperation::NEW_CONFIG; });
+}
+
 void
-PacketDispatcher::handleEntry(const Packet::Entry &entry) {
+PacketDispatcher::handleEntry(const Packet::Entry &entry, const FeedOperation *op) {
     // Called by handlePacket() in executor thread.
     LOG(spam, "replay packet entry: entrySerial(%" PRIu64 "), entryType(%u)", entry.serial(), entry.type());
 
     auto entry_serial_num = entry.serial();
     _packet_handler->check_serial_num(entry_serial_num);
     ReplayPacketDispatcher dispatcher(*_packet_handler);
-    dispatcher.replayEntry(entry);
+    if (op != nullptr) {
+        dispatcher.replayOperation(*op);
+    } else {
+        dispatcher.replayEntry(entry);
+    }
     _packet_handler->optionalCommit(entry_serial_num);
 }
 
@@ -172,9 +268,11 @@ ReplayTransactionLogState::ReplayTransactionLogState(
         IBucketDBHandler &bucketDBHandler,
         IReplayConfig &replay_config,
         FeedConfigStore &config_store,
-        IIncSerialNum& inc_serial_num)
+        IIncSerialNum& inc_serial_num,
+        Executor &deserialize_executor)
     : FeedState(REPLAY_TRANSACTION_LOG),
       _doc_type_name(name),
+      _deserialize_executor(deserialize_executor),
       _packet_handler(std::make_unique<TransactionLogReplayPacketHandler>(feed_view_ptr, bucketDBHandler, replay_config, config_store, inc_serial_num))
 { }
 
@@ -183,7 +281,7 @@ ReplayTransactionLogState::~ReplayTransactionLogState() = default;
 void
 ReplayTransactionLogState::receive(const PacketWrapper::SP &wrap, Executor &executor) {
     executor.execute(makeLambdaTask([this, wrap = wrap] () {
-        PacketDispatcher dispatcher(_packet_handler.get());
+        PacketDispatcher dispatcher(_packet_handler.get(), _deserialize_executor);
         dispatcher.handlePacket(*wrap);
     }));
 }
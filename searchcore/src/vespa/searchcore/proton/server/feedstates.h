@@ -44,9 +44,12 @@ public:
 /**
  * The feed handler is replaying the transaction log.
  * Replayed messages from the transaction log are sent to the active feed view.
+ * Entries in a packet are deserialized in parallel using the deserialize executor,
+ * but are always applied in serial number order by the receiving executor.
  */
 class ReplayTransactionLogState : public FeedState {
     vespalib::string _doc_type_name;
+    vespalib::Executor &_deserialize_executor;
     std::unique_ptr<IReplayPacketHandler> _packet_handler;
 
 public:
@@ -55,7 +58,8 @@ public:
             bucketdb::IBucketDBHandler &bucketDBHandler,
             IReplayConfig &replay_config,
             FeedConfigStore &config_store,
-            IIncSerialNum &inc_serial_num);
+            IIncSerialNum &inc_serial_num,
+            vespalib::Executor &deserialize_executor);
 
     ~ReplayTransactionLogState() override;
     void handleOperation(FeedToken, FeedOperationUP op) override {
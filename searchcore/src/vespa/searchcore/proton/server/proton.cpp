@@ -18,6 +18,8 @@
 #include <vespa/document/base/exceptions.h>
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/llvm/object_code_cache.h>
 #include <vespa/metrics/updatehook.h>
 #include <vespa/searchcore/proton/attribute/i_attribute_usage_listener.h>
 #include <vespa/searchcore/proton/flushengine/flush_engine_explorer.h>
@@ -40,6 +42,7 @@
 #include <vespa/vespalib/util/mmap_file_allocator_factory.h>
 #include <vespa/vespalib/util/random.h>
 #include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/work_stealing_executor.h>
 
 #include <vespa/searchlib/aggregation/forcelink.hpp>
 #include <vespa/searchlib/expression/forcelink.hpp>
@@ -242,6 +245,8 @@ Proton::Proton(const config::ConfigUri & configUri,
       _sharedExecutor(),
       _compile_cache_executor_binding(),
       _queryLimiter(),
+      _tensorLoader(vespalib::eval::FastValueBuilderFactory::get()),
+      _constantValueCache(_tensorLoader),
       _clock(0.001),
       _threadPool(128_Ki),
       _distributionKey(-1),
@@ -288,12 +293,14 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     _tls = std::make_unique<TLS>(_configUri.createWithNewId(protonConfig.tlsconfigid), _fileHeaderContext);
     _metricsEngine->addMetricsHook(*_metricsHook);
     _fileHeaderContext.setClusterName(protonConfig.clustername, protonConfig.basedir);
+    const bool workStealing = protonConfig.executor.workstealing;
     _matchEngine = std::make_unique<MatchEngine>(protonConfig.numsearcherthreads,
                                                  protonConfig.numthreadspersearch,
                                                  protonConfig.distributionkey,
-                                                 protonConfig.search.async);
+                                                 protonConfig.search.async,
+                                                 workStealing);
     _distributionKey = protonConfig.distributionkey;
-    _summaryEngine= std::make_unique<SummaryEngine>(protonConfig.numsummarythreads, protonConfig.docsum.async);
+    _summaryEngine= std::make_unique<SummaryEngine>(protonConfig.numsummarythreads, protonConfig.docsum.async, workStealing);
     _docsumBySlime = std::make_unique<DocsumBySlime>(*_summaryEngine);
 
     IFlushStrategy::SP strategy;
@@ -330,14 +337,25 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
                                                              protonConfig.visit.ignoremaxbytes);
 
     vespalib::string fileConfigId;
-    _warmupExecutor = std::make_unique<vespalib::ThreadStackExecutor>(4, 128_Ki, index_warmup_executor);
-
     const size_t sharedThreads = derive_shared_threads(protonConfig, hwInfo.cpu());
-    _sharedExecutor = std::make_shared<vespalib::BlockingThreadStackExecutor>(sharedThreads, 128_Ki, sharedThreads*16, proton_shared_executor);
+    if (workStealing) {
+        _warmupExecutor = std::make_unique<vespalib::WorkStealingExecutor>(4, 128_Ki, index_warmup_executor);
+        _sharedExecutor = std::make_shared<vespalib::WorkStealingExecutor>(sharedThreads, 128_Ki, proton_shared_executor, sharedThreads*16, true);
+    } else {
+        _warmupExecutor = std::make_unique<vespalib::ThreadStackExecutor>(4, 128_Ki, index_warmup_executor);
+        _sharedExecutor = std::make_shared<vespalib::BlockingThreadStackExecutor>(sharedThreads, 128_Ki, sharedThreads*16, proton_shared_executor);
+    }
     _compile_cache_executor_binding = vespalib::eval::CompileCache::bind(_sharedExecutor);
+    if (protonConfig.compilecache.persistent) {
+        vespalib::eval::ObjectCodeCache::bind(protonConfig.basedir + "/compilecache", protonConfig.compilecache.maxsize);
+    }
     InitializeThreads initializeThreads;
     if (protonConfig.initialize.threads > 0) {
-        initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(protonConfig.initialize.threads, 128_Ki, initialize_executor);
+        if (workStealing) {
+            initializeThreads = std::make_shared<vespalib::WorkStealingExecutor>(protonConfig.initialize.threads, 128_Ki, initialize_executor);
+        } else {
+            initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(protonConfig.initialize.threads, 128_Ki, initialize_executor);
+        }
         _initDocumentDbsInSequence = (protonConfig.initialize.threads == 1);
     }
     _protonConfigurer.applyInitialConfig(initializeThreads);
@@ -481,6 +499,7 @@ Proton::~Proton()
     _tls.reset();
     _warmupExecutor.reset();
     _compile_cache_executor_binding.reset();
+    vespalib::eval::ObjectCodeCache::bind("");
     _sharedExecutor.reset();
     _clock.stop();
     LOG(debug, "Explicit destructor done");
@@ -616,7 +635,7 @@ Proton::addDocumentDB(const document::DocumentType &docType,
         initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(1, 128_Ki);
     }
     auto ret = DocumentDB::create(config.basedir + "/documents", documentDBConfig, config.tlsspec,
-                                  _queryLimiter, _clock, docTypeName, bucketSpace, config, *this,
+                                  _queryLimiter, _clock, _constantValueCache, docTypeName, bucketSpace, config, *this,
                                   *_warmupExecutor, *_sharedExecutor, *_persistenceEngine, *_tls->getTransLogServer(),
                                   *_metricsEngine, _fileHeaderContext, std::move(config_store),
                                   initializeThreads, bootstrapConfig->getHwInfo());
@@ -25,6 +25,8 @@
 #include <vespa/vespalib/net/state_explorer.h>
 #include <vespa/vespalib/util/varholder.h>
 #include <vespa/eval/eval/llvm/compile_cache.h>
+#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
+#include <vespa/eval/eval/value_cache/constant_value_cache.h>
 #include <mutex>
 #include <shared_mutex>
 
@@ -103,10 +105,12 @@ private:
     std::unique_ptr<IProtonDiskLayout> _protonDiskLayout;
     ProtonConfigurer                _protonConfigurer;
     ProtonConfigFetcher             _protonConfigFetcher;
-    std::unique_ptr<vespalib::ThreadStackExecutorBase> _warmupExecutor;
-    std::shared_ptr<vespalib::ThreadStackExecutorBase> _sharedExecutor;
+    std::unique_ptr<vespalib::SyncableThreadExecutor> _warmupExecutor;
+    std::shared_ptr<vespalib::SyncableThreadExecutor> _sharedExecutor;
     vespalib::eval::CompileCache::ExecutorBinding::UP _compile_cache_executor_binding;
     matching::QueryLimiter          _queryLimiter;
+    vespalib::eval::ConstantTensorLoader _tensorLoader;
+    vespalib::eval::ConstantValueCache _constantValueCache;
     vespalib::Clock                 _clock;
     FastOS_ThreadPool               _threadPool;
     uint32_t                        _distributionKey;
@@ -12,6 +12,9 @@ class FeedOperation;
  * Utility class that deserializes packet entries into feed operations
  * during replay from the transaction log and dispatches the feed operations
  * to a given handler class.
+ *
+ * Deserializing and dispatching can also be done as separate steps, allowing
+ * entries to be deserialized in parallel while still being dispatched in order.
  */
 class ReplayPacketDispatcher
 {
@@ -20,7 +23,7 @@ private:
     IReplayPacketHandler &_handler;
 
     template <typename OperationType>
-    void replay(OperationType &op, vespalib::nbostream &is, const Packet::Entry &entry);
+    void replay(const FeedOperation &op);
 
 protected:
     virtual void store(const FeedOperation &op);
@@ -30,6 +33,18 @@ public:
     virtual ~ReplayPacketDispatcher();
 
     void replayEntry(const Packet::Entry &entry);
+
+    /**
+     * Dispatch an operation that has already been deserialized by deserializeEntry().
+     */
+    void replayOperation(const FeedOperation &op);
+
+    /**
+     * Deserialize a packet entry into a feed operation without dispatching it.
+     * Does not handle NEW_CONFIG entries, as they depend on the config stream handler.
+     */
+    static std::unique_ptr<FeedOperation>
+    deserializeEntry(const Packet::Entry &entry, const document::DocumentTypeRepo &repo);
 };
 
 } // namespace proton
@@ -6,8 +6,6 @@
 #include "searchable_feed_view.h"
 #include "searchview.h"
 #include "summaryadapter.h"
-#include <vespa/eval/eval/value_cache/constant_tensor_loader.h>
-#include <vespa/eval/eval/value_cache/constant_value_cache.h>
 #include <vespa/searchcore/proton/attribute/attributemanager.h>
 #include <vespa/searchcore/proton/common/doctypename.h>
 #include <vespa/searchcore/proton/docsummary/summarymanager.h>
@@ -53,15 +51,18 @@ public:
         const FastAccessDocSubDB::Context  _fastUpdCtx;
         matching::QueryLimiter            &_queryLimiter;
         const vespalib::Clock             &_clock;
+        const vespalib::eval::ConstantValueFactory &_constantValueFactory;
         vespalib::SyncableThreadExecutor  &_warmupExecutor;
 
         Context(const FastAccessDocSubDB::Context &fastUpdCtx,
                 matching::QueryLimiter &queryLimiter,
                 const vespalib::Clock &clock,
+                const vespalib::eval::ConstantValueFactory &constantValueFactory,
                 vespalib::SyncableThreadExecutor &warmupExecutor)
             : _fastUpdCtx(fastUpdCtx),
               _queryLimiter(queryLimiter),
               _clock(clock),
+              _constantValueFactory(constantValueFactory),
               _warmupExecutor(warmupExecutor)
         { }
     };
@@ -74,8 +75,6 @@ private:
     IIndexWriter::SP                            _indexWriter;
     vespalib::VarHolder<SearchView::SP>         _rSearchView;
     vespalib::VarHolder<SearchableFeedView::SP> _rFeedView;
-    vespalib::eval::ConstantTensorLoader        _tensorLoader;
-    vespalib::eval::ConstantValueCache          _constantValueCache;
     matching::ConstantValueRepo                 _constantValueRepo;
     SearchableDocSubDBConfigurer                _configurer;
     vespalib::SyncableThreadExecutor           &_warmupExecutor;
@@ -47,6 +47,7 @@ selectOptimization(ProtonConfig::Indexing::Optimize optimize) {
         case CfgOptimize::LATENCY: return OptimizeFor::LATENCY;
         case CfgOptimize::THROUGHPUT: return OptimizeFor::THROUGHPUT;
         case CfgOptimize::ADAPTIVE: return OptimizeFor::ADAPTIVE;
+        case CfgOptimize::LOCKFREE: return OptimizeFor::LOCKFREE;
     }
     return OptimizeFor::LATENCY;
 }
@@ -2,6 +2,8 @@
 #include "summaryengine.h"
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/work_stealing_executor.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.summaryengine.summaryengine");
@@ -45,6 +47,14 @@ uint32_t getNumDocs(const DocsumReply &reply) {
 
 VESPA_THREAD_STACK_TAG(summary_engine_executor)
 
+std::unique_ptr<vespalib::SyncableThreadExecutor>
+make_executor(size_t numThreads, bool workStealing) {
+    if (workStealing) {
+        return std::make_unique<vespalib::WorkStealingExecutor>(numThreads, 128_Ki, summary_engine_executor);
+    }
+    return std::make_unique<vespalib::ThreadStackExecutor>(numThreads, 128_Ki, summary_engine_executor);
+}
+
 } // namespace anonymous
 
 namespace proton {
@@ -59,18 +69,18 @@ SummaryEngine::DocsumMetrics::DocsumMetrics()
 
 SummaryEngine::DocsumMetrics::~DocsumMetrics() = default;
 
-SummaryEngine::SummaryEngine(size_t numThreads, bool async)
+SummaryEngine::SummaryEngine(size_t numThreads, bool async, bool workStealing)
     : _lock(),
       _async(async),
       _closed(false),
       _handlers(),
-      _executor(numThreads, 128_Ki, summary_engine_executor),
+      _executor(make_executor(numThreads, workStealing)),
       _metrics(std::make_unique<DocsumMetrics>())
 { }
 
 SummaryEngine::~SummaryEngine()
 {
-    _executor.shutdown();
+    _executor->shutdown();
 }
 
 void
@@ -82,7 +92,7 @@ SummaryEngine::close()
         _closed = true;
     }
     LOG(debug, "Handshaking with task manager");
-    _executor.sync();
+    _executor->sync();
 }
 
 ISearchHandler::SP
@@ -119,7 +129,7 @@ SummaryEngine::getDocsums(DocsumRequest::Source request, DocsumClient & client)
     }
     if (_async) {
         auto task = std::make_unique<DocsumTask>(*this, std::move(request), client);
-        _executor.execute(std::move(task));
+        _executor->execute(std::move(task));
         return DocsumReply::UP();
     }
     return getDocsums(request.release());
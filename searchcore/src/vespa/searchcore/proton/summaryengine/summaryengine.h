@@ -5,7 +5,7 @@
 #include <vespa/searchcore/proton/common/doctypename.h>
 #include <vespa/searchcore/proton/common/handlermap.hpp>
 #include <vespa/searchlib/engine/docsumapi.h>
-#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/threadexecutor.h>
 #include <vespa/metrics/valuemetric.h>
 #include <vespa/metrics/countmetric.h>
 #include <vespa/metrics/metricset.h>
@@ -35,7 +35,7 @@ private:
     bool                          _async;
     bool                          _closed;
     HandlerMap<ISearchHandler>    _handlers;
-    vespalib::ThreadStackExecutor _executor;
+    std::unique_ptr<vespalib::SyncableThreadExecutor> _executor;
     std::unique_ptr<metrics::MetricSet> _metrics;
 
 public:
@@ -49,8 +49,10 @@ public:
      * using the putSearchHandler() method.
      *
      * @param numThreads Number of threads allocated for handling summary requests.
+     * @param async if docsum requests are dispatched to threadpool
+     * @param workStealing use a work stealing executor for the threadpool
      */
-    SummaryEngine(size_t numThreads, bool async);
+    SummaryEngine(size_t numThreads, bool async, bool workStealing = false);
     SummaryEngine(size_t numThreads)
         : SummaryEngine(numThreads, true)
     { }
@@ -66,12 +68,12 @@ public:
      *
      * @return executor stats
      **/
-    vespalib::ThreadStackExecutor::Stats getExecutorStats() { return _executor.getStats(); }
+    vespalib::ExecutorStats getExecutorStats() { return _executor->getStats(); }
 
     /**
      * Returns the underlying executor. Only used for state explorers.
      */
-    const vespalib::SyncableThreadExecutor& get_executor() const { return _executor; }
+    const vespalib::SyncableThreadExecutor& get_executor() const { return *_executor; }
 
     /**
      * Starts the underlying threads. This will throw a vespalib::Exception if
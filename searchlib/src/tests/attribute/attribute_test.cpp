@@ -185,6 +185,7 @@ private:
     void testMemorySaver(const AttributePtr & a);
 
     void testReload();
+    void testMappedLoad();
     void testHasLoadData();
     void testMemorySaver();
 
@@ -611,6 +612,45 @@ void AttributeTest::testReload()
     }
 }
 
+void AttributeTest::testMappedLoad()
+{
+    Config cfg(BasicType::INT64, CollectionType::SINGLE);
+    AttributePtr a = createAttribute("mapped_1", cfg);
+    addDocs(a, 5000);
+    auto &ia = static_cast<IntegerAttribute &>(*a);
+    for (uint32_t doc = 0; doc < 5000; ++doc) {
+        ia.update(doc, doc * 3);
+    }
+    a->commit();
+    EXPECT_TRUE(a->save());
+
+    AttributePtr b = createAttribute("mapped_1", cfg);
+    b->set_load_mapped(true);
+    EXPECT_TRUE(b->load());
+    EXPECT_EQUAL(5000u, b->getNumDocs());
+    auto &ib = static_cast<IntegerAttribute &>(*b);
+    for (uint32_t doc = 0; doc < 5000; ++doc) {
+        EXPECT_EQUAL(int64_t(doc) * 3, ib.getInt(doc));
+    }
+    // Writes to a mapped attribute must not reach the file
+    ib.update(10, 42);
+    b->commit();
+    EXPECT_EQUAL(42, ib.getInt(10));
+    AttributeVector::DocId docId;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        EXPECT_TRUE(b->addDoc(docId));
+    }
+    b->commit();
+    EXPECT_EQUAL(7999u, docId);
+    EXPECT_EQUAL(42, ib.getInt(10));
+    EXPECT_EQUAL(4999 * 3, ib.getInt(4999));
+
+    AttributePtr c = createAttribute("mapped_1", cfg);
+    c->set_load_mapped(true);
+    EXPECT_TRUE(c->load());
+    EXPECT_EQUAL(30, static_cast<IntegerAttribute &>(*c).getInt(10));
+}
+
 void AttributeTest::testHasLoadData()
 {
     { // single value
@@ -2292,6 +2332,7 @@ int AttributeTest::Main()
 
     testBaseName();
     testReload();
+    testMappedLoad();
     testHasLoadData();
     testMemorySaver();
 
@@ -328,6 +328,22 @@ AttributeManagerTest::testConfigConvert()
         auto out = ConfigConverter::convert(a);
         EXPECT_FALSE(out.hnsw_index_params().has_value());
     }
+    { // mmap policy (default)
+        CACA a;
+        auto out = ConfigConverter::convert(a);
+        EXPECT_TRUE(out.get_mmap_policy().is_default());
+        EXPECT_TRUE(out.get_memory_allocator() == nullptr);
+    }
+    { // mmap policy (explicit)
+        using MmapPolicy = vespalib::alloc::MmapPolicy;
+        CACA a;
+        a.memory.hugepages = CACA::Memory::Hugepages::TRANSPARENT;
+        a.memory.numa = CACA::Memory::Numa::BIND;
+        a.memory.numanode = 1;
+        auto out = ConfigConverter::convert(a);
+        EXPECT_TRUE(out.get_mmap_policy() == MmapPolicy(MmapPolicy::HugePages::TRANSPARENT, MmapPolicy::Numa::BIND, 1));
+        EXPECT_TRUE(out.get_memory_allocator() != nullptr);
+    }
 }
 
 bool gt_attribute(const attribute::IAttributeVector * a, const attribute::IAttributeVector * b) {
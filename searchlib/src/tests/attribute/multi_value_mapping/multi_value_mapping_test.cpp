@@ -3,6 +3,7 @@
 #include <vespa/searchlib/attribute/multi_value_mapping.h>
 #include <vespa/searchlib/attribute/multi_value_mapping.hpp>
 #include <vespa/searchlib/attribute/not_implemented_attribute.h>
+#include <vespa/searchcommon/common/compaction_strategy.h>
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 #include <vespa/vespalib/test/insertion_operators.h>
@@ -146,6 +147,13 @@ public:
         _attr->commit();
         _attr->incGeneration();
     }
+    bool considerCompact(const search::CompactionStrategy &compactionStrategy) {
+        _mvMapping->updateStat();
+        bool result = _mvMapping->considerCompact(compactionStrategy);
+        _attr->commit();
+        _attr->incGeneration();
+        return result;
+    }
 };
 
 using IntMappingTest = MappingTestBase<int>;
@@ -349,4 +357,45 @@ TEST_F(CompactionIntMappingTest, test_that_compaction_works)
     EXPECT_LT(bufferCountAfter, bufferCountBefore);
 }
 
+TEST_F(CompactionIntMappingTest, test_that_compaction_can_be_interleaved_with_feed)
+{
+    setup(3, 64, 512, 129);
+    addRandomDocs(40000);
+    uint32_t docIdLimit = size();
+    for (uint32_t docId = 0; docId < docIdLimit; docId += 2) {
+        clearDoc(docId);
+    }
+    search::CompactionStrategy compactionStrategy(0.05, 0.2, 1000);
+    EXPECT_TRUE(considerCompact(compactionStrategy));
+    EXPECT_TRUE(_mvMapping->isCompacting());
+    uint32_t slices = 1;
+    while (_mvMapping->isCompacting()) {
+        clearDoc(1 + 2 * slices);
+        addRandomDoc();
+        EXPECT_TRUE(considerCompact(compactionStrategy));
+        checkRefMapping();
+        ++slices;
+    }
+    EXPECT_LE(docIdLimit / 1000, slices);
+    checkRefMapping();
+}
+
+TEST_F(CompactionIntMappingTest, test_that_pending_compaction_can_be_finished_when_idle)
+{
+    setup(3, 64, 512, 129);
+    addRandomDocs(40000);
+    uint32_t docIdLimit = size();
+    for (uint32_t docId = 0; docId < docIdLimit; docId += 2) {
+        clearDoc(docId);
+    }
+    search::CompactionStrategy compactionStrategy(0.05, 0.2, 1000);
+    EXPECT_FALSE(_mvMapping->finishCompact());
+    EXPECT_TRUE(considerCompact(compactionStrategy));
+    EXPECT_TRUE(_mvMapping->isCompacting());
+    EXPECT_TRUE(_mvMapping->finishCompact());
+    EXPECT_FALSE(_mvMapping->isCompacting());
+    EXPECT_FALSE(_mvMapping->finishCompact());
+    checkRefMapping();
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
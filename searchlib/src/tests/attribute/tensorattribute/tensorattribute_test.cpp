@@ -1,6 +1,9 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/document/base/exceptions.h>
+#include <vespa/document/datatype/tensor_data_type.h>
+#include <vespa/document/fieldvalue/tensorfieldvalue.h>
+#include <vespa/document/update/tensor_modify_update.h>
 #include <vespa/eval/eval/simple_value.h>
 #include <vespa/eval/eval/tensor_spec.h>
 #include <vespa/eval/eval/value.h>
@@ -31,6 +34,9 @@
 #include <vespa/log/log.h>
 LOG_SETUP("tensorattribute_test");
 
+using document::TensorDataType;
+using document::TensorFieldValue;
+using document::TensorModifyUpdate;
 using document::WrongTensorTypeException;
 using search::AttributeGuard;
 using search::AttributeVector;
@@ -407,6 +413,14 @@ struct Fixture {
         _attr->commit();
     }
 
+    void modify_tensor(uint32_t docid, TensorModifyUpdate::Operation operation, const TensorSpec &cells) {
+        auto cells_type = TensorDataType::fromSpec(cells.type());
+        auto cells_value = std::make_unique<TensorFieldValue>(*cells_type);
+        *cells_value = createTensor(cells);
+        _tensorAttr->update_tensor(docid, TensorModifyUpdate(operation, std::move(cells_value)), false);
+        _attr->commit();
+    }
+
     void set_empty_tensor(uint32_t docid) {
         set_tensor_internal(docid, *_tensorAttr->getEmptyTensor());
     }
@@ -775,6 +789,25 @@ TEST_F("setTensor() updates nearest neighbor index", DenseTensorAttributeMockInd
     index.expect_add(1, {7, 9});
 }
 
+TEST_F("tensor modify update only updates nearest neighbor index when cells are changed", DenseTensorAttributeMockIndex)
+{
+    auto& index = f.mock_index();
+
+    f.set_tensor(1, vec_2d(3, 5));
+    index.clear();
+    f.modify_tensor(1, TensorModifyUpdate::Operation::ADD, TensorSpec("tensor(x{})").add({{"x", "1"}}, 2));
+    f.assertGetTensor(vec_2d(3, 7), 1);
+    index.expect_remove(1, {3, 5});
+    index.expect_add(1, {3, 7});
+    index.clear();
+
+    // Cells are left as is.
+    f.modify_tensor(1, TensorModifyUpdate::Operation::REPLACE, TensorSpec("tensor(x{})").add({{"x", "0"}}, 3));
+    f.assertGetTensor(vec_2d(3, 7), 1);
+    index.expect_empty_remove();
+    index.expect_empty_add();
+}
+
 TEST_F("nearest neighbor index can be updated in two phases", DenseTensorAttributeMockIndex)
 {
     auto& index = f.mock_index();
@@ -14,9 +14,11 @@
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <iomanip>
+#include <map>
 
 using document::BucketId;
 using namespace search::docstore;
@@ -735,6 +737,56 @@ TEST("testWriteRead") {
     FastOS_File::EmptyAndRemoveDirectory("empty");
 }
 
+struct CollectingBufferVisitor : public IBufferVisitor {
+    std::map<uint32_t, vespalib::string> docs;
+    void visit(uint32_t lid, vespalib::ConstBufferRef buffer) override {
+        docs[lid] = vespalib::string(buffer.c_str(), buffer.size());
+    }
+};
+
+void
+verifyBatchedRead(const TuneFileSummary & tune)
+{
+    DirectoryHandler tmpDir("batched");
+    DummyFileHeaderContext fileHeaderContext;
+    vespalib::ThreadStackExecutor executor(1, 128_Ki);
+    MyTlSyncer tlSyncer;
+    LogDataStore::Config config;
+    config.setFileConfig({{CompressionConfig::NONE, 0, 0}, 300});
+    {
+        LogDataStore datastore(executor, "batched", config, GrowStrategy(),
+                               tune, fileHeaderContext, tlSyncer, nullptr);
+        for (uint32_t lid(0); lid < 100; lid++) {
+            vespalib::string doc = vespalib::make_string("document number %u", lid);
+            datastore.write(lid + 1, lid, doc.c_str(), doc.size());
+        }
+        datastore.flush(datastore.initFlush(100));
+    }
+    LogDataStore datastore(executor, "batched", config, GrowStrategy(),
+                           tune, fileHeaderContext, tlSyncer, nullptr);
+    IDataStore::LidVector lids;
+    for (uint32_t lid(0); lid < 100; lid += 3) {
+        lids.push_back(lid);
+    }
+    CollectingBufferVisitor visitor;
+    datastore.read(lids, visitor);
+    EXPECT_EQUAL(lids.size(), visitor.docs.size());
+    for (uint32_t lid : lids) {
+        EXPECT_EQUAL(vespalib::make_string("document number %u", lid), visitor.docs[lid]);
+    }
+}
+
+TEST("require that batched reads spanning many chunks give the same result for all read modes") {
+    TuneFileSummary tune;
+    TEST_DO(verifyBatchedRead(tune));
+    tune._randRead.setWantMemoryMap();
+    TEST_DO(verifyBatchedRead(tune));
+    tune._randRead.setWantDirectIO();
+    TEST_DO(verifyBatchedRead(tune));
+    tune._randRead.setWantAsyncIO();
+    TEST_DO(verifyBatchedRead(tune));
+}
+
 TEST("requireThatSyncTokenIsUpdatedAfterFlush") {
 #if 0
     std::string file = "sync.dat";
@@ -91,6 +91,7 @@ TEST_F(OnnxFeatureTest, simple_onnx_model_can_be_calculated) {
     add_expr("bias_tensor", "tensor<float>(a[1],b[1]):[[9]]");
     add_onnx(OnnxModel("simple", simple_model));
     compile(onnx_feature("simple"));
+    EXPECT_FALSE(program.has_batch_executors());
     EXPECT_EQ(get(1), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 79.0));
     EXPECT_EQ(get("onnxModel(simple).output", 1), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 79.0));
     EXPECT_EQ(get(2), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 84.0));
@@ -109,6 +110,40 @@ TEST_F(OnnxFeatureTest, dynamic_onnx_model_can_be_calculated) {
     EXPECT_EQ(get(3), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 89.0));
 }
 
+TEST_F(OnnxFeatureTest, dynamic_onnx_model_can_be_calculated_in_batch) {
+    add_expr("query_tensor", "tensor<float>(a[1],b[4]):[[docid,2,3,4]]");
+    add_expr("attribute_tensor", "tensor<float>(a[4],b[1]):[[5],[6],[7],[8]]");
+    add_expr("bias_tensor", "tensor<float>(a[1],b[2]):[[4,5]]");
+    add_onnx(OnnxModel("dynamic", dynamic_model));
+    compile(onnx_feature("dynamic"));
+    ASSERT_TRUE(program.has_batch_executors());
+    for (uint32_t docid: {1, 2, 3, 5}) {
+        program.add_to_batch(docid);
+    }
+    program.evaluate_batch();
+    EXPECT_EQ(get(1), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 79.0));
+    EXPECT_EQ(get(2), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 84.0));
+    EXPECT_EQ(get(3), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 89.0));
+    EXPECT_EQ(get(4), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 94.0));
+    EXPECT_EQ(get(5), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 99.0));
+}
+
+TEST_F(OnnxFeatureTest, batch_falls_back_to_single_evaluation_when_shared_inputs_differ) {
+    add_expr("query_tensor", "tensor<float>(a[1],b[4]):[[docid,2,3,4]]");
+    add_expr("attribute_tensor", "tensor<float>(a[4],b[1]):[[docid],[6],[7],[8]]");
+    add_expr("bias_tensor", "tensor<float>(a[1],b[2]):[[4,5]]");
+    add_onnx(OnnxModel("dynamic", dynamic_model));
+    compile(onnx_feature("dynamic"));
+    ASSERT_TRUE(program.has_batch_executors());
+    for (uint32_t docid: {1, 2, 3}) {
+        program.add_to_batch(docid);
+    }
+    program.evaluate_batch();
+    EXPECT_EQ(get(1), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 75.0));
+    EXPECT_EQ(get(2), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 78.0));
+    EXPECT_EQ(get(3), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 83.0));
+}
+
 TEST_F(OnnxFeatureTest, strange_input_and_output_names_are_normalized) {
     add_expr("input_0", "tensor<float>(a[2]):[10,20]");
     add_expr("input_1", "tensor<float>(a[2]):[5,10]");
@@ -391,4 +391,24 @@ TEST_F("require that fast-forest gbdt evaluation is pure", Fixture()) {
     EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
 }
 
+TEST_F("require that fast-forest gbdt evaluation can be batched", Fixture()) {
+    f1.use_fast_forest().add_expr("rank", "if(docid<50,1,2)+if(value(2)<1,10,20)").compile();
+    ASSERT_TRUE(f1.program.has_batch_executors());
+    for (uint32_t docid = 1; docid <= 100; ++docid) {
+        if (docid != 70) {
+            f1.program.add_to_batch(docid);
+        }
+    }
+    f1.program.evaluate_batch();
+    for (uint32_t docid = 1; docid <= 100; ++docid) {
+        EXPECT_EQUAL(f1.get(docid), (docid < 50) ? 21.0 : 22.0);
+    }
+}
+
+TEST_F("require that constant fast-forest gbdt evaluation is not batched", Fixture()) {
+    f1.use_fast_forest().add_expr("rank", tree_expr).compile();
+    EXPECT_TRUE(!f1.program.has_batch_executors());
+    EXPECT_EQUAL(f1.get(), 21.0);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -695,6 +695,67 @@ TEST_F(FieldIndexInterleavedFeaturesTest, interleaved_features_are_capped)
     EXPECT_EQ(std::numeric_limits<uint16_t>::max(), entry.get_field_length());
 }
 
+struct FieldIndexHashDictionaryTest : public ::testing::Test {
+    Schema schema;
+    NormalFieldIndex idx;
+    FieldIndexHashDictionaryTest()
+        : schema(make_single_field_schema()),
+          idx(schema, 0, FieldLengthInfo(), true)
+    {
+    }
+    ~FieldIndexHashDictionaryTest() {}
+};
+
+TEST_F(FieldIndexHashDictionaryTest, require_that_insert_and_find_works)
+{
+    EXPECT_TRUE(idx.has_hash_dictionary());
+    EXPECT_TRUE(assertPostingList("[]", idx.find("b")));
+    WrapInserter(idx).word("b").add(10).word("d").add(11).flush();
+    EXPECT_TRUE(assertPostingList("[10]", idx.find("b")));
+    EXPECT_TRUE(assertPostingList("[11]", idx.find("d")));
+    WrapInserter(idx).rewind().word("a").add(12).word("b").add(12).
+            word("c").add(12).word("d").add(12).word("e").add(12).flush();
+    EXPECT_EQ(5u, idx.getNumUniqueWords());
+    idx.commit();
+    EXPECT_TRUE(assertPostingList("[12]", idx.findFrozen("a")));
+    EXPECT_TRUE(assertPostingList("[10,12]", idx.findFrozen("b")));
+    EXPECT_TRUE(assertPostingList("[12]", idx.findFrozen("c")));
+    EXPECT_TRUE(assertPostingList("[11,12]", idx.findFrozen("d")));
+    EXPECT_TRUE(assertPostingList("[12]", idx.findFrozen("e")));
+    EXPECT_TRUE(assertPostingList("[]", idx.findFrozen("f")));
+}
+
+TEST_F(FieldIndexHashDictionaryTest, require_that_remove_works)
+{
+    WrapInserter(idx).word("a").add(10).add(20).word("b").add(20).flush();
+    MyDrainRemoves(idx).drain(10);
+    WrapInserter(idx).rewind().word("a").remove(10).flush();
+    EXPECT_TRUE(assertPostingList("[20]", idx.find("a")));
+    MyDrainRemoves(idx).drain(20);
+    WrapInserter(idx).rewind().word("a").remove(20).word("b").remove(20).flush();
+    EXPECT_TRUE(assertPostingList("[]", idx.find("a")));
+    EXPECT_TRUE(assertPostingList("[]", idx.find("b")));
+    EXPECT_EQ(2u, idx.getNumUniqueWords());
+}
+
+TEST_F(FieldIndexHashDictionaryTest, require_that_dumping_uses_sorted_word_order)
+{
+    WrapInserter(idx).word("c").add(5, getFeatures(3, 1)).flush();
+    WrapInserter(idx).rewind().word("a").add(7, getFeatures(2, 1)).
+            word("b").add(6, getFeatures(4, 1)).word("c").remove(5).flush();
+    MyBuilder b(schema);
+    b.startField(0);
+    idx.dump(b);
+    b.endField();
+    EXPECT_EQ("f=0[w=a[d=7[e=0,w=1,l=2[0]]],w=b[d=6[e=0,w=1,l=4[0]]]]", b.toStr());
+}
+
+TEST_F(FieldIndexHashDictionaryTest, require_that_memory_usage_includes_hash_dictionary)
+{
+    NormalFieldIndex btree_idx(schema, 0);
+    EXPECT_LT(btree_idx.getMemoryUsage().allocatedBytes(), idx.getMemoryUsage().allocatedBytes());
+}
+
 Schema
 make_multi_field_schema()
 {
@@ -67,6 +67,17 @@ TEST_F("require that correct empty tensor is returned for 1d bound tensor", Fixt
                                    add({{"x", 2}}, 0));
 }
 
+TEST_F("require that unpublished raw buffer is freed without hold", Fixture("tensor(x[3])"))
+{
+    auto before = f.store.getMemoryUsage();
+    auto raw = f.store.allocRawBuffer();
+    f.store.freeRawBuffer(raw.ref);
+    auto after = f.store.getMemoryUsage();
+    EXPECT_EQUAL(before.usedBytes() + 32, after.usedBytes());
+    EXPECT_EQUAL(before.deadBytes() + 32, after.deadBytes());
+    EXPECT_EQUAL(0u, after.allocatedBytesOnHold());
+}
+
 void
 assertArraySize(const vespalib::string &tensorType, uint32_t expArraySize) {
     Fixture f(tensorType);
@@ -743,6 +743,46 @@ TEST("test sending a lot of data async") {
 
 
 
+TEST("test group commit writes and syncs commits together") {
+    const unsigned int NUM_PACKETS = 200;
+    const unsigned int NUM_ENTRIES = 10;
+    const unsigned int TOTAL_NUM_ENTRIES = NUM_PACKETS * NUM_ENTRIES;
+    const vespalib::string GROUP("group-commit");
+    {
+        DummyFileHeaderContext fileHeaderContext;
+        TransLogServer tlss("test14", 18377, ".", fileHeaderContext,
+                            DomainConfig().setPartSizeLimit(0x80000).setFSyncOnCommit(true).setGroupCommitDelay(20ms));
+        TransLogClient tls("tcp/localhost:18377");
+        createDomainTest(tls, GROUP, 0);
+        auto s1 = openDomainTest(tls, GROUP);
+        fillDomainTest(tlss, GROUP, NUM_PACKETS, NUM_ENTRIES);
+        SerialNum b(0), e(0);
+        size_t c(0);
+        EXPECT_TRUE(s1->status(b, e, c));
+        EXPECT_EQUAL(e, TOTAL_NUM_ENTRIES);
+        EXPECT_EQUAL(c, TOTAL_NUM_ENTRIES);
+        CommitStats stats = tlss.getDomainStats()[GROUP].commitStats;
+        EXPECT_EQUAL(size_t(NUM_PACKETS), stats.numChunks);
+        EXPECT_LESS(stats.numBatches, stats.numChunks);
+        EXPECT_LESS(size_t(1), stats.maxChunksInBatch);
+        EXPECT_LESS_EQUAL(stats.numBatches, stats.numSyncs);
+    }
+    {
+        DummyFileHeaderContext fileHeaderContext;
+        TransLogServer tlss("test14", 18377, ".", fileHeaderContext, DomainConfig().setPartSizeLimit(0x1000000));
+        TransLogClient tls("tcp/localhost:18377");
+        auto s1 = openDomainTest(tls, GROUP);
+        CallBackManyTest ca(2);
+        auto visitor = tls.createVisitor(GROUP, ca);
+        ASSERT_TRUE(visitor);
+        ASSERT_TRUE( visitor->visit(2, TOTAL_NUM_ENTRIES) );
+        for (size_t i(0); ! ca._eof && (i < 60000); i++ ) { std::this_thread::sleep_for(10ms); }
+        ASSERT_TRUE( ca._eof );
+        EXPECT_EQUAL(ca._count, TOTAL_NUM_ENTRIES);
+        EXPECT_EQUAL(ca._value, TOTAL_NUM_ENTRIES);
+    }
+}
+
 TEST("testErase") {
     const unsigned int NUM_PACKETS = 1000;
     const unsigned int NUM_ENTRIES = 100;
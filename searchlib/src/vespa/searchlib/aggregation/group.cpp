@@ -7,7 +7,6 @@
 
 #include <vespa/vespalib/objects/objectdumper.h>
 #include <vespa/vespalib/objects/visit.hpp>
-#include <vespa/vespalib/stllike/hash_set.hpp>
 #include <cmath>
 #include <cassert>
 #include <algorithm>
@@ -4,7 +4,7 @@
 #include "rawrank.h"
 #include "aggregationresult.h"
 #include <vespa/searchlib/common/hitrank.h>
-#include <vespa/vespalib/stllike/hash_set.h>
+#include <vespa/vespalib/stllike/swiss_hash_set.h>
 #include <vespa/fastos/dynamiclibrary.h>
 #include <vector>
 
@@ -41,11 +41,11 @@ public:
     typedef ChildP * GroupList;
     struct GroupEqual : public std::binary_function<ChildP, ChildP, bool> {
         GroupEqual(const GroupList * v) : _v(v) { }
-        bool operator()(uint32_t a, uint32_t b) { return (*_v)[a]->getId().cmpFast((*_v)[b]->getId()) == 0; }
-        bool operator()(const Group & a, uint32_t b) { return a.getId().cmpFast((*_v)[b]->getId()) == 0; }
-        bool operator()(uint32_t a, const Group & b) { return (*_v)[a]->getId().cmpFast(b.getId()) == 0; }
-        bool operator()(const ResultNode & a, uint32_t b) { return a.cmpFast((*_v)[b]->getId()) == 0; }
-        bool operator()(uint32_t a, const ResultNode & b) { return (*_v)[a]->getId().cmpFast(b) == 0; }
+        bool operator()(uint32_t a, uint32_t b) const { return (*_v)[a]->getId().cmpFast((*_v)[b]->getId()) == 0; }
+        bool operator()(const Group & a, uint32_t b) const { return a.getId().cmpFast((*_v)[b]->getId()) == 0; }
+        bool operator()(uint32_t a, const Group & b) const { return (*_v)[a]->getId().cmpFast(b.getId()) == 0; }
+        bool operator()(const ResultNode & a, uint32_t b) const { return a.cmpFast((*_v)[b]->getId()) == 0; }
+        bool operator()(uint32_t a, const ResultNode & b) const { return (*_v)[a]->getId().cmpFast(b) == 0; }
         const GroupList *_v;
     };
     struct GroupHasher {
@@ -118,7 +118,7 @@ private:
     private:
 
         using  ExpressionVector = ExpressionNode::CP *;
-        using GroupHash = vespalib::hash_set<uint32_t, GroupHasher, GroupEqual >;
+        using GroupHash = vespalib::swiss_hash_set<uint32_t, GroupHasher, GroupEqual >;
         void setAggrSize(uint32_t v)    { _packedLength = (_packedLength & ~0x0f) | v; }
         void setExprSize(uint32_t v)    { _packedLength = (_packedLength & ~0x30) | (v << 4); }
         void setOrderBySize(uint32_t v) { _packedLength = (_packedLength & ~0xc0) | (v << 6); }
@@ -124,7 +124,8 @@ AttributeVector::AttributeVector(vespalib::stringref baseFileName, const Config
       _compactLidSpaceGeneration(0u),
       _hasEnum(false),
       _loaded(false),
-      _isUpdateableInMemoryOnly(attribute::isUpdateableInMemoryOnly(getName(), getConfig()))
+      _isUpdateableInMemoryOnly(attribute::isUpdateableInMemoryOnly(getName(), getConfig())),
+      _load_mapped(false)
 {
 }
 
@@ -448,6 +448,13 @@ public:
 
     bool isEnumeratedSaveFormat() const;
     bool load();
+    /**
+     * Request that the next load memory maps the data file instead of reading it,
+     * when supported by the attribute type and the file layout. The mapping is
+     * private; pages are copied on the first write to them.
+     */
+    void set_load_mapped(bool value) { _load_mapped = value; }
+    bool load_mapped() const { return _load_mapped; }
     void commit() { commit(false); }
     void commit(bool forceUpdateStats);
     void commit(const CommitParam & param);
@@ -590,6 +597,7 @@ private:
     bool                                  _hasEnum;
     bool                                  _loaded;
     bool                                  _isUpdateableInMemoryOnly;
+    bool                                  _load_mapped;
     vespalib::steady_time                 _nextStatUpdateTime;
 
 ////// Locking strategy interface. only available from the Guards.
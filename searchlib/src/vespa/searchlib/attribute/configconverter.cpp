@@ -90,6 +90,37 @@ convertMatch(AttributesConfig::Attribute::Match match_cfg) {
     assert(false);
 }
 
+vespalib::alloc::MmapPolicy
+convert_mmap_policy(const AttributesConfig::Attribute::Memory & memory) {
+    using MmapPolicy = vespalib::alloc::MmapPolicy;
+    using CfgMemory = AttributesConfig::Attribute::Memory;
+    MmapPolicy::HugePages huge_pages = MmapPolicy::HugePages::NONE;
+    switch (memory.hugepages) {
+        case CfgMemory::Hugepages::NONE:
+            huge_pages = MmapPolicy::HugePages::NONE;
+            break;
+        case CfgMemory::Hugepages::TRANSPARENT:
+            huge_pages = MmapPolicy::HugePages::TRANSPARENT;
+            break;
+        case CfgMemory::Hugepages::EXPLICIT:
+            huge_pages = MmapPolicy::HugePages::EXPLICIT;
+            break;
+    }
+    MmapPolicy::Numa numa = MmapPolicy::Numa::DEFAULT;
+    switch (memory.numa) {
+        case CfgMemory::Numa::DEFAULT:
+            numa = MmapPolicy::Numa::DEFAULT;
+            break;
+        case CfgMemory::Numa::INTERLEAVE:
+            numa = MmapPolicy::Numa::INTERLEAVE;
+            break;
+        case CfgMemory::Numa::BIND:
+            numa = MmapPolicy::Numa::BIND;
+            break;
+    }
+    return MmapPolicy(huge_pages, numa, memory.numanode);
+}
+
 }
 
 Config
@@ -114,6 +145,7 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     retval.setPredicateParams(predicateParams);
     retval.set_dictionary_config(convert_dictionary(cfg.dictionary));
     retval.set_match(convertMatch(cfg.match));
+    retval.set_mmap_policy(convert_mmap_policy(cfg.memory));
     using CfgDm = AttributesConfig::Attribute::Distancemetric;
     DistanceMetric dm(DistanceMetric::Euclidean);
     switch (cfg.distancemetric) {
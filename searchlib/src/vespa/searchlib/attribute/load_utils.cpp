@@ -9,6 +9,8 @@
 #include <vespa/searchlib/util/fileutil.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/util/array.hpp>
+#include <fcntl.h>
+#include <unistd.h>
 
 using search::multivalue::Value;
 using search::multivalue::WeightedValue;
@@ -80,6 +82,19 @@ LoadUtils::loadUDAT(const AttributeVector& attr)
     return loadFile(attr, "udat");
 }
 
+vespalib::alloc::Alloc
+LoadUtils::mapDAT(const AttributeVector& attr, size_t offset, size_t size)
+{
+    vespalib::string fileName = attr.getBaseFileName() + ".dat";
+    int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return vespalib::alloc::Alloc();
+    }
+    auto result = vespalib::alloc::Alloc::allocMMapFile(fd, offset, size);
+    ::close(fd);
+    return result;
+}
+
 
 #define INSTANTIATE_ARRAY(ValueType, Saver) \
 template uint32_t loadFromEnumeratedMultiValue(MultiValueMapping<Value<ValueType>> &, ReaderBase &, vespalib::ConstArrayRef<ValueType>, vespalib::ConstArrayRef<uint32_t>, Saver)
@@ -4,6 +4,7 @@
 
 #include "attributevector.h"
 #include "readerbase.h"
+#include <vespa/vespalib/util/alloc.h>
 #include <vespa/vespalib/util/arrayref.h>
 
 namespace search::attribute {
@@ -31,6 +32,12 @@ public:
     static LoadedBufferUP loadIDX(const AttributeVector& attr);
     static LoadedBufferUP loadWeight(const AttributeVector& attr);
     static LoadedBufferUP loadUDAT(const AttributeVector& attr);
+
+    /**
+     * Privately memory map the given part of the dat file, see vespalib::alloc::Alloc::allocMMapFile().
+     * Returns an empty allocation if the offset is not page aligned or the mapping fails.
+     */
+    static vespalib::alloc::Alloc mapDAT(const AttributeVector& attr, size_t offset, size_t size);
 };
 
 /**
@@ -23,6 +23,8 @@ private:
     using ConstArrayRef = vespalib::ConstArrayRef<EntryT>;
 
     ArrayStore _store;
+
+    ICompactionContext::UP startCompactWorst(bool compactMemory, bool compactAddressSpace) override;
 public:
     MultiValueMapping(const MultiValueMapping &) = delete;
     MultiValueMapping & operator = (const MultiValueMapping &) = delete;
@@ -44,7 +46,6 @@ public:
 
     void doneLoadFromMultiValue() { _store.setInitializing(false); }
 
-    void compactWorst(bool compactMemory, bool compactAddressSpace) override;
 
     vespalib::AddressSpace getAddressSpaceUsage() const override;
     vespalib::MemoryUsage getArrayStoreMemoryUsage() const override;
@@ -15,7 +15,7 @@ MultiValueMapping<EntryT,RefT>::MultiValueMapping(const vespalib::datastore::Arr
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wuninitialized"
 #endif
-    : MultiValueMappingBase(gs, _store.getGenerationHolder()),
+    : MultiValueMappingBase(gs, _store.getGenerationHolder(), storeCfg.memory_allocator()),
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
@@ -24,7 +24,11 @@ MultiValueMapping<EntryT,RefT>::MultiValueMapping(const vespalib::datastore::Arr
 }
 
 template <typename EntryT, typename RefT>
-MultiValueMapping<EntryT,RefT>::~MultiValueMapping() = default;
+MultiValueMapping<EntryT,RefT>::~MultiValueMapping()
+{
+    // A pending compaction context refers to _store
+    _compactionContext.reset();
+}
 
 template <typename EntryT, typename RefT>
 void
@@ -52,13 +56,10 @@ MultiValueMapping<EntryT,RefT>::replace(uint32_t docId, ConstArrayRef values)
 }
 
 template <typename EntryT, typename RefT>
-void
-MultiValueMapping<EntryT,RefT>::compactWorst(bool compactMemory, bool compactAddressSpace)
+vespalib::datastore::ICompactionContext::UP
+MultiValueMapping<EntryT,RefT>::startCompactWorst(bool compactMemory, bool compactAddressSpace)
 {
-    vespalib::datastore::ICompactionContext::UP compactionContext(_store.compactWorst(compactMemory, compactAddressSpace));
-    if (compactionContext) {
-        compactionContext->compact(vespalib::ArrayRef<EntryRef>(&_indices[0], _indices.size()));
-    }
+    return _store.compactWorst(compactMemory, compactAddressSpace);
 }
 
 template <typename EntryT, typename RefT>
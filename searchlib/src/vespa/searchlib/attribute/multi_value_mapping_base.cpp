@@ -2,16 +2,20 @@
 
 #include "multi_value_mapping_base.h"
 #include <vespa/searchcommon/common/compaction_strategy.h>
+#include <algorithm>
 #include <cassert>
 
 namespace search::attribute {
 
 MultiValueMappingBase::MultiValueMappingBase(const vespalib::GrowStrategy &gs,
-                                             vespalib::GenerationHolder &genHolder)
-    : _indices(gs, genHolder),
+                                             vespalib::GenerationHolder &genHolder,
+                                             const vespalib::alloc::MemoryAllocator* memory_allocator)
+    : _indices(gs, genHolder, vespalib::alloc::Alloc::alloc_with_allocator(memory_allocator)),
       _totalValues(0u),
       _cachedArrayStoreMemoryUsage(),
-      _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32))
+      _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32)),
+      _compactionContext(),
+      _compactionPos(0)
 {
 }
 
@@ -74,9 +78,50 @@ MultiValueMappingBase::updateStat()
     return retval;
 }
 
+void
+MultiValueMappingBase::compactSlice(uint32_t maxEntries)
+{
+    uint32_t size = _indices.size();
+    uint32_t pos = std::min(_compactionPos, size);
+    uint32_t end = ((maxEntries == 0) || (size - pos <= maxEntries)) ? size : (pos + maxEntries);
+    if (end > pos) {
+        _compactionContext->compact(vespalib::ArrayRef<EntryRef>(&_indices[pos], end - pos));
+    }
+    _compactionPos = end;
+    if (end == size) {
+        _compactionContext.reset();
+        _compactionPos = 0;
+    }
+}
+
+void
+MultiValueMappingBase::compactWorst(bool compactMemory, bool compactAddressSpace)
+{
+    if (_compactionContext) {
+        compactSlice(0);
+    }
+    _compactionContext = startCompactWorst(compactMemory, compactAddressSpace);
+    _compactionPos = 0;
+    compactSlice(0);
+}
+
+bool
+MultiValueMappingBase::finishCompact()
+{
+    if (!_compactionContext) {
+        return false;
+    }
+    compactSlice(0);
+    return true;
+}
+
 bool
 MultiValueMappingBase::considerCompact(const CompactionStrategy &compactionStrategy)
 {
+    if (_compactionContext) {
+        compactSlice(compactionStrategy.getMaxCompactEntriesPerSlice());
+        return true;
+    }
     size_t usedBytes = _cachedArrayStoreMemoryUsage.usedBytes();
     size_t deadBytes = _cachedArrayStoreMemoryUsage.deadBytes();
     size_t usedArrays = _cachedArrayStoreAddressSpaceUsage.used();
@@ -84,7 +129,9 @@ MultiValueMappingBase::considerCompact(const CompactionStrategy &compactionStrat
     bool compactMemory = compactionStrategy.should_compact_memory(usedBytes, deadBytes);
     bool compactAddressSpace = compactionStrategy.should_compact_address_space(usedArrays, deadArrays);
     if (compactMemory || compactAddressSpace) {
-        compactWorst(compactMemory, compactAddressSpace);
+        _compactionContext = startCompactWorst(compactMemory, compactAddressSpace);
+        _compactionPos = 0;
+        compactSlice(compactionStrategy.getMaxCompactEntriesPerSlice());
         return true;
     }
     return false;
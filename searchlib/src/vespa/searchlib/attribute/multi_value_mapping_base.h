@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/vespalib/datastore/entryref.h>
+#include <vespa/vespalib/datastore/i_compaction_context.h>
 #include <vespa/vespalib/util/address_space.h>
 #include <vespa/vespalib/util/rcuvector.h>
 #include <functional>
@@ -19,19 +20,26 @@ class MultiValueMappingBase
 public:
     using EntryRef = vespalib::datastore::EntryRef;
     using RefVector = vespalib::RcuVectorBase<EntryRef>;
+    using ICompactionContext = vespalib::datastore::ICompactionContext;
 
 protected:
     RefVector _indices;
     size_t    _totalValues;
     vespalib::MemoryUsage _cachedArrayStoreMemoryUsage;
     vespalib::AddressSpace _cachedArrayStoreAddressSpaceUsage;
+    // Pending incremental compaction, must be reset by subclass before the array store is destroyed
+    ICompactionContext::UP _compactionContext;
+    uint32_t  _compactionPos;
 
-    MultiValueMappingBase(const vespalib::GrowStrategy &gs, vespalib::GenerationHolder &genHolder);
+    MultiValueMappingBase(const vespalib::GrowStrategy &gs, vespalib::GenerationHolder &genHolder,
+                          const vespalib::alloc::MemoryAllocator* memory_allocator);
     virtual ~MultiValueMappingBase();
 
     void updateValueCount(size_t oldValues, size_t newValues) {
         _totalValues += newValues - oldValues;
     }
+    virtual ICompactionContext::UP startCompactWorst(bool compactMemory, bool compactAddressSpace) = 0;
+    void compactSlice(uint32_t maxEntries);
 public:
     using RefCopyVector = vespalib::Array<EntryRef>;
 
@@ -51,8 +59,20 @@ public:
 
     uint32_t getNumKeys() const { return _indices.size(); }
     uint32_t getCapacityKeys() const { return _indices.capacity(); }
-    virtual void compactWorst(bool compatMemory, bool compactAddressSpace) = 0;
+    void compactWorst(bool compactMemory, bool compactAddressSpace);
+    bool isCompacting() const { return static_cast<bool>(_compactionContext); }
+    /**
+     * Starts compaction if the compaction strategy says so. If the strategy limits the number of
+     * entries per slice, the compaction is spread over several calls and each call continues the
+     * pending compaction. Returns true if any entries were moved (a new generation is needed).
+     */
     bool considerCompact(const CompactionStrategy &compactionStrategy);
+    /**
+     * Moves all remaining entries of a pending incremental compaction, releasing the compacted
+     * buffers. Used when the attribute is idle, so that a compaction does not wait for more feed
+     * to finish. Returns true if any entries were moved (a new generation is needed).
+     */
+    bool finishCompact();
 };
 
 }
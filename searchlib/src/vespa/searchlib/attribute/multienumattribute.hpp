@@ -161,6 +161,8 @@ template <typename B, typename M>
 void
 MultiValueEnumAttribute<B, M>::onCommit()
 {
+    // A commit without changes means that feed is idle, then any pending compaction is finished at once
+    bool idle = this->_changes.empty();
     // update enum store
     auto updater = this->_enumStore.make_batch_updater();
     this->insertNewUniqueValues(updater);
@@ -172,7 +174,9 @@ MultiValueEnumAttribute<B, M>::onCommit()
     this->freezeEnumDictionary();
     std::atomic_thread_fence(std::memory_order_release);
     this->removeAllOldGenerations();
-    if (this->_mvMapping.considerCompact(this->getConfig().getCompactionStrategy())) {
+    if ((idle && this->_mvMapping.finishCompact()) ||
+        this->_mvMapping.considerCompact(this->getConfig().getCompactionStrategy()))
+    {
         this->incGeneration();
         this->updateStat(true);
     }
@@ -53,6 +53,8 @@ template <typename B, typename M>
 void
 MultiValueNumericAttribute<B, M>::onCommit()
 {
+    // A commit without changes means that feed is idle, then any pending compaction is finished at once
+    bool idle = this->_changes.empty();
     DocumentValues docValues;
     this->applyAttributeChanges(docValues);
     {
@@ -67,7 +69,9 @@ MultiValueNumericAttribute<B, M>::onCommit()
     this->removeAllOldGenerations();
 
     this->_changes.clear();
-    if (this->_mvMapping.considerCompact(this->getConfig().getCompactionStrategy())) {
+    if ((idle && this->_mvMapping.finishCompact()) ||
+        this->_mvMapping.considerCompact(this->getConfig().getCompactionStrategy()))
+    {
         this->incGeneration();
         this->updateStat(true);
     }
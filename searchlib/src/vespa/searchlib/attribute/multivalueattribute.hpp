@@ -26,7 +26,8 @@ MultiValueAttribute(const vespalib::string &baseFileName,
                                                                multivalueattribute::SMALL_MEMORY_PAGE_SIZE,
                                                                8 * 1024,
                                                                cfg.getGrowStrategy().getMultiValueAllocGrowFactor(),
-                                                               multivalueattribute::enable_free_lists),
+                                                               multivalueattribute::enable_free_lists)
+                         .memory_allocator(cfg.get_memory_allocator()),
                  cfg.getGrowStrategy().to_generic_strategy())
 {
 }
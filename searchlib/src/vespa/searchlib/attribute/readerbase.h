@@ -45,6 +45,7 @@ public:
     const vespalib::GenericHeader &getDatHeader() const {
         return _datHeader;
     }
+    uint32_t getDatHeaderLen() const { return _datHeaderLen; }
 protected:
     std::unique_ptr<FastOS_FileInterface>  _datFile;
 private:
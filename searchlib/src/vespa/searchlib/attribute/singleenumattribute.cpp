@@ -18,7 +18,8 @@ SingleValueEnumAttributeBase(const Config & c, GenerationHolder &genHolder)
     : _enumIndices(c.getGrowStrategy().getDocsInitialCapacity(),
                    c.getGrowStrategy().getDocsGrowPercent(),
                    c.getGrowStrategy().getDocsGrowDelta(),
-                   genHolder)
+                   genHolder,
+                   vespalib::alloc::Alloc::alloc_with_allocator(c.get_memory_allocator()))
 {
 }
 
@@ -104,6 +104,7 @@ public:
     bool onLoad() override;
 
     bool onLoadEnumerated(ReaderBase &attrReader);
+    bool onLoadMapped(ReaderBase &attrReader, size_t sz);
 
     AttributeVector::SearchContext::UP
     getSearch(std::unique_ptr<QueryTermSimple> term, const attribute::SearchContextParams & params) const override;
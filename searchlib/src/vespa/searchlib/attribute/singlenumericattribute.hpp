@@ -19,7 +19,8 @@ SingleValueNumericAttribute(const vespalib::string & baseFileName, const Attribu
     _data(c.getGrowStrategy().getDocsInitialCapacity(),
           c.getGrowStrategy().getDocsGrowPercent(),
           c.getGrowStrategy().getDocsGrowDelta(),
-          getGenerationHolder())
+          getGenerationHolder(),
+          vespalib::alloc::Alloc::alloc_with_allocator(c.get_memory_allocator()))
 { }
 
 template <typename B>
@@ -124,6 +125,21 @@ SingleValueNumericAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
 }
 
 
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::onLoadMapped(ReaderBase &attrReader, size_t sz)
+{
+    if (sz == 0) {
+        return false;
+    }
+    auto buf = attribute::LoadUtils::mapDAT(*this, attrReader.getDatHeaderLen(), sz * sizeof(T));
+    if (buf.get() == nullptr) {
+        return false;
+    }
+    _data.replaceVector(std::make_unique<vespalib::Array<T>>(std::move(buf), sz));
+    return true;
+}
+
 template <typename B>
 bool
 SingleValueNumericAttribute<B>::onLoad()
@@ -142,9 +158,11 @@ SingleValueNumericAttribute<B>::onLoad()
     const size_t sz(attrReader.getDataCount());
     getGenerationHolder().clearHoldLists();
     _data.reset();
-    _data.unsafe_reserve(sz);
-    for (uint32_t i = 0; i < sz; ++i) {
-        _data.push_back(attrReader.getNextData());
+    if (!(this->load_mapped() && onLoadMapped(attrReader, sz))) {
+        _data.unsafe_reserve(sz);
+        for (uint32_t i = 0; i < sz; ++i) {
+            _data.push_back(attrReader.getNextData());
+        }
     }
 
     B::setNumDocs(sz);
@@ -93,7 +93,7 @@ public:
 class TuneFileRandRead
 {
 public:
-    enum TuneControl { NORMAL, DIRECTIO, MMAP };
+    enum TuneControl { NORMAL, DIRECTIO, MMAP, ASYNCIO };
 private:
     TuneControl _tuneControl;
     int         _mmapFlags;
@@ -109,8 +109,10 @@ public:
     void setWantMemoryMap() { _tuneControl = MMAP; }
     void setWantDirectIO()  { _tuneControl = DIRECTIO; }
     void setWantNormal()    { _tuneControl = NORMAL; }
+    void setWantAsyncIO()   { _tuneControl = ASYNCIO; }
     bool getWantDirectIO()   const { return _tuneControl == DIRECTIO; }
     bool getWantMemoryMap()  const { return _tuneControl == MMAP; }
+    bool getWantAsyncIO()    const { return _tuneControl == ASYNCIO; }
     int  getMemoryMapFlags() const { return _mmapFlags; }
     int  getAdvise()         const { return _advise; }
 
@@ -190,22 +192,56 @@ public:
 };
 
 
+/**
+ * Controls how attribute vectors are read from disk when loaded.
+ */
+class TuneFileAttributeLoad
+{
+public:
+    enum TuneControl { NORMAL, MMAP };
+private:
+    TuneControl _tuneControl;
+public:
+    TuneFileAttributeLoad() noexcept : _tuneControl(NORMAL) { }
+    void setWantMemoryMap() { _tuneControl = MMAP; }
+    bool getWantMemoryMap() const { return _tuneControl == MMAP; }
+
+    template <typename Config>
+    void setFromConfig(const enum Config::Io &config) {
+        switch (config) {
+        case Config::Io::MMAP:
+            _tuneControl = MMAP;
+            break;
+        default:
+            _tuneControl = NORMAL;
+            break;
+        }
+    }
+
+    bool operator==(const TuneFileAttributeLoad &rhs) const { return _tuneControl == rhs._tuneControl; }
+    bool operator!=(const TuneFileAttributeLoad &rhs) const { return _tuneControl != rhs._tuneControl; }
+};
+
+
 /**
  * Controls file access for writing attributes to disk.
  */
 class TuneFileAttributes
 {
 public:
-    TuneFileSeqWrite _write;
+    TuneFileSeqWrite      _write;
+    TuneFileAttributeLoad _load;
 
-    TuneFileAttributes() noexcept : _write() { }
+    TuneFileAttributes() noexcept : _write(), _load() { }
 
     bool operator==(const TuneFileAttributes &rhs) const {
-        return _write == rhs._write;
+        return _write == rhs._write &&
+                _load == rhs._load;
     }
 
     bool operator!=(const TuneFileAttributes &rhs) const {
-        return _write != rhs._write;
+        return _write != rhs._write ||
+                _load != rhs._load;
     }
 };
 
@@ -269,6 +269,9 @@ FileChunk::enableRead()
             LOG(debug, "enableRead(): MMapRandReadDynamic: file='%s'", _dataFileName.c_str());
             _file = std::make_unique<MMapRandReadDynamic>(_dataFileName, mmapFlags, fadviseOptions);
         }
+    } else if (_tune._randRead.getWantAsyncIO()) {
+        LOG(debug, "enableRead(): AsyncIORandRead: file='%s'", _dataFileName.c_str());
+        _file = std::make_unique<AsyncIORandRead>(_dataFileName);
     } else {
         LOG(debug, "enableRead(): NormalRandRead: file='%s'", _dataFileName.c_str());
         _file = std::make_unique<NormalRandRead>(_dataFileName);
@@ -367,19 +370,37 @@ void
 FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const
 {
     if (count == 0) { return; }
+    // Group lids by chunk and fetch all chunks as one batch, so that readers
+    // able to do asynchronous io get all of them in flight at once.
+    std::vector<std::pair<uint32_t, uint32_t>> groups;
     uint32_t prevChunk = begin->getChunkId();
     uint32_t start(0);
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         if (li.getChunkId() != prevChunk) {
-            ChunkInfo ci = _chunkInfo[prevChunk];
-            read(begin + start, i - start, ci, visitor);
+            groups.emplace_back(start, i - start);
             prevChunk = li.getChunkId();
             start = i;
         }
     }
-    ChunkInfo ci = _chunkInfo[prevChunk];
-    read(begin + start, count - start, ci, visitor);
+    groups.emplace_back(start, count - start);
+    if (groups.size() == 1) {
+        read(begin, count, _chunkInfo[prevChunk], visitor);
+        return;
+    }
+    std::vector<vespalib::DataBuffer> buffers;
+    std::vector<FileRandRead::Request> requests;
+    buffers.reserve(groups.size());
+    requests.reserve(groups.size());
+    for (const auto & group : groups) {
+        const ChunkInfo & ci = _chunkInfo[(begin + group.first)->getChunkId()];
+        buffers.emplace_back(0ul, ALIGNMENT);
+        requests.emplace_back(ci.getOffset(), ci.getSize(), buffers.back());
+    }
+    _file->readBatch(requests.data(), requests.size());
+    for (size_t g(0); g < groups.size(); g++) {
+        visit(begin + groups[g].first, groups[g].second, buffers[g], visitor);
+    }
 }
 
 void
@@ -387,6 +408,13 @@ FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo c
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive = _file->read(ci.getOffset(), whole, ci.getSize());
+    visit(begin, count, whole, visitor);
+}
+
+void
+FileChunk::visit(LidInfoWithLidV::const_iterator begin, size_t count, const vespalib::DataBuffer & whole,
+                 IBufferVisitor & visitor) const
+{
     Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen(), _skipCrcOnRead);
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
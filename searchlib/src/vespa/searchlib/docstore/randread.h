@@ -16,8 +16,30 @@ class FileRandRead
 {
 public:
     typedef std::shared_ptr<FastOS_FileInterface> FSP;
+    /**
+     * One read in a batch. The buffer is filled as with a single read,
+     * and keepAlive must be held as long as the buffer is in use.
+     */
+    struct Request {
+        size_t                 offset;
+        size_t                 sz;
+        vespalib::DataBuffer * buffer;
+        FSP                    keepAlive;
+        Request(size_t offset_in, size_t sz_in, vespalib::DataBuffer & buffer_in)
+            : offset(offset_in), sz(sz_in), buffer(&buffer_in), keepAlive()
+        { }
+    };
     virtual ~FileRandRead() { }
     virtual FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) = 0;
+    /**
+     * Perform a batch of reads. Implementations able to keep several
+     * reads in flight at once override this, the default reads them one by one.
+     */
+    virtual void readBatch(Request * requests, size_t count) {
+        for (size_t i(0); i < count; i++) {
+            requests[i].keepAlive = read(requests[i].offset, *requests[i].buffer, requests[i].sz);
+        }
+    }
     virtual int64_t getSize() = 0;
 };
 
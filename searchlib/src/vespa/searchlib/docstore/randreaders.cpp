@@ -3,7 +3,12 @@
 #include "randreaders.h"
 #include "summaryexceptions.h"
 #include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/io/batch_pread.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/fastos/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".search.docstore.randreaders");
@@ -167,4 +172,60 @@ NormalRandRead::getSize()
     return _file->GetSize();
 }
 
+AsyncIORandRead::AsyncIORandRead(const vespalib::string & fileName)
+    : _file(std::make_unique<FastOS_File>(fileName.c_str())),
+      _fd(-1)
+{
+    if ( ! _file->OpenReadOnly()) {
+        throw SummaryException("Failed opening data file", *_file, VESPA_STRLOC);
+    }
+    _fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (_fd < 0) {
+        throw SummaryException("Failed opening data file for async io", *_file, VESPA_STRLOC);
+    }
+}
+
+AsyncIORandRead::~AsyncIORandRead()
+{
+    ::close(_fd);
+}
+
+FileRandRead::FSP
+AsyncIORandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
+{
+    buffer.clear();
+    buffer.ensureFree(sz);
+    _file->ReadBuf(buffer.getFree(), sz, offset);
+    buffer.moveFreeToData(sz);
+    return FSP();
+}
+
+void
+AsyncIORandRead::readBatch(Request * requests, size_t count)
+{
+    std::vector<vespalib::BatchPRead::Request> batch;
+    batch.reserve(count);
+    for (size_t i(0); i < count; i++) {
+        vespalib::DataBuffer & buffer = *requests[i].buffer;
+        buffer.clear();
+        buffer.ensureFree(requests[i].sz);
+        batch.emplace_back(_fd, buffer.getFree(), requests[i].sz, requests[i].offset);
+    }
+    vespalib::BatchPRead::read(batch.data(), batch.size());
+    for (size_t i(0); i < count; i++) {
+        if (batch[i].result != ssize_t(requests[i].sz)) {
+            throw std::runtime_error(vespalib::make_string("Fatal: Reading %zu bytes at offset %zu, got %zd from '%s'",
+                                                           requests[i].sz, requests[i].offset,
+                                                           batch[i].result, _file->GetFileName()));
+        }
+        requests[i].buffer->moveFreeToData(requests[i].sz);
+    }
+}
+
+int64_t
+AsyncIORandRead::getSize()
+{
+    return _file->GetSize();
+}
+
 }
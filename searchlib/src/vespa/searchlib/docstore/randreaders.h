@@ -50,6 +50,23 @@ private:
     std::mutex                                _lock;
 };
 
+/**
+ * Reads with pread, but submits batched reads so that all of them are in
+ * flight at the same time (io_uring, or a thread pool when not available).
+ */
+class AsyncIORandRead : public FileRandRead
+{
+public:
+    AsyncIORandRead(const vespalib::string & fileName);
+    ~AsyncIORandRead() override;
+    FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    void readBatch(Request * requests, size_t count) override;
+    int64_t getSize() override;
+private:
+    std::unique_ptr<FastOS_FileInterface>  _file;
+    int                                    _fd;
+};
+
 class NormalRandRead : public FileRandRead
 {
 public:
@@ -4,9 +4,11 @@
 #include <vespa/searchlib/fef/properties.h>
 #include <vespa/searchlib/fef/onnx_model.h>
 #include <vespa/searchlib/fef/featureexecutor.h>
+#include <vespa/eval/eval/cell_type.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/stash.h>
+#include <cstring>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".features.onnx_feature");
@@ -18,6 +20,9 @@ using search::fef::IIndexEnvironment;
 using search::fef::IQueryEnvironment;
 using search::fef::ParameterList;
 using vespalib::Stash;
+using vespalib::eval::CellTypeUtils;
+using vespalib::eval::DenseValueView;
+using vespalib::eval::TypedCells;
 using vespalib::eval::ValueType;
 using vespalib::make_string_short::fmt;
 using vespalib::eval::Onnx;
@@ -44,33 +49,144 @@ vespalib::string normalize_name(const vespalib::string &name, const char *contex
 }
 
 /**
- * Feature executor that evaluates an onnx model
+ * Feature executor that evaluates an onnx model. If the model has a
+ * batch dimension, the inputs of multiple documents may be collected
+ * and evaluated with a single model run. The outputs for each
+ * document are then views into the batch results.
  */
 class OnnxFeatureExecutor : public FeatureExecutor
 {
 private:
-    Onnx::EvalContext _eval_context;
+    const Onnx                         &_model;
+    const Onnx::WireInfo               &_wire_info;
+    const Onnx::BatchPlanner           *_batch_planner;
+    Onnx::EvalContext                   _eval_context;
+    std::vector<uint32_t>               _batch_docs;
+    std::vector<std::vector<char>>      _batch_cells;
+    bool                                _batch_shared_ok;
+    bool                                _batch_done;
+    size_t                              _batch_pos;
+    size_t                              _batch_context_size;
+    std::unique_ptr<Onnx::WireInfo>     _batch_wire_info;
+    std::unique_ptr<Onnx::EvalContext>  _batch_context;
+    std::vector<DenseValueView>         _doc_results;
+
+    void reset_batch() {
+        _batch_docs.clear();
+        for (auto &cells: _batch_cells) {
+            cells.clear();
+        }
+        _batch_shared_ok = true;
+        _batch_done = false;
+        _batch_pos = 0;
+    }
+
+    bool find_in_batch(uint32_t docid) {
+        if (!_batch_done) {
+            return false;
+        }
+        while ((_batch_pos < _batch_docs.size()) && (_batch_docs[_batch_pos] < docid)) {
+            ++_batch_pos;
+        }
+        return ((_batch_pos < _batch_docs.size()) && (_batch_docs[_batch_pos] == docid));
+    }
+
+    void prepare_batch_context(size_t batch_size) {
+        if (_batch_context && (_batch_context_size == batch_size)) {
+            return;
+        }
+        _batch_context.reset();
+        _batch_wire_info = std::make_unique<Onnx::WireInfo>(_batch_planner->get_wire_info(batch_size));
+        _batch_context = std::make_unique<Onnx::EvalContext>(_model, *_batch_wire_info);
+        _batch_context_size = batch_size;
+    }
+
 public:
-    OnnxFeatureExecutor(const Onnx &model, const Onnx::WireInfo &wire_info)
-        : _eval_context(model, wire_info) {}
+    OnnxFeatureExecutor(const Onnx &model, const Onnx::WireInfo &wire_info, const Onnx::BatchPlanner *batch_planner)
+        : _model(model),
+          _wire_info(wire_info),
+          _batch_planner(batch_planner),
+          _eval_context(model, wire_info),
+          _batch_docs(),
+          _batch_cells(wire_info.vespa_inputs.size()),
+          _batch_shared_ok(true),
+          _batch_done(false),
+          _batch_pos(0),
+          _batch_context_size(0),
+          _batch_wire_info(),
+          _batch_context(),
+          _doc_results()
+    {
+        _doc_results.reserve(wire_info.vespa_outputs.size());
+    }
     bool isPure() override { return true; }
+    bool supports_batch() override { return (_batch_planner != nullptr); }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject>) override {
         for (size_t i = 0; i < _eval_context.num_results(); ++i) {
             outputs().set_object(i, _eval_context.get_result(i));
         }
     }
-    void execute(uint32_t) override {
+    void handle_add_to_batch(uint32_t docid) override {
+        if (_batch_done) {
+            reset_batch();
+        }
+        bool first = _batch_docs.empty();
+        for (size_t i = 0; i < _eval_context.num_params(); ++i) {
+            auto cells = inputs().get_object(i).get().cells();
+            const char *src = static_cast<const char *>(cells.data);
+            size_t size = CellTypeUtils::mem_size(cells.type, cells.size);
+            auto &dst = _batch_cells[i];
+            if (first || _batch_planner->is_batched_input(i)) {
+                dst.insert(dst.end(), src, src + size);
+            } else if ((dst.size() != size) || (memcmp(dst.data(), src, size) != 0)) {
+                // inputs without batch dimension must be the same for all documents
+                _batch_shared_ok = false;
+            }
+        }
+        _batch_docs.push_back(docid);
+    }
+    void handle_evaluate_batch() override {
+        _batch_done = true;
+        if (!_batch_shared_ok || (_batch_docs.size() < 2)) {
+            _batch_docs.clear();
+            return;
+        }
+        prepare_batch_context(_batch_docs.size());
+        for (size_t i = 0; i < _batch_context->num_params(); ++i) {
+            const auto &type = _batch_wire_info->vespa_inputs[i];
+            DenseValueView param(type, TypedCells(_batch_cells[i].data(), type.cell_type(), type.dense_subspace_size()));
+            _batch_context->bind_param(i, param);
+        }
+        _batch_context->eval();
+    }
+    void execute(uint32_t docid) override {
+        if (find_in_batch(docid)) {
+            _doc_results.clear();
+            for (size_t i = 0; i < _batch_context->num_results(); ++i) {
+                const auto &type = _wire_info.vespa_outputs[i];
+                auto cells = _batch_context->get_result(i).cells();
+                size_t size = type.dense_subspace_size();
+                const char *data = static_cast<const char *>(cells.data) + CellTypeUtils::mem_size(cells.type, _batch_pos * size);
+                _doc_results.emplace_back(type, TypedCells(data, cells.type, size));
+                outputs().set_object(i, _doc_results.back());
+            }
+            return;
+        }
         for (size_t i = 0; i < _eval_context.num_params(); ++i) {
             _eval_context.bind_param(i, inputs().get_object(i).get());
         }
         _eval_context.eval();
+        if (_batch_done) {
+            handle_bind_outputs(outputs().get_bound());
+        }
     }
 };
 
 OnnxBlueprint::OnnxBlueprint()
     : Blueprint("onnxModel"),
       _model(nullptr),
-      _wire_info()
+      _wire_info(),
+      _batch_planner()
 {
 }
 
@@ -126,6 +242,10 @@ OnnxBlueprint::setup(const IIndexEnvironment &env,
         describeOutput(output_name.value(), "output from onnx model", FeatureType::object(output_type));
     }
     _wire_info = planner.get_wire_info(*_model);
+    auto batch_planner = std::make_unique<Onnx::BatchPlanner>(*_model, _wire_info);
+    if (batch_planner->can_batch()) {
+        _batch_planner = std::move(batch_planner);
+    }
     return true;
 }
 
@@ -133,7 +253,7 @@ FeatureExecutor &
 OnnxBlueprint::createExecutor(const IQueryEnvironment &, Stash &stash) const
 {
     assert(_model);
-    return stash.create<OnnxFeatureExecutor>(*_model, _wire_info);
+    return stash.create<OnnxFeatureExecutor>(*_model, _wire_info, _batch_planner.get());
 }
 
 }
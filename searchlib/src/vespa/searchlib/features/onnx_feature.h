@@ -15,6 +15,7 @@ private:
     using Onnx = vespalib::eval::Onnx;
     std::unique_ptr<Onnx> _model;
     Onnx::WireInfo _wire_info;
+    std::unique_ptr<Onnx::BatchPlanner> _batch_planner;
 public:
     OnnxBlueprint();
     ~OnnxBlueprint() override;
@@ -7,6 +7,7 @@
 #include <vespa/searchlib/features/rankingexpression/feature_name_extractor.h>
 #include <vespa/eval/eval/param_usage.h>
 #include <vespa/eval/eval/fast_value.h>
+#include <algorithm>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".features.rankingexpression");
@@ -44,7 +45,10 @@ vespalib::string list_issues(const std::vector<vespalib::string> &issues) {
 //-----------------------------------------------------------------------------
 
 /**
- * Implements the executor for fast forest gbdt evaluation
+ * Implements the executor for fast forest gbdt evaluation. When
+ * re-ranking, the inputs of multiple documents are collected and the
+ * forest is evaluated for up to FastForest::max_batch_size documents
+ * at a time.
  **/
 class FastForestExecutor : public fef::FeatureExecutor
 {
@@ -52,10 +56,23 @@ private:
     const FastForest &_forest;
     FastForest::Context::UP _ctx;
     ArrayRef<float> _params;
+    std::vector<uint32_t> _batch_docs;
+    std::vector<float> _batch_params;
+    std::vector<float> _chunk_params;
+    std::vector<double> _batch_results;
+    bool _batch_done;
+    size_t _batch_pos;
+
+    void reset_batch();
+    bool find_in_batch(uint32_t docid);
+    void read_params(float *dst);
 
 public:
     FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest);
     bool isPure() override { return true; }
+    bool supports_batch() override { return true; }
+    void handle_add_to_batch(uint32_t docid) override;
+    void handle_evaluate_batch() override;
     void execute(uint32_t docId) override;
 };
 
@@ -132,23 +149,94 @@ public:
 FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest)
     : _forest(forest),
       _ctx(_forest.create_context()),
-      _params(param_space)
+      _params(param_space),
+      _batch_docs(),
+      _batch_params(),
+      _chunk_params(),
+      _batch_results(),
+      _batch_done(false),
+      _batch_pos(0)
 {
 }
 
 void
-FastForestExecutor::execute(uint32_t)
+FastForestExecutor::reset_batch()
+{
+    _batch_docs.clear();
+    _batch_params.clear();
+    _batch_results.clear();
+    _batch_done = false;
+    _batch_pos = 0;
+}
+
+bool
+FastForestExecutor::find_in_batch(uint32_t docid)
+{
+    if (!_batch_done) {
+        return false;
+    }
+    while ((_batch_pos < _batch_docs.size()) && (_batch_docs[_batch_pos] < docid)) {
+        ++_batch_pos;
+    }
+    return ((_batch_pos < _batch_docs.size()) && (_batch_docs[_batch_pos] == docid));
+}
+
+void
+FastForestExecutor::read_params(float *dst)
 {
     size_t i = 0;
     for (; (i + 3) < _params.size(); i += 4) {
-        _params[i+0] = inputs().get_number(i+0);
-        _params[i+1] = inputs().get_number(i+1);
-        _params[i+2] = inputs().get_number(i+2);
-        _params[i+3] = inputs().get_number(i+3);
+        dst[i+0] = inputs().get_number(i+0);
+        dst[i+1] = inputs().get_number(i+1);
+        dst[i+2] = inputs().get_number(i+2);
+        dst[i+3] = inputs().get_number(i+3);
     }
     for (; i < _params.size(); ++i) {
-        _params[i] = inputs().get_number(i);
+        dst[i] = inputs().get_number(i);
+    }
+}
+
+void
+FastForestExecutor::handle_add_to_batch(uint32_t docid)
+{
+    if (_batch_done) {
+        reset_batch();
+    }
+    size_t offset = _batch_params.size();
+    _batch_params.resize(offset + _params.size());
+    read_params(&_batch_params[offset]);
+    _batch_docs.push_back(docid);
+}
+
+void
+FastForestExecutor::handle_evaluate_batch()
+{
+    _batch_done = true;
+    size_t num_params = _params.size();
+    size_t num_docs = _batch_docs.size();
+    _batch_results.resize(num_docs);
+    for (size_t first = 0; first < num_docs; first += FastForest::max_batch_size) {
+        size_t n = std::min(num_docs - first, FastForest::max_batch_size);
+        // eval_batch wants the parameters column-major
+        _chunk_params.resize(num_params * n);
+        for (size_t d = 0; d < n; ++d) {
+            const float *src = &_batch_params[(first + d) * num_params];
+            for (size_t p = 0; p < num_params; ++p) {
+                _chunk_params[p * n + d] = src[p];
+            }
+        }
+        _forest.eval_batch(*_ctx, _chunk_params.data(), n, &_batch_results[first]);
+    }
+}
+
+void
+FastForestExecutor::execute(uint32_t docid)
+{
+    if (find_in_batch(docid)) {
+        outputs().set_number(0, _batch_results[_batch_pos]);
+        return;
     }
+    read_params(&_params[0]);
     outputs().set_number(0, _forest.eval(*_ctx, &_params[0]));
 }
 
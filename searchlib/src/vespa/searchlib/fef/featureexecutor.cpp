@@ -20,6 +20,22 @@ FeatureExecutor::isPure()
     return false;
 }
 
+bool
+FeatureExecutor::supports_batch()
+{
+    return false;
+}
+
+void
+FeatureExecutor::handle_add_to_batch(uint32_t)
+{
+}
+
+void
+FeatureExecutor::handle_evaluate_batch()
+{
+}
+
 void
 FeatureExecutor::handle_bind_inputs(vespalib::ConstArrayRef<LazyValue>)
 {
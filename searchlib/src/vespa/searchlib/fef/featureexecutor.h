@@ -110,6 +110,24 @@ protected:
      **/
     virtual void execute(uint32_t docId) = 0;
 
+    /**
+     * Collect the inputs for the given document into the pending
+     * batch. Only called for executors supporting batch evaluation.
+     * The inputs of this executor are available for the given
+     * document while this function is running.
+     *
+     * @param docid the local document id being collected
+     **/
+    virtual void handle_add_to_batch(uint32_t docid);
+
+    /**
+     * Evaluate all documents collected into the pending batch at
+     * once. The results are kept until the next batch is started and
+     * are picked up when this executor is later executed for each of
+     * the collected documents.
+     **/
+    virtual void handle_evaluate_batch();
+
 public:
     /**
      * Create a feature executor that has not yet been bound to neither
@@ -150,6 +168,37 @@ public:
      **/
     virtual bool isPure();
 
+    /**
+     * Check if this feature executor is able to evaluate multiple
+     * documents at once. This is typically the case for executors
+     * where the per-call overhead dominates (like onnx models), and
+     * is used when re-ranking a set of hits to first collect the
+     * inputs of all hits (see @ref add_to_batch), then evaluate them
+     * together (see @ref evaluate_batch) before each hit is
+     * executed as normal. This method returns false by default.
+     *
+     * @return true if this feature executor supports batch evaluation
+     **/
+    virtual bool supports_batch();
+
+    /**
+     * Add the given document to the pending batch of documents to be
+     * evaluated together.
+     *
+     * @param docid the local document id to collect inputs for
+     **/
+    void add_to_batch(uint32_t docid) {
+        _inputs.set_docid(docid);
+        handle_add_to_batch(docid);
+        // make sure the document is executed (using batch results) later
+        _inputs.set_docid(-1);
+    }
+
+    /**
+     * Evaluate all documents in the pending batch.
+     **/
+    void evaluate_batch() { handle_evaluate_batch(); }
+
     /**
      * Make sure this executor has been executed for the given
      * document.
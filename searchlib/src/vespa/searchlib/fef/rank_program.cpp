@@ -161,6 +161,7 @@ RankProgram::RankProgram(BlueprintResolver::SP resolver)
       _hot_stash(32_Ki),
       _cold_stash(),
       _executors(),
+      _batch_executors(),
       _unboxed_seeds(),
       _is_const()
 {
@@ -203,9 +204,11 @@ RankProgram::setup(const MatchData &md,
                 inputs[input_idx] = LazyValue(input_value, input_executor);
             }
         }
+        bool is_overridden = false;
         for (; (override < override_end) && (override->ref.executor == i); ++override) {
             FeatureExecutor *tmp = executor;
             executor = &(stash.get().create<FeatureOverrider>(*tmp, override->ref.output, override->value));
+            is_overridden = true;
         }
         executor->bind_inputs(inputs);
         executor->bind_outputs(outputs);
@@ -213,6 +216,8 @@ RankProgram::setup(const MatchData &md,
         _executors.push_back(executor);
         if (is_const) {
             run_const(executor);
+        } else if (!is_overridden && executor->supports_batch()) {
+            _batch_executors.push_back(executor);
         }
     }
     for (const auto &seed_entry: _resolver->getSeedMap()) {
@@ -240,6 +245,22 @@ RankProgram::setup(const MatchData &md,
     }
 }
 
+void
+RankProgram::add_to_batch(uint32_t docid)
+{
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->add_to_batch(docid);
+    }
+}
+
+void
+RankProgram::evaluate_batch()
+{
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->evaluate_batch();
+    }
+}
+
 FeatureResolver
 RankProgram::get_seeds(bool unbox_seeds) const
 {
@@ -23,8 +23,11 @@ namespace search::fef {
  * that you need unpack any relevant posting information into the
  * MatchData object passed to the setup function before trying to
  * resolve lazy values.
+ *
+ * Rank programs created while a vespalib::StashScope is active are
+ * allocated in the bound stash (see vespalib::StashAllocated).
  **/
-class RankProgram
+class RankProgram : public vespalib::StashAllocated
 {
 private:
     RankProgram(const RankProgram &) = delete;
@@ -38,6 +41,7 @@ private:
     vespalib::Stash                  _hot_stash;
     vespalib::Stash                  _cold_stash;
     std::vector<FeatureExecutor *>   _executors;
+    std::vector<FeatureExecutor *>   _batch_executors;
     MappedValues                     _unboxed_seeds;
     ValueSet                         _is_const;
 
@@ -61,6 +65,19 @@ public:
     size_t num_executors() const { return _executors.size(); }
     const FeatureExecutor &get_executor(size_t i) const { return *_executors[i]; }
 
+    /**
+     * Check if any of the executors in this program is able to
+     * evaluate multiple documents at once. If so, the documents to
+     * be evaluated may be added to a batch (in increasing docid
+     * order, with match data unpacked for each document) and the
+     * batch evaluated before the features are resolved for each
+     * document (in increasing docid order, with match data unpacked
+     * again).
+     **/
+    bool has_batch_executors() const { return !_batch_executors.empty(); }
+    void add_to_batch(uint32_t docid);
+    void evaluate_batch();
+
     /**
      * Set up this rank program by creating the needed feature
      * executors and wiring them together. This function will also
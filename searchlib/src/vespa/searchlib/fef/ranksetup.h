@@ -403,7 +403,9 @@ public:
     // These functions create rank programs for different tasks. Note
     // that the setup function must be called on rank programs for
     // them to be ready to use. Also keep in mind that creating a rank
-    // program is cheap while setting it up is more expensive.
+    // program is cheap while setting it up is more expensive. Rank
+    // programs created while a vespalib::StashScope is active are
+    // allocated in the bound stash and must not outlive it.
 
     RankProgram::UP create_first_phase_program() const { return std::make_unique<RankProgram>(_first_phase_resolver); }
     RankProgram::UP create_second_phase_program() const { return std::make_unique<RankProgram>(_second_phase_resolver); }
@@ -4,6 +4,7 @@
 #include <vespa/searchlib/aggregation/groupinglevel.h>
 #include <vespa/searchlib/grouping/collect.h>
 #include <vespa/vespalib/util/sort.h>
+#include <vespa/vespalib/stllike/hash_set.h>
 
 namespace search::grouping {
 
@@ -45,7 +45,14 @@ FieldIndex<interleaved_features>::FieldIndex(const index::Schema& schema, uint32
 template <bool interleaved_features>
 FieldIndex<interleaved_features>::FieldIndex(const index::Schema& schema, uint32_t fieldId,
                                              const index::FieldLengthInfo& info)
-    : FieldIndexBase(schema, fieldId, info),
+    : FieldIndex(schema, fieldId, info, false)
+{
+}
+
+template <bool interleaved_features>
+FieldIndex<interleaved_features>::FieldIndex(const index::Schema& schema, uint32_t fieldId,
+                                             const index::FieldLengthInfo& info, bool hash_dictionary)
+    : FieldIndexBase(schema, fieldId, info, hash_dictionary),
       _postingListStore()
 {
     using InserterType = OrderedFieldIndexInserter<interleaved_features>;
@@ -60,6 +67,14 @@ FieldIndex<interleaved_features>::~FieldIndex()
     _dict.disableFreeLists();
     _dict.disableElemHoldList();
     // XXX: Kludge
+    if (_hash_dict) {
+        _hash_dict->normalize_values([this](EntryRef pidx) {
+            if (pidx.valid()) {
+                _postingListStore.clear(pidx);
+            }
+            return EntryRef();
+        });
+    }
     for (DictionaryTree::Iterator it = _dict.begin();
          it.valid(); ++it) {
         EntryRef pidx(it.getData());
@@ -80,10 +95,30 @@ FieldIndex<interleaved_features>::~FieldIndex()
     trimHoldLists();
 }
 
+template <bool interleaved_features>
+EntryRef
+FieldIndex<interleaved_features>::getPostingListRef(const DictionaryTree::Iterator& itr) const
+{
+    if (_hash_dict) {
+        const HashDictionary& hash_dict = *_hash_dict;
+        auto kv = hash_dict.find(WordComparator(_wordStore), itr.getKey()._wordRef);
+        return (kv != nullptr) ? kv->second.load_relaxed() : EntryRef();
+    }
+    return EntryRef(itr.getData());
+}
+
 template <bool interleaved_features>
 typename FieldIndex<interleaved_features>::PostingList::Iterator
 FieldIndex<interleaved_features>::find(const vespalib::stringref word) const
 {
+    if (_hash_dict) {
+        const HashDictionary& hash_dict = *_hash_dict;
+        auto kv = hash_dict.find(WordComparator(_wordStore, word), EntryRef());
+        if (kv != nullptr) {
+            return _postingListStore.begin(kv->second.load_relaxed());
+        }
+        return typename PostingList::Iterator();
+    }
     DictionaryTree::Iterator itr = _dict.find(WordKey(EntryRef()), KeyComp(_wordStore, word));
     if (itr.valid()) {
         return _postingListStore.begin(EntryRef(itr.getData()));
@@ -95,6 +130,14 @@ template <bool interleaved_features>
 typename FieldIndex<interleaved_features>::PostingList::ConstIterator
 FieldIndex<interleaved_features>::findFrozen(const vespalib::stringref word) const
 {
+    if (_hash_dict) {
+        const HashDictionary& hash_dict = *_hash_dict;
+        auto kv = hash_dict.find(WordComparator(_wordStore, word), EntryRef());
+        if (kv != nullptr) {
+            return _postingListStore.beginFrozen(kv->second.load_acquire());
+        }
+        return typename PostingList::Iterator();
+    }
     auto itr = _dict.getFrozenView().find(WordKey(EntryRef()), KeyComp(_wordStore, word));
     if (itr.valid()) {
         return _postingListStore.beginFrozen(EntryRef(itr.getData()));
@@ -112,7 +155,7 @@ FieldIndex<interleaved_features>::compactFeatures()
     auto itr = _dict.begin();
     uint32_t packedIndex = _fieldId;
     for (; itr.valid(); ++itr) {
-        typename PostingListStore::RefType pidx(EntryRef(itr.getData()));
+        typename PostingListStore::RefType pidx(getPostingListRef(itr));
         if (!pidx.valid()) {
             continue;
         }
@@ -170,7 +213,7 @@ FieldIndex<interleaved_features>::dump(search::index::IndexBuilder & indexBuilde
     _featureStore.setupForField(_fieldId, decoder);
     for (auto itr = _dict.begin(); itr.valid(); ++itr) {
         const WordKey & wk = itr.getKey();
-        typename PostingListStore::RefType plist(EntryRef(itr.getData()));
+        typename PostingListStore::RefType plist(getPostingListRef(itr));
         word = _wordStore.getWord(wk._wordRef);
         if (!plist.valid()) {
             continue;
@@ -215,6 +258,9 @@ FieldIndex<interleaved_features>::getMemoryUsage() const
     vespalib::MemoryUsage usage;
     usage.merge(_wordStore.getMemoryUsage());
     usage.merge(_dict.getMemoryUsage());
+    if (_hash_dict) {
+        usage.merge(_hash_dict->get_memory_usage());
+    }
     usage.merge(_postingListStore.getMemoryUsage());
     usage.merge(_featureStore.getMemoryUsage());
     usage.merge(_remover.getStore().getMemoryUsage());
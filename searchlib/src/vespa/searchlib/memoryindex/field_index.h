@@ -21,6 +21,9 @@ class IOrderedFieldIndexInserter;
  * It consists of the following components:
  *   - WordStore containing all unique words in this field (across all documents).
  *   - B-Tree dictionary that maps from unique word (32-bit ref) -> posting list (32-bit ref).
+ *   - Optional hash dictionary that maps from unique word (32-bit ref) -> posting list (32-bit ref).
+ *     When enabled it owns the posting list refs and is used for exact word lookups,
+ *     while the B-Tree dictionary only keeps the words in sorted order.
  *   - B-Tree posting lists that maps from document id (32-bit) -> features (32-bit ref).
  *   - BTreeStore containing all the posting lists.
  *   - FeatureStore containing information on where a (word, document) pair matched this field.
@@ -57,6 +60,9 @@ private:
             _generationHandler.getFirstUsedGeneration();
         _postingListStore.trimHoldLists(usedGen);
         _dict.getAllocator().trimHoldLists(usedGen);
+        if (_hash_dict) {
+            _hash_dict->trim_hold_lists(usedGen);
+        }
         _featureStore.trimHoldLists(usedGen);
     }
 
@@ -65,6 +71,9 @@ private:
             _generationHandler.getCurrentGeneration();
         _postingListStore.transferHoldLists(generation);
         _dict.getAllocator().transferHoldLists(generation);
+        if (_hash_dict) {
+            _hash_dict->transfer_hold_lists(generation);
+        }
         _featureStore.transferHoldLists(generation);
     }
 
@@ -72,9 +81,13 @@ private:
         _generationHandler.incGeneration();
     }
 
+    vespalib::datastore::EntryRef getPostingListRef(const DictionaryTree::Iterator& itr) const;
+
 public:
     FieldIndex(const index::Schema& schema, uint32_t fieldId);
     FieldIndex(const index::Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info);
+    FieldIndex(const index::Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info,
+               bool hash_dictionary);
     ~FieldIndex();
 
     typename PostingList::Iterator find(const vespalib::stringref word) const;
@@ -3,6 +3,7 @@
 #include "field_index_base.h"
 #include "i_ordered_field_index_inserter.h"
 #include <vespa/vespalib/stllike/asciistream.h>
+#include <vespa/vespalib/stllike/hash_fun.h>
 
 namespace search::memoryindex {
 
@@ -13,6 +14,25 @@ operator<<(vespalib::asciistream& os, const FieldIndexBase::WordKey& rhs)
     return os;
 }
 
+bool
+FieldIndexBase::WordComparator::less(const vespalib::datastore::EntryRef lhs, const vespalib::datastore::EntryRef rhs) const
+{
+    return strcmp(getWord(lhs), getWord(rhs)) < 0;
+}
+
+bool
+FieldIndexBase::WordComparator::equal(const vespalib::datastore::EntryRef lhs, const vespalib::datastore::EntryRef rhs) const
+{
+    return strcmp(getWord(lhs), getWord(rhs)) == 0;
+}
+
+size_t
+FieldIndexBase::WordComparator::hash(const vespalib::datastore::EntryRef rhs) const
+{
+    vespalib::hash<const char *> hasher;
+    return hasher(getWord(rhs));
+}
+
 FieldIndexBase::FieldIndexBase(const index::Schema& schema, uint32_t fieldId)
     : FieldIndexBase(schema, fieldId, index::FieldLengthInfo())
 {
@@ -20,16 +40,26 @@ FieldIndexBase::FieldIndexBase(const index::Schema& schema, uint32_t fieldId)
 
 FieldIndexBase::FieldIndexBase(const index::Schema& schema, uint32_t fieldId,
                                const index::FieldLengthInfo& info)
+    : FieldIndexBase(schema, fieldId, info, false)
+{
+}
+
+FieldIndexBase::FieldIndexBase(const index::Schema& schema, uint32_t fieldId,
+                               const index::FieldLengthInfo& info, bool hash_dictionary)
     : _wordStore(),
       _numUniqueWords(0),
       _generationHandler(),
       _dict(),
+      _hash_dict(),
       _featureStore(schema),
       _fieldId(fieldId),
       _remover(_wordStore),
       _inserter(),
       _calculator(info)
 {
+    if (hash_dictionary) {
+        _hash_dict = std::make_unique<HashDictionary>(std::make_unique<WordComparator>(_wordStore));
+    }
 }
 
 FieldIndexBase::~FieldIndexBase() = default;
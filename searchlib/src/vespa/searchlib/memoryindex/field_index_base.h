@@ -11,6 +11,8 @@
 #include <vespa/vespalib/btree/btree.h>
 #include <vespa/vespalib/btree/btreenodeallocator.h>
 #include <vespa/vespalib/btree/btreeroot.h>
+#include <vespa/vespalib/datastore/entry_comparator.h>
+#include <vespa/vespalib/datastore/sharded_hash_map.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/memoryusage.h>
 
@@ -65,10 +67,44 @@ public:
         }
     };
 
+    /**
+     * Comparator class for words used in the hash dictionary.
+     *
+     * Valid entry ref is mapped to a word in the word store.
+     * Invalid entry ref is mapped to the word given to the constructor.
+     */
+    class WordComparator : public vespalib::datastore::EntryComparator {
+    private:
+        const WordStore& _wordStore;
+        const vespalib::stringref _word;
+
+        const char* getWord(vespalib::datastore::EntryRef wordRef) const {
+            if (wordRef.valid()) {
+                return _wordStore.getWord(wordRef);
+            }
+            return _word.data();
+        }
+
+    public:
+        WordComparator(const WordStore& wordStore)
+            : _wordStore(wordStore),
+              _word()
+        { }
+        WordComparator(const WordStore& wordStore, const vespalib::stringref word)
+            : _wordStore(wordStore),
+              _word(word)
+        { }
+
+        bool less(const vespalib::datastore::EntryRef lhs, const vespalib::datastore::EntryRef rhs) const override;
+        bool equal(const vespalib::datastore::EntryRef lhs, const vespalib::datastore::EntryRef rhs) const override;
+        size_t hash(const vespalib::datastore::EntryRef rhs) const override;
+    };
+
     using PostingListPtr = uint32_t;
     using DictionaryTree = vespalib::btree::BTree<WordKey, PostingListPtr,
                                         vespalib::btree::NoAggregated,
                                         const KeyComp>;
+    using HashDictionary = vespalib::datastore::ShardedHashMap;
 
 protected:
     using GenerationHandler = vespalib::GenerationHandler;
@@ -77,6 +113,7 @@ protected:
     uint64_t                _numUniqueWords;
     GenerationHandler       _generationHandler;
     DictionaryTree          _dict;
+    std::unique_ptr<HashDictionary> _hash_dict;
     FeatureStore            _featureStore;
     uint32_t                _fieldId;
     FieldIndexRemover       _remover;
@@ -99,6 +136,8 @@ public:
 
     FieldIndexBase(const index::Schema& schema, uint32_t fieldId);
     FieldIndexBase(const index::Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info);
+    FieldIndexBase(const index::Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info,
+                   bool hash_dictionary);
     ~FieldIndexBase();
 
     uint64_t getNumUniqueWords() const override { return _numUniqueWords; }
@@ -112,6 +151,17 @@ public:
     }
 
     DictionaryTree& getDictionaryTree() { return _dict; }
+
+    /**
+     * Returns the hash dictionary mapping from word ref -> posting list ref,
+     * or nullptr if this field index only uses the btree dictionary.
+     *
+     * When present, the hash dictionary owns the posting list refs and is used
+     * for all exact word lookups. The btree dictionary then only keeps the
+     * words in sorted order (for dumping).
+     */
+    HashDictionary* get_hash_dictionary() { return _hash_dict.get(); }
+    bool has_hash_dictionary() const { return static_cast<bool>(_hash_dict); }
     FieldIndexRemover& getDocumentRemover() override { return _remover; }
 
 };
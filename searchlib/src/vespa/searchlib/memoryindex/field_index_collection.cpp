@@ -24,6 +24,12 @@ using index::WordDocElementFeatures;
 namespace memoryindex {
 
 FieldIndexCollection::FieldIndexCollection(const Schema& schema, const IFieldLengthInspector& inspector)
+    : FieldIndexCollection(schema, inspector, false)
+{
+}
+
+FieldIndexCollection::FieldIndexCollection(const Schema& schema, const IFieldLengthInspector& inspector,
+                                           bool hash_dictionary)
     : _fieldIndexes(),
       _numFields(schema.getNumIndexFields())
 {
@@ -31,10 +37,12 @@ FieldIndexCollection::FieldIndexCollection(const Schema& schema, const IFieldLen
         const auto& field = schema.getIndexField(fieldId);
         if (field.use_interleaved_features()) {
             _fieldIndexes.push_back(std::make_unique<FieldIndex<true>>(schema, fieldId,
-                                                                       inspector.get_field_length_info(field.getName())));
+                                                                       inspector.get_field_length_info(field.getName()),
+                                                                       hash_dictionary));
         } else {
             _fieldIndexes.push_back(std::make_unique<FieldIndex<false>>(schema, fieldId,
-                                                                        inspector.get_field_length_info(field.getName())));
+                                                                        inspector.get_field_length_info(field.getName()),
+                                                                        hash_dictionary));
         }
     }
 }
@@ -32,6 +32,8 @@ private:
 
 public:
     FieldIndexCollection(const index::Schema& schema, const index::IFieldLengthInspector& inspector);
+    FieldIndexCollection(const index::Schema& schema, const index::IFieldLengthInspector& inspector,
+                         bool hash_dictionary);
     ~FieldIndexCollection() override;
 
     uint64_t getNumUniqueWords() const {
@@ -53,10 +53,19 @@ MemoryIndex::MemoryIndex(const Schema& schema,
                          const IFieldLengthInspector& inspector,
                          ISequencedTaskExecutor& invertThreads,
                          ISequencedTaskExecutor& pushThreads)
+    : MemoryIndex(schema, inspector, invertThreads, pushThreads, false)
+{
+}
+
+MemoryIndex::MemoryIndex(const Schema& schema,
+                         const IFieldLengthInspector& inspector,
+                         ISequencedTaskExecutor& invertThreads,
+                         ISequencedTaskExecutor& pushThreads,
+                         bool hash_dictionary)
     : _schema(schema),
       _invertThreads(invertThreads),
       _pushThreads(pushThreads),
-      _fieldIndexes(std::make_unique<FieldIndexCollection>(_schema, inspector)),
+      _fieldIndexes(std::make_unique<FieldIndexCollection>(_schema, inspector, hash_dictionary)),
       _inverter0(std::make_unique<DocumentInverter>(_schema, _invertThreads, _pushThreads, *_fieldIndexes)),
       _inverter1(std::make_unique<DocumentInverter>(_schema, _invertThreads, _pushThreads, *_fieldIndexes)),
       _inverter(_inverter0.get()),
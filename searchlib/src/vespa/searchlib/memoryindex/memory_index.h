@@ -97,6 +97,18 @@ public:
                 ISequencedTaskExecutor& invertThreads,
                 ISequencedTaskExecutor& pushThreads);
 
+    /**
+     * Create a new memory index based on the given schema.
+     *
+     * @param hash_dictionary whether the field indexes should use a hash dictionary for exact word lookups,
+     *                        keeping the btree dictionary only for ordered traversal.
+     */
+    MemoryIndex(const index::Schema& schema,
+                const index::IFieldLengthInspector& inspector,
+                ISequencedTaskExecutor& invertThreads,
+                ISequencedTaskExecutor& pushThreads,
+                bool hash_dictionary);
+
     ~MemoryIndex();
 
     const index::Schema &getSchema() const { return _schema; }
@@ -36,6 +36,9 @@ OrderedFieldIndexInserter<interleaved_features>::OrderedFieldIndexInserter(Field
       _prevAdd(false),
       _fieldIndex(fieldIndex),
       _dItr(_fieldIndex.getDictionaryTree().begin()),
+      _hashDict(_fieldIndex.get_hash_dictionary()),
+      _hashPostingRef(nullptr),
+      _wordRef(),
       _listener(_fieldIndex.getDocumentRemover()),
       _removes(),
       _adds()
@@ -54,16 +57,26 @@ OrderedFieldIndexInserter<interleaved_features>::flushWord()
     }
     //XXX: Feature store leak, removed features not marked dead
     PostingListStore &postingListStore(_fieldIndex.getPostingListStore());
-    vespalib::datastore::EntryRef pidx(_dItr.getData());
+    vespalib::datastore::EntryRef oldPidx;
+    if (_hashDict != nullptr) {
+        oldPidx = _hashPostingRef->load_relaxed();
+    } else {
+        oldPidx = vespalib::datastore::EntryRef(_dItr.getData());
+    }
+    vespalib::datastore::EntryRef pidx(oldPidx);
     postingListStore.apply(pidx,
                            &_adds[0],
                            &_adds[0] + _adds.size(),
                            &_removes[0],
                            &_removes[0] + _removes.size());
-    if (pidx.ref() != _dItr.getData()) {
-        // Before updating ref
-        std::atomic_thread_fence(std::memory_order_release);
-        _dItr.writeData(pidx.ref());
+    if (pidx != oldPidx) {
+        if (_hashDict != nullptr) {
+            _hashPostingRef->store_release(pidx);
+        } else {
+            // Before updating ref
+            std::atomic_thread_fence(std::memory_order_release);
+            _dItr.writeData(pidx.ref());
+        }
     }
     _removes.clear();
     _adds.clear();
@@ -94,6 +107,22 @@ OrderedFieldIndexInserter<interleaved_features>::setNextWord(const vespalib::str
     _prevDocId = noDocId;
     _prevAdd = false;
     flushWord();
+    if (_hashDict != nullptr) {
+        std::function<vespalib::datastore::EntryRef(void)> insert_word([this]() { return seekWord(); });
+        WordComparator comp(_fieldIndex.getWordStore(), _word);
+        auto& kv = _hashDict->add(comp, vespalib::datastore::EntryRef(), insert_word);
+        _wordRef = kv.first.load_relaxed();
+        _hashPostingRef = &kv.second;
+    } else {
+        _wordRef = seekWord();
+    }
+    assert(_word == _fieldIndex.getWordStore().getWord(_wordRef));
+}
+
+template <bool interleaved_features>
+vespalib::datastore::EntryRef
+OrderedFieldIndexInserter<interleaved_features>::seekWord()
+{
     const WordStore &wordStore(_fieldIndex.getWordStore());
     KeyComp cmp(wordStore, _word);
     WordKey key;
@@ -108,7 +137,7 @@ OrderedFieldIndexInserter<interleaved_features>::setNextWord(const vespalib::str
         dTree.insert(_dItr, insertKey, vespalib::datastore::EntryRef().ref());
     }
     assert(_dItr.valid());
-    assert(_word == wordStore.getWord(_dItr.getKey()._wordRef));
+    return _dItr.getKey()._wordRef;
 }
 
 template <bool interleaved_features>
@@ -123,7 +152,7 @@ OrderedFieldIndexInserter<interleaved_features>::add(uint32_t docId,
     _adds.push_back(PostingListKeyDataType(docId, PostingListEntryType(featureRef,
                                                                        cap_u16(features.num_occs()),
                                                                        cap_u16(features.field_length()))));
-    _listener.insert(_dItr.getKey()._wordRef, docId);
+    _listener.insert(_wordRef, docId);
     _prevDocId = docId;
     _prevAdd = true;
 }
@@ -148,13 +177,15 @@ OrderedFieldIndexInserter<interleaved_features>::rewind()
     _prevDocId = noDocId;
     _prevAdd = false;
     _dItr.begin();
+    _hashPostingRef = nullptr;
+    _wordRef = vespalib::datastore::EntryRef();
 }
 
 template <bool interleaved_features>
 vespalib::datastore::EntryRef
 OrderedFieldIndexInserter<interleaved_features>::getWordRef() const
 {
-    return _dItr.getKey()._wordRef;
+    return _wordRef;
 }
 
 template class OrderedFieldIndexInserter<false>;
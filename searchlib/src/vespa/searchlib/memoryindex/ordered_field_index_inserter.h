@@ -16,6 +16,9 @@ class IFieldIndexInsertListener;
  *
  * This is done by doing a single pass scan of the dictionary of the FieldIndex,
  * and for each word updating the posting list with docId adds / removes.
+ * When the FieldIndex has a hash dictionary, existing words are looked up in
+ * the hash dictionary and the B-Tree dictionary is only positioned when a new
+ * word must be inserted.
  *
  * Insert order must be properly sorted, first by word, then by docId.
  *
@@ -31,11 +34,17 @@ private:
     using DictionaryTree = typename FieldIndexType::DictionaryTree;
     using PostingListStore = typename FieldIndexType::PostingListStore;
     using KeyComp = typename FieldIndexType::KeyComp;
+    using WordComparator = typename FieldIndexType::WordComparator;
+    using HashDictionary = typename FieldIndexType::HashDictionary;
     using WordKey = typename FieldIndexType::WordKey;
     using PostingListEntryType = typename FieldIndexType::PostingListEntryType;
     using PostingListKeyDataType = typename FieldIndexType::PostingListKeyDataType;
     FieldIndexType& _fieldIndex;
     typename DictionaryTree::Iterator _dItr;
+    HashDictionary* _hashDict;
+    // Posting list ref for (_word) in the hash dictionary. Only valid until the next word is added.
+    vespalib::datastore::AtomicEntryRef* _hashPostingRef;
+    vespalib::datastore::EntryRef _wordRef;
     IFieldIndexInsertListener &_listener;
 
     // Pending changes to posting list for (_word)
@@ -52,6 +61,13 @@ private:
      */
     void flushWord();
 
+    /**
+     * Position _dItr at (_word), inserting it into the B-Tree dictionary if missing.
+     *
+     * Returns the word ref for (_word).
+     */
+    vespalib::datastore::EntryRef seekWord();
+
 public:
     OrderedFieldIndexInserter(FieldIndexType& fieldIndex);
     ~OrderedFieldIndexInserter() override;
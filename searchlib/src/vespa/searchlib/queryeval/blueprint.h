@@ -8,6 +8,7 @@
 #include "global_filter.h"
 #include "multisearch.h"
 #include <vespa/searchlib/common/bitvector.h>
+#include <vespa/vespalib/util/stash.h>
 
 namespace vespalib { class ObjectVisitor; }
 namespace vespalib::slime {
@@ -36,8 +37,11 @@ class MatchingElementsSearch;
  * operations are implemented by extending the blueprint::Intermediate
  * template class. Leaf operations are implemented by extending the
  * blueprint::Leaf template class.
+ *
+ * Blueprints created while a vespalib::StashScope is active are
+ * allocated in the bound stash (see vespalib::StashAllocated).
  **/
-class Blueprint
+class Blueprint : public vespalib::StashAllocated
 {
 public:
     typedef std::unique_ptr<Blueprint> UP;
@@ -6,6 +6,7 @@
 #include "begin_and_end_id.h"
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/trinary.h>
+#include <vespa/vespalib/util/stash.h>
 #include <memory>
 #include <vector>
 
@@ -29,8 +30,11 @@ namespace search::queryeval {
  * a document. The placement and format of this match data is a
  * contract between the application and the leaf search objects and is
  * of no concern to the interface defined by this class.
+ *
+ * Search objects created while a vespalib::StashScope is active are
+ * allocated in the bound stash (see vespalib::StashAllocated).
  **/
-class SearchIterator
+class SearchIterator : public vespalib::StashAllocated
 {
 private:
     using BitVectorUP = std::unique_ptr<BitVector>;
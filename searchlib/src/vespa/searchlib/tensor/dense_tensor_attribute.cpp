@@ -5,11 +5,13 @@
 #include "nearest_neighbor_index.h"
 #include "nearest_neighbor_index_saver.h"
 #include "tensor_attribute.hpp"
+#include <vespa/document/update/tensor_modify_update.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/fastlib/io/bufferedfile.h>
 #include <vespa/searchlib/attribute/load_utils.h>
 #include <vespa/searchlib/attribute/readerbase.h>
 #include <vespa/vespalib/data/slime/inserter.h>
+#include <cstring>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.tensor.dense_tensor_attribute");
@@ -139,6 +141,38 @@ DenseTensorAttribute::setTensor(DocId docId, const vespalib::eval::Value &tensor
     }
 }
 
+void
+DenseTensorAttribute::update_tensor(DocId docId,
+                                    const document::TensorUpdate &update,
+                                    bool create_empty_if_non_existing)
+{
+    EntryRef ref;
+    if (docId < getCommittedDocIdLimit()) {
+        ref = _refVector[docId];
+    }
+    const auto *modify_update = dynamic_cast<const document::TensorModifyUpdate *>(&update);
+    if (modify_update == nullptr || !ref.valid()) {
+        TensorAttribute::update_tensor(docId, update, create_empty_if_non_existing);
+        return;
+    }
+    // Readers might still use the old cells, so the update is applied
+    // to a copy of them; this avoids building an intermediate tensor.
+    auto raw = _denseTensorStore.allocRawBuffer();
+    memcpy(raw.data, _denseTensorStore.getRawBuffer(ref), _denseTensorStore.getBufSize());
+    vespalib::eval::TypedCells cells(raw.data, _denseTensorStore.type().cell_type(), _denseTensorStore.getNumCells());
+    if (modify_update->apply_to_dense_cells(_denseTensorStore.type(), cells) == 0) {
+        // nothing changed; keep the old cells and leave the index alone.
+        // The copy was never published, so it can be reused right away.
+        _denseTensorStore.freeRawBuffer(raw.ref);
+        return;
+    }
+    consider_remove_from_index(docId);
+    setTensorRef(docId, raw.ref);
+    if (_index) {
+        _index->add_document(docId);
+    }
+}
+
 std::unique_ptr<PrepareResult>
 DenseTensorAttribute::prepare_set_tensor(DocId docid, const vespalib::eval::Value& tensor) const
 {
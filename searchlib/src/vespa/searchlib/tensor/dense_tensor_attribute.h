@@ -32,6 +32,9 @@ public:
     // Implements AttributeVector and ITensorAttribute
     uint32_t clearDoc(DocId docId) override;
     void setTensor(DocId docId, const vespalib::eval::Value &tensor) override;
+    void update_tensor(DocId docId,
+                       const document::TensorUpdate &update,
+                       bool create_empty_if_non_existing) override;
     std::unique_ptr<PrepareResult> prepare_set_tensor(DocId docid, const vespalib::eval::Value& tensor) const override;
     void complete_set_tensor(DocId docid, const vespalib::eval::Value& tensor, std::unique_ptr<PrepareResult> prepare_result) override;
     std::unique_ptr<vespalib::eval::Value> getTensor(DocId docId) const override;
@@ -97,6 +97,12 @@ DenseTensorStore::allocRawBuffer()
     return result;
 }
 
+void
+DenseTensorStore::freeRawBuffer(EntryRef ref)
+{
+    _concreteStore.freeElem(ref, _tensorSizeCalc.alignedSize());
+}
+
 void
 DenseTensorStore::holdTensor(EntryRef ref)
 {
@@ -63,6 +63,8 @@ public:
     size_t getBufSize() const { return _tensorSizeCalc.bufSize(); }
     const void *getRawBuffer(RefType ref) const;
     vespalib::datastore::Handle<char> allocRawBuffer();
+    // Frees a raw buffer at once; only valid if it has never been visible to readers.
+    void freeRawBuffer(EntryRef ref);
     void holdTensor(EntryRef ref) override;
     EntryRef move(EntryRef ref) override;
     std::unique_ptr<vespalib::eval::Value> getTensor(EntryRef ref) const;
@@ -54,7 +54,7 @@ SerializedFastValueAttribute::getTensor(DocId docId) const
         return {};
     }
     if (const auto * ptr = _streamedValueStore.get_tensor_entry(ref)) {
-        return ptr->create_fast_value_view(_tensor_type);
+        return ptr->create_value_view(_tensor_type);
     }
     return {};
 }
@@ -11,9 +11,11 @@ namespace search::tensor {
  * Attribute vector class storing serialized tensors for all documents in memory.
  *
  * When fetching a tensor with getTensor(docId) the returned Value
- * will have a FastValueIndex (constructed on the fly) for its sparse
- * mapping, but refer to a common type, while cells() will refer to
- * memory in the serialized store without copying.
+ * will refer to a common type, while cells() will refer to memory in
+ * the serialized store without copying. Sparse tensors get a
+ * FastValueIndex (constructed on the fly) for their sparse mapping.
+ * Mixed tensors get an index reading the stored labels directly,
+ * building a hash map only if full addresses are looked up.
  *
  */
 class SerializedFastValueAttribute : public TensorAttribute {
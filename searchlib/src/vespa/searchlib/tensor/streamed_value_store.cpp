@@ -127,6 +127,22 @@ StreamedValueStore::TensorEntryImpl<CT>::create_fast_value_view(const ValueType
     return std::make_unique<MyFastValueView>(type_ref, handles.view(), TypedCells(cells), num_mapped, num_spaces);
 }
 
+template <typename CT>
+Value::UP
+StreamedValueStore::TensorEntryImpl<CT>::create_value_view(const ValueType &type_ref) const
+{
+    size_t dense_size = type_ref.dense_subspace_size();
+    if (dense_size == 1) {
+        // sparse operations are optimized for values with a FastValueIndex
+        return create_fast_value_view(type_ref);
+    }
+    size_t num_mapped = type_ref.count_mapped_dimensions();
+    size_t num_spaces = cells.size() / dense_size;
+    assert(dense_size * num_spaces == cells.size());
+    assert(num_mapped * num_spaces == handles.view().size());
+    return std::make_unique<StreamedValueView>(type_ref, num_mapped, TypedCells(cells), num_spaces, handles.view());
+}
+
 template <typename CT>
 void
 StreamedValueStore::TensorEntryImpl<CT>::encode_value(const ValueType &type, vespalib::nbostream &target) const
@@ -25,6 +25,7 @@ public:
     struct TensorEntry {
         using SP = std::shared_ptr<TensorEntry>;
         virtual Value::UP create_fast_value_view(const ValueType &type_ref) const = 0;
+        virtual Value::UP create_value_view(const ValueType &type_ref) const = 0;
         virtual void encode_value(const ValueType &type, vespalib::nbostream &target) const = 0;
         virtual MemoryUsage get_memory_usage() const = 0;
         virtual ~TensorEntry();
@@ -38,6 +39,7 @@ public:
         std::vector<CT> cells;
         TensorEntryImpl(const Value &value, size_t num_mapped, size_t dense_size);
         Value::UP create_fast_value_view(const ValueType &type_ref) const override;
+        Value::UP create_value_view(const ValueType &type_ref) const override;
         void encode_value(const ValueType &type, vespalib::nbostream &target) const override;
         MemoryUsage get_memory_usage() const override;
         ~TensorEntryImpl() override;
@@ -37,6 +37,15 @@ Domain::Domain(const string &domainName, const string & baseDir, Executor & exec
                const DomainConfig & cfg, const FileHeaderContext &fileHeaderContext)
     : _config(cfg),
       _currentChunk(createCommitChunk(cfg)),
+      _pendingCommitsLock(),
+      _pendingCommitsCond(),
+      _pendingCommits(),
+      _pendingCommitBytes(0),
+      _firstPendingCommitTime(),
+      _groupCommitScheduled(false),
+      _groupCommitNow(false),
+      _commitStatsLock(),
+      _commitStats(),
       _lastSerial(0),
       _singleCommitter(std::make_unique<vespalib::ThreadStackExecutor>(1, 128_Ki)),
       _executor(executor),
@@ -110,9 +119,12 @@ Domain::addPart(SerialNum partId, bool isLastPart) {
 }
 
 Domain::~Domain() {
-    std::unique_lock guard(_currentChunkMonitor);
-    _currentChunkCond.notify_all();
-    commitChunk(grabCurrentChunk(guard), guard);
+    {
+        std::unique_lock guard(_currentChunkMonitor);
+        _currentChunkCond.notify_all();
+        commitChunk(grabCurrentChunk(guard), guard);
+    }
+    commitPendingNow();
     _singleCommitter->shutdown().sync();
 }
 
@@ -121,6 +133,10 @@ Domain::getDomainInfo() const
 {
     std::unique_lock guard(_lock);
     DomainInfo info(SerialNumRange(begin(guard), end(guard)), size(guard), byteSize(guard), _maxSessionRunTime);
+    {
+        std::lock_guard statsGuard(_commitStatsLock);
+        info.commitStats = _commitStats;
+    }
     for (const auto &entry: _parts) {
         const DomainPart &part = *entry.second;
         info.parts.emplace_back(PartInfo(part.range(), part.size(), part.byteSize(), part.fileName()));
@@ -211,6 +227,7 @@ Domain::triggerSyncNow(std::unique_ptr<vespalib::Executor::Task> done_sync_task)
         std::unique_lock guard(_currentChunkMonitor);
         commitAndTransferResponses(guard);
     }
+    commitPendingNow();
     if (done_sync_task) {
         // Need to protect against being called from the _singleCommitter as that will cause a deadlock
         // That is done from Domain::commitChunk.lamdba->Domain::doCommit()->optionallyRotateFile->triggerSyncNow({})
@@ -223,7 +240,9 @@ Domain::triggerSyncNow(std::unique_ptr<vespalib::Executor::Task> done_sync_task)
     if (!_pendingSync) {
         _pendingSync = true;
         _executor.execute(makeLambdaTask([this, domainPart= getActivePart()]() {
+            vespalib::steady_time start = vespalib::steady_clock::now();
             domainPart->sync();
+            recordSync(vespalib::steady_clock::now() - start);
             std::lock_guard monitorGuard(_syncMonitor);
             _pendingSync = false;
             _syncCond.notify_all();
@@ -394,27 +413,109 @@ Domain::grabCurrentChunk(const UniqueLock & guard) {
 void
 Domain::commitChunk(std::unique_ptr<CommitChunk> chunk, const UniqueLock & chunkOrderGuard) {
     assert(chunkOrderGuard.mutex() == &_currentChunkMonitor && chunkOrderGuard.owns_lock());
+    if (_config.useGroupCommit()) {
+        // Chunks are queued in serial number order as we hold the chunk order guard.
+        std::lock_guard guard(_pendingCommitsLock);
+        if (_pendingCommits.empty()) {
+            _firstPendingCommitTime = vespalib::steady_clock::now();
+        }
+        _pendingCommitBytes += chunk->sizeBytes();
+        _pendingCommits.push_back(std::move(chunk));
+        if (_pendingCommitBytes >= _config.getGroupCommitSizeLimit()) {
+            _pendingCommitsCond.notify_all();
+        }
+        if ( ! _groupCommitScheduled) {
+            _groupCommitScheduled = true;
+            _singleCommitter->execute(makeLambdaTask([this]() { groupCommit(); }));
+        }
+        return;
+    }
     _singleCommitter->execute( makeLambdaTask([this, chunk = std::move(chunk)]() mutable {
-        doCommit(std::move(chunk));
+        CommitChunkList chunks;
+        chunks.push_back(std::move(chunk));
+        doCommit(std::move(chunks));
     }));
 }
 
 void
-Domain::doCommit(std::unique_ptr<CommitChunk> chunk) {
-    const Packet & packet = chunk->getPacket();
-    if (packet.empty()) return;
-    
-    vespalib::nbostream_longlivedbuf is(packet.getHandle().data(), packet.getHandle().size());
+Domain::groupCommit() {
+    CommitChunkList chunks;
+    {
+        std::unique_lock guard(_pendingCommitsLock);
+        vespalib::steady_time deadline = _firstPendingCommitTime + _config.getGroupCommitDelay();
+        while ( ! _groupCommitNow && (_pendingCommitBytes < _config.getGroupCommitSizeLimit())) {
+            if (_pendingCommitsCond.wait_until(guard, deadline) == std::cv_status::timeout) {
+                break;
+            }
+        }
+        chunks.swap(_pendingCommits);
+        _pendingCommitBytes = 0;
+        _groupCommitScheduled = false;
+        _groupCommitNow = false;
+    }
+    doCommit(std::move(chunks));
+}
+
+void
+Domain::commitPendingNow() {
+    std::lock_guard guard(_pendingCommitsLock);
+    if (_groupCommitScheduled) {
+        _groupCommitNow = true;
+        _pendingCommitsCond.notify_all();
+    }
+}
+
+void
+Domain::doCommit(CommitChunkList chunks) {
+    // All chunks in the batch are written with one write and one sync,
+    // and acked together when the chunks are destructed.
+    Packet merged(0);
+    const Packet * packet = nullptr;
+    size_t numNonEmpty(0);
+    for (const auto & chunk : chunks) {
+        if ( ! chunk->getPacket().empty()) {
+            if (numNonEmpty == 0) {
+                packet = &chunk->getPacket();
+            } else {
+                if (numNonEmpty == 1) {
+                    merged.merge(*packet);
+                    packet = &merged;
+                }
+                merged.merge(chunk->getPacket());
+            }
+            numNonEmpty++;
+        }
+    }
+    if (packet == nullptr) return;
+
+    vespalib::nbostream_longlivedbuf is(packet->getHandle().data(), packet->getHandle().size());
     Packet::Entry entry;
     entry.deserialize(is);
     DomainPart::SP dp = optionallyRotateFile(entry.serial());
-    dp->commit(entry.serial(), packet);
+    dp->commit(entry.serial(), *packet);
     if (_config.getFSyncOnCommit()) {
+        vespalib::steady_time start = vespalib::steady_clock::now();
         dp->sync();
+        recordSync(vespalib::steady_clock::now() - start);
+    }
+    {
+        std::lock_guard guard(_commitStatsLock);
+        _commitStats.numBatches++;
+        _commitStats.numChunks += numNonEmpty;
+        _commitStats.maxChunksInBatch = std::max(_commitStats.maxChunksInBatch, numNonEmpty);
     }
     cleanSessions();
-    LOG(debug, "Releasing %zu acks and %zu entries and %zu bytes.",
-        chunk->getNumCallBacks(), chunk->getPacket().size(), chunk->sizeBytes());
+    LOG(debug, "Releasing acks and %zu entries and %zu bytes from %zu chunks.",
+        packet->size(), packet->sizeBytes(), numNonEmpty);
+}
+
+void
+Domain::recordSync(vespalib::duration syncTime) {
+    std::lock_guard guard(_commitStatsLock);
+    DurationSeconds seconds = std::chrono::duration_cast<DurationSeconds>(syncTime);
+    _commitStats.numSyncs++;
+    _commitStats.syncTime += seconds;
+    _commitStats.maxSyncTime = std::max(_commitStats.maxSyncTime, seconds);
 }
 
 bool
@@ -63,9 +63,14 @@ private:
     void commitIfFull(const UniqueLock & guard);
     void commitAndTransferResponses(const UniqueLock & guard);
 
+    using CommitChunkList = std::vector<std::unique_ptr<CommitChunk>>;
+
     std::unique_ptr<CommitChunk> grabCurrentChunk(const UniqueLock & guard);
     void commitChunk(std::unique_ptr<CommitChunk> chunk, const UniqueLock & chunkOrderGuard);
-    void doCommit(std::unique_ptr<CommitChunk> chunk);
+    void groupCommit();
+    void commitPendingNow();
+    void doCommit(CommitChunkList chunks);
+    void recordSync(vespalib::duration syncTime);
     SerialNum begin(const UniqueLock & guard) const;
     SerialNum end(const UniqueLock & guard) const;
     size_t byteSize(const UniqueLock & guard) const;
@@ -85,6 +90,15 @@ private:
 
     DomainConfig                 _config;
     std::unique_ptr<CommitChunk> _currentChunk;
+    std::mutex                   _pendingCommitsLock;
+    std::condition_variable      _pendingCommitsCond;
+    CommitChunkList              _pendingCommits;
+    size_t                       _pendingCommitBytes;
+    vespalib::steady_time        _firstPendingCommitTime;
+    bool                         _groupCommitScheduled;
+    bool                         _groupCommitNow;
+    mutable std::mutex           _commitStatsLock;
+    CommitStats                  _commitStats;
     SerialNum                    _lastSerial;
     std::unique_ptr<Executor>    _singleCommitter;
     Executor                    &_executor;
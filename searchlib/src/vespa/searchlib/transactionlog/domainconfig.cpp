@@ -9,7 +9,9 @@ DomainConfig::DomainConfig()
       _compressionLevel(9),
       _fSyncOnCommit(false),
       _partSizeLimit(0x10000000), // 256M
-      _chunkSizeLimit(0x40000)   // 256k
+      _chunkSizeLimit(0x40000),  // 256k
+      _groupCommitDelay(duration::zero()),
+      _groupCommitSizeLimit(0x400000) // 4M
 { }
 
 }
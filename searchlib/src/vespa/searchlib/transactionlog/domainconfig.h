@@ -16,17 +16,39 @@ public:
     DomainConfig & setChunkSizeLimit(size_t v)      { _chunkSizeLimit = v; return *this; }
     DomainConfig & setCompressionLevel(uint8_t v)   { _compressionLevel = v; return *this; }
     DomainConfig & setFSyncOnCommit(bool v)         { _fSyncOnCommit = v; return *this; }
+    DomainConfig & setGroupCommitDelay(duration v)  { _groupCommitDelay = v; return *this; }
+    DomainConfig & setGroupCommitSizeLimit(size_t v) { _groupCommitSizeLimit = v; return *this; }
     Encoding          getEncoding() const { return _encoding; }
     size_t       getPartSizeLimit() const { return _partSizeLimit; }
     size_t      getChunkSizeLimit() const { return _chunkSizeLimit; }
     uint8_t   getCompressionlevel() const { return _compressionLevel; }
     bool         getFSyncOnCommit() const { return _fSyncOnCommit; }
+    duration  getGroupCommitDelay() const { return _groupCommitDelay; }
+    size_t getGroupCommitSizeLimit() const { return _groupCommitSizeLimit; }
+    bool    useGroupCommit() const { return _groupCommitDelay > duration::zero(); }
 private:
     Encoding     _encoding;
     uint8_t      _compressionLevel;
     bool         _fSyncOnCommit;
     size_t       _partSizeLimit;
     size_t       _chunkSizeLimit;
+    duration     _groupCommitDelay;
+    size_t       _groupCommitSizeLimit;
+};
+
+/**
+ * Statistics for commits written to a domain. All values are accumulated since the domain was created.
+ */
+struct CommitStats {
+    using DurationSeconds = std::chrono::duration<double>;
+    size_t          numBatches;
+    size_t          numChunks;
+    size_t          maxChunksInBatch;
+    size_t          numSyncs;
+    DurationSeconds syncTime;
+    DurationSeconds maxSyncTime;
+    CommitStats()
+        : numBatches(0), numChunks(0), maxChunksInBatch(0), numSyncs(0), syncTime(), maxSyncTime() {}
 };
 
 struct PartInfo {
@@ -48,11 +70,13 @@ struct DomainInfo {
     size_t numEntries;
     size_t byteSize;
     DurationSeconds maxSessionRunTime;
+    CommitStats commitStats;
     std::vector<PartInfo> parts;
     DomainInfo(SerialNumRange range_in, size_t numEntries_in, size_t byteSize_in, DurationSeconds maxSessionRunTime_in)
-            : range(range_in), numEntries(numEntries_in), byteSize(byteSize_in), maxSessionRunTime(maxSessionRunTime_in), parts() {}
+            : range(range_in), numEntries(numEntries_in), byteSize(byteSize_in), maxSessionRunTime(maxSessionRunTime_in),
+              commitStats(), parts() {}
     DomainInfo()
-            : range(), numEntries(0), byteSize(0), maxSessionRunTime(), parts() {}
+            : range(), numEntries(0), byteSize(0), maxSessionRunTime(), commitStats(), parts() {}
 };
 
 using DomainStats = std::map<vespalib::string, DomainInfo>;
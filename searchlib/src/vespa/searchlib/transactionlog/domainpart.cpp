@@ -386,6 +386,8 @@ DomainPart::commit(SerialNum firstSerial, const Packet &packet)
     if (_range.from() == 0) {
         _range.from(firstSerial);
     }
+    // All chunks of the packet are encoded into one buffer and written with a single write.
+    nbostream os;
     IChunk::UP chunk = IChunk::create(_encoding, _compressionLevel);
     for (size_t i(0); h.size() > 0; i++) {
         //LOG(spam,
@@ -396,7 +398,7 @@ DomainPart::commit(SerialNum firstSerial, const Packet &packet)
         if (_range.to() < entry.serial()) {
             chunk->add(entry);
             if (_encoding.getCompression() == Encoding::Compression::none) {
-                write(*_transLog, *chunk);
+                encode(os, *chunk);
                 chunk = IChunk::create(_encoding, _compressionLevel);
             }
             _sz++;
@@ -407,7 +409,10 @@ DomainPart::commit(SerialNum firstSerial, const Packet &packet)
         }
     }
     if ( ! chunk->getEntries().empty()) {
-        write(*_transLog, *chunk);
+        encode(os, *chunk);
+    }
+    if (os.size() > 0) {
+        write(*_transLog, SerialNumRange(firstSerial, _range.to()), os);
     }
     std::lock_guard guard(_lock);
     _skipList.emplace_back(firstSerial, firstPos);
@@ -445,25 +450,30 @@ DomainPart::visit(FastOS_FileInterface &file, SerialNumRange &r, Packet &packet)
 }
 
 void
-DomainPart::write(FastOS_FileInterface &file, const IChunk & chunk)
+DomainPart::encode(nbostream & os, const IChunk & chunk) const
 {
-    nbostream os;
     size_t begin = os.wp();
     os << _encoding.getRaw();  // Placeholder for encoding
     os << uint32_t(0);         // Placeholder for size
     Encoding realEncoding = chunk.encode(os);
     size_t end = os.wp();
-    os.wp(0);
+    os.wp(begin);
     os << realEncoding.getRaw();  //Patching real encoding
     os << uint32_t(end - (begin + sizeof(uint32_t) + sizeof(uint8_t))); // Patching actual size.
     os.wp(end);
+    LOG(debug, "Encoded chunk with %zu entries and %zu bytes, range[%" PRIu64 ", %" PRIu64 "] encoding(wanted=%x, real=%x)",
+        chunk.getEntries().size(), end - begin, chunk.range().from(), chunk.range().to(), _encoding.getRaw(), realEncoding.getRaw());
+}
+
+void
+DomainPart::write(FastOS_FileInterface &file, SerialNumRange range, const nbostream & os)
+{
     std::lock_guard guard(_writeLock);
     if ( ! file.CheckedWrite(os.data(), os.size()) ) {
-        throw runtime_error(handleWriteError("Failed writing the entry.", file, byteSize(), chunk.range(), os.size()));
+        throw runtime_error(handleWriteError("Failed writing the entry.", file, byteSize(), range, os.size()));
     }
-    LOG(debug, "Wrote chunk with %zu entries and %zu bytes, range[%" PRIu64 ", %" PRIu64 "] encoding(wanted=%x, real=%x)",
-        chunk.getEntries().size(), os.size(), chunk.range().from(), chunk.range().to(), _encoding.getRaw(), realEncoding.getRaw());
-    _writtenSerial = chunk.range().to();
+    LOG(debug, "Wrote %zu bytes, range[%" PRIu64 ", %" PRIu64 "]", os.size(), range.from(), range.to());
+    _writtenSerial = range.to();
     _byteSize.fetch_add(os.size(), std::memory_order_release);
 }
 
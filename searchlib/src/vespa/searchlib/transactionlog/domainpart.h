@@ -49,7 +49,8 @@ private:
     static Packet readPacket(FastOS_FileInterface & file, SerialNumRange wanted, size_t targetSize, bool allowTruncate);
     static bool read(FastOS_FileInterface &file, IChunk::UP & chunk, Alloc &buf, bool allowTruncate);
 
-    void write(FastOS_FileInterface &file, const IChunk & entry);
+    void encode(vespalib::nbostream & os, const IChunk & chunk) const;
+    void write(FastOS_FileInterface &file, SerialNumRange range, const vespalib::nbostream & os);
     void writeHeader(const common::FileHeaderContext &fileHeaderContext);
 
     class SkipInfo
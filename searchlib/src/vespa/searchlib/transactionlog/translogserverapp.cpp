@@ -66,17 +66,21 @@ getDomainConfig(const searchlib::TranslogserverConfig & cfg) {
         .setCompressionLevel(cfg.compression.level)
         .setPartSizeLimit(cfg.filesizemax)
         .setChunkSizeLimit(cfg.chunk.sizelimit)
-        .setFSyncOnCommit(cfg.usefsync);
+        .setFSyncOnCommit(cfg.usefsync)
+        .setGroupCommitDelay(vespalib::from_s(cfg.groupcommit.delay))
+        .setGroupCommitSizeLimit(cfg.groupcommit.sizelimit);
     return dcfg;
 }
 
 void
 logReconfig(const searchlib::TranslogserverConfig & cfg, const DomainConfig & dcfg) {
     LOG(config, "configure Transaction Log Server %s at port %d\n"
-                "DomainConfig {encoding={%d, %d}, compression_level=%d, part_limit=%ld, chunk_limit=%ld}",
+                "DomainConfig {encoding={%d, %d}, compression_level=%d, part_limit=%ld, chunk_limit=%ld, "
+                "group_commit_delay=%1.3f, group_commit_limit=%ld}",
         cfg.servername.c_str(), cfg.listenport,
         dcfg.getEncoding().getCrc(), dcfg.getEncoding().getCompression(), dcfg.getCompressionlevel(),
-        dcfg.getPartSizeLimit(), dcfg.getChunkSizeLimit());
+        dcfg.getPartSizeLimit(), dcfg.getChunkSizeLimit(),
+        vespalib::to_s(dcfg.getGroupCommitDelay()), dcfg.getGroupCommitSizeLimit());
 }
 
 }
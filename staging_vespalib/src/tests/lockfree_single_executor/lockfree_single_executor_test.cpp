@@ -0,0 +1,173 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+
+#include <vespa/vespalib/util/lockfree_single_executor.h>
+#include <vespa/vespalib/util/backtrace.h>
+#include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace vespalib;
+
+VESPA_THREAD_STACK_TAG(lockfree_executor)
+
+TEST("require that all tasks are executed") {
+    std::atomic<uint64_t> counter(0);
+    LockFreeSingleExecutor executor(lockfree_executor, 10);
+    EXPECT_EQUAL(16u, executor.getTaskLimit());
+    EXPECT_EQUAL(1u, executor.getNumThreads());
+    for (uint64_t i(0); i < 10; i++) {
+        EXPECT_TRUE(executor.execute(makeLambdaTask([&counter] {counter++;})).get() == nullptr);
+    }
+    executor.sync();
+    EXPECT_EQUAL(10u, counter);
+
+    counter = 0;
+    for (uint64_t i(0); i < 10000; i++) {
+        executor.execute(makeLambdaTask([&counter] {counter++;}));
+    }
+    executor.sync();
+    EXPECT_EQUAL(10000u, counter);
+}
+
+struct MultiProducerFixture {
+    LockFreeSingleExecutor executor;
+    std::vector<std::vector<size_t>> seen;
+    MultiProducerFixture(size_t num_producers)
+        : executor(lockfree_executor, 64), seen(num_producers) {}
+};
+
+TEST_MT_F("require that tasks from each producer are executed in order", 4, MultiProducerFixture(num_threads)) {
+    auto &seen = f1.seen[thread_id];
+    for (size_t i = 0; i < 10000; ++i) {
+        f1.executor.execute(makeLambdaTask([&seen, i] { seen.push_back(i); }));
+    }
+    TEST_BARRIER();
+    if (thread_id == 0) {
+        f1.executor.sync();
+        for (const auto &list: f1.seen) {
+            ASSERT_EQUAL(10000u, list.size());
+            for (size_t i = 0; i < list.size(); ++i) {
+                EXPECT_EQUAL(i, list[i]);
+            }
+        }
+    }
+}
+
+TEST("require that producers block when task limit is reached") {
+    LockFreeSingleExecutor executor(lockfree_executor, 4);
+    Gate gate;
+    CountDownLatch started(1);
+    executor.execute(makeLambdaTask([&gate, &started] { started.countDown(); gate.await(); }));
+    started.await();
+    for (size_t i = 0; i < 4; ++i) {
+        executor.execute(makeLambdaTask([] {}));
+    }
+    Gate blocked_done;
+    std::thread thread([&executor, &blocked_done]() {
+                           executor.execute(makeLambdaTask([] {}));
+                           blocked_done.countDown();
+                       });
+    EXPECT_FALSE(blocked_done.await(20ms));
+    gate.countDown();
+    EXPECT_TRUE(blocked_done.await(30s));
+    thread.join();
+    executor.sync();
+    EXPECT_EQUAL(6u, executor.getStats().acceptedTasks);
+}
+
+TEST("require that task limit can be lowered but not raised above initial capacity") {
+    LockFreeSingleExecutor executor(lockfree_executor, 10);
+    executor.setTaskLimit(4);
+    EXPECT_EQUAL(4u, executor.getTaskLimit());
+    executor.setTaskLimit(5);
+    EXPECT_EQUAL(8u, executor.getTaskLimit());
+    executor.setTaskLimit(1000);
+    EXPECT_EQUAL(16u, executor.getTaskLimit());
+}
+
+TEST("require that task limit can be raised up to the reserved capacity") {
+    LockFreeSingleExecutor executor(lockfree_executor, 10, 40);
+    EXPECT_EQUAL(16u, executor.getTaskLimit());
+    executor.setTaskLimit(64);
+    EXPECT_EQUAL(64u, executor.getTaskLimit());
+    executor.setTaskLimit(1000);
+    EXPECT_EQUAL(64u, executor.getTaskLimit());
+    Gate gate;
+    CountDownLatch started(1);
+    executor.execute(makeLambdaTask([&gate, &started] { started.countDown(); gate.await(); }));
+    started.await();
+    for (size_t i = 0; i < 64; ++i) {
+        executor.execute(makeLambdaTask([] {}));
+    }
+    gate.countDown();
+    executor.sync();
+    EXPECT_EQUAL(65u, executor.getStats().acceptedTasks);
+}
+
+TEST("require that lowering task limit blocks producers earlier") {
+    LockFreeSingleExecutor executor(lockfree_executor, 16);
+    executor.setTaskLimit(2);
+    Gate gate;
+    CountDownLatch started(1);
+    executor.execute(makeLambdaTask([&gate, &started] { started.countDown(); gate.await(); }));
+    started.await();
+    executor.execute(makeLambdaTask([] {}));
+    executor.execute(makeLambdaTask([] {}));
+    Gate blocked_done;
+    std::thread thread([&executor, &blocked_done]() {
+                           executor.execute(makeLambdaTask([] {}));
+                           blocked_done.countDown();
+                       });
+    EXPECT_FALSE(blocked_done.await(20ms));
+    executor.setTaskLimit(8);
+    EXPECT_TRUE(blocked_done.await(30s));
+    thread.join();
+    gate.countDown();
+    executor.sync();
+}
+
+TEST("require that tasks are rejected after shutdown") {
+    std::atomic<uint64_t> counter(0);
+    LockFreeSingleExecutor executor(lockfree_executor, 10);
+    executor.execute(makeLambdaTask([&counter] {counter++;}));
+    executor.shutdown();
+    auto rejected = executor.execute(makeLambdaTask([&counter] {counter++;}));
+    EXPECT_TRUE(rejected.get() != nullptr);
+    executor.sync();
+    EXPECT_EQUAL(1u, counter);
+    auto stats = executor.getStats();
+    EXPECT_EQUAL(1u, stats.acceptedTasks);
+    EXPECT_EQUAL(1u, stats.rejectedTasks);
+}
+
+TEST("require that stats are reset when read") {
+    LockFreeSingleExecutor executor(lockfree_executor, 10);
+    for (size_t i = 0; i < 5; ++i) {
+        executor.execute(makeLambdaTask([] {}));
+    }
+    executor.sync();
+    auto stats = executor.getStats();
+    EXPECT_EQUAL(5u, stats.acceptedTasks);
+    EXPECT_LESS_EQUAL(1u, stats.queueSize.count());
+    EXPECT_LESS_EQUAL(stats.queueSize.max(), 5u);
+    stats = executor.getStats();
+    EXPECT_EQUAL(0u, stats.acceptedTasks);
+    EXPECT_EQUAL(0u, stats.rejectedTasks);
+    EXPECT_EQUAL(0u, stats.queueSize.count());
+}
+
+TEST("require that thread stack tag is used") {
+    LockFreeSingleExecutor executor(lockfree_executor, 10);
+    vespalib::string trace;
+    executor.execute(makeLambdaTask([&trace] { trace = getStackTrace(0); }));
+    executor.sync();
+    if (!EXPECT_TRUE(trace.find("lockfree_executor") != vespalib::string::npos)) {
+        fprintf(stderr, "%s\n", trace.c_str());
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -6,6 +6,8 @@
 #include <vespa/vespalib/util/time.h>
 #include <atomic>
 #include <cinttypes>
+#include <thread>
+#include <vector>
 
 using vespalib::ISequencedTaskExecutor;
 using vespalib::SequencedTaskExecutor;
@@ -52,20 +54,32 @@ int main(int argc, char **argv) {
     size_t num_threads = params.next("num_threads", num_strands);
     size_t max_waiting = params.next("max_waiting", optimize_for_throughput ? 32 : 0);
     size_t work_size = params.next("work_size", 0);
+    bool use_lockfree_executor = params.next("use_lockfree_executor", 0);
+    size_t num_producers = params.next("num_producers", 1);
     std::atomic<long> counter(0);
     std::unique_ptr<ISequencedTaskExecutor> executor;
     if (use_adaptive_executor) {
         executor = std::make_unique<AdaptiveSequencedExecutor>(num_strands, num_threads, max_waiting, task_limit);
     } else {
-        auto optimize = optimize_for_throughput
-                        ? vespalib::Executor::OptimizeFor::THROUGHPUT
-                        : vespalib::Executor::OptimizeFor::LATENCY;
+        auto optimize = use_lockfree_executor
+                        ? vespalib::Executor::OptimizeFor::LOCKFREE
+                        : optimize_for_throughput
+                          ? vespalib::Executor::OptimizeFor::THROUGHPUT
+                          : vespalib::Executor::OptimizeFor::LATENCY;
         executor = SequencedTaskExecutor::create(sequenced_executor, num_strands, task_limit, optimize);
     }
     vespalib::Timer timer;
-    for (size_t task_id = 0; task_id < num_tasks; ++task_id) {
-        executor->executeTask(ExecutorId(task_id % num_strands),
-                              vespalib::makeLambdaTask([&counter,work_size] { (void) do_work(work_size); counter++; }));
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < num_producers; ++producer) {
+        producers.emplace_back([&, producer]() {
+                                   for (size_t task_id = producer; task_id < num_tasks; task_id += num_producers) {
+                                       executor->executeTask(ExecutorId(task_id % num_strands),
+                                                             vespalib::makeLambdaTask([&counter,work_size] { (void) do_work(work_size); counter++; }));
+                                   }
+                               });
+    }
+    for (auto &producer: producers) {
+        producer.join();
     }
     executor.reset();
     fprintf(stderr, "\ntotal time: %" PRId64 " ms\n", vespalib::count_ms(timer.elapsed()));
@@ -0,0 +1,282 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "lockfree_single_executor.h"
+#include <vespa/vespalib/util/alloc.h>
+#include <cassert>
+#include <cinttypes>
+#include <limits>
+#include <thread>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.util.lockfree_single_executor");
+
+namespace vespalib {
+
+namespace {
+
+constexpr uint32_t SPIN_COUNT = 256;
+
+template <typename T>
+void atomic_min(std::atomic<T> &target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while ((value < current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+template <typename T>
+void atomic_max(std::atomic<T> &target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while ((value > current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+// spin (yielding the cpu) until the condition holds; returns false if it did not hold in time
+template <typename F>
+bool spin_until(F &&cond) {
+    for (uint32_t i = 0; i < SPIN_COUNT; ++i) {
+        if (cond()) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return cond();
+}
+
+}
+
+// A slot is free for position p when seq == p and holds the task for
+// position p when seq == p + 1. When the consumer takes the task, the
+// slot becomes free for position p + capacity.
+struct LockFreeSingleExecutor::Slot {
+    std::atomic<uint64_t> seq;
+    Task::UP              task;
+    Slot() : seq(0), task() {}
+};
+
+LockFreeSingleExecutor::LockFreeSingleExecutor(init_fun_t func, uint32_t taskLimit)
+    : LockFreeSingleExecutor(std::move(func), taskLimit, taskLimit)
+{
+}
+
+LockFreeSingleExecutor::LockFreeSingleExecutor(init_fun_t func, uint32_t taskLimit, uint32_t maxTaskLimit)
+    : _capacity(vespalib::roundUp2inN(std::max(taskLimit, maxTaskLimit))),
+      _slots(std::make_unique<Slot[]>(_capacity)),
+      _taskLimit(vespalib::roundUp2inN(taskLimit)),
+      _wp(0),
+      _rp(0),
+      _done(0),
+      _consumerParked(false),
+      _numWaiting(0),
+      _closed(false),
+      _stopped(false),
+      _mutex(),
+      _consumerCondition(),
+      _producerCondition(),
+      _lastAccepted(0),
+      _rejected(0),
+      _queueSizeCount(0),
+      _queueSizeTotal(0),
+      _queueSizeMin(std::numeric_limits<size_t>::max()),
+      _queueSizeMax(0),
+      _threadInit(std::move(func), *this),
+      _thread(_threadInit)
+{
+    assert(taskLimit > 0);
+    for (uint64_t i = 0; i < _capacity; ++i) {
+        _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    _thread.start();
+}
+
+LockFreeSingleExecutor::~LockFreeSingleExecutor() {
+    shutdown();
+    sync();
+    {
+        std::lock_guard guard(_mutex);
+        _stopped.store(true);
+        _consumerCondition.notify_one();
+    }
+    _thread.stop().join();
+}
+
+size_t
+LockFreeSingleExecutor::getNumThreads() const {
+    return 1;
+}
+
+Executor::Task::UP
+LockFreeSingleExecutor::execute(Task::UP task) {
+    uint64_t wp = _wp.load(std::memory_order_relaxed);
+    for (;;) {
+        if (_closed.load(std::memory_order_relaxed)) {
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+        Slot &slot = _slots[wp & (_capacity - 1)];
+        int64_t diff = int64_t(slot.seq.load(std::memory_order_acquire)) - int64_t(wp);
+        bool full = (diff < 0) || ((wp - _rp.load(std::memory_order_acquire)) >= _taskLimit.load(std::memory_order_relaxed));
+        if (full) {
+            wait_for_room(wp);
+            wp = _wp.load(std::memory_order_relaxed);
+        } else if (diff > 0) {
+            wp = _wp.load(std::memory_order_relaxed);
+        } else if (_wp.compare_exchange_weak(wp, wp + 1, std::memory_order_relaxed)) {
+            slot.task = std::move(task);
+            slot.seq.store(wp + 1, std::memory_order_release);
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_consumerParked.load(std::memory_order_relaxed)) {
+        std::lock_guard guard(_mutex);
+        _consumerCondition.notify_one();
+    }
+    return task;
+}
+
+void
+LockFreeSingleExecutor::setTaskLimit(uint32_t taskLimit) {
+    uint64_t wantedTaskLimit = vespalib::roundUp2inN(std::max(taskLimit, 1u));
+    if (wantedTaskLimit > _capacity) {
+        LOG(warning, "Task limit %u is above the capacity of the ring buffer, using %" PRIu64 " instead",
+            taskLimit, _capacity);
+    }
+    _taskLimit.store(std::min(wantedTaskLimit, _capacity), std::memory_order_relaxed);
+    notify_waiters();
+}
+
+void
+LockFreeSingleExecutor::wait_for_room(uint64_t wp) {
+    auto has_room = [this, wp]() {
+                        return (_closed.load(std::memory_order_relaxed) ||
+                                ((wp - _rp.load(std::memory_order_acquire)) < _taskLimit.load(std::memory_order_relaxed)));
+                    };
+    if (spin_until(has_room)) {
+        return;
+    }
+    std::unique_lock guard(_mutex);
+    _numWaiting.fetch_add(1);
+    _producerCondition.wait(guard, has_room);
+    _numWaiting.fetch_sub(1);
+}
+
+void
+LockFreeSingleExecutor::wait_for_done(uint64_t wp) {
+    auto is_done = [this, wp]() { return (_done.load(std::memory_order_acquire) >= wp); };
+    if (spin_until(is_done)) {
+        return;
+    }
+    std::unique_lock guard(_mutex);
+    _numWaiting.fetch_add(1);
+    _producerCondition.wait(guard, is_done);
+    _numWaiting.fetch_sub(1);
+}
+
+void
+LockFreeSingleExecutor::notify_waiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_numWaiting.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard guard(_mutex);
+        _producerCondition.notify_all();
+    }
+}
+
+void
+LockFreeSingleExecutor::wakeup() {
+    std::lock_guard guard(_mutex);
+    _consumerCondition.notify_one();
+}
+
+LockFreeSingleExecutor &
+LockFreeSingleExecutor::sync() {
+    wait_for_done(_wp.load(std::memory_order_acquire));
+    return *this;
+}
+
+LockFreeSingleExecutor &
+LockFreeSingleExecutor::shutdown() {
+    _closed.store(true);
+    notify_waiters();
+    return *this;
+}
+
+bool
+LockFreeSingleExecutor::has_task(uint64_t rp) const {
+    return (_slots[rp & (_capacity - 1)].seq.load(std::memory_order_acquire) == (rp + 1));
+}
+
+size_t
+LockFreeSingleExecutor::take_tasks(Task::UP *batch) {
+    uint64_t rp = _rp.load(std::memory_order_relaxed);
+    size_t n = 0;
+    while ((n < BATCH_SIZE) && has_task(rp)) {
+        Slot &slot = _slots[rp & (_capacity - 1)];
+        batch[n++] = std::move(slot.task);
+        slot.seq.store(rp + _capacity, std::memory_order_release);
+        ++rp;
+    }
+    if (n > 0) {
+        sample_queue_size(_wp.load(std::memory_order_relaxed) - _rp.load(std::memory_order_relaxed));
+        _rp.store(rp, std::memory_order_release);
+        notify_waiters();
+    }
+    return n;
+}
+
+void
+LockFreeSingleExecutor::park_consumer() {
+    uint64_t rp = _rp.load(std::memory_order_relaxed);
+    auto wanted = [this, rp]() { return (has_task(rp) || _stopped.load(std::memory_order_relaxed)); };
+    if (spin_until(wanted)) {
+        return;
+    }
+    std::unique_lock guard(_mutex);
+    _consumerParked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    _consumerCondition.wait(guard, wanted);
+    _consumerParked.store(false, std::memory_order_relaxed);
+}
+
+void
+LockFreeSingleExecutor::run() {
+    Task::UP batch[BATCH_SIZE];
+    uint64_t done = _done.load(std::memory_order_relaxed);
+    for (;;) {
+        size_t n = take_tasks(batch);
+        if (n == 0) {
+            if (_stopped.load(std::memory_order_acquire)) {
+                break;
+            }
+            park_consumer();
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            batch[i]->run();
+            batch[i].reset();
+            _done.store(++done, std::memory_order_release);
+        }
+        notify_waiters();
+    }
+}
+
+void
+LockFreeSingleExecutor::sample_queue_size(size_t value) {
+    _queueSizeCount.fetch_add(1, std::memory_order_relaxed);
+    _queueSizeTotal.fetch_add(value, std::memory_order_relaxed);
+    atomic_min(_queueSizeMin, value);
+    atomic_max(_queueSizeMax, value);
+}
+
+ThreadExecutor::Stats
+LockFreeSingleExecutor::getStats() {
+    uint64_t accepted = _wp.load(std::memory_order_relaxed);
+    uint64_t lastAccepted = _lastAccepted.exchange(accepted, std::memory_order_relaxed);
+    Stats stats;
+    stats.acceptedTasks = (accepted - lastAccepted);
+    stats.rejectedTasks = _rejected.exchange(0, std::memory_order_relaxed);
+    stats.queueSize.add(_queueSizeCount.exchange(0, std::memory_order_relaxed),
+                        _queueSizeTotal.exchange(0, std::memory_order_relaxed),
+                        _queueSizeMin.exchange(std::numeric_limits<size_t>::max(), std::memory_order_relaxed),
+                        _queueSizeMax.exchange(0, std::memory_order_relaxed));
+    return stats;
+}
+
+}
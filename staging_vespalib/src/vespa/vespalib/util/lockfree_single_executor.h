@@ -0,0 +1,94 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/threadexecutor.h>
+#include <vespa/vespalib/util/thread.h>
+#include <vespa/vespalib/util/time.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace vespalib {
+
+/**
+ * Has a single thread consuming tasks from a fixed size ring buffer,
+ * like the SingleExecutor, but producers do not take any lock when
+ * there is room for their task. Each slot in the ring buffer has a
+ * sequence number telling whether it is free or holds a task for the
+ * current round, so that multiple producers can claim slots with a
+ * single compare-and-swap. The consumer takes up to a batch of tasks
+ * out of the ring buffer before running them, freeing their slots as
+ * early as possible.
+ *
+ * Both the consumer (when there are no tasks) and the producers (when
+ * there is no room) spin for a while before parking on a condition
+ * variable. The lock is only taken when actually parking, and by the
+ * other side when it sees that someone is parked.
+ *
+ * The capacity of the ring buffer is fixed at construction time, and
+ * is sized for maxTaskLimit. The task limit may be lowered and raised
+ * again, but a limit above the capacity is capped to the capacity
+ * (with a warning). Like the capacity, the task limit is always
+ * rounded up to a power of 2.
+ */
+class LockFreeSingleExecutor final : public SyncableThreadExecutor, Runnable {
+public:
+    // Room reserved in the ring buffer by users expecting the task limit to be raised by reconfig.
+    static constexpr uint32_t RESERVE_FACTOR = 4;
+
+    LockFreeSingleExecutor(init_fun_t func, uint32_t taskLimit);
+    LockFreeSingleExecutor(init_fun_t func, uint32_t taskLimit, uint32_t maxTaskLimit);
+    ~LockFreeSingleExecutor() override;
+    Task::UP execute(Task::UP task) override;
+    void setTaskLimit(uint32_t taskLimit) override;
+    LockFreeSingleExecutor & sync() override;
+    void wakeup() override;
+    size_t getNumThreads() const override;
+    uint32_t getTaskLimit() const override { return _taskLimit.load(std::memory_order_relaxed); }
+    Stats getStats() override;
+    LockFreeSingleExecutor & shutdown() override;
+private:
+    struct Slot;
+    struct ThreadInit : Runnable {
+        init_fun_t init_fun;
+        Runnable  &target;
+        ThreadInit(init_fun_t init_fun_in, Runnable &target_in)
+            : init_fun(std::move(init_fun_in)), target(target_in) {}
+        void run() override { init_fun(target); }
+    };
+    static constexpr uint32_t BATCH_SIZE = 64;
+
+    void run() override;
+    bool has_task(uint64_t rp) const;
+    size_t take_tasks(Task::UP *batch);
+    void park_consumer();
+    void wait_for_room(uint64_t wp);
+    void wait_for_done(uint64_t wp);
+    void notify_waiters();
+    void sample_queue_size(size_t value);
+
+    const uint64_t              _capacity;
+    std::unique_ptr<Slot[]>     _slots;
+    std::atomic<uint32_t>       _taskLimit;
+    alignas(64) std::atomic<uint64_t> _wp;
+    alignas(64) std::atomic<uint64_t> _rp;
+    std::atomic<uint64_t>       _done;
+    alignas(64) std::atomic<bool>     _consumerParked;
+    std::atomic<uint32_t>       _numWaiting;
+    std::atomic<bool>           _closed;
+    std::atomic<bool>           _stopped;
+    std::mutex                  _mutex;
+    std::condition_variable     _consumerCondition;
+    std::condition_variable     _producerCondition;
+    std::atomic<uint64_t>       _lastAccepted;
+    std::atomic<size_t>         _rejected;
+    std::atomic<size_t>         _queueSizeCount;
+    std::atomic<size_t>         _queueSizeTotal;
+    std::atomic<size_t>         _queueSizeMin;
+    std::atomic<size_t>         _queueSizeMax;
+    ThreadInit                  _threadInit;
+    vespalib::Thread            _thread;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "sequencedtaskexecutor.h"
 #include "adaptive_sequenced_executor.h"
+#include "lockfree_single_executor.h"
 #include "singleexecutor.h"
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
 #include <vespa/vespalib/util/size_literals.h>
@@ -41,6 +42,9 @@ SequencedTaskExecutor::create(vespalib::Runnable::init_fun_t func, uint32_t thre
             if (optimize == OptimizeFor::THROUGHPUT) {
                 uint32_t watermark = kindOfWatermark == 0 ? taskLimit / 10 : kindOfWatermark;
                 executors->push_back(std::make_unique<SingleExecutor>(func, taskLimit, watermark, reactionTime));
+            } else if (optimize == OptimizeFor::LOCKFREE) {
+                executors->push_back(std::make_unique<LockFreeSingleExecutor>(func, taskLimit,
+                                                                              taskLimit * LockFreeSingleExecutor::RESERVE_FACTOR));
             } else {
                 executors->push_back(std::make_unique<BlockingThreadStackExecutor>(1, stackSize, taskLimit, func));
             }
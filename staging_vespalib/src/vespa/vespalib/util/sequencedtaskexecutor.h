@@ -31,6 +31,7 @@ public:
 
     /*
      * Note that if you choose Optimize::THROUGHPUT, you must ensure only a single producer, or synchronize on the outside.
+     * Optimize::LOCKFREE uses a lock-free ring buffer per thread that can be shared by multiple producers.
      *
      */
     static std::unique_ptr<ISequencedTaskExecutor>
@@ -72,12 +72,13 @@ std::vector<uint64_t>
 PendingMessageTracker::clearMessagesForNode(uint16_t node)
 {
     std::lock_guard guard(_lock);
-    MessagesByNodeAndBucket& idx(boost::multi_index::get<1>(_messages));
+    MessagesByNodeAndBucket& idx(boost::multi_index::get<0>(_messages));
     auto range = pairAsRange(idx.equal_range(boost::make_tuple(node)));
 
     std::vector<uint64_t> erasedIds;
     for (auto& entry : range) {
         erasedIds.push_back(entry.msgId);
+        _messagesById.erase(entry.msgId);
     }
     idx.erase(std::begin(range), std::end(range));
 
@@ -90,8 +91,11 @@ PendingMessageTracker::insert(const std::shared_ptr<api::StorageMessage>& msg)
 {
     std::lock_guard guard(_lock);
     if (msg->getAddress()) {
-        _messages.emplace(currentTime(), msg->getType().getId(), msg->getPriority(), msg->getMsgId(),
-                          msg->getBucket(), msg->getAddress()->getIndex());
+        if ( ! _messagesById.contains(msg->getMsgId())) {
+            auto inserted = _messages.emplace(currentTime(), msg->getType().getId(), msg->getPriority(), msg->getMsgId(),
+                                              msg->getBucket(), msg->getAddress()->getIndex());
+            _messagesById.insert(std::make_pair(msg->getMsgId(), inserted.first));
+        }
 
         _nodeInfo.incPending(msg->getAddress()->getIndex());
 
@@ -109,18 +113,18 @@ PendingMessageTracker::reply(const api::StorageReply& r)
     LOG(debug, "Got reply: %s", r.toString().c_str());
     uint64_t msgId = r.getMsgId();
 
-    MessagesByMsgId& msgs = boost::multi_index::get<0>(_messages);
-    MessagesByMsgId::iterator iter = msgs.find(msgId);
+    auto found = _messagesById.find(msgId);
 
-    if (iter != msgs.end()) {
-        bucket = iter->bucket;
+    if (found != _messagesById.end()) {
+        bucket = found->second->bucket;
         _nodeInfo.decPending(r.getAddress()->getIndex());
         api::ReturnCode::Result code = r.getResult().getResult();
         if (code == api::ReturnCode::BUSY || code == api::ReturnCode::TIMEOUT) {
             _nodeInfo.setBusy(r.getAddress()->getIndex(), _nodeBusyDuration);
         }
         LOG(debug, "Erased message with id %" PRIu64, msgId);
-        msgs.erase(msgId);
+        _messages.erase(found->second);
+        _messagesById.erase(found);
         auto deferred_tasks = get_deferred_ops_if_bucket_writes_drained(bucket);
         // Deferred tasks may try to send messages, which in turn will invoke the PendingMessageTracker.
         // To avoid deadlocking, we run the tasks outside the lock.
@@ -168,7 +172,7 @@ bool range_is_empty_or_only_has_read_ops(const Range& range) noexcept {
 bool
 PendingMessageTracker::bucket_has_no_pending_write_ops(const document::Bucket& bucket) const noexcept
 {
-    auto& bucket_idx = boost::multi_index::get<2>(_messages);
+    auto& bucket_idx = boost::multi_index::get<1>(_messages);
     auto pending_tasks_for_bucket = bucket_idx.equal_range(bucket);
     return range_is_empty_or_only_has_read_ops(pending_tasks_for_bucket);
 }
@@ -230,7 +234,7 @@ void
 PendingMessageTracker::checkPendingMessages(uint16_t node, const document::Bucket &bucket, Checker& checker) const
 {
     std::lock_guard guard(_lock);
-    const MessagesByNodeAndBucket& msgs(boost::multi_index::get<1>(_messages));
+    const MessagesByNodeAndBucket& msgs(boost::multi_index::get<0>(_messages));
 
     auto range = pairAsRange(msgs.equal_range(boost::make_tuple(node, bucket)));
     runCheckerOnRange(checker, range);
@@ -240,7 +244,7 @@ void
 PendingMessageTracker::checkPendingMessages(const document::Bucket &bucket, Checker& checker) const
 {
     std::lock_guard guard(_lock);
-    const MessagesByBucketAndType& msgs(boost::multi_index::get<2>(_messages));
+    const MessagesByBucketAndType& msgs(boost::multi_index::get<1>(_messages));
 
     auto range = pairAsRange(msgs.equal_range(boost::make_tuple(bucket)));
     runCheckerOnRange(checker, range);
@@ -250,7 +254,7 @@ bool
 PendingMessageTracker::hasPendingMessage(uint16_t node, const document::Bucket &bucket, uint32_t messageType) const
 {
     std::lock_guard guard(_lock);
-    const MessagesByNodeAndBucket& msgs(boost::multi_index::get<1>(_messages));
+    const MessagesByNodeAndBucket& msgs(boost::multi_index::get<0>(_messages));
 
     auto range = msgs.equal_range(boost::make_tuple(node, bucket, messageType));
     return (range.first != range.second);
@@ -267,7 +271,7 @@ void
 PendingMessageTracker::getStatusPerBucket(std::ostream& out) const
 {
     std::lock_guard guard(_lock);
-    const MessagesByNodeAndBucket& msgs = boost::multi_index::get<1>(_messages);
+    const MessagesByNodeAndBucket& msgs = boost::multi_index::get<0>(_messages);
     using BucketMap = std::map<document::Bucket, std::vector<vespalib::string>>;
     BucketMap perBucketMsgs;
     for (const auto& msg : msgs) {
@@ -296,7 +300,7 @@ void
 PendingMessageTracker::getStatusPerNode(std::ostream& out) const
 {
     std::lock_guard guard(_lock);
-    const MessagesByNodeAndBucket& msgs = boost::multi_index::get<1>(_messages);
+    const MessagesByNodeAndBucket& msgs = boost::multi_index::get<0>(_messages);
     int lastNode = -1;
     for (const auto & node : msgs) {
         if (node.nodeIdx != lastNode) {
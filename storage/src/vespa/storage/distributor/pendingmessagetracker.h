@@ -7,7 +7,7 @@
 #include <vespa/storageframework/generic/component/componentregister.h>
 #include <vespa/storageframework/generic/component/component.h>
 #include <vespa/storageapi/message/bucket.h>
-#include <vespa/vespalib/stllike/hash_set.h>
+#include <vespa/vespalib/stllike/swiss_hash_map.h>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/member.hpp>
@@ -140,8 +140,6 @@ private:
         vespalib::string toHtml() const;
     };
 
-    struct MessageIdKey : boost::multi_index::member<MessageEntry, uint64_t, &MessageEntry::msgId> {};
-
     /**
      * Each entry has a separate composite keyed index on node+bucket id+type.
      * This makes it efficient to find all messages for a node, for a bucket
@@ -170,15 +168,16 @@ private:
     using Messages = boost::multi_index::multi_index_container <
         MessageEntry,
         boost::multi_index::indexed_by<
-            boost::multi_index::ordered_unique<MessageIdKey>,
             boost::multi_index::ordered_non_unique<CompositeNodeBucketKey>,
             boost::multi_index::ordered_non_unique<CompositeBucketMsgNodeKey>
         >
     >;
 
-    using MessagesByMsgId         = Messages::nth_index<0>::type;
-    using MessagesByNodeAndBucket = Messages::nth_index<1>::type;
-    using MessagesByBucketAndType = Messages::nth_index<2>::type;
+    using MessagesByNodeAndBucket = Messages::nth_index<0>::type;
+    using MessagesByBucketAndType = Messages::nth_index<1>::type;
+    // Every reply looks up its message by id, so that index is a hash map
+    // rather than yet another ordered index in the container.
+    using MessagesByMsgId         = vespalib::swiss_hash_map<uint64_t, Messages::iterator>;
     using DeferredBucketTaskMap   = std::unordered_multimap<
             document::Bucket,
             std::unique_ptr<DeferredTask>,
@@ -186,6 +185,7 @@ private:
         >;
 
     Messages              _messages;
+    MessagesByMsgId       _messagesById;
     framework::Component  _component;
     NodeInfo              _nodeInfo;
     std::chrono::seconds  _nodeBusyDuration;
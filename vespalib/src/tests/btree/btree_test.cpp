@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <string>
+#include <set>
 #include <vespa/vespalib/btree/btreeroot.h>
 #include <vespa/vespalib/btree/btreebuilder.h>
 #include <vespa/vespalib/btree/btreenodeallocator.h>
@@ -1174,6 +1175,57 @@ TEST_F(BTreeTest, require_that_upper_bound_works)
     requireThatUpperBoundWorksT<SetTreeL>();
 }
 
+TEST_F(BTreeTest, require_that_vector_key_search_matches_ordered_set)
+{
+    // uint32_t keys ordered by std::less are searched with vector compares
+    using UIntTree = BTree<uint32_t, BTreeNoLeafData, btree::NoAggregated, std::less<uint32_t>>;
+    GenerationHandler g;
+    UIntTree t;
+    std::set<uint32_t> exp;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        uint32_t key = i * 0x9e3779b1u; // spread keys over the whole range, including above 2^31
+        EXPECT_TRUE(t.insert(key, BTreeNoLeafData()));
+        exp.insert(key);
+    }
+    exp.insert(0u);
+    t.insert(0u, BTreeNoLeafData());
+    exp.insert(std::numeric_limits<uint32_t>::max());
+    t.insert(std::numeric_limits<uint32_t>::max(), BTreeNoLeafData());
+    std::vector<uint32_t> keys(exp.begin(), exp.end());
+    std::vector<uint32_t> scanned;
+    for (auto itr = t.begin(); itr.valid(); ++itr) {
+        scanned.push_back(itr.getKey());
+    }
+    EXPECT_EQ(keys, scanned);
+    std::vector<uint32_t> probes;
+    for (uint32_t key : keys) {
+        probes.push_back(key - 1);
+        probes.push_back(key);
+        probes.push_back(key + 1);
+    }
+    for (uint32_t probe : probes) {
+        auto lb = exp.lower_bound(probe);
+        auto itr = t.lowerBound(probe);
+        if (lb == exp.end()) {
+            EXPECT_FALSE(itr.valid());
+        } else {
+            EXPECT_EQ(*lb, itr.getKey());
+        }
+        auto ub = exp.upper_bound(probe);
+        itr = t.upperBound(probe);
+        if (ub == exp.end()) {
+            EXPECT_FALSE(itr.valid());
+        } else {
+            EXPECT_EQ(*ub, itr.getKey());
+        }
+    }
+    auto itr = t.begin();
+    for (size_t i = 1; i < keys.size(); i += 7) {
+        itr.binarySeek(keys[i] - 1);
+        EXPECT_EQ(*exp.lower_bound(keys[i] - 1), itr.getKey());
+    }
+}
+
 struct UpdKeyComp {
     int _remainder;
     mutable size_t _numErrors;
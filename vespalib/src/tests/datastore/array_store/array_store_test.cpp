@@ -150,13 +150,13 @@ TEST("require that we test with trivial and non-trivial types")
 
 TEST_F("control static sizes", NumberFixture(3)) {
 #ifdef _LIBCPP_VERSION
-    EXPECT_EQUAL(400u, sizeof(f.store));
+    EXPECT_EQUAL(408u, sizeof(f.store));
     EXPECT_EQUAL(296u, sizeof(NumberFixture::ArrayStoreType::DataStoreType));
 #else
-    EXPECT_EQUAL(432u, sizeof(f.store));
+    EXPECT_EQUAL(440u, sizeof(f.store));
     EXPECT_EQUAL(328u, sizeof(NumberFixture::ArrayStoreType::DataStoreType));
 #endif
-    EXPECT_EQUAL(72u, sizeof(NumberFixture::ArrayStoreType::SmallArrayType));
+    EXPECT_EQUAL(80u, sizeof(NumberFixture::ArrayStoreType::SmallArrayType));
     MemoryUsage usage = f.store.getMemoryUsage();
     EXPECT_EQUAL(960u, usage.allocatedBytes());
     EXPECT_EQUAL(32u, usage.usedBytes());
@@ -360,6 +360,40 @@ TEST_F("require that compactWorst selects on neither memory nor address space",
     testCompaction(f, false, false);
 }
 
+TEST_F("require that compaction can be done in several slices", NumberFixture(3))
+{
+    std::vector<EntryRef> removed;
+    for (uint32_t i = 0; i < 100; ++i) {
+        f.add({i});
+        removed.push_back(f.add({i + 1000}));
+    }
+    for (auto ref : removed) {
+        f.remove(ref);
+    }
+    f.trimHoldLists();
+    EntryRef oldRef = f.getEntryRef({5});
+    std::vector<EntryRef> refs;
+    for (uint32_t i = 0; i < 100; ++i) {
+        refs.push_back(f.getEntryRef({i}));
+    }
+    {
+        ICompactionContext::UP ctx = f.store.compactWorst(true, false);
+        for (size_t pos = 0; pos < refs.size(); pos += 7) {
+            ctx->compact(ArrayRef<EntryRef>(&refs[pos], std::min(size_t(7), refs.size() - pos)));
+            f.trimHoldLists();
+            EXPECT_FALSE(f.store.bufferState(oldRef).isOnHold());
+            f.assertGet(oldRef, {5});
+        }
+    }
+    EXPECT_TRUE(f.store.bufferState(oldRef).isOnHold());
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_NOT_EQUAL(f.getBufferId(oldRef), f.getBufferId(refs[i]));
+        f.assertGet(refs[i], {i});
+    }
+    f.trimHoldLists();
+    EXPECT_TRUE(f.store.bufferState(oldRef).isFree());
+}
+
 TEST_F("require that used, onHold and dead memory usage is tracked for small arrays", NumberFixture(2))
 {
     MemStats exp(f.store.getMemoryUsage());
@@ -634,8 +634,33 @@ TEST(DataStoreTest, can_set_memory_allocator)
     EXPECT_EQ(AllocStats(3, 3), stats);
 }
 
+namespace {
+
+class MyHugePageAllocator : public MyMemoryAllocator
+{
+public:
+    using MyMemoryAllocator::MyMemoryAllocator;
+    size_t huge_page_bytes(PtrAndSize alloc) const override { return alloc.second; }
+};
+
+}
+
+TEST(DataStoreTest, memory_usage_reports_huge_page_bytes)
+{
+    AllocStats stats;
+    MyStore s(std::make_unique<MyBufferType>(std::make_unique<MyHugePageAllocator>(stats), MyStore::RefType::offsetSize()));
+    s.addEntry(42);
+    s.addEntry(43);
+    auto usage = s.getMemoryUsage();
+    EXPECT_LT(0u, usage.allocatedHugePageBytes());
+    EXPECT_LE(usage.allocatedHugePageBytes(), usage.allocatedBytes());
+    MyStore plain;
+    plain.addEntry(42);
+    EXPECT_EQ(0u, plain.getMemoryUsage().allocatedHugePageBytes());
+}
+
 TEST(DataStoreTest, control_static_sizes) {
-    EXPECT_EQ(72, sizeof(BufferTypeBase));
+    EXPECT_EQ(80, sizeof(BufferTypeBase));
     EXPECT_EQ(32, sizeof(BufferState::FreeList));
     EXPECT_EQ(1, sizeof(BufferState::State));
     EXPECT_EQ(144, sizeof(BufferState));
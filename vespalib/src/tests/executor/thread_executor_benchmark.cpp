@@ -0,0 +1,82 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/blockingthreadstackexecutor.h>
+#include <vespa/vespalib/util/work_stealing_executor.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/time.h>
+#include <atomic>
+#include <cinttypes>
+#include <thread>
+#include <vector>
+
+using vespalib::SyncableThreadExecutor;
+using vespalib::ThreadStackExecutor;
+using vespalib::BlockingThreadStackExecutor;
+using vespalib::WorkStealingExecutor;
+
+size_t do_work(size_t size) {
+    size_t ret = 0;
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < 128; ++j) {
+            ret = (ret + i) * j;
+        }
+    }
+    return ret;
+}
+
+struct SimpleParams {
+    int argc;
+    char **argv;
+    int idx;
+    SimpleParams(int argc_in, char **argv_in) : argc(argc_in), argv(argv_in), idx(0) {}
+    int next(const char *name, int fallback) {
+        ++idx;
+        int value = 0;
+        if (argc > idx) {
+            value = atoi(argv[idx]);
+        } else {
+            value = fallback;
+        }
+        fprintf(stderr, "param %s: %d\n", name, value);
+        return value;
+    }
+};
+
+// executor types: 0: ThreadStackExecutor, 1: BlockingThreadStackExecutor, 2: WorkStealingExecutor (blocking)
+std::unique_ptr<SyncableThreadExecutor> make_executor(int type, size_t num_threads, size_t task_limit) {
+    switch (type) {
+    case 0: return std::make_unique<ThreadStackExecutor>(num_threads, 128_Ki);
+    case 1: return std::make_unique<BlockingThreadStackExecutor>(num_threads, 128_Ki, task_limit);
+    default: return std::make_unique<WorkStealingExecutor>(num_threads, 128_Ki, task_limit, true);
+    }
+}
+
+int main(int argc, char **argv) {
+    SimpleParams params(argc, argv);
+    int executor_type = params.next("executor_type", 2);
+    size_t num_tasks = params.next("num_tasks", 1000000);
+    size_t num_producers = params.next("num_producers", 4);
+    size_t num_threads = params.next("num_threads", 8);
+    size_t task_limit = params.next("task_limit", 1000);
+    size_t work_size = params.next("work_size", 0);
+    std::atomic<long> counter(0);
+    auto executor = make_executor(executor_type, num_threads, task_limit);
+    vespalib::Timer timer;
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p]() {
+                                   for (size_t task_id = p; task_id < num_tasks; task_id += num_producers) {
+                                       executor->execute(vespalib::makeLambdaTask([&counter,work_size] { (void) do_work(work_size); counter++; }));
+                                   }
+                               });
+    }
+    for (auto &producer: producers) {
+        producer.join();
+    }
+    executor->sync();
+    fprintf(stderr, "\ntotal time: %" PRId64 " ms\n", vespalib::count_ms(timer.elapsed()));
+    executor.reset();
+    return (size_t(counter) == num_tasks) ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+
+#include <vespa/vespalib/util/work_stealing_executor.h>
+#include <vespa/vespalib/util/backtrace.h>
+#include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <atomic>
+#include <thread>
+
+using namespace vespalib;
+
+using Task = Executor::Task;
+
+struct MyTask : public Executor::Task {
+    Gate &gate;
+    CountDownLatch &latch;
+    static std::atomic<uint32_t> runCnt;
+    static std::atomic<uint32_t> deleteCnt;
+    MyTask(Gate &g, CountDownLatch &l) : gate(g), latch(l) {}
+    void run() override {
+        runCnt.fetch_add(1);
+        latch.countDown();
+        gate.await();
+    }
+    ~MyTask() override {
+        deleteCnt.fetch_add(1);
+    }
+    static void resetStats() {
+        runCnt = 0;
+        deleteCnt = 0;
+    }
+};
+std::atomic<uint32_t> MyTask::runCnt(0);
+std::atomic<uint32_t> MyTask::deleteCnt(0);
+
+struct MyState {
+    Gate                 gate;     // to block workers
+    CountDownLatch       latch;    // to wait for workers
+    WorkStealingExecutor executor;
+    bool                 checked;
+    MyState() : gate(), latch(10), executor(10, 128_Ki, 20), checked(false)
+    {
+        MyTask::resetStats();
+    }
+    MyState &execute(uint32_t cnt) {
+        for (uint32_t i = 0; i < cnt; ++i) {
+            executor.execute(std::make_unique<MyTask>(gate, latch));
+        }
+        return *this;
+    }
+    MyState &sync() {
+        executor.sync();
+        return *this;
+    }
+    MyState &shutdown() {
+        executor.shutdown();
+        return *this;
+    }
+    MyState &open() {
+        gate.countDown();
+        return *this;
+    }
+    MyState &wait() {
+        latch.await();
+        return *this;
+    }
+    MyState &check(uint32_t expect_rejected,
+                   uint32_t expect_queue,
+                   uint32_t expect_running,
+                   uint32_t expect_deleted)
+    {
+        ASSERT_TRUE(!checked);
+        checked = true;
+        WorkStealingExecutor::Stats stats = executor.getStats();
+        EXPECT_EQUAL(expect_running + expect_deleted, MyTask::runCnt);
+        EXPECT_EQUAL(expect_rejected + expect_deleted, MyTask::deleteCnt);
+        EXPECT_EQUAL(expect_queue + expect_running + expect_deleted,
+                     stats.acceptedTasks);
+        EXPECT_EQUAL(expect_rejected, stats.rejectedTasks);
+        if (expect_deleted == 0) {
+            EXPECT_EQUAL(expect_queue + expect_running, stats.queueSize.max());
+        }
+        stats = executor.getStats();
+        EXPECT_EQUAL(expect_queue + expect_running, stats.queueSize.max());
+        EXPECT_EQUAL(0u, stats.acceptedTasks);
+        EXPECT_EQUAL(0u, stats.rejectedTasks);
+        return *this;
+    }
+};
+
+TEST_F("require that tasks are run and deleted", MyState()) {
+    TEST_DO(f1.open().execute(5).sync().check(0, 0, 0, 5));
+}
+
+TEST_F("require that tasks run concurrently", MyState()) {
+    TEST_DO(f1.execute(10).wait().check(0, 0, 10, 0).open());
+}
+
+TEST_F("require that thread count is respected", MyState()) {
+    TEST_DO(f1.execute(20).wait().check(0, 10, 10, 0).open());
+}
+
+TEST_F("require that extra tasks are dropped", MyState()) {
+    TEST_DO(f1.execute(40).wait().check(20, 10, 10, 0).open());
+}
+
+TEST_F("require that active workers drain input queue", MyState()) {
+    TEST_DO(f1.execute(20).wait().open().sync().check(0, 0, 0, 20));
+}
+
+TEST_F("require that pending tasks are run after shutdown", MyState()) {
+    TEST_DO(f1.execute(20).wait().shutdown().open().sync().check(0, 0, 0, 20));
+}
+
+TEST_F("require that new tasks are dropped after shutdown", MyState()) {
+    TEST_DO(f1.open().shutdown().execute(5).sync().check(5, 0, 0, 0));
+}
+
+struct BlockingState {
+    Gate                 gate;
+    CountDownLatch       latch;
+    WorkStealingExecutor executor;
+    BlockingState(uint32_t taskLimit, uint32_t tasksToWaitFor)
+        : gate(), latch(tasksToWaitFor), executor(1, 128_Ki, taskLimit, true)
+    {}
+    void execute(size_t numTasks) {
+        for (size_t i = 0; i < numTasks; ++i) {
+            EXPECT_TRUE(executor.execute(std::make_unique<MyTask>(gate, latch)).get() == nullptr);
+        }
+    }
+};
+
+TEST_F("require that blocking executor blocks when task limit is reached", BlockingState(3, 4)) {
+    f1.execute(3);
+    Gate executed;
+    std::thread thread([&state = f1, &executed]() {
+                           state.execute(1);
+                           executed.countDown();
+                       });
+    EXPECT_FALSE(executed.await(10ms));
+    f1.gate.countDown();
+    EXPECT_TRUE(executed.await(30s));
+    thread.join();
+    f1.latch.await();
+    f1.executor.sync();
+}
+
+TEST_F("require that blocking executor unblocks when task limit is increased", BlockingState(3, 4)) {
+    f1.execute(3);
+    Gate executed;
+    std::thread thread([&state = f1, &executed]() {
+                           state.execute(1);
+                           executed.countDown();
+                       });
+    EXPECT_FALSE(executed.await(10ms));
+    f1.executor.setTaskLimit(4);
+    EXPECT_TRUE(executed.await(30s));
+    thread.join();
+    f1.gate.countDown();
+    f1.latch.await();
+    f1.executor.sync();
+}
+
+TEST_F("require that blocking executor rejects tasks when shut down while blocked", BlockingState(3, 3)) {
+    f1.execute(3);
+    std::thread thread([&state = f1]() {
+                           EXPECT_TRUE(state.executor.execute(std::make_unique<MyTask>(state.gate, state.latch)).get() != nullptr);
+                       });
+    std::this_thread::sleep_for(10ms);
+    f1.executor.shutdown();
+    thread.join();
+    f1.gate.countDown();
+    f1.executor.sync();
+    EXPECT_EQUAL(1u, f1.executor.getStats().rejectedTasks);
+}
+
+struct SpawnTask : public Executor::Task {
+    Executor &executor;
+    CountDownLatch &latch;
+    size_t depth;
+    SpawnTask(Executor &executor_in, CountDownLatch &latch_in, size_t depth_in)
+        : executor(executor_in), latch(latch_in), depth(depth_in) {}
+    void run() override {
+        if (depth > 0) {
+            EXPECT_TRUE(executor.execute(std::make_unique<SpawnTask>(executor, latch, depth - 1)).get() == nullptr);
+            EXPECT_TRUE(executor.execute(std::make_unique<SpawnTask>(executor, latch, depth - 1)).get() == nullptr);
+        }
+        latch.countDown();
+    }
+};
+
+TEST("require that tasks can be executed by worker threads") {
+    WorkStealingExecutor executor(4, 128_Ki);
+    CountDownLatch latch((1 << 13) - 1);
+    executor.execute(std::make_unique<SpawnTask>(executor, latch, 12));
+    EXPECT_TRUE(latch.await(30s));
+    executor.sync();
+    EXPECT_EQUAL(size_t((1 << 13) - 1), executor.getStats().acceptedTasks);
+}
+
+struct CountTask : public Executor::Task {
+    std::atomic<size_t> &count;
+    explicit CountTask(std::atomic<size_t> &count_in) : count(count_in) {}
+    void run() override { count.fetch_add(1, std::memory_order_relaxed); }
+};
+
+struct StressState {
+    WorkStealingExecutor executor;
+    std::atomic<size_t> count;
+    StressState() : executor(4, 128_Ki, 1000, true), count(0) {}
+};
+
+TEST_MT_F("require that many threads can execute and sync concurrently", 8, StressState()) {
+    for (size_t i = 0; i < 5000; ++i) {
+        EXPECT_TRUE(f1.executor.execute(std::make_unique<CountTask>(f1.count)).get() == nullptr);
+        if ((i % 1000) == (thread_id * 100)) {
+            f1.executor.sync();
+        }
+    }
+    TEST_BARRIER();
+    if (thread_id == 0) {
+        f1.executor.sync();
+        EXPECT_EQUAL(num_threads * 5000, f1.count.load());
+    }
+}
+
+vespalib::string get_worker_stack_trace(WorkStealingExecutor &executor) {
+    struct StackTraceTask : public Executor::Task {
+        vespalib::string &trace;
+        explicit StackTraceTask(vespalib::string &t) : trace(t) {}
+        void run() override { trace = getStackTrace(0); }
+    };
+    vespalib::string trace;
+    executor.execute(std::make_unique<StackTraceTask>(trace));
+    executor.sync();
+    return trace;
+}
+
+VESPA_THREAD_STACK_TAG(my_stack_tag);
+
+TEST_F("require that executor has appropriate default thread stack tag", WorkStealingExecutor(1, 128_Ki)) {
+    vespalib::string trace = get_worker_stack_trace(f1);
+    if (!EXPECT_TRUE(trace.find("unnamed_work_stealing_executor") != vespalib::string::npos)) {
+        fprintf(stderr, "%s\n", trace.c_str());
+    }
+}
+
+TEST_F("require that executor thread stack tag can be set", WorkStealingExecutor(1, 128_Ki, my_stack_tag)) {
+    vespalib::string trace = get_worker_stack_trace(f1);
+    if (!EXPECT_TRUE(trace.find("my_stack_tag") != vespalib::string::npos)) {
+        fprintf(stderr, "%s\n", trace.c_str());
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
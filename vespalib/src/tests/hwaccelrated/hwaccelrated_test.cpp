@@ -37,4 +37,38 @@ TEST("test euclidean distance") {
     verifyEuclideanDistance<double >(genericAccelrator);
 }
 
+template<typename T, typename S>
+void verifyDotProduct(const hwaccelrated::IAccelrated & accel, size_t testLength) {
+    srand(1);
+    std::vector<T> a(testLength);
+    std::vector<T> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand()%255 - 127;
+        b[i] = rand()%255 - 127;
+    }
+    for (size_t j(0); j < 0x41; j++) {
+        S sum(0);
+        for (size_t i(j); i < testLength; i++) {
+            sum += S(a[i]) * S(b[i]);
+        }
+        S hwComputedSum(accel.dotProduct(&a[j], &b[j], testLength - j));
+        EXPECT_EQUAL(sum, hwComputedSum);
+    }
+}
+
+TEST("test int8 dot product") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    const auto & accel = hwaccelrated::IAccelrated::getAccelerator();
+    verifyDotProduct<int8_t, int64_t>(genericAccelrator, 255);
+    verifyDotProduct<int8_t, int64_t>(accel, 255);
+    verifyDotProduct<int8_t, int64_t>(accel, 2000000);
+}
+
+TEST("test bfloat16 dot product") {
+    hwaccelrated::GenericAccelrator genericAccelrator;
+    const auto & accel = hwaccelrated::IAccelrated::getAccelerator();
+    verifyDotProduct<BFloat16, float>(genericAccelrator, 255);
+    verifyDotProduct<BFloat16, float>(accel, 255);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
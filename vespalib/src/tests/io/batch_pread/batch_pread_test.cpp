@@ -0,0 +1,95 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/io/batch_pread.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+using vespalib::BatchPRead;
+
+namespace {
+
+const char *file_name = "batch_pread_test.dat";
+constexpr size_t file_size = 1024 * 1024;
+
+uint8_t expected_byte(size_t pos) { return (pos * 7 + (pos >> 10)) & 0xff; }
+
+struct BatchPReadTest : public ::testing::Test
+{
+    int fd;
+    BatchPReadTest()
+        : fd(-1)
+    {
+        std::vector<uint8_t> data(file_size);
+        for (size_t i = 0; i < file_size; ++i) {
+            data[i] = expected_byte(i);
+        }
+        int wfd = ::open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        EXPECT_EQ(ssize_t(file_size), ::write(wfd, data.data(), data.size()));
+        ::close(wfd);
+        fd = ::open(file_name, O_RDONLY);
+    }
+    ~BatchPReadTest() override {
+        ::close(fd);
+        ::unlink(file_name);
+    }
+    void read_and_verify(size_t num_requests, size_t len) {
+        std::vector<std::vector<uint8_t>> buffers(num_requests, std::vector<uint8_t>(len));
+        std::vector<BatchPRead::Request> requests;
+        for (size_t i = 0; i < num_requests; ++i) {
+            size_t offset = (i * 7919 * 13) % (file_size - len);
+            requests.emplace_back(fd, buffers[i].data(), len, offset);
+        }
+        BatchPRead::read(requests.data(), requests.size());
+        for (size_t i = 0; i < num_requests; ++i) {
+            ASSERT_EQ(ssize_t(len), requests[i].result);
+            for (size_t j = 0; j < len; ++j) {
+                ASSERT_EQ(expected_byte(requests[i].offset + j), buffers[i][j]);
+            }
+        }
+    }
+};
+
+}
+
+TEST_F(BatchPReadTest, single_read_is_performed)
+{
+    read_and_verify(1, 4096);
+}
+
+TEST_F(BatchPReadTest, batch_larger_than_ring_is_performed)
+{
+    read_and_verify(200, 1000);
+}
+
+TEST_F(BatchPReadTest, read_past_end_of_file_is_short)
+{
+    std::vector<uint8_t> buf(100);
+    std::vector<BatchPRead::Request> requests;
+    requests.emplace_back(fd, buf.data(), buf.size(), file_size - 10);
+    requests.emplace_back(fd, buf.data(), 0, 0);
+    BatchPRead::read(requests.data(), requests.size());
+    EXPECT_EQ(10, requests[0].result);
+    EXPECT_EQ(0, requests[1].result);
+}
+
+TEST_F(BatchPReadTest, read_from_bad_file_descriptor_fails)
+{
+    std::vector<uint8_t> buf(100);
+    std::vector<BatchPRead::Request> requests;
+    requests.emplace_back(-1, buf.data(), buf.size(), 0);
+    requests.emplace_back(fd, buf.data(), buf.size(), 0);
+    BatchPRead::read(requests.data(), requests.size());
+    EXPECT_EQ(-EBADF, requests[0].result);
+    EXPECT_EQ(100, requests[1].result);
+}
+
+TEST_F(BatchPReadTest, thread_pool_fallback_gives_same_result)
+{
+    BatchPRead::disable_io_uring();
+    EXPECT_FALSE(BatchPRead::has_io_uring());
+    read_and_verify(200, 1000);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
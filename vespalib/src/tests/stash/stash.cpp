@@ -3,6 +3,8 @@
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/stash.h>
 #include <vespa/vespalib/util/traits.h>
+#include <cstring>
+#include <thread>
 
 using namespace vespalib;
 
@@ -471,4 +473,104 @@ TEST("require that uninitialized arrays can be created") {
     EXPECT_EQUAL(sum({chunk_header_size(), sizeof(float) * 64}), stash.count_used());
 }
 
+struct Base : StashAllocated {
+    size_t &destructed;
+    explicit Base(size_t &dref) : destructed(dref) {}
+    virtual ~Base() { ++destructed; }
+};
+
+struct Derived : Base {
+    char bloat[100];
+    explicit Derived(size_t &dref) : Base(dref), bloat() {}
+};
+
+struct OverAligned : Base {
+    alignas(64) char words[64];
+    explicit OverAligned(size_t &dref) : Base(dref), words() {}
+};
+
+bool is_aligned(const void *ptr, size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return ((reinterpret_cast<uintptr_t>(ptr) % align) == 0);
+}
+
+TEST("require that stash allocated objects use the heap when no stash is bound") {
+    size_t destructed = 0;
+    EXPECT_TRUE(StashScope::current() == nullptr);
+    std::unique_ptr<Base> obj = std::make_unique<Derived>(destructed);
+    EXPECT_TRUE(is_aligned(obj.get()));
+    obj.reset();
+    EXPECT_EQUAL(1u, destructed);
+}
+
+TEST("require that stash allocated objects use the stash bound to the current thread") {
+    size_t destructed = 0;
+    Stash stash;
+    std::unique_ptr<Base> obj1;
+    std::unique_ptr<Base> obj2;
+    {
+        StashScope scope(stash);
+        EXPECT_EQUAL(&stash, StashScope::current());
+        obj1 = std::make_unique<Derived>(destructed);
+        obj2 = std::make_unique<Base>(destructed);
+    }
+    EXPECT_TRUE(StashScope::current() == nullptr);
+    EXPECT_TRUE(is_aligned(obj1.get()));
+    EXPECT_TRUE(is_aligned(obj2.get()));
+    size_t used = stash.count_used();
+    EXPECT_GREATER(used, sum({chunk_header_size(), sizeof(Derived), sizeof(Base)}));
+    obj1.reset();
+    obj2.reset();
+    EXPECT_EQUAL(2u, destructed);
+    EXPECT_EQUAL(used, stash.count_used());
+}
+
+TEST("require that over-aligned stash allocated objects keep their alignment") {
+    size_t destructed = 0;
+    Stash stash;
+    std::vector<std::unique_ptr<Base>> objs;
+    for (size_t i = 0; i < 5; ++i) {
+        objs.push_back(std::make_unique<OverAligned>(destructed));
+        objs.push_back(std::make_unique<Derived>(destructed));
+    }
+    {
+        StashScope scope(stash);
+        for (size_t i = 0; i < 5; ++i) {
+            objs.push_back(std::make_unique<OverAligned>(destructed));
+            objs.push_back(std::make_unique<Derived>(destructed));
+        }
+    }
+    EXPECT_GREATER(stash.count_used(), 5 * sizeof(OverAligned));
+    for (size_t i = 0; i < objs.size(); i += 2) {
+        auto *obj = static_cast<OverAligned *>(objs[i].get());
+        EXPECT_TRUE(is_aligned(obj->words, 64));
+        memset(obj->words, 0xff, sizeof(obj->words));
+    }
+    objs.clear();
+    EXPECT_EQUAL(20u, destructed);
+}
+
+TEST("require that stash scopes can be nested") {
+    size_t destructed = 0;
+    Stash outer;
+    Stash inner;
+    StashScope outer_scope(outer);
+    {
+        StashScope inner_scope(inner);
+        EXPECT_EQUAL(&inner, StashScope::current());
+        auto obj = std::make_unique<Derived>(destructed);
+        EXPECT_EQUAL(0u, outer.count_used());
+        EXPECT_GREATER(inner.count_used(), 0u);
+    }
+    EXPECT_EQUAL(&outer, StashScope::current());
+    EXPECT_EQUAL(1u, destructed);
+}
+
+TEST("require that the stash scope is thread local") {
+    Stash stash;
+    StashScope scope(stash);
+    Stash *seen = &stash;
+    std::thread([&seen]() { seen = StashScope::current(); }).join();
+    EXPECT_TRUE(seen == nullptr);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,6 +8,8 @@
 #include <xxhash.h>
 #include <vespa/vespalib/stllike/hash_set.hpp>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/stllike/swiss_hash_set.h>
+#include <vespa/vespalib/stllike/swiss_hash_map.h>
 
 template <typename S>
 void fill(S & s, size_t count)
@@ -94,6 +96,18 @@ size_t benchHashMapVespaLib2(size_t sz, size_t numLookups)
     return benchM(set, sz, numLookups);
 }
 
+size_t benchSwissHashVespaLib(size_t sz, size_t numLookups)
+{
+    vespalib::swiss_hash_set<uint32_t> set(sz);
+    return bench(set, sz, numLookups);
+}
+
+size_t benchSwissHashMapVespaLib(size_t sz, size_t numLookups)
+{
+    vespalib::swiss_hash_map<uint32_t, uint32_t> set(sz);
+    return benchM(set, sz, numLookups);
+}
+
 std::unique_ptr<char []> createData(size_t sz) {
     auto data = std::make_unique<char []>(sz);
     for (size_t i(0); i < sz; i++) {
@@ -150,6 +164,8 @@ int main(int argc, char *argv[])
     description['G'] = "vespalib::hash_set with simple and modulator.";
     description['k'] = "vespalib::hash_map";
     description['K'] = "vespalib::hash_map with simple and modulator.";
+    description['s'] = "vespalib::swiss_hash_set";
+    description['S'] = "vespalib::swiss_hash_map";
     description['x'] = "xxhash32";
     description['X'] = "xxhash64";
     description['l'] = "legacy";
@@ -161,11 +177,13 @@ int main(int argc, char *argv[])
         case 'G': found = benchHashVespaLib2(count, rep); break;
         case 'k': found = benchHashMapVespaLib(count, rep); break;
         case 'K': found = benchHashMapVespaLib2(count, rep); break;
+        case 's': found = benchSwissHashVespaLib(count, rep); break;
+        case 'S': found = benchSwissHashMapVespaLib(count, rep); break;
         case 'x': found = benchXXHash32(count, rep); break;
         case 'X': found = benchXXHash64(count, rep); break;
         case 'l': found = benchLegacyHash(count, rep); break;
         default:
-            for (char c : "mhgGkKxXl") {
+            for (char c : "mhgGkKsSxXl") {
                 printf("'%c' = %s\n", c, description[c]);
             }
             return 1;
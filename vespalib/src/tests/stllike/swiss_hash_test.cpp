@@ -0,0 +1,210 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/stllike/swiss_hash_map.h>
+#include <vespa/vespalib/stllike/swiss_hash_set.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <map>
+#include <random>
+
+using namespace vespalib;
+
+namespace {
+
+// all keys collide on the low bits of the hash
+struct BadHash {
+    size_t operator() (uint32_t key) const noexcept { return (size_t(key) << 32); }
+};
+
+struct Counted {
+    static size_t alive;
+    int value;
+    Counted(int value_in) noexcept : value(value_in) { ++alive; }
+    Counted(const Counted &rhs) noexcept : value(rhs.value) { ++alive; }
+    Counted(Counted &&rhs) noexcept : value(rhs.value) { ++alive; }
+    Counted & operator = (const Counted &) = default;
+    ~Counted() { --alive; }
+    bool operator == (const Counted &rhs) const { return (value == rhs.value); }
+};
+size_t Counted::alive = 0;
+
+}
+
+TEST("require that empty map does not allocate") {
+    swiss_hash_map<uint32_t, uint32_t> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQUAL(0u, m.size());
+    EXPECT_TRUE(m.find(7) == m.end());
+    EXPECT_TRUE(m.begin() == m.end());
+    EXPECT_EQUAL(sizeof(m), m.getMemoryConsumption());
+    m.erase(7);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+}
+
+TEST("require that map entries can be inserted, found and erased") {
+    swiss_hash_map<uint32_t, uint32_t> m;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(m.insert(std::make_pair(i, i * 2)).second);
+        EXPECT_FALSE(m.insert(std::make_pair(i, i * 3)).second);
+    }
+    EXPECT_EQUAL(1000u, m.size());
+    EXPECT_EQUAL(2048u, m.capacity());
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto found = m.find(i);
+        ASSERT_TRUE(found != m.end());
+        EXPECT_EQUAL(i * 2, found->second);
+        EXPECT_TRUE(m.contains(i));
+        EXPECT_EQUAL(1u, m.count(i));
+    }
+    EXPECT_TRUE(m.find(1000) == m.end());
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        m.erase(i);
+    }
+    EXPECT_EQUAL(500u, m.size());
+    for (uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_EQUAL((i % 2) == 1, m.contains(i));
+    }
+}
+
+TEST("require that operator[] inserts default value") {
+    swiss_hash_map<vespalib::string, int> m;
+    m["foo"] = 3;
+    m["bar"] += 5;
+    m["foo"] += 1;
+    EXPECT_EQUAL(2u, m.size());
+    EXPECT_EQUAL(4, m["foo"]);
+    EXPECT_EQUAL(5, m["bar"]);
+    EXPECT_EQUAL(0, m["baz"]);
+    EXPECT_EQUAL(3u, m.size());
+}
+
+TEST("require that iteration visits all entries once") {
+    swiss_hash_set<uint32_t> s;
+    for (uint32_t i = 0; i < 100; ++i) {
+        s.insert(i * 7);
+    }
+    std::vector<uint32_t> seen(s.begin(), s.end());
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQUAL(100u, seen.size());
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_EQUAL(i * 7, seen[i]);
+    }
+    size_t sum = 0;
+    s.for_each([&sum](uint32_t v) { sum += v; });
+    EXPECT_EQUAL(7u * 99 * 100 / 2, sum);
+}
+
+TEST("require that weak hash functions work") {
+    swiss_hash_set<uint32_t, BadHash> s;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        s.insert(i);
+    }
+    for (uint32_t i = 0; i < 20000; ++i) {
+        EXPECT_EQUAL(i < 10000, s.contains(i));
+    }
+}
+
+TEST("require that erased slots are reused") {
+    swiss_hash_map<uint32_t, uint32_t> m(100);
+    size_t capacity = m.capacity();
+    for (uint32_t round = 0; round < 100; ++round) {
+        for (uint32_t i = 0; i < 100; ++i) {
+            m[round * 100 + i] = i;
+        }
+        for (uint32_t i = 0; i < 100; ++i) {
+            m.erase(round * 100 + i);
+        }
+    }
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQUAL(capacity, m.capacity());
+}
+
+TEST("require that random operations match std::map") {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> key_dist(0, 5000);
+    swiss_hash_map<uint32_t, uint32_t> m;
+    std::map<uint32_t, uint32_t> ref;
+    for (size_t i = 0; i < 200000; ++i) {
+        uint32_t key = key_dist(gen);
+        switch (gen() % 3) {
+        case 0:
+            m[key] = i;
+            ref[key] = i;
+            break;
+        case 1:
+            m.erase(key);
+            ref.erase(key);
+            break;
+        default:
+            auto found = m.find(key);
+            auto ref_found = ref.find(key);
+            ASSERT_EQUAL(ref_found == ref.end(), found == m.end());
+            if (found != m.end()) {
+                EXPECT_EQUAL(ref_found->second, found->second);
+            }
+        }
+    }
+    EXPECT_EQUAL(ref.size(), m.size());
+    size_t visited = 0;
+    for (const auto &entry : m) {
+        ++visited;
+        EXPECT_EQUAL(ref[entry.first], entry.second);
+    }
+    EXPECT_EQUAL(ref.size(), visited);
+}
+
+TEST("require that entries are destructed") {
+    {
+        swiss_hash_map<int, Counted> m;
+        for (int i = 0; i < 1000; ++i) {
+            m.insert(std::make_pair(i, Counted(i)));
+        }
+        EXPECT_EQUAL(1000u, Counted::alive);
+        m.erase(17);
+        EXPECT_EQUAL(999u, Counted::alive);
+        swiss_hash_map<int, Counted> copy(m);
+        EXPECT_EQUAL(1998u, Counted::alive);
+        EXPECT_TRUE(copy == m);
+        copy.clear();
+        EXPECT_EQUAL(999u, Counted::alive);
+        EXPECT_FALSE(copy == m);
+    }
+    EXPECT_EQUAL(0u, Counted::alive);
+}
+
+TEST("require that map can be moved and swapped") {
+    swiss_hash_map<int, std::unique_ptr<int>> m;
+    EXPECT_TRUE(m.insert(std::make_pair(4, std::make_unique<int>(5))).second);
+    swiss_hash_map<int, std::unique_ptr<int>> moved(std::move(m));
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.find(4) == m.end());
+    ASSERT_TRUE(moved.find(4) != moved.end());
+    EXPECT_EQUAL(5, *moved[4]);
+    swap(m, moved);
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQUAL(5, *m[4]);
+    m[5] = std::make_unique<int>(6);
+    EXPECT_EQUAL(2u, m.size());
+}
+
+TEST("require that set can be looked up by alternative key") {
+    swiss_hash_set<vespalib::string> s({"foo", "bar"});
+    EXPECT_EQUAL(2u, s.size());
+    EXPECT_TRUE(s.find(vespalib::stringref("foo")) != s.end());
+    EXPECT_TRUE(s.find(vespalib::stringref("baz")) == s.end());
+}
+
+TEST("require that resize reserves room without growing later") {
+    swiss_hash_set<uint32_t> s;
+    s.resize(1000);
+    size_t capacity = s.capacity();
+    EXPECT_EQUAL(2048u, capacity);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        s.insert(i);
+    }
+    EXPECT_EQUAL(capacity, s.capacity());
+    EXPECT_LESS(s.getMemoryConsumption(), capacity * (sizeof(uint32_t) + 1) + 128);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -3,6 +3,8 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/generationhandler.h>
 #include <deque>
+#include <thread>
+#include <vector>
 
 namespace vespalib {
 
@@ -15,6 +17,7 @@ private:
     void requireThatGuardsCanBeCopied();
     void requireThatTheFirstUsedGenerationIsCorrect();
     void requireThatGenerationCanGrowLarge();
+    void requireThatGuardsFromManyThreadsAreCounted();
 public:
     int Main() override;
 };
@@ -138,6 +141,40 @@ Test::requireThatGenerationCanGrowLarge()
     }
 }
 
+void
+Test::requireThatGuardsFromManyThreadsAreCounted()
+{
+    GenerationHandler gh;
+    constexpr size_t num_threads = 16;
+    std::vector<GenGuard> guards(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&gh, &guard = guards[i]]() { guard = gh.takeGuard(); });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    threads.clear();
+    EXPECT_EQUAL(num_threads, gh.getGenerationRefCount(0));
+    gh.incGeneration();
+    EXPECT_EQUAL(0u, gh.getFirstUsedGeneration());
+    for (size_t i = 0; i < num_threads; ++i) {
+        // copy and release guards in other threads than the ones taking them
+        threads.emplace_back([&guard = guards[num_threads - 1 - i]]() {
+                                 GenGuard copy(guard);
+                                 guard = GenGuard();
+                             });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQUAL(0u, gh.getGenerationRefCount(0));
+    EXPECT_TRUE(gh.hasReaders());
+    gh.updateFirstUsedGeneration();
+    EXPECT_FALSE(gh.hasReaders());
+    EXPECT_EQUAL(1u, gh.getFirstUsedGeneration());
+}
+
 int
 Test::Main()
 {
@@ -148,6 +185,7 @@ Test::Main()
     TEST_DO(requireThatGuardsCanBeCopied());
     TEST_DO(requireThatTheFirstUsedGenerationIsCorrect());
     TEST_DO(requireThatGenerationCanGrowLarge());
+    TEST_DO(requireThatGuardsFromManyThreadsAreCounted());
 
     TEST_DONE();
 }
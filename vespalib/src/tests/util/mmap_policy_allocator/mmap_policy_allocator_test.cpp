@@ -0,0 +1,140 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/mmap_policy_allocator.h>
+#include <vespa/vespalib/util/alloc.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cstring>
+
+using vespalib::alloc::Alloc;
+using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::MmapPolicy;
+using vespalib::alloc::MmapPolicyAllocator;
+
+using HugePages = MmapPolicy::HugePages;
+using Numa = MmapPolicy::Numa;
+
+namespace {
+
+constexpr size_t huge_page_size = MemoryAllocator::HUGEPAGE_SIZE;
+
+struct MyAlloc
+{
+    const MemoryAllocator& allocator;
+    MemoryAllocator::PtrAndSize buf;
+
+    MyAlloc(const MemoryAllocator& allocator_in, size_t sz)
+        : allocator(allocator_in),
+          buf(allocator.alloc(sz))
+    {
+    }
+
+    ~MyAlloc()
+    {
+        allocator.free(buf);
+    }
+
+    void* data() const noexcept { return buf.first; }
+    size_t size() const noexcept { return buf.second; }
+};
+
+bool is_huge_page_aligned(const void* ptr) {
+    return (reinterpret_cast<uintptr_t>(ptr) & (huge_page_size - 1)) == 0;
+}
+
+}
+
+TEST(MmapPolicyAllocatorTest, zero_sized_allocation_is_handled)
+{
+    MmapPolicyAllocator allocator(MmapPolicy(HugePages::TRANSPARENT, Numa::DEFAULT));
+    MyAlloc buf(allocator, 0);
+    EXPECT_EQ(nullptr, buf.data());
+    EXPECT_EQ(0u, buf.size());
+    EXPECT_EQ(0u, allocator.huge_page_bytes(buf.buf));
+}
+
+TEST(MmapPolicyAllocatorTest, small_allocation_uses_heap)
+{
+    MmapPolicyAllocator allocator(MmapPolicy(HugePages::TRANSPARENT, Numa::INTERLEAVE));
+    MyAlloc buf(allocator, 1000);
+    EXPECT_TRUE(buf.data() != nullptr);
+    EXPECT_EQ(1000u, buf.size());
+    memset(buf.data(), 1, buf.size());
+    EXPECT_EQ(0u, allocator.huge_page_bytes(buf.buf));
+    EXPECT_EQ(0u, allocator.resize_inplace(buf.buf, 2000));
+}
+
+TEST(MmapPolicyAllocatorTest, large_allocation_is_rounded_up_to_huge_pages)
+{
+    MmapPolicyAllocator allocator(MmapPolicy(HugePages::TRANSPARENT, Numa::DEFAULT));
+    MyAlloc buf(allocator, huge_page_size + 1);
+    EXPECT_EQ(2 * huge_page_size, buf.size());
+    EXPECT_TRUE(is_huge_page_aligned(buf.data()));
+    memset(buf.data(), 1, buf.size());
+    // Huge pages are only reported if the kernel accepted the advice
+    size_t huge_page_bytes = allocator.huge_page_bytes(buf.buf);
+    EXPECT_TRUE(huge_page_bytes == 0u || huge_page_bytes == buf.size());
+}
+
+TEST(MmapPolicyAllocatorTest, ordinary_pages_are_not_reported_as_huge_pages)
+{
+    MmapPolicyAllocator allocator(MmapPolicy(HugePages::NONE, Numa::INTERLEAVE));
+    MyAlloc buf(allocator, 3 * huge_page_size);
+    EXPECT_EQ(3 * huge_page_size, buf.size());
+    memset(buf.data(), 1, buf.size());
+    EXPECT_EQ(0u, allocator.huge_page_bytes(buf.buf));
+}
+
+TEST(MmapPolicyAllocatorTest, explicit_huge_pages_falls_back_when_not_available)
+{
+    MmapPolicyAllocator allocator(MmapPolicy(HugePages::EXPLICIT, Numa::BIND, 0));
+    MyAlloc buf(allocator, huge_page_size);
+    EXPECT_EQ(huge_page_size, buf.size());
+    EXPECT_TRUE(is_huge_page_aligned(buf.data()));
+    memset(buf.data(), 1, buf.size());
+    EXPECT_EQ(0u, allocator.resize_inplace(buf.buf, 2 * huge_page_size));
+}
+
+TEST(MmapPolicyAllocatorTest, resize_inplace_works_in_whole_huge_pages)
+{
+    MmapPolicyAllocator allocator(MmapPolicy(HugePages::TRANSPARENT, Numa::DEFAULT));
+    MyAlloc buf(allocator, 4 * huge_page_size);
+    EXPECT_EQ(2 * huge_page_size, allocator.resize_inplace(buf.buf, huge_page_size + 1));
+    buf.buf.second = 2 * huge_page_size;
+    memset(buf.data(), 1, buf.size());
+    size_t new_size = allocator.resize_inplace(buf.buf, 3 * huge_page_size);
+    // Growing depends on the address space after the mapping being free
+    EXPECT_TRUE(new_size == 0u || new_size == 3 * huge_page_size);
+    if (new_size != 0u) {
+        buf.buf.second = new_size;
+        memset(buf.data(), 2, buf.size());
+    }
+}
+
+TEST(MmapPolicyAllocatorTest, allocators_are_shared_per_policy)
+{
+    MmapPolicy transparent(HugePages::TRANSPARENT, Numa::DEFAULT);
+    MmapPolicy bind0(HugePages::NONE, Numa::BIND, 0);
+    MmapPolicy bind1(HugePages::NONE, Numa::BIND, 1);
+    EXPECT_EQ(nullptr, MmapPolicyAllocator::get_allocator(MmapPolicy()));
+    auto a = MmapPolicyAllocator::get_allocator(transparent);
+    auto b = MmapPolicyAllocator::get_allocator(bind0);
+    auto c = MmapPolicyAllocator::get_allocator(bind1);
+    EXPECT_TRUE(a != nullptr);
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(b != c);
+    EXPECT_EQ(a, MmapPolicyAllocator::get_allocator(transparent));
+    EXPECT_EQ(c, MmapPolicyAllocator::get_allocator(bind1));
+    EXPECT_TRUE(transparent == dynamic_cast<const MmapPolicyAllocator&>(*a).policy());
+}
+
+TEST(MmapPolicyAllocatorTest, alloc_reports_huge_page_bytes)
+{
+    auto allocator = MmapPolicyAllocator::get_allocator(MmapPolicy(HugePages::TRANSPARENT, Numa::DEFAULT));
+    Alloc buf = Alloc::alloc_with_allocator(allocator).create(huge_page_size);
+    EXPECT_EQ(huge_page_size, buf.size());
+    EXPECT_TRUE(buf.huge_page_bytes() == 0u || buf.huge_page_bytes() == huge_page_size);
+    Alloc default_buf = Alloc::alloc_with_allocator(nullptr).create(huge_page_size);
+    EXPECT_EQ(0u, default_buf.huge_page_bytes());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
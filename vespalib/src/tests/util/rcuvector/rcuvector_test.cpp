@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/test/memory_allocator_observer.h>
 #include <vespa/vespalib/util/rcuvector.h>
 #include <vespa/vespalib/util/size_literals.h>
 
@@ -294,4 +295,26 @@ TEST("test small expand")
     g.trimHoldLists(2);
 }
 
+TEST("require that memory allocator is kept when expanding")
+{
+    using MyMemoryAllocator = vespalib::alloc::test::MemoryAllocatorObserver;
+    using AllocStats = MyMemoryAllocator::Stats;
+    AllocStats stats;
+    MyMemoryAllocator allocator(stats);
+    {
+        GenerationHolder g;
+        RcuVectorBase<int> v(1, 100, 0, g, alloc::Alloc::alloc_with_allocator(&allocator));
+        v.push_back(1);
+        EXPECT_TRUE(AllocStats(1, 0) == stats);
+        v.push_back(2);
+        v.push_back(3);
+        EXPECT_EQUAL(4u, v.capacity());
+        EXPECT_TRUE(AllocStats(3, 0) == stats);
+        g.transferHoldLists(1);
+        g.trimHoldLists(2);
+        EXPECT_TRUE(AllocStats(3, 2) == stats);
+    }
+    EXPECT_TRUE(AllocStats(3, 3) == stats);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
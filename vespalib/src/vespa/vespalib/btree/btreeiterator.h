@@ -230,6 +230,12 @@ private:
      */
     void findNextLeafNode();
 
+    /*
+     * Prefetch the leaf node after the current leaf node, if it has
+     * the same parent, to hide memory latency during range scans.
+     */
+    void prefetchNextLeafNode() const;
+
     /*
      * Find the previous leaf node, called by operator--() as needed.
      */
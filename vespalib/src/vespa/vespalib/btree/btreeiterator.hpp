@@ -196,6 +196,7 @@ findNextLeafNode()
                 node = inode->getChild(0);
             }
             _leaf.setNodeAndIdx(_allocator->mapLeafRef(node), 0u);
+            prefetchNextLeafNode();
             return;
         }
     }
@@ -203,6 +204,24 @@ findNextLeafNode()
 }
 
 
+template <typename KeyT, typename DataT, typename AggrT,
+          uint32_t INTERNAL_SLOTS, uint32_t LEAF_SLOTS, uint32_t PATH_SIZE>
+void
+BTreeIteratorBase<KeyT, DataT, AggrT, INTERNAL_SLOTS, LEAF_SLOTS, PATH_SIZE>::
+prefetchNextLeafNode() const
+{
+    const PathElement & elem = _path[0];
+    const InternalNodeType * inode = elem.getNode();
+    uint32_t idx = elem.getIdx() + 1;
+    if (idx < inode->validSlots()) {
+        const char * next = reinterpret_cast<const char *>(_allocator->mapLeafRef(inode->getChild(idx)));
+        for (size_t offset = 0; offset < sizeof(LeafNodeType); offset += 64) {
+            __builtin_prefetch(next + offset);
+        }
+    }
+}
+
+
 template <typename KeyT, typename DataT, typename AggrT,
           uint32_t INTERNAL_SLOTS, uint32_t LEAF_SLOTS, uint32_t PATH_SIZE>
 void
@@ -4,6 +4,9 @@
 
 #include "btreenode.h"
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <type_traits>
 
 namespace vespalib::btree {
 
@@ -34,6 +37,45 @@ public:
     }
 };
 
+/*
+ * Keys are stored contiguously in a node, separate from the data. For
+ * nodes with uint32_t keys (e.g. docids in posting lists) ordered by
+ * std::less, all keys in the node are compared with the search key
+ * using vector instructions (through gcc vector extensions), and the
+ * keys before the search key in [sidx, eidx) are counted. This avoids
+ * the hard to predict branches of a binary search.
+ */
+template <typename KeyT, uint32_t NumSlots, typename CompareT>
+constexpr bool use_vector_key_search() {
+    return std::is_same_v<KeyT, uint32_t> && std::is_same_v<CompareT, std::less<uint32_t>> && ((NumSlots % 4) == 0);
+}
+
+template <uint32_t NumSlots, bool upper>
+uint32_t
+vector_key_search(const uint32_t *keys, uint32_t sidx, uint32_t eidx, uint32_t key)
+{
+    typedef uint32_t V __attribute__ ((vector_size (16)));
+    typedef int32_t M __attribute__ ((vector_size (16)));
+    constexpr uint32_t width = sizeof(V) / sizeof(uint32_t);
+    V vkey = V{} + key;
+    V start = V{} + sidx;
+    V end = V{} + eidx;
+    V idx = {0, 1, 2, 3};
+    M count = {};
+    for (uint32_t i = 0; i < NumSlots; i += width) {
+        V k;
+        memcpy(&k, keys + i, sizeof(V));
+        M before;
+        if constexpr (upper) {
+            before = (k <= vkey);
+        } else {
+            before = (k < vkey);
+        }
+        count += before & (idx >= start) & (idx < end); // true is -1
+        idx += width;
+    }
+    return sidx - (count[0] + count[1] + count[2] + count[3]);
+}
 
 }
 
@@ -43,9 +85,14 @@ uint32_t
 BTreeNodeT<KeyT, NumSlots>::
 lower_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
 {
-    const KeyT * itr = std::lower_bound<const KeyT *, KeyT, CompareT>
-        (_keys + sidx, _keys + validSlots(), key, comp);
-    return itr - _keys;
+    if constexpr (use_vector_key_search<KeyT, NumSlots, CompareT>()) {
+        (void) comp;
+        return vector_key_search<NumSlots, false>(_keys, sidx, validSlots(), key);
+    } else {
+        const KeyT * itr = std::lower_bound<const KeyT *, KeyT, CompareT>
+            (_keys + sidx, _keys + validSlots(), key, comp);
+        return itr - _keys;
+    }
 }
 
 template <typename KeyT, uint32_t NumSlots>
@@ -53,10 +100,7 @@ template <typename CompareT>
 uint32_t
 BTreeNodeT<KeyT, NumSlots>::lower_bound(const KeyT & key, CompareT comp) const
 {
-    
-    const KeyT * itr = std::lower_bound<const KeyT *, KeyT, CompareT>
-        (_keys, _keys + validSlots(), key, comp);
-    return itr - _keys;
+    return lower_bound<CompareT>(0, key, comp);
 }
 
 
@@ -66,9 +110,14 @@ uint32_t
 BTreeNodeT<KeyT, NumSlots>::
 upper_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
 {
-    const KeyT * itr = std::upper_bound<const KeyT *, KeyT, CompareT>
-        (_keys + sidx, _keys + validSlots(), key, comp);
-    return itr - _keys;
+    if constexpr (use_vector_key_search<KeyT, NumSlots, CompareT>()) {
+        (void) comp;
+        return vector_key_search<NumSlots, true>(_keys, sidx, validSlots(), key);
+    } else {
+        const KeyT * itr = std::upper_bound<const KeyT *, KeyT, CompareT>
+            (_keys + sidx, _keys + validSlots(), key, comp);
+        return itr - _keys;
+    }
 }
 
 
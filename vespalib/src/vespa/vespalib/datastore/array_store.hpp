@@ -31,6 +31,7 @@ template <typename EntryT, typename RefT>
 void
 ArrayStore<EntryT, RefT>::initArrayTypes(const ArrayStoreConfig &cfg)
 {
+    _largeArrayType.set_memory_allocator(cfg.memory_allocator());
     _largeArrayTypeId = _store.addType(&_largeArrayType);
     assert(_largeArrayTypeId == 0);
     _smallArrayTypes.reserve(_maxSmallArraySize);
@@ -40,6 +41,7 @@ ArrayStore<EntryT, RefT>::initArrayTypes(const ArrayStoreConfig &cfg)
                                       spec.numArraysForNewBuffer, spec.allocGrowFactor);
     }
     for (auto & type : _smallArrayTypes) {
+        type.set_memory_allocator(cfg.memory_allocator());
         uint32_t typeId = _store.addType(&type);
         assert(typeId == type.getArraySize()); // Enforce 1-to-1 mapping between type ids and sizes for small arrays
     }
@@ -7,7 +7,8 @@ namespace vespalib::datastore {
 
 ArrayStoreConfig::ArrayStoreConfig(size_t maxSmallArraySize, const AllocSpec &defaultSpec)
     : _allocSpecs(),
-      _enable_free_lists(false)
+      _enable_free_lists(false),
+      _memory_allocator(nullptr)
 {
     for (size_t i = 0; i < (maxSmallArraySize + 1); ++i) {
         _allocSpecs.push_back(defaultSpec);
@@ -16,7 +17,8 @@ ArrayStoreConfig::ArrayStoreConfig(size_t maxSmallArraySize, const AllocSpec &de
 
 ArrayStoreConfig::ArrayStoreConfig(const AllocSpecVector &allocSpecs)
     : _allocSpecs(allocSpecs),
-      _enable_free_lists(false)
+      _enable_free_lists(false),
+      _memory_allocator(nullptr)
 {
 }
 
@@ -5,6 +5,8 @@
 #include <cstddef>
 #include <vector>
 
+namespace vespalib::alloc { class MemoryAllocator; }
+
 namespace vespalib::datastore {
 
 /**
@@ -40,6 +42,7 @@ public:
 private:
     AllocSpecVector _allocSpecs;
     bool _enable_free_lists;
+    const alloc::MemoryAllocator* _memory_allocator;
 
     /**
      * Setup an array store with arrays of size [1-(allocSpecs.size()-1)] allocated in buffers and
@@ -66,6 +69,18 @@ public:
         return std::move(*this);
     }
     [[nodiscard]] bool enable_free_lists() const noexcept { return _enable_free_lists; }
+    /**
+     * Memory allocator used for all buffers in the array store, nullptr means default allocator.
+     */
+    ArrayStoreConfig& memory_allocator(const alloc::MemoryAllocator* allocator) & noexcept {
+        _memory_allocator = allocator;
+        return *this;
+    }
+    ArrayStoreConfig&& memory_allocator(const alloc::MemoryAllocator* allocator) && noexcept {
+        _memory_allocator = allocator;
+        return std::move(*this);
+    }
+    [[nodiscard]] const alloc::MemoryAllocator* memory_allocator() const noexcept { return _memory_allocator; }
 
     /**
      * Generate a config that is optimized for the given memory huge page size.
@@ -34,7 +34,8 @@ BufferTypeBase::BufferTypeBase(uint32_t arraySize,
       _activeBuffers(0),
       _holdBuffers(0),
       _holdUsedElems(0),
-      _aggr_counts()
+      _aggr_counts(),
+      _memory_allocator(nullptr)
 {
 }
 
@@ -92,7 +93,7 @@ BufferTypeBase::onFree(ElemCount usedElems)
 const alloc::MemoryAllocator*
 BufferTypeBase::get_memory_allocator() const
 {
-    return nullptr;
+    return _memory_allocator;
 }
 
 void
@@ -64,6 +64,11 @@ public:
     void onHold(const ElemCount* usedElems, const ElemCount* deadElems);
     virtual void onFree(ElemCount usedElems);
     virtual const alloc::MemoryAllocator* get_memory_allocator() const;
+    /**
+     * Set the memory allocator used for new buffers of this type (nullptr means default).
+     * The allocator must outlive all buffers allocated with it.
+     */
+    void set_memory_allocator(const alloc::MemoryAllocator* allocator) { _memory_allocator = allocator; }
 
     /**
      * Calculate number of arrays to allocate for new buffer given how many elements are needed.
@@ -120,6 +125,7 @@ protected:
     uint32_t _holdBuffers;
     size_t   _holdUsedElems;  // Number of used elements in all held buffers for this type.
     AggregatedBufferCounts _aggr_counts;
+    const alloc::MemoryAllocator* _memory_allocator;
 };
 
 /**
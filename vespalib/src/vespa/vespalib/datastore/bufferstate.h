@@ -164,6 +164,7 @@ public:
     size_t getHoldElems() const { return _holdElems; }
     size_t getExtraUsedBytes() const { return _extraUsedBytes; }
     size_t getExtraHoldBytes() const { return _extraHoldBytes; }
+    size_t getHugePageBytes() const { return _buffer.huge_page_bytes(); }
     bool getCompacting() const { return _compacting; }
     void setCompacting() { _compacting = true; }
     uint32_t get_used_arrays() const noexcept { return _usedElems / _arraySize; }
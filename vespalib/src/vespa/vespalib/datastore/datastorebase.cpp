@@ -228,6 +228,7 @@ DataStoreBase::getMemoryUsage() const
     usage.setUsedBytes(stats._usedBytes);
     usage.setDeadBytes(stats._deadBytes);
     usage.setAllocatedBytesOnHold(stats._holdBytes);
+    usage.setAllocatedHugePageBytes(stats._hugePageBytes);
     return usage;
 }
 
@@ -302,6 +303,7 @@ add_buffer_state_to_mem_stats(const BufferState& state, size_t elementSize, Data
     stats._usedBytes += (state.size() * elementSize) + extra_used_bytes;
     stats._deadBytes += state.getDeadElems() * elementSize;
     stats._holdBytes += (state.getHoldElems() * elementSize) + state.getExtraHoldBytes();
+    stats._hugePageBytes += state.getHugePageBytes();
 }
 
 }
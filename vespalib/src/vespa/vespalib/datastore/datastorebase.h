@@ -109,6 +109,7 @@ public:
         size_t _usedBytes;
         size_t _deadBytes;
         size_t _holdBytes;
+        size_t _hugePageBytes;
         uint32_t _freeBuffers;
         uint32_t _activeBuffers;
         uint32_t _holdBuffers;
@@ -122,6 +123,7 @@ public:
               _usedBytes(0),
               _deadBytes(0),
               _holdBytes(0),
+              _hugePageBytes(0),
               _freeBuffers(0),
               _activeBuffers(0),
               _holdBuffers(0)
@@ -136,6 +138,7 @@ public:
             _usedBytes += rhs._usedBytes;
             _deadBytes += rhs._deadBytes;
             _holdBytes += rhs._holdBytes;
+            _hugePageBytes += rhs._hugePageBytes;
             _freeBuffers += rhs._freeBuffers;
             _activeBuffers += rhs._activeBuffers;
             _holdBuffers += rhs._holdBuffers;
@@ -2,7 +2,10 @@
 
 #pragma once
 
+#include "entryref.h"
 #include <vespa/vespalib/util/array.h>
+#include <vespa/vespalib/util/arrayref.h>
+#include <memory>
 
 namespace vespalib::datastore {
 
@@ -11,6 +14,8 @@ namespace vespalib::datastore {
  *
  * All entry refs pointing to allocated data in the store must be passed to the compaction context
  * such that these can be updated according to the buffer compaction that happens internally.
+ * The refs may be passed in several calls (e.g. a bounded number of refs per writer thread slice),
+ * and the compacted buffers are not released until the compaction context is destroyed.
  */
 struct ICompactionContext {
     using UP = std::unique_ptr<ICompactionContext>;
@@ -5,6 +5,16 @@
 
 namespace vespalib::hwaccelrated {
 
+int64_t
+Avx2Accelrator::dotProduct(const int8_t * a, const int8_t * b, size_t sz) const {
+    return avx::dotProductInt8(a, b, sz);
+}
+
+float
+Avx2Accelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const {
+    return avx::dotProductBFloat16<16>(a, b, sz);
+}
+
 size_t
 Avx2Accelrator::populationCount(const uint64_t *a, size_t sz) const {
     return helper::populationCount(a, sz);
@@ -12,6 +12,8 @@ namespace vespalib::hwaccelrated {
 class Avx2Accelrator : public GenericAccelrator
 {
 public:
+    int64_t dotProduct(const int8_t * a, const int8_t * b, size_t sz) const override;
+    float dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const override;
     size_t populationCount(const uint64_t *a, size_t sz) const override;
     double squaredEuclideanDistance(const float * a, const float * b, size_t sz) const override;
     double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const override;
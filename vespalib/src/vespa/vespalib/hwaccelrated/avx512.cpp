@@ -17,6 +17,18 @@ Avx512Accelrator::dotProduct(const double * af, const double * bf, size_t sz) co
     return avx::dotProductSelectAlignment<double, 64>(af, bf, sz);
 }
 
+int64_t
+Avx512Accelrator::dotProduct(const int8_t * a, const int8_t * b, size_t sz) const
+{
+    return avx::dotProductInt8(a, b, sz);
+}
+
+float
+Avx512Accelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const
+{
+    return avx::dotProductBFloat16<32>(a, b, sz);
+}
+
 size_t
 Avx512Accelrator::populationCount(const uint64_t *a, size_t sz) const {
     return helper::populationCount(a, sz);
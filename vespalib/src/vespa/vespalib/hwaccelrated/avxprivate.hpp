@@ -4,6 +4,8 @@
 
 #include "private_helpers.hpp"
 #include <vespa/fastos/dynamiclibrary.h>
+#include <vespa/vespalib/util/bfloat16.h>
+#include <algorithm>
 
 namespace vespalib::hwaccelrated::avx {
 
@@ -134,4 +136,45 @@ double euclideanDistanceSelectAlignment(const T * af, const T * bf, size_t sz)
     }
 }
 
+inline int64_t dotProductInt8(const int8_t * a, const int8_t * b, size_t sz)
+{
+    // int8 products fit in int16 and are summed pairwise into int32
+    // partial sums (vpmaddwd) that are flushed to the 64-bit sum
+    // before they are able to overflow.
+    constexpr size_t FlushInterval = 65536;
+    int64_t sum(0);
+    for (size_t i(0); i < sz;) {
+        const size_t end(std::min(sz, i + FlushInterval));
+        int32_t partial(0);
+        for (; i < end; i++) {
+            partial += int16_t(a[i]) * int16_t(b[i]);
+        }
+        sum += partial;
+    }
+    return sum;
+}
+
+template <size_t UNROLL>
+float dotProductBFloat16(const BFloat16 * a, const BFloat16 * b, size_t sz)
+{
+    float partial[UNROLL];
+    for (size_t j(0); j < UNROLL; j++) {
+        partial[j] = 0;
+    }
+    size_t i(0);
+    for (; i + UNROLL <= sz; i += UNROLL) {
+        for (size_t j(0); j < UNROLL; j++) {
+            partial[j] += a[i+j].to_float() * b[i+j].to_float();
+        }
+    }
+    float sum(0);
+    for (; i < sz; i++) {
+        sum += a[i].to_float() * b[i].to_float();
+    }
+    for (size_t j(0); j < UNROLL; j++) {
+        sum += partial[j];
+    }
+    return sum;
+}
+
 }
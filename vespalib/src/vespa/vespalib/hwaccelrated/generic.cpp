@@ -119,6 +119,12 @@ GenericAccelrator::dotProduct(const int64_t * a, const int64_t * b, size_t sz) c
     return multiplyAdd<long long, int64_t, 8>(a, b, sz);
 }
 
+float
+GenericAccelrator::dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const
+{
+    return multiplyAdd<float, BFloat16, 8>(a, b, sz);
+}
+
 void
 GenericAccelrator::orBit(void * aOrg, const void * bOrg, size_t bytes) const
 {
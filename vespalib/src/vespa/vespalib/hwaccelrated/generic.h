@@ -18,6 +18,7 @@ public:
     int64_t dotProduct(const int16_t * a, const int16_t * b, size_t sz) const override;
     int64_t dotProduct(const int32_t * a, const int32_t * b, size_t sz) const override;
     long long dotProduct(const int64_t * a, const int64_t * b, size_t sz) const override;
+    float dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const override;
     void orBit(void * a, const void * b, size_t bytes) const override;
     void andBit(void * a, const void * b, size_t bytes) const override;
     void andNotBit(void * a, const void * b, size_t bytes) const override;
@@ -49,7 +49,7 @@ std::vector<T> createAndFill(size_t sz) {
     return v;
 }
 
-template<typename T>
+template<typename T, typename S = T>
 void
 verifyDotproduct(const IAccelrated & accel)
 {
@@ -58,11 +58,11 @@ verifyDotproduct(const IAccelrated & accel)
     std::vector<T> a = createAndFill<T>(testLength);
     std::vector<T> b = createAndFill<T>(testLength);
     for (size_t j(0); j < 0x20; j++) {
-        T sum(0);
+        S sum(0);
         for (size_t i(j); i < testLength; i++) {
             sum += a[i]*b[i];
         }
-        T hwComputedSum(accel.dotProduct(&a[j], &b[j], testLength - j));
+        S hwComputedSum(accel.dotProduct(&a[j], &b[j], testLength - j));
         if (sum != hwComputedSum) {
             fprintf(stderr, "Accelrator is not computing dotproduct correctly.\n");
             LOG_ABORT("should not be reached");
@@ -228,8 +228,10 @@ private:
     void verify(const IAccelrated & accelrated) {
         verifyDotproduct<float>(accelrated);
         verifyDotproduct<double>(accelrated);
+        verifyDotproduct<int8_t, int64_t>(accelrated);
         verifyDotproduct<int32_t>(accelrated);
         verifyDotproduct<int64_t>(accelrated);
+        verifyDotproduct<BFloat16, float>(accelrated);
         verifyEuclideanDistance<float>(accelrated);
         verifyEuclideanDistance<double>(accelrated);
         verifyPopulationCount(accelrated);
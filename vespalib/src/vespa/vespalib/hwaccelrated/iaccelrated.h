@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <vespa/vespalib/util/bfloat16.h>
 #include <memory>
 #include <cstdint>
 #include <vector>
@@ -23,6 +24,8 @@ public:
     virtual int64_t dotProduct(const int16_t * a, const int16_t * b, size_t sz) const = 0;
     virtual int64_t dotProduct(const int32_t * a, const int32_t * b, size_t sz) const = 0;
     virtual long long dotProduct(const int64_t * a, const int64_t * b, size_t sz) const = 0;
+    // products are accumulated in float
+    virtual float dotProduct(const BFloat16 * a, const BFloat16 * b, size_t sz) const = 0;
     virtual void orBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andBit(void * a, const void * b, size_t bytes) const = 0;
     virtual void andNotBit(void * a, const void * b, size_t bytes) const = 0;
@@ -0,0 +1,368 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batch_pread.h"
+#include <vespa/vespalib/util/count_down_latch.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.io.batch_pread");
+
+namespace vespalib {
+
+namespace {
+
+VESPA_THREAD_STACK_TAG(batch_pread_executor)
+
+constexpr uint32_t RING_ENTRIES = 64;
+constexpr uint32_t FALLBACK_THREADS = 16;
+
+std::atomic<bool> io_uring_disabled(false);
+
+void
+pread_fully(BatchPRead::Request &req)
+{
+    size_t done = (req.result > 0) ? req.result : 0;
+    while (done < req.len) {
+        ssize_t res = ::pread(req.fd, static_cast<char *>(req.buf) + done, req.len - done, req.offset + done);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            req.result = -errno;
+            return;
+        }
+        if (res == 0) {
+            break;
+        }
+        done += res;
+    }
+    req.result = done;
+}
+
+ThreadStackExecutor &
+fallback_executor()
+{
+    static ThreadStackExecutor executor(FALLBACK_THREADS, 128_Ki, batch_pread_executor);
+    return executor;
+}
+
+void
+read_with_thread_pool(BatchPRead::Request *requests, size_t count)
+{
+    if (count == 1) {
+        pread_fully(requests[0]);
+        return;
+    }
+    CountDownLatch latch(count - 1);
+    auto &executor = fallback_executor();
+    for (size_t i = 1; i < count; ++i) {
+        auto rejected = executor.execute(makeLambdaTask([req = &requests[i], &latch]() {
+            pread_fully(*req);
+            latch.countDown();
+        }));
+        if (rejected) {
+            rejected->run();
+        }
+    }
+    pread_fully(requests[0]);
+    latch.await();
+}
+
+#ifdef __linux__
+
+/**
+ * Minimal io_uring submission/completion ring driven directly
+ * through the kernel system calls. One ring is created lazily per
+ * thread and only ever used by that thread.
+ **/
+class IoUring
+{
+private:
+    int            _fd;
+    void          *_sq_ptr;
+    size_t         _sq_size;
+    void          *_cq_ptr;
+    size_t         _cq_size;
+    io_uring_sqe  *_sqes;
+    size_t         _sqes_size;
+    unsigned      *_sq_head;
+    unsigned      *_sq_tail;
+    unsigned      *_sq_mask;
+    unsigned      *_sq_array;
+    unsigned      *_cq_head;
+    unsigned      *_cq_tail;
+    unsigned      *_cq_mask;
+    io_uring_cqe  *_cqes;
+    uint32_t       _entries;
+
+    static int setup(uint32_t entries, io_uring_params *params) {
+        return syscall(__NR_io_uring_setup, entries, params);
+    }
+    int enter(uint32_t to_submit, uint32_t min_complete) {
+        return syscall(__NR_io_uring_enter, _fd, to_submit, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+    void push(const BatchPRead::Request &req, size_t idx);
+    bool submit_and_wait(uint32_t to_submit);
+    uint32_t withdraw_unsubmitted();
+    size_t reap(BatchPRead::Request *requests);
+public:
+    IoUring(uint32_t entries);
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+    ~IoUring();
+    bool valid() const { return _sqes != nullptr; }
+    /**
+     * Returns false if the ring failed. Requests that were not
+     * completed are then left with result -ECANCELED.
+     **/
+    bool read(BatchPRead::Request *requests, size_t count);
+};
+
+IoUring::IoUring(uint32_t entries)
+    : _fd(-1), _sq_ptr(MAP_FAILED), _sq_size(0), _cq_ptr(MAP_FAILED), _cq_size(0),
+      _sqes(nullptr), _sqes_size(0), _sq_head(nullptr), _sq_tail(nullptr), _sq_mask(nullptr), _sq_array(nullptr),
+      _cq_head(nullptr), _cq_tail(nullptr), _cq_mask(nullptr), _cqes(nullptr), _entries(0)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _fd = setup(entries, &params);
+    if (_fd < 0) {
+        return;
+    }
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        _sq_size = std::max(_sq_size, _cq_size);
+    }
+    _sq_ptr = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_sq_ptr == MAP_FAILED) {
+        return;
+    }
+    if (!single_mmap) {
+        _cq_ptr = mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (_cq_ptr == MAP_FAILED) {
+            return;
+        }
+    }
+    char *sq = static_cast<char *>(_sq_ptr);
+    char *cq = static_cast<char *>(single_mmap ? _sq_ptr : _cq_ptr);
+    _sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    _sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    _cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    _entries = params.sq_entries;
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (sqes != MAP_FAILED) {
+        _sqes = static_cast<io_uring_sqe *>(sqes);
+    }
+}
+
+IoUring::~IoUring()
+{
+    if (_sqes != nullptr) {
+        munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ptr != MAP_FAILED) {
+        munmap(_cq_ptr, _cq_size);
+    }
+    if (_sq_ptr != MAP_FAILED) {
+        munmap(_sq_ptr, _sq_size);
+    }
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+void
+IoUring::push(const BatchPRead::Request &req, size_t idx)
+{
+    unsigned tail = *_sq_tail;
+    unsigned slot = tail & *_sq_mask;
+    io_uring_sqe &sqe = _sqes[slot];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = req.fd;
+    sqe.addr = reinterpret_cast<uint64_t>(req.buf);
+    sqe.len = req.len;
+    sqe.off = req.offset;
+    sqe.user_data = idx;
+    _sq_array[slot] = slot;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+bool
+IoUring::submit_and_wait(uint32_t to_submit)
+{
+    for (;;) {
+        int res = enter(to_submit, 1);
+        if (res < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            LOG(warning, "io_uring_enter failed: %s", strerror(errno));
+            return false;
+        }
+        // The kernel may consume fewer entries than asked for, and then
+        // returns without waiting; submit the rest before waiting.
+        to_submit -= res;
+        if (to_submit == 0) {
+            return true;
+        }
+    }
+}
+
+uint32_t
+IoUring::withdraw_unsubmitted()
+{
+    // Without SQPOLL the kernel only reads the submission queue inside
+    // io_uring_enter, so entries it has not consumed can be taken back.
+    unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *_sq_tail;
+    __atomic_store_n(_sq_tail, head, __ATOMIC_RELEASE);
+    return (tail - head);
+}
+
+size_t
+IoUring::reap(BatchPRead::Request *requests)
+{
+    size_t reaped = 0;
+    unsigned head = *_cq_head;
+    unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const io_uring_cqe &cqe = _cqes[head & *_cq_mask];
+        BatchPRead::Request &req = requests[cqe.user_data];
+        req.result = cqe.res;
+        ++head;
+        ++reaped;
+        if ((req.result < 0) || ((req.result > 0) && (size_t(req.result) < req.len))) {
+            // Errors (including unsupported opcode) and short reads are
+            // completed with plain pread.
+            if (req.result < 0) {
+                req.result = 0;
+            }
+            pread_fully(req);
+        }
+    }
+    __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+bool
+IoUring::read(BatchPRead::Request *requests, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        requests[i].result = -ECANCELED;
+    }
+    size_t next = 0;
+    size_t in_flight = 0;
+    while ((next < count) || (in_flight > 0)) {
+        uint32_t to_submit = 0;
+        while ((next < count) && (in_flight < _entries)) {
+            push(requests[next], next);
+            ++next;
+            ++in_flight;
+            ++to_submit;
+        }
+        if (!submit_and_wait(to_submit)) {
+            in_flight -= withdraw_unsubmitted();
+            // Reads already submitted still write into their buffers, so
+            // they must complete before the caller gets to reuse them.
+            while (in_flight > 0) {
+                in_flight -= reap(requests);
+                if ((in_flight > 0) && !submit_and_wait(0)) {
+                    // The kernel may still write into buffers owned by the caller.
+                    LOG_ABORT("should not be reached");
+                }
+            }
+            return false;
+        }
+        in_flight -= reap(requests);
+    }
+    return true;
+}
+
+IoUring *
+thread_ring()
+{
+    thread_local std::unique_ptr<IoUring> ring;
+    thread_local bool tried = false;
+    if (!tried) {
+        tried = true;
+        auto candidate = std::make_unique<IoUring>(RING_ENTRIES);
+        if (candidate->valid()) {
+            ring = std::move(candidate);
+        } else {
+            io_uring_disabled = true;
+        }
+    }
+    return ring.get();
+}
+
+#endif
+
+}
+
+void
+BatchPRead::read(Request *requests, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+#ifdef __linux__
+    if ((count > 1) && !io_uring_disabled) {
+        IoUring *ring = thread_ring();
+        if (ring != nullptr) {
+            if (ring->read(requests, count)) {
+                return;
+            }
+            LOG(warning, "io_uring failed, falling back to plain pread");
+            io_uring_disabled = true;
+            for (size_t i = 0; i < count; ++i) {
+                if (requests[i].result == -ECANCELED) {
+                    requests[i].result = 0;
+                    pread_fully(requests[i]);
+                }
+            }
+            return;
+        }
+    }
+#endif
+    read_with_thread_pool(requests, count);
+}
+
+bool
+BatchPRead::has_io_uring()
+{
+#ifdef __linux__
+    return !io_uring_disabled && (thread_ring() != nullptr);
+#else
+    return false;
+#endif
+}
+
+void
+BatchPRead::disable_io_uring()
+{
+    io_uring_disabled = true;
+}
+
+} // namespace vespalib
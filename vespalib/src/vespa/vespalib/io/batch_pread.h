@@ -0,0 +1,53 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace vespalib {
+
+/**
+ * Performs a batch of positional reads and waits until all of them
+ * have completed. The reads are submitted through io_uring when the
+ * kernel supports it, so that the whole batch is in flight at the
+ * same time while only the calling thread is used. When io_uring is
+ * not available the reads are spread across a small shared pool of
+ * threads doing plain pread.
+ *
+ * Each request gets its result stored in 'result'; the number of
+ * bytes read, or -errno on failure. Short reads (other than at end of
+ * file) are completed before returning.
+ **/
+class BatchPRead
+{
+public:
+    struct Request {
+        int      fd;
+        void    *buf;
+        size_t   len;
+        uint64_t offset;
+        ssize_t  result;
+        Request(int fd_in, void *buf_in, size_t len_in, uint64_t offset_in) noexcept
+            : fd(fd_in), buf(buf_in), len(len_in), offset(offset_in), result(0)
+        {}
+    };
+
+    /**
+     * Perform all reads in the given batch, blocking until they are done.
+     **/
+    static void read(Request *requests, size_t count);
+
+    /**
+     * Whether batches are submitted through io_uring in this process.
+     **/
+    static bool has_io_uring();
+
+    /**
+     * Force use of the thread pool fallback. Used for testing.
+     **/
+    static void disable_io_uring();
+};
+
+} // namespace vespalib
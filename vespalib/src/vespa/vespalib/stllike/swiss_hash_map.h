@@ -0,0 +1,99 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "swiss_table.hpp"
+#include "hash_fun.h"
+#include "select.h"
+#include <initializer_list>
+
+namespace vespalib {
+
+/**
+ * Hash map with the same interface as hash_map, backed by an open
+ * addressing swiss_table. Lookups are faster and use less memory than
+ * with hash_map, in particular when most lookups are for keys that are
+ * not present. Iterators and references are invalidated when the map
+ * grows, so reserve up front (or use hash_map) when that matters.
+ **/
+template< typename K, typename V, typename H = vespalib::hash<K>, typename EQ = std::equal_to<> >
+class swiss_hash_map
+{
+public:
+    typedef std::pair<K, V> value_type;
+    typedef K key_type;
+    typedef V mapped_type;
+    using HashTable = swiss_table< K, value_type, H, EQ, Select1st<value_type> >;
+private:
+    HashTable _ht;
+public:
+    typedef typename HashTable::iterator iterator;
+    typedef typename HashTable::const_iterator const_iterator;
+    typedef typename HashTable::insert_result insert_result;
+public:
+    swiss_hash_map(swiss_hash_map &&) noexcept = default;
+    swiss_hash_map & operator = (swiss_hash_map &&) noexcept = default;
+    swiss_hash_map(const swiss_hash_map &) = default;
+    swiss_hash_map & operator = (const swiss_hash_map &) = default;
+    swiss_hash_map() : _ht(0, H(), EQ()) {}
+    explicit swiss_hash_map(size_t reserveSize) : _ht(reserveSize, H(), EQ()) {}
+    swiss_hash_map(size_t reserveSize, H hasher, EQ equality) : _ht(reserveSize, hasher, equality) {}
+    swiss_hash_map(std::initializer_list<value_type> input) : _ht(input.size(), H(), EQ()) {
+        insert(input.begin(), input.end());
+    }
+    ~swiss_hash_map() = default;
+    iterator begin()                         { return _ht.begin(); }
+    iterator end()                           { return _ht.end(); }
+    const_iterator begin()             const { return _ht.begin(); }
+    const_iterator end()               const { return _ht.end(); }
+    size_t capacity()                  const { return _ht.capacity(); }
+    size_t size()                      const { return _ht.size(); }
+    bool empty()                       const { return _ht.empty(); }
+    insert_result insert(const value_type & value) { return _ht.insert(value); }
+    insert_result insert(value_type &&value) { return _ht.insert(std::move(value)); }
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    /// This gives faster iteration than can be achieved by the iterators.
+    template <typename Func>
+    void for_each(Func func) const { _ht.for_each(func); }
+    const V & operator [] (const K & key) const { return _ht.find(key)->second; }
+    V & operator [] (const K & key) {
+        return _ht.insert_with(key, [&key](void *mem) { new (mem) value_type(key, V()); }).first->second;
+    }
+    void erase(const K & key)                   { _ht.erase(key); }
+    void erase(const_iterator it)               { _ht.erase(it); }
+    iterator find(const K & key)                { return _ht.find(key); }
+    size_t count(const K & key)           const { return _ht.find(key) != _ht.end() ? 1 : 0; }
+    bool contains(const K & key)          const { return _ht.find(key) != end(); }
+    const_iterator find(const K & key)    const { return _ht.find(key); }
+
+    template< typename AltKey >
+    const_iterator find(const AltKey & key) const { return _ht.find(key); }
+    template< typename AltKey>
+    iterator find(const AltKey & key) { return _ht.find(key); }
+
+    void clear()                                { _ht.clear(); }
+    void resize(size_t newSize)                 { _ht.resize(newSize); }
+    void swap(swiss_hash_map & rhs)             { _ht.swap(rhs._ht); }
+    bool operator == (const swiss_hash_map & rhs) const {
+        bool equal = (size() == rhs.size());
+        for (auto itr = begin(); equal && (itr != end()); ++itr) {
+            auto found = rhs.find(itr->first);
+            equal = (found != rhs.end()) && (found->second == itr->second);
+        }
+        return equal;
+    }
+    size_t getMemoryConsumption() const { return _ht.getMemoryConsumption(); }
+};
+
+template< typename K, typename V, typename H, typename EQ >
+void swap(swiss_hash_map<K, V, H, EQ> & a, swiss_hash_map<K, V, H, EQ> & b)
+{
+    a.swap(b);
+}
+
+}
@@ -0,0 +1,94 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "swiss_table.hpp"
+#include "hash_fun.h"
+#include "identity.h"
+#include <initializer_list>
+
+namespace vespalib {
+
+/**
+ * Hash set with the same interface as hash_set, backed by an open
+ * addressing swiss_table. See swiss_hash_map for when to use it.
+ **/
+template< typename K, typename H = vespalib::hash<K>, typename EQ = std::equal_to<> >
+class swiss_hash_set
+{
+private:
+    using HashTable = swiss_table< K, K, H, EQ, Identity >;
+    HashTable _ht;
+public:
+    typedef typename HashTable::iterator iterator;
+    typedef typename HashTable::const_iterator const_iterator;
+    typedef typename HashTable::insert_result insert_result;
+public:
+    swiss_hash_set(swiss_hash_set &&) noexcept = default;
+    swiss_hash_set & operator = (swiss_hash_set &&) noexcept = default;
+    swiss_hash_set(const swiss_hash_set &) = default;
+    swiss_hash_set & operator = (const swiss_hash_set &) = default;
+    swiss_hash_set() : _ht(0, H(), EQ()) {}
+    explicit swiss_hash_set(size_t reserveSize) : _ht(reserveSize, H(), EQ()) {}
+    swiss_hash_set(size_t reserveSize, const H & hasher, const EQ & equal) : _ht(reserveSize, hasher, equal) {}
+    template <typename InputIterator>
+    swiss_hash_set(InputIterator first, InputIterator last) : _ht(0, H(), EQ()) {
+        insert(first, last);
+    }
+    swiss_hash_set(std::initializer_list<K> input) : _ht(input.size(), H(), EQ()) {
+        insert(input.begin(), input.end());
+    }
+    ~swiss_hash_set() = default;
+    iterator begin()                         { return _ht.begin(); }
+    iterator end()                           { return _ht.end(); }
+    const_iterator begin()             const { return _ht.begin(); }
+    const_iterator end()               const { return _ht.end(); }
+    size_t capacity()                  const { return _ht.capacity(); }
+    size_t size()                      const { return _ht.size(); }
+    bool empty()                       const { return _ht.empty(); }
+    insert_result insert(const K & value)    { return _ht.insert(value); }
+    insert_result insert(K &&value)          { return _ht.insert(std::move(value)); }
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+    void erase(const K & key)                { _ht.erase(key); }
+    void erase(const_iterator it)            { _ht.erase(it); }
+    size_t count(const K & key) const        { return _ht.find(key) != end() ? 1 : 0; }
+    bool contains(const K & key) const       { return _ht.find(key) != end(); }
+    iterator find(const K & key)             { return _ht.find(key); }
+    const_iterator find(const K & key) const { return _ht.find(key); }
+
+    /// This gives faster iteration than can be achieved by the iterators.
+    template <typename Func>
+    void for_each(Func func) const { _ht.for_each(func); }
+
+    template< typename AltKey >
+    const_iterator find(const AltKey & key) const { return _ht.find(key); }
+
+    template< typename AltKey>
+    iterator find(const AltKey & key) { return _ht.find(key); }
+
+    void clear()                             { _ht.clear(); }
+    void resize(size_t newSize)              { _ht.resize(newSize); }
+    void swap(swiss_hash_set & rhs)          { _ht.swap(rhs._ht); }
+
+    bool operator==(const swiss_hash_set &rhs) const {
+        bool equal = (size() == rhs.size());
+        for (auto itr = begin(); equal && (itr != end()); ++itr) {
+            equal = (rhs.find(*itr) != rhs.end());
+        }
+        return equal;
+    }
+
+    size_t getMemoryConsumption() const { return _ht.getMemoryConsumption(); }
+};
+
+template< typename K, typename H, typename EQ >
+void swap(swiss_hash_set<K, H, EQ> & a, swiss_hash_set<K, H, EQ> & b)
+{
+    a.swap(b);
+}
+
+}
@@ -0,0 +1,260 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace vespalib {
+namespace swiss {
+
+static constexpr size_t group_size = 16;
+static constexpr uint8_t ctrl_empty = 0x80;
+static constexpr uint8_t ctrl_deleted = 0xfe;
+
+/**
+ * A group of control bytes probed together. Full slots have a control
+ * byte holding 7 bits of the hash of the entry, empty and deleted
+ * slots have the high bit set.
+ **/
+struct Group {
+#ifdef __SSE2__
+    __m128i ctrl;
+    explicit Group(const uint8_t *pos) noexcept : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+    uint32_t match(uint8_t value) const noexcept {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl));
+    }
+    uint32_t match_empty_or_deleted() const noexcept { return _mm_movemask_epi8(ctrl); }
+#else
+    const uint8_t *ctrl;
+    explicit Group(const uint8_t *pos) noexcept : ctrl(pos) {}
+    uint32_t match(uint8_t value) const noexcept {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_size; ++i) {
+            bits |= (uint32_t(ctrl[i] == value) << i);
+        }
+        return bits;
+    }
+    uint32_t match_empty_or_deleted() const noexcept {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_size; ++i) {
+            bits |= (uint32_t(ctrl[i] >> 7) << i);
+        }
+        return bits;
+    }
+#endif
+    uint32_t match_empty() const noexcept { return match(ctrl_empty); }
+};
+
+// The hash is mixed (to cope with weak hash functions like identity)
+// and split into h1 (where probing starts) and h2 (the 7 bits stored
+// in the control byte).
+constexpr uint64_t mix_hash(uint64_t hash) noexcept {
+    __uint128_t mixed = __uint128_t(hash) * 0x9e3779b97f4a7c15ull;
+    return (uint64_t(mixed >> 64) ^ uint64_t(mixed));
+}
+constexpr size_t h1(uint64_t mixed) noexcept { return (mixed >> 7); }
+constexpr uint8_t h2(uint64_t mixed) noexcept { return (mixed & 0x7f); }
+
+// control bytes of the table used before anything is inserted
+extern const uint8_t empty_ctrl[group_size];
+
+}
+
+/**
+ * Open addressing hash table in the style of a Swiss table, used to
+ * implement swiss_hash_map and swiss_hash_set.
+ *
+ * Entries are stored inline in a power of 2 sized slot array, with a
+ * separate array of one control byte per slot. Lookups compare a group
+ * of 16 control bytes at a time (using SSE2 when available) and only
+ * call the equality function for entries whose 7 bit hash matches.
+ * The table is kept at most 7/8 full. Erased entries leave tombstones
+ * that are cleaned up when the table is rehashed.
+ *
+ * Unlike hashtable, iterators and references are invalidated by
+ * inserts that make the table grow, and entries are moved when that
+ * happens.
+ **/
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+class swiss_table
+{
+private:
+    static constexpr size_t npos = size_t(-1);
+    static constexpr size_t min_capacity = 2;
+
+    template <typename TableP, typename V>
+    class iterator_t {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = V;
+        using pointer = V *;
+        using reference = V &;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator_t(TableP table, size_t idx) noexcept : _table(table), _idx(idx) {}
+        template <typename OtherP, typename OtherV>
+        iterator_t(const iterator_t<OtherP, OtherV> &rhs) noexcept : _table(rhs._table), _idx(rhs._idx) {}
+        V & operator * ()  const { return _table->_slots[_idx]; }
+        V * operator -> () const { return &_table->_slots[_idx]; }
+        iterator_t & operator ++ () {
+            _idx = _table->next_full(_idx + 1);
+            return *this;
+        }
+        iterator_t operator ++ (int) {
+            iterator_t prev = *this;
+            ++(*this);
+            return prev;
+        }
+        template <typename OtherP, typename OtherV>
+        bool operator == (const iterator_t<OtherP, OtherV> &rhs) const { return (_idx == rhs._idx); }
+        template <typename OtherP, typename OtherV>
+        bool operator != (const iterator_t<OtherP, OtherV> &rhs) const { return (_idx != rhs._idx); }
+        size_t getInternalIndex() const { return _idx; }
+    private:
+        template <typename, typename> friend class iterator_t;
+        TableP _table;
+        size_t _idx;
+    };
+public:
+    using iterator = iterator_t<swiss_table *, Value>;
+    using const_iterator = iterator_t<const swiss_table *, const Value>;
+    using insert_result = std::pair<iterator, bool>;
+
+    swiss_table(size_t reserved_size, const Hash & hasher, const Equal & equal);
+    swiss_table(swiss_table && rhs) noexcept;
+    swiss_table & operator = (swiss_table && rhs) noexcept;
+    swiss_table(const swiss_table & rhs);
+    swiss_table & operator = (const swiss_table & rhs);
+    ~swiss_table();
+
+    iterator begin()             { return iterator(this, next_full(0)); }
+    iterator end()               { return iterator(this, capacity()); }
+    const_iterator begin() const { return const_iterator(this, next_full(0)); }
+    const_iterator end()   const { return const_iterator(this, capacity()); }
+    size_t capacity()      const { return (_mask + 1); }
+    size_t size()          const { return _size; }
+    bool empty()           const { return (_size == 0); }
+
+    template <typename AltKey>
+    iterator find(const AltKey & key) {
+        size_t idx = find_index(key);
+        return iterator(this, (idx != npos) ? idx : capacity());
+    }
+    template <typename AltKey>
+    const_iterator find(const AltKey & key) const {
+        size_t idx = find_index(key);
+        return const_iterator(this, (idx != npos) ? idx : capacity());
+    }
+    insert_result insert(const Value & value) {
+        return insert_with(_keyExtractor(value), [&value](void *mem) { new (mem) Value(value); });
+    }
+    insert_result insert(Value && value) {
+        return insert_with(_keyExtractor(value), [&value](void *mem) { new (mem) Value(std::move(value)); });
+    }
+    /**
+     * Inserts an entry constructed by make(void *mem) if the key is not
+     * present, avoiding both the construction and a second lookup when
+     * it is.
+     **/
+    template <typename AltKey, typename MakeValue>
+    insert_result insert_with(const AltKey & key, MakeValue && make);
+    template <typename AltKey>
+    size_t erase(const AltKey & key) {
+        size_t idx = find_index(key);
+        if (idx == npos) {
+            return 0;
+        }
+        erase_index(idx);
+        return 1;
+    }
+    void erase(const_iterator it) { erase_index(it.getInternalIndex()); }
+    void clear();
+    void resize(size_t new_size);
+    void swap(swiss_table & rhs) noexcept;
+
+    template <typename Func>
+    void for_each(Func func) const {
+        for (size_t i = 0; i < capacity(); ++i) {
+            if (is_full(_ctrl[i])) {
+                func(_slots[i]);
+            }
+        }
+    }
+    size_t getMemoryConsumption() const {
+        return sizeof(swiss_table) + ((_slots != nullptr) ? (capacity() + swiss::group_size + (capacity() * sizeof(Value))) : 0);
+    }
+private:
+    Hash        _hasher;
+    Equal       _equal;
+    KeyExtract  _keyExtractor;
+    uint8_t    *_ctrl;
+    Value      *_slots;
+    size_t      _mask;
+    uint32_t    _window;
+    size_t      _size;
+    size_t      _growth_left;
+
+    static bool is_full(uint8_t ctrl) { return (ctrl < swiss::ctrl_empty); }
+    static size_t max_load(size_t capacity) { return ((capacity * 7) / 8); }
+    static size_t capacity_for(size_t num_entries);
+    size_t next_full(size_t idx) const {
+        while ((idx < capacity()) && !is_full(_ctrl[idx])) {
+            ++idx;
+        }
+        return idx;
+    }
+    void set_ctrl(size_t idx, uint8_t value) {
+        _ctrl[idx] = value;
+        if (idx < swiss::group_size) {
+            // mirror the start of the table to allow unaligned group loads
+            _ctrl[capacity() + idx] = value;
+        }
+    }
+    template <typename AltKey>
+    size_t find_index(const AltKey & key) const {
+        return find_index(key, swiss::mix_hash(_hasher(key)));
+    }
+    template <typename AltKey>
+    size_t find_index(const AltKey & key, uint64_t mixed) const {
+        uint8_t ctrl = swiss::h2(mixed);
+        size_t pos = (swiss::h1(mixed) & _mask);
+        for (size_t step = swiss::group_size; true; step += swiss::group_size) {
+            swiss::Group group(_ctrl + pos);
+            for (uint32_t bits = (group.match(ctrl) & _window); bits != 0; bits &= (bits - 1)) {
+                size_t idx = ((pos + __builtin_ctz(bits)) & _mask);
+                if (__builtin_expect(_equal(_keyExtractor(_slots[idx]), key), true)) {
+                    return idx;
+                }
+            }
+            if (__builtin_expect((group.match_empty() & _window) != 0, true)) {
+                return npos;
+            }
+            pos = ((pos + step) & _mask);
+        }
+    }
+    size_t find_insert_index(uint64_t mixed) const {
+        size_t pos = (swiss::h1(mixed) & _mask);
+        for (size_t step = swiss::group_size; true; step += swiss::group_size) {
+            uint32_t bits = (swiss::Group(_ctrl + pos).match_empty_or_deleted() & _window);
+            if (bits != 0) {
+                return ((pos + __builtin_ctz(bits)) & _mask);
+            }
+            pos = ((pos + step) & _mask);
+        }
+    }
+    void erase_index(size_t idx);
+    void rehash(size_t new_capacity);
+    void rehash_for_insert();
+    void allocate(size_t capacity);
+    void deallocate();
+    void destroy_all();
+};
+
+}
@@ -0,0 +1,247 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "swiss_table.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace vespalib {
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+size_t
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::capacity_for(size_t num_entries)
+{
+    size_t capacity = min_capacity;
+    while (max_load(capacity) < num_entries) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::swiss_table(size_t reserved_size, const Hash & hasher, const Equal & equal)
+    : _hasher(hasher),
+      _equal(equal),
+      _keyExtractor(),
+      _ctrl(const_cast<uint8_t *>(swiss::empty_ctrl)),
+      _slots(nullptr),
+      _mask(0),
+      _window(1),
+      _size(0),
+      _growth_left(0)
+{
+    if (reserved_size > 0) {
+        allocate(capacity_for(reserved_size));
+    }
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::swiss_table(swiss_table && rhs) noexcept
+    : swiss_table(0, rhs._hasher, rhs._equal)
+{
+    swap(rhs);
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+swiss_table<Key, Value, Hash, Equal, KeyExtract> &
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::operator = (swiss_table && rhs) noexcept
+{
+    swiss_table tmp(std::move(rhs));
+    swap(tmp);
+    return *this;
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::swiss_table(const swiss_table & rhs)
+    : swiss_table(0, rhs._hasher, rhs._equal)
+{
+    if (rhs.empty()) {
+        return;
+    }
+    allocate(capacity_for(rhs.size()));
+    rhs.for_each([this](const Value & value) {
+        uint64_t mixed = swiss::mix_hash(_hasher(_keyExtractor(value)));
+        size_t idx = find_insert_index(mixed);
+        new (static_cast<void *>(_slots + idx)) Value(value);
+        set_ctrl(idx, swiss::h2(mixed));
+        --_growth_left;
+        ++_size;
+    });
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+swiss_table<Key, Value, Hash, Equal, KeyExtract> &
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::operator = (const swiss_table & rhs)
+{
+    if (this != &rhs) {
+        swiss_table tmp(rhs);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::~swiss_table()
+{
+    destroy_all();
+    deallocate();
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+template <typename AltKey, typename MakeValue>
+typename swiss_table<Key, Value, Hash, Equal, KeyExtract>::insert_result
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::insert_with(const AltKey & key, MakeValue && make)
+{
+    uint64_t mixed = swiss::mix_hash(_hasher(key));
+    size_t idx = find_index(key, mixed);
+    if (idx != npos) {
+        return insert_result(iterator(this, idx), false);
+    }
+    idx = find_insert_index(mixed);
+    if (__builtin_expect((_growth_left == 0) && (_ctrl[idx] == swiss::ctrl_empty), false)) {
+        rehash_for_insert();
+        idx = find_insert_index(mixed);
+    }
+    make(static_cast<void *>(_slots + idx));
+    if (_ctrl[idx] == swiss::ctrl_empty) {
+        --_growth_left;
+    }
+    set_ctrl(idx, swiss::h2(mixed));
+    ++_size;
+    return insert_result(iterator(this, idx), true);
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::erase_index(size_t idx)
+{
+    _slots[idx].~Value();
+    --_size;
+    if (capacity() <= swiss::group_size) {
+        // all slots are inspected by the first group probed, so no
+        // probe sequence can depend on this slot having been full
+        set_ctrl(idx, swiss::ctrl_empty);
+        ++_growth_left;
+    } else {
+        set_ctrl(idx, swiss::ctrl_deleted);
+    }
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::clear()
+{
+    if (_slots == nullptr) {
+        return;
+    }
+    destroy_all();
+    memset(_ctrl, swiss::ctrl_empty, capacity() + swiss::group_size);
+    _size = 0;
+    _growth_left = max_load(capacity());
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::resize(size_t new_size)
+{
+    size_t new_capacity = capacity_for(std::max(new_size, _size));
+    if ((new_size > 0) && ((_slots == nullptr) || (new_capacity > capacity()))) {
+        rehash(new_capacity);
+    }
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::swap(swiss_table & rhs) noexcept
+{
+    std::swap(_hasher, rhs._hasher);
+    std::swap(_equal, rhs._equal);
+    std::swap(_keyExtractor, rhs._keyExtractor);
+    std::swap(_ctrl, rhs._ctrl);
+    std::swap(_slots, rhs._slots);
+    std::swap(_mask, rhs._mask);
+    std::swap(_window, rhs._window);
+    std::swap(_size, rhs._size);
+    std::swap(_growth_left, rhs._growth_left);
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::rehash(size_t new_capacity)
+{
+    uint8_t *old_ctrl = _ctrl;
+    Value *old_slots = _slots;
+    size_t old_capacity = capacity();
+    allocate(new_capacity);
+    if (old_slots == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (is_full(old_ctrl[i])) {
+            Value & value = old_slots[i];
+            uint64_t mixed = swiss::mix_hash(_hasher(_keyExtractor(value)));
+            size_t idx = find_insert_index(mixed);
+            new (static_cast<void *>(_slots + idx)) Value(std::move(value));
+            value.~Value();
+            set_ctrl(idx, swiss::h2(mixed));
+            --_growth_left;
+        }
+    }
+    delete [] old_ctrl;
+    std::allocator<Value>().deallocate(old_slots, old_capacity);
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::rehash_for_insert()
+{
+    if ((capacity() > swiss::group_size) && ((_size * 32) <= (capacity() * 25))) {
+        // full of tombstones; clean them up without growing
+        rehash(capacity());
+    } else {
+        rehash(std::max(min_capacity, capacity() * 2));
+    }
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::allocate(size_t capacity)
+{
+    _ctrl = new uint8_t[capacity + swiss::group_size];
+    memset(_ctrl, swiss::ctrl_empty, capacity + swiss::group_size);
+    _slots = std::allocator<Value>().allocate(capacity);
+    _mask = capacity - 1;
+    _window = (capacity < swiss::group_size) ? ((1u << capacity) - 1) : ((1u << swiss::group_size) - 1);
+    _growth_left = max_load(capacity);
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::deallocate()
+{
+    if (_slots != nullptr) {
+        delete [] _ctrl;
+        std::allocator<Value>().deallocate(_slots, capacity());
+        _ctrl = const_cast<uint8_t *>(swiss::empty_ctrl);
+        _slots = nullptr;
+        _mask = 0;
+        _window = 1;
+        _growth_left = 0;
+    }
+}
+
+template< typename Key, typename Value, typename Hash, typename Equal, typename KeyExtract >
+void
+swiss_table<Key, Value, Hash, Equal, KeyExtract>::destroy_all()
+{
+    if constexpr (!std::is_trivially_destructible_v<Value>) {
+        for (size_t i = 0; i < capacity(); ++i) {
+            if (is_full(_ctrl[i])) {
+                _slots[i].~Value();
+            }
+        }
+    }
+}
+
+}
@@ -147,6 +147,7 @@ public:
     size_t resize_inplace(PtrAndSize current, size_t newSize) const override;
     static size_t sresize_inplace(PtrAndSize current, size_t newSize);
     static PtrAndSize salloc(size_t sz, void * wantedAddress);
+    static PtrAndSize smap_file(int fd, size_t offset, size_t sz);
     static void sfree(PtrAndSize alloc);
     static MemoryAllocator & getDefault();
 private:
@@ -366,6 +367,30 @@ MMapAllocator::salloc(size_t sz, void * wantedAddress)
     return PtrAndSize(buf, sz);
 }
 
+MemoryAllocator::PtrAndSize
+MMapAllocator::smap_file(int fd, size_t offset, size_t sz)
+{
+    sz = round_up_to_page_size(sz);
+    if ((sz == 0) || (round_up_to_page_size(offset) != offset)) {
+        return PtrAndSize(nullptr, 0);
+    }
+    size_t mmapId = std::atomic_fetch_add(&_G_mmapCount, 1ul);
+    void * buf = mmap(nullptr, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset);
+    if (buf == MAP_FAILED) {
+        LOG(warning, "Failed mmaping file descriptor %d at offset %zu of size %zu: %s",
+            fd, offset, sz, FastOS_FileInterface::getLastErrorString().c_str());
+        return PtrAndSize(nullptr, 0);
+    }
+    if (sz >= _G_MMapLogLimit) {
+        string stackTrace = getStackTrace(1);
+        LOG(info, "mmap %ld of file of size %ld from %s", mmapId, sz, stackTrace.c_str());
+        std::lock_guard guard(_G_lock);
+        _G_HugeMappings[buf] = MMapInfo(mmapId, sz, stackTrace);
+        LOG(info, "%ld mappings of accumulated size %ld", _G_HugeMappings.size(), sum(_G_HugeMappings));
+    }
+    return PtrAndSize(buf, sz);
+}
+
 size_t
 MMapAllocator::sresize_inplace(PtrAndSize current, size_t newSize) {
     newSize = round_up_to_page_size(newSize);
@@ -506,6 +531,14 @@ Alloc::allocMMap(size_t sz)
     return Alloc(&MMapAllocator::getDefault(), sz);
 }
 
+Alloc
+Alloc::allocMMapFile(int fd, size_t offset, size_t sz) noexcept
+{
+    Alloc result(&MMapAllocator::getDefault());
+    result._alloc = MMapAllocator::smap_file(fd, offset, sz);
+    return result;
+}
+
 Alloc
 Alloc::alloc() noexcept
 {
@@ -533,7 +566,7 @@ Alloc::alloc(size_t sz, size_t mmapLimit, size_t alignment) noexcept
 Alloc
 Alloc::alloc_with_allocator(const MemoryAllocator* allocator) noexcept
 {
-    return Alloc(allocator);
+    return (allocator != nullptr) ? Alloc(allocator) : alloc();
 }
 
 }
@@ -32,6 +32,13 @@ public:
      * @return true if successful.
      */
     bool resize_inplace(size_t newSize);
+    /*
+     * Returns how many bytes of this allocation that are backed by huge pages,
+     * as reported by the underlying memory allocator.
+     */
+    size_t huge_page_bytes() const {
+        return (_alloc.first != nullptr) ? _allocator->huge_page_bytes(_alloc) : 0;
+    }
     Alloc(const Alloc &) = delete;
     Alloc & operator = (const Alloc &) = delete;
     Alloc(Alloc && rhs) noexcept :
@@ -69,6 +76,14 @@ public:
     static Alloc allocAlignedHeap(size_t sz, size_t alignment);
     static Alloc allocHeap(size_t sz=0);
     static Alloc allocMMap(size_t sz=0);
+    /**
+     * Maps sz bytes of an open file, starting at the page aligned offset,
+     * privately into memory. Pages are read from the file on first access
+     * and copied on first write, so the file itself is never modified.
+     * The mapping does not depend on the file descriptor being kept open.
+     * Returns an empty allocation if the file could not be mapped.
+     */
+    static Alloc allocMMapFile(int fd, size_t offset, size_t sz) noexcept;
     /**
      * Optional alignment is assumed to be <= system page size, since mmap
      * is always used when size is above limit.
@@ -77,6 +92,10 @@ public:
     static Alloc alloc_aligned(size_t sz, size_t alignment) noexcept;
     static Alloc alloc(size_t sz, size_t mmapLimit, size_t alignment=0) noexcept;
     static Alloc alloc() noexcept;
+    /**
+     * Empty allocation using the given memory allocator, or the default
+     * allocator if nullptr is given.
+     */
     static Alloc alloc_with_allocator(const MemoryAllocator* allocator) noexcept;
 private:
     Alloc(const MemoryAllocator * allocator, size_t sz) noexcept
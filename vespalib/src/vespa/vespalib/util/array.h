@@ -131,6 +131,7 @@ public:
     size_t byteSize() const                 { return _sz * sizeof(T); }
     size_t byteCapacity() const             { return _array.size(); }
     size_t capacity() const                 { return _array.size()/sizeof(T); }
+    size_t huge_page_bytes() const          { return _array.huge_page_bytes(); }
     void clear() {
         std::destroy(array(0), array(_sz));
         _sz = 0;
@@ -141,6 +142,10 @@ public:
     bool operator == (const Array & rhs) const;
     bool operator != (const Array & rhs) const;
 
+    /**
+     * Create an empty array using the same memory allocator as this array.
+     */
+    Array create() const { return Array(_array); }
     static Alloc stealAlloc(Array && rhs) {
         rhs._sz = 0;
         return std::move(rhs._array);
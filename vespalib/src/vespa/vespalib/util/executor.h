@@ -23,7 +23,7 @@ public:
         virtual ~Task() = default;
     };
 
-    enum class OptimizeFor {LATENCY, THROUGHPUT, ADAPTIVE};
+    enum class OptimizeFor {LATENCY, THROUGHPUT, ADAPTIVE, LOCKFREE};
 
     /**
      * Execute the given task using one of the internal threads some
@@ -1,12 +1,49 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "generationhandler.h"
+#include <algorithm>
 #include <cassert>
+#include <thread>
 
 namespace vespalib {
 
-GenerationHandler::GenerationHold::GenerationHold(void)
-    : _refCount(1),
+namespace {
+
+// upper limit on reference count shards, bounding the memory used per generation hold
+constexpr uint32_t max_shards = 64;
+
+uint32_t
+calcNumShards()
+{
+    uint32_t cpus = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t shards = 1;
+    while ((shards < cpus) && (shards < max_shards)) {
+        shards *= 2;
+    }
+    return shards;
+}
+
+std::atomic<uint32_t> nextThreadShard(0);
+
+}
+
+uint32_t
+GenerationHandler::GenerationHold::numShards()
+{
+    static const uint32_t shards = calcNumShards();
+    return shards;
+}
+
+uint32_t
+GenerationHandler::GenerationHold::threadShard()
+{
+    static thread_local uint32_t shard = (nextThreadShard.fetch_add(1, std::memory_order_relaxed) & (numShards() - 1));
+    return shard;
+}
+
+GenerationHandler::GenerationHold::GenerationHold()
+    : _shards(std::make_unique<Shard[]>(numShards())),
+      _invalid(true),
       _generation(0),
       _next(0)
 { }
@@ -17,59 +54,67 @@ GenerationHandler::GenerationHold::~GenerationHold() {
 
 void
 GenerationHandler::GenerationHold::setValid() {
-    assert(!valid(_refCount));
-    _refCount.fetch_sub(1);
+    assert(_invalid.load(std::memory_order_relaxed));
+    _invalid.store(false, std::memory_order_relaxed);
 }
 
 bool
 GenerationHandler::GenerationHold::setInvalid() {
-    uint32_t refs = _refCount;
-    assert(valid(refs));
-    if (refs != 0) {
-        return false;
-    }
-    return _refCount.compare_exchange_strong(refs, 1, std::memory_order_seq_cst);
+    // Readers increase their reference count before checking the
+    // invalid flag, so either they see the flag and back off, or we
+    // see their reference.
+    _invalid.store(true);
+    return (getRefCount() == 0);
 }
 
 void
-GenerationHandler::GenerationHold::release() {
-    _refCount.fetch_sub(2);
+GenerationHandler::GenerationHold::release(uint32_t shard) {
+    _shards[shard].refCount.fetch_sub(1);
 }
 
 GenerationHandler::GenerationHold *
-GenerationHandler::GenerationHold::acquire() {
-    if (valid(_refCount.fetch_add(2))) {
+GenerationHandler::GenerationHold::acquire(uint32_t shard) {
+    _shards[shard].refCount.fetch_add(1);
+    if (!_invalid.load()) {
         return this;
     } else {
-        release();
+        release(shard);
         return nullptr;
     }
 }
 
 GenerationHandler::GenerationHold *
-GenerationHandler::GenerationHold::copy(GenerationHold *self) {
+GenerationHandler::GenerationHold::copy(GenerationHold *self, uint32_t shard) {
     if (self == nullptr) {
         return nullptr;
     } else {
-        uint32_t oldRefCount = self->_refCount.fetch_add(2);
+        // Use the same shard as the guard copied from; its reference
+        // count will not drop to zero while the copy is being made.
+        uint32_t oldRefCount = self->_shards[shard].refCount.fetch_add(1);
         (void) oldRefCount;
-        assert(valid(oldRefCount));
+        assert(oldRefCount > 0);
         return self;
     }
 }
 
 uint32_t
 GenerationHandler::GenerationHold::getRefCount() const {
-    return _refCount / 2;
+    uint32_t refCount = 0;
+    for (uint32_t i = 0, n = numShards(); i < n; ++i) {
+        refCount += _shards[i].refCount.load();
+    }
+    return refCount;
 }
 
 GenerationHandler::Guard::Guard()
-    : _hold(nullptr)
+    : _hold(nullptr),
+      _shard(0)
 {
 }
 
-GenerationHandler::Guard::Guard(GenerationHold *hold)
-    : _hold(hold->acquire())
+GenerationHandler::Guard::Guard(GenerationHold *hold, uint32_t shard)
+    : _hold(hold->acquire(shard)),
+      _shard(shard)
 {
 }
 
@@ -79,12 +124,14 @@ GenerationHandler::Guard::~Guard()
 }
 
 GenerationHandler::Guard::Guard(const Guard & rhs)
-    : _hold(GenerationHold::copy(rhs._hold))
+    : _hold(GenerationHold::copy(rhs._hold, rhs._shard)),
+      _shard(rhs._shard)
 {
 }
 
 GenerationHandler::Guard::Guard(Guard &&rhs)
-    : _hold(rhs._hold)
+    : _hold(rhs._hold),
+      _shard(rhs._shard)
 {
     rhs._hold = nullptr;
 }
@@ -94,7 +141,8 @@ GenerationHandler::Guard::operator=(const Guard & rhs)
 {
     if (&rhs != this) {
         cleanup();
-        _hold = GenerationHold::copy(rhs._hold);
+        _hold = GenerationHold::copy(rhs._hold, rhs._shard);
+        _shard = rhs._shard;
     }
     return *this;
 }
@@ -105,6 +153,7 @@ GenerationHandler::Guard::operator=(Guard &&rhs)
     if (&rhs != this) {
         cleanup();
         _hold = rhs._hold;
+        _shard = rhs._shard;
         rhs._hold = nullptr;
     }
     return *this;
@@ -162,7 +211,8 @@ GenerationHandler::~GenerationHandler(void)
 GenerationHandler::Guard
 GenerationHandler::takeGuard() const
 {
-    Guard guard(_last);
+    const uint32_t shard = GenerationHold::threadShard();
+    Guard guard(_last, shard);
     for (;;) {
         // Must check valid() after increasing refcount
         std::atomic_thread_fence(std::memory_order_acquire);
@@ -172,7 +222,7 @@ GenerationHandler::takeGuard() const
          * Clashed with writer freeing entry.  Must abandon current
          * guard and try again.
          */
-        guard = Guard(_last);
+        guard = Guard(_last, shard);
     }
     // Guard has been valid after bumping refCount
     return guard;
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <atomic>
+#include <memory>
 
 namespace vespalib {
 
@@ -12,6 +13,13 @@ namespace vespalib {
  * (changed by a single writer), and previous generations still
  * occupied by multiple readers.  Readers will take a generation guard
  * by calling takeGuard().
+ *
+ * The reference count of each generation is split into shards placed
+ * in separate cache lines. Each reader thread is assigned a shard the
+ * first time it takes a guard, and only updates that shard when
+ * taking and releasing guards. This avoids having all reader threads
+ * write to the same cache line. The writer sums all shards when
+ * checking if a generation is still in use.
  **/
 class GenerationHandler {
 public:
@@ -25,10 +33,12 @@ public:
      */
     class GenerationHold
     {
-        // least significant bit is invalid flag
-        std::atomic<uint32_t> _refCount;
-
-        static bool valid(uint32_t refCount) { return (refCount & 1) == 0u; }
+        struct alignas(64) Shard {
+            std::atomic<uint32_t> refCount;
+            Shard() noexcept : refCount(0) {}
+        };
+        std::unique_ptr<Shard[]> _shards;
+        std::atomic<bool>        _invalid;
     public:
         generation_t _generation;
         GenerationHold *_next;	// next free element or next newer element.
@@ -38,10 +48,14 @@ public:
 
         void setValid();
         bool setInvalid();
-        void release();
-        GenerationHold *acquire();
-        static GenerationHold *copy(GenerationHold *self);
+        void release(uint32_t shard);
+        GenerationHold *acquire(uint32_t shard);
+        static GenerationHold *copy(GenerationHold *self, uint32_t shard);
         uint32_t getRefCount() const;
+        // number of reference count shards (a power of 2)
+        static uint32_t numShards();
+        // shard used by the calling thread
+        static uint32_t threadShard();
     };
 
     /**
@@ -50,15 +64,16 @@ public:
     class Guard {
     private:
         GenerationHold *_hold;
+        uint32_t        _shard;
         void cleanup() {
             if (_hold != nullptr) {
-                _hold->release();
+                _hold->release(_shard);
                 _hold = nullptr;
             }
         }
     public:
         Guard();
-        Guard(GenerationHold *hold); // hold is never nullptr
+        Guard(GenerationHold *hold, uint32_t shard); // hold is never nullptr
         ~Guard();
         Guard(const Guard & rhs);
         Guard(Guard &&rhs);
@@ -34,6 +34,15 @@ public:
      * @return true if successful.
      */
     virtual size_t resize_inplace(PtrAndSize current, size_t newSize) const = 0;
+    /*
+     * Returns how many bytes of the given allocation that was requested
+     * to be backed by huge pages (explicit or transparent) where the
+     * request succeeded.
+     */
+    virtual size_t huge_page_bytes(PtrAndSize alloc) const {
+        (void) alloc;
+        return 0;
+    }
     static size_t roundUpToHugePages(size_t sz) {
         return (sz+(HUGEPAGE_SIZE-1)) & ~(HUGEPAGE_SIZE-1);
     }
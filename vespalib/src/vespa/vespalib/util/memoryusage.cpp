@@ -18,6 +18,7 @@ operator << (asciistream & os, const MemoryUsage & usage) {
     os << ", used: " << usage.usedBytes();
     os << ", dead: " << usage.deadBytes();
     os << ", onhold: " << usage.allocatedBytesOnHold();
+    os << ", hugepages: " << usage.allocatedHugePageBytes();
     return os;
 }
 
@@ -12,26 +12,30 @@ private:
     size_t _usedBytes;
     size_t _deadBytes;
     size_t _allocatedBytesOnHold;
+    size_t _allocatedHugePageBytes; // part of allocated bytes that is backed by huge pages
 
 public:
     MemoryUsage() noexcept
         : _allocatedBytes(0),
           _usedBytes(0),
           _deadBytes(0),
-          _allocatedBytesOnHold(0)
+          _allocatedBytesOnHold(0),
+          _allocatedHugePageBytes(0)
     { }
 
     MemoryUsage(size_t allocated, size_t used, size_t dead, size_t onHold) noexcept
         : _allocatedBytes(allocated),
           _usedBytes(used),
           _deadBytes(dead),
-          _allocatedBytesOnHold(onHold)
+          _allocatedBytesOnHold(onHold),
+          _allocatedHugePageBytes(0)
     { }
 
     size_t allocatedBytes() const { return _allocatedBytes; }
     size_t usedBytes() const { return _usedBytes; }
     size_t deadBytes() const { return _deadBytes; }
     size_t allocatedBytesOnHold() const { return _allocatedBytesOnHold; }
+    size_t allocatedHugePageBytes() const { return _allocatedHugePageBytes; }
     void incAllocatedBytes(size_t inc) { _allocatedBytes += inc; }
     void decAllocatedBytes(size_t dec) { _allocatedBytes -= dec; }
     void incUsedBytes(size_t inc) { _usedBytes += inc; }
@@ -43,6 +47,7 @@ public:
     void setUsedBytes(size_t used) { _usedBytes = used; }
     void setDeadBytes(size_t dead) { _deadBytes = dead; }
     void setAllocatedBytesOnHold(size_t onHold) { _allocatedBytesOnHold = onHold; }
+    void setAllocatedHugePageBytes(size_t huge) { _allocatedHugePageBytes = huge; }
 
     void mergeGenerationHeldBytes(size_t inc) {
         _allocatedBytes += inc;
@@ -55,6 +60,7 @@ public:
         _usedBytes += rhs._usedBytes;
         _deadBytes += rhs._deadBytes;
         _allocatedBytesOnHold += rhs._allocatedBytesOnHold;
+        _allocatedHugePageBytes += rhs._allocatedHugePageBytes;
     }
     string toString() const;
 };
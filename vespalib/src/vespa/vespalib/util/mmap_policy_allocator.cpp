@@ -0,0 +1,335 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "mmap_policy_allocator.h"
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <sys/mman.h>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.mmap_policy_allocator");
+
+namespace vespalib::alloc {
+
+namespace {
+
+constexpr int mmap_prot = PROT_READ | PROT_WRITE;
+constexpr int mmap_flags = MAP_ANON | MAP_PRIVATE;
+
+// Memory policy modes from <linux/mempolicy.h>, to avoid depending on libnuma
+constexpr int mpol_bind = 2;
+constexpr int mpol_interleave = 3;
+constexpr size_t bits_per_word = 8 * sizeof(unsigned long);
+
+std::atomic<bool> warned_huge_pages(false);
+std::atomic<bool> warned_numa(false);
+
+void set_node(std::vector<unsigned long> &mask, uint32_t node) {
+    size_t word = node / bits_per_word;
+    if (word >= mask.size()) {
+        mask.resize(word + 1, 0ul);
+    }
+    mask[word] |= (1ul << (node % bits_per_word));
+}
+
+// Parses a node list like "0-3,5" as found in /sys/devices/system/node/online
+std::vector<unsigned long> read_online_numa_nodes() {
+    std::vector<unsigned long> mask;
+    FILE *file = fopen("/sys/devices/system/node/online", "r");
+    if (file == nullptr) {
+        return mask;
+    }
+    char buf[256];
+    if (fgets(buf, sizeof(buf), file) != nullptr) {
+        char *pos = buf;
+        while (*pos != '\0' && *pos != '\n') {
+            char *end = nullptr;
+            unsigned long first = strtoul(pos, &end, 10);
+            if (end == pos) {
+                break;
+            }
+            unsigned long last = first;
+            pos = end;
+            if (*pos == '-') {
+                last = strtoul(pos + 1, &end, 10);
+                pos = end;
+            }
+            for (unsigned long node = first; node <= last; ++node) {
+                set_node(mask, node);
+            }
+            if (*pos == ',') {
+                ++pos;
+            }
+        }
+    }
+    fclose(file);
+    return mask;
+}
+
+const std::vector<unsigned long> &online_numa_nodes() {
+    static std::vector<unsigned long> nodes = read_online_numa_nodes();
+    return nodes;
+}
+
+bool mbind_memory(void *buf, size_t sz, int mode, const std::vector<unsigned long> &mask) {
+#ifdef __linux__
+    if (mask.empty()) {
+        return false;
+    }
+    long rc = syscall(SYS_mbind, buf, sz, mode, mask.data(), (mask.size() * bits_per_word) + 1, 0u);
+    return (rc == 0);
+#else
+    (void) buf;
+    (void) sz;
+    (void) mode;
+    (void) mask;
+    return false;
+#endif
+}
+
+bool advise_huge_pages(void *buf, size_t sz) {
+#ifdef MADV_HUGEPAGE
+    return (madvise(buf, sz, MADV_HUGEPAGE) == 0);
+#else
+    (void) buf;
+    (void) sz;
+    return false;
+#endif
+}
+
+void *mmap_explicit_huge_pages(size_t sz) {
+#ifdef MAP_HUGETLB
+    return mmap(nullptr, sz, mmap_prot, mmap_flags | MAP_HUGETLB, -1, 0);
+#else
+    (void) sz;
+    return MAP_FAILED;
+#endif
+}
+
+// Maps sz bytes starting at a huge page boundary, to let transparent huge pages cover the whole area
+void *mmap_huge_page_aligned(size_t sz) {
+    size_t mapped_sz = sz + MemoryAllocator::HUGEPAGE_SIZE;
+    char *buf = static_cast<char *>(mmap(nullptr, mapped_sz, mmap_prot, mmap_flags, -1, 0));
+    if (buf == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    uintptr_t addr = reinterpret_cast<uintptr_t>(buf);
+    uintptr_t aligned = (addr + MemoryAllocator::HUGEPAGE_SIZE - 1) & ~uintptr_t(MemoryAllocator::HUGEPAGE_SIZE - 1);
+    size_t head = aligned - addr;
+    size_t tail = mapped_sz - head - sz;
+    if (head > 0) {
+        int retval = munmap(buf, head);
+        assert(retval == 0);
+        (void) retval;
+    }
+    if (tail > 0) {
+        int retval = munmap(buf + head + sz, tail);
+        assert(retval == 0);
+        (void) retval;
+    }
+    return buf + head;
+}
+
+}
+
+MmapPolicyAllocator::MmapPolicyAllocator(const MmapPolicy &policy)
+    : _policy(policy),
+      _lock(),
+      _fallbacks(),
+      _num_fallbacks(0)
+{
+}
+
+MmapPolicyAllocator::~MmapPolicyAllocator() = default;
+
+bool
+MmapPolicyAllocator::apply_policy(void *buf, size_t sz, bool explicit_huge_pages) const
+{
+    bool huge_pages_ok = explicit_huge_pages;
+    if (!explicit_huge_pages && (_policy.huge_pages != MmapPolicy::HugePages::NONE)) {
+        huge_pages_ok = advise_huge_pages(buf, sz);
+        if (!huge_pages_ok && !warned_huge_pages.exchange(true)) {
+            LOG(warning, "Failed madvise(%p, %zu, MADV_HUGEPAGE): %s. Memory will use ordinary pages",
+                buf, sz, strerror(errno));
+        }
+    }
+    if (_policy.numa != MmapPolicy::Numa::DEFAULT) {
+        bool numa_ok = false;
+        if (_policy.numa == MmapPolicy::Numa::INTERLEAVE) {
+            numa_ok = mbind_memory(buf, sz, mpol_interleave, online_numa_nodes());
+        } else {
+            std::vector<unsigned long> mask;
+            set_node(mask, _policy.numa_node);
+            numa_ok = mbind_memory(buf, sz, mpol_bind, mask);
+        }
+        if (!numa_ok && !warned_numa.exchange(true)) {
+            LOG(warning, "Failed binding %zu bytes at %p to numa node(s) (mode %d, node %u): %s",
+                sz, buf, static_cast<int>(_policy.numa), _policy.numa_node, strerror(errno));
+        }
+    }
+    return huge_pages_ok;
+}
+
+void
+MmapPolicyAllocator::add_fallback(const void *buf) const
+{
+    std::lock_guard guard(_lock);
+    if (_fallbacks.insert(buf).second) {
+        _num_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+MmapPolicyAllocator::remove_fallback(const void *buf) const
+{
+    if (_num_fallbacks.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    std::lock_guard guard(_lock);
+    if (_fallbacks.erase(buf) != 0) {
+        _num_fallbacks.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+MemoryAllocator::PtrAndSize
+MmapPolicyAllocator::mmap_alloc(size_t sz) const
+{
+    sz = roundUpToHugePages(sz);
+    if (_policy.huge_pages == MmapPolicy::HugePages::EXPLICIT) {
+        void *buf = mmap_explicit_huge_pages(sz);
+        if (buf != MAP_FAILED) {
+            apply_policy(buf, sz, true);
+            return PtrAndSize(buf, sz);
+        }
+        LOG(debug, "Failed allocating %zu bytes with MAP_HUGETLB: %s. Falling back to transparent huge pages",
+            sz, strerror(errno));
+    }
+    void *buf = (_policy.huge_pages != MmapPolicy::HugePages::NONE)
+                ? mmap_huge_page_aligned(sz)
+                : mmap(nullptr, sz, mmap_prot, mmap_flags, -1, 0);
+    if (buf == MAP_FAILED) {
+        throw OOMException(make_string("Failed mmaping anonymous of size %zu errno(%d)", sz, errno));
+    }
+    if (!apply_policy(buf, sz, false) && (_policy.huge_pages != MmapPolicy::HugePages::NONE)) {
+        add_fallback(buf);
+    }
+    return PtrAndSize(buf, sz);
+}
+
+MemoryAllocator::PtrAndSize
+MmapPolicyAllocator::alloc(size_t sz) const
+{
+    if (sz == 0) {
+        return PtrAndSize(nullptr, 0);
+    }
+    if (use_mmap(sz)) {
+        return mmap_alloc(sz);
+    }
+    return PtrAndSize(malloc(sz), sz);
+}
+
+void
+MmapPolicyAllocator::free(PtrAndSize alloc) const
+{
+    if (alloc.first == nullptr) {
+        return;
+    }
+    if (is_mmapped(alloc.second)) {
+        remove_fallback(alloc.first);
+        int retval = munmap(alloc.first, alloc.second);
+        assert(retval == 0);
+        (void) retval;
+    } else {
+        ::free(alloc.first);
+    }
+}
+
+void
+MmapPolicyAllocator::free(void * ptr, size_t sz) const
+{
+    if (use_mmap(sz)) {
+        free(PtrAndSize(ptr, roundUpToHugePages(sz)));
+    } else {
+        free(PtrAndSize(ptr, sz));
+    }
+}
+
+size_t
+MmapPolicyAllocator::resize_inplace(PtrAndSize current, size_t newSize) const
+{
+    // Explicit huge page mappings cannot be extended by an ordinary mapping
+    if (!is_mmapped(current.second) || !use_mmap(newSize) ||
+        (_policy.huge_pages == MmapPolicy::HugePages::EXPLICIT))
+    {
+        return 0;
+    }
+    newSize = roundUpToHugePages(newSize);
+    char *end = static_cast<char *>(current.first) + current.second;
+    if (newSize > current.second) {
+        size_t extra = newSize - current.second;
+        void *got = mmap(end, extra, mmap_prot, mmap_flags, -1, 0);
+        if (got == MAP_FAILED) {
+            return 0;
+        }
+        if (got != end) {
+            int retval = munmap(got, extra);
+            assert(retval == 0);
+            (void) retval;
+            return 0;
+        }
+        if (!apply_policy(got, extra, false) && (_policy.huge_pages != MmapPolicy::HugePages::NONE)) {
+            add_fallback(current.first);
+        }
+    } else if (newSize < current.second) {
+        int retval = munmap(static_cast<char *>(current.first) + newSize, current.second - newSize);
+        assert(retval == 0);
+        (void) retval;
+    }
+    return newSize;
+}
+
+size_t
+MmapPolicyAllocator::huge_page_bytes(PtrAndSize alloc) const
+{
+    if ((_policy.huge_pages == MmapPolicy::HugePages::NONE) || !is_mmapped(alloc.second)) {
+        return 0;
+    }
+    if (_num_fallbacks.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard guard(_lock);
+        if (_fallbacks.find(alloc.first) != _fallbacks.end()) {
+            return 0;
+        }
+    }
+    return alloc.second;
+}
+
+const MemoryAllocator *
+MmapPolicyAllocator::get_allocator(const MmapPolicy &policy)
+{
+    if (policy.is_default()) {
+        return nullptr;
+    }
+    static std::mutex lock;
+    // Never destroyed, since memory allocated by these allocators may be freed during static destruction
+    static auto *allocators = new std::vector<std::unique_ptr<MmapPolicyAllocator>>();
+    std::lock_guard guard(lock);
+    for (const auto &allocator : *allocators) {
+        if (allocator->policy() == policy) {
+            return allocator.get();
+        }
+    }
+    allocators->push_back(std::make_unique<MmapPolicyAllocator>(policy));
+    return allocators->back().get();
+}
+
+}
@@ -0,0 +1,84 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "memory_allocator.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+namespace vespalib::alloc {
+
+/*
+ * Policy for how large anonymous memory mappings should be backed.
+ */
+struct MmapPolicy {
+    enum class HugePages : uint8_t {
+        NONE,        // ordinary pages
+        TRANSPARENT, // huge page aligned mapping with madvise(MADV_HUGEPAGE)
+        EXPLICIT     // MAP_HUGETLB, falling back to TRANSPARENT if no huge pages are available
+    };
+    enum class Numa : uint8_t {
+        DEFAULT,     // first touch
+        INTERLEAVE,  // interleave pages across all online numa nodes
+        BIND         // bind pages to numa_node
+    };
+    HugePages huge_pages;
+    Numa      numa;
+    uint32_t  numa_node;
+
+    MmapPolicy() noexcept : MmapPolicy(HugePages::NONE, Numa::DEFAULT, 0) {}
+    MmapPolicy(HugePages huge_pages_in, Numa numa_in, uint32_t numa_node_in = 0) noexcept
+        : huge_pages(huge_pages_in),
+          numa(numa_in),
+          numa_node(numa_node_in)
+    {}
+    bool is_default() const noexcept { return (huge_pages == HugePages::NONE) && (numa == Numa::DEFAULT); }
+    bool operator==(const MmapPolicy &rhs) const noexcept {
+        return (huge_pages == rhs.huge_pages) && (numa == rhs.numa) && (numa_node == rhs.numa_node);
+    }
+    bool operator!=(const MmapPolicy &rhs) const noexcept { return !(*this == rhs); }
+};
+
+/*
+ * Memory allocator for large random access arrays (attribute vectors,
+ * data store buffers) where TLB misses and remote numa memory
+ * accesses matter. Allocations of at least half a huge page are
+ * rounded up to whole huge pages and memory mapped according to the
+ * given policy; smaller allocations use the heap.
+ *
+ * Failing to apply the policy (no huge pages configured, no numa
+ * support) is not an error; the memory is then backed by ordinary
+ * pages and is not reported by huge_page_bytes().
+ */
+class MmapPolicyAllocator : public MemoryAllocator {
+    MmapPolicy                  _policy;
+    mutable std::mutex          _lock;
+    mutable std::set<const void *> _fallbacks; // mappings where huge pages could not be used
+    mutable std::atomic<size_t> _num_fallbacks;
+
+    bool use_mmap(size_t sz) const noexcept { return (sz + (HUGEPAGE_SIZE >> 1) - 1) >= HUGEPAGE_SIZE; }
+    bool is_mmapped(size_t sz) const noexcept { return sz >= HUGEPAGE_SIZE; }
+    bool apply_policy(void *buf, size_t sz, bool explicit_huge_pages) const;
+    void add_fallback(const void *buf) const;
+    void remove_fallback(const void *buf) const;
+    PtrAndSize mmap_alloc(size_t sz) const;
+public:
+    MmapPolicyAllocator(const MmapPolicy &policy);
+    ~MmapPolicyAllocator() override;
+    PtrAndSize alloc(size_t sz) const override;
+    void free(PtrAndSize alloc) const override;
+    void free(void * ptr, size_t sz) const override;
+    size_t resize_inplace(PtrAndSize current, size_t newSize) const override;
+    size_t huge_page_bytes(PtrAndSize alloc) const override;
+    const MmapPolicy &policy() const noexcept { return _policy; }
+
+    /*
+     * Returns a shared allocator for the given policy, or nullptr
+     * (meaning the default allocator) for the default policy.
+     */
+    static const MemoryAllocator *get_allocator(const MmapPolicy &policy);
+};
+
+}
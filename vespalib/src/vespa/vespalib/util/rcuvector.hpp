@@ -52,7 +52,7 @@ RcuVectorBase<T>::~RcuVectorBase() = default;
 template <typename T>
 void
 RcuVectorBase<T>::expand(size_t newCapacity) {
-    std::unique_ptr<ArrayType> tmpData(new ArrayType());
+    std::unique_ptr<ArrayType> tmpData(new ArrayType(_data.create()));
     tmpData->reserve(newCapacity);
     for (const T & v : _data) {
         tmpData->push_back_fast(v);
@@ -90,7 +90,7 @@ RcuVectorBase<T>::shrink(size_t newSize)
         return;
     }
     if (!_data.try_unreserve(wantedCapacity)) {
-        std::unique_ptr<ArrayType> tmpData(new ArrayType());
+        std::unique_ptr<ArrayType> tmpData(new ArrayType(_data.create()));
         tmpData->reserve(wantedCapacity);
         tmpData->resize(newSize);
         for (uint32_t i = 0; i < newSize; ++i) {
@@ -147,6 +147,7 @@ RcuVectorBase<T>::getMemoryUsage() const
     MemoryUsage retval;
     retval.incAllocatedBytes(_data.capacity() * sizeof(T));
     retval.incUsedBytes(_data.size() * sizeof(T));
+    retval.setAllocatedHugePageBytes(_data.huge_page_bytes());
     return retval;
 }
 
@@ -2,6 +2,8 @@
 
 #include "stash.h"
 #include <algorithm>
+#include <cstdint>
+#include <new>
 
 namespace vespalib {
 namespace stash {
@@ -41,6 +43,15 @@ Cleanup *run_cleanup(Cleanup *cleanup, Cleanup *until = nullptr) {
     return until;
 }
 
+thread_local Stash *_current_stash = nullptr;
+
+// Header in front of objects allocated by StashAllocated, telling
+// where the memory came from. Keeps the default new alignment;
+// over-aligned types get a header as large as their alignment.
+constexpr size_t alloc_header_size = 16;
+constexpr char heap_tag = 0;
+constexpr char stash_tag = 1;
+
 } // namespace vespalib::stash::<unnamed>
 
 } // namespace vespalib::stash
@@ -140,4 +151,83 @@ Stash::get_memory_usage() const
     return MemoryUsage(allocated, used, 0, 0);
 };
 
+StashScope::StashScope(Stash &stash) noexcept
+    : _prev(stash::_current_stash)
+{
+    stash::_current_stash = &stash;
+}
+
+StashScope::~StashScope()
+{
+    stash::_current_stash = _prev;
+}
+
+Stash *
+StashScope::current() noexcept
+{
+    return stash::_current_stash;
+}
+
+namespace {
+
+// The header is at least as large as the alignment, so that the
+// object following it keeps the alignment of the header.
+void *stash_allocated_new(size_t size, size_t align) {
+    size_t header_size = std::max(stash::alloc_header_size, align);
+    char *mem;
+    char tag;
+    Stash *stash = stash::_current_stash;
+    if (stash != nullptr) {
+        // stash memory is only pointer aligned
+        char *raw = stash->alloc(header_size + size + (header_size - sizeof(char *)));
+        mem = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(raw) + (header_size - 1))
+                                       & ~uintptr_t(header_size - 1));
+        tag = stash::stash_tag;
+    } else {
+        size_t total = (header_size + size + (header_size - 1)) & ~(header_size - 1);
+        mem = static_cast<char *>(aligned_alloc(header_size, total));
+        if (mem == nullptr) {
+            throw std::bad_alloc();
+        }
+        tag = stash::heap_tag;
+    }
+    *mem = tag;
+    return mem + header_size;
+}
+
+void stash_allocated_delete(void *ptr, size_t align) noexcept {
+    if (ptr != nullptr) {
+        char *mem = static_cast<char *>(ptr) - std::max(stash::alloc_header_size, align);
+        if (*mem == stash::heap_tag) {
+            free(mem);
+        }
+    }
+}
+
+}
+
+void *
+StashAllocated::operator new(size_t size)
+{
+    return stash_allocated_new(size, stash::alloc_header_size);
+}
+
+void *
+StashAllocated::operator new(size_t size, std::align_val_t align)
+{
+    return stash_allocated_new(size, static_cast<size_t>(align));
+}
+
+void
+StashAllocated::operator delete(void *ptr) noexcept
+{
+    stash_allocated_delete(ptr, stash::alloc_header_size);
+}
+
+void
+StashAllocated::operator delete(void *ptr, std::align_val_t align) noexcept
+{
+    stash_allocated_delete(ptr, static_cast<size_t>(align));
+}
+
 } // namespace vespalib
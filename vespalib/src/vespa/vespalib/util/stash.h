@@ -6,6 +6,7 @@
 #include "arrayref.h"
 #include "memoryusage.h"
 #include <cstdlib>
+#include <new>
 
 namespace vespalib {
 namespace stash {
@@ -194,4 +195,47 @@ public:
     }
 };
 
+/**
+ * @brief Binds a stash as the arena of the current thread while in
+ * scope.
+ *
+ * Objects of classes inheriting StashAllocated that are created by
+ * the current thread while a stash is bound are bump-allocated in
+ * that stash instead of on the heap. Scopes may be nested; the
+ * innermost binding is used. The stash must outlive all objects
+ * allocated in it, which means that objects created inside the scope
+ * must not be handed over to owners living longer than the stash.
+ **/
+class StashScope
+{
+private:
+    Stash *_prev;
+public:
+    explicit StashScope(Stash &stash) noexcept;
+    StashScope(const StashScope &) = delete;
+    StashScope &operator=(const StashScope &) = delete;
+    ~StashScope();
+    static Stash *current() noexcept;
+};
+
+/**
+ * @brief Mixin making a class hierarchy allocate its objects in the
+ * stash bound to the current thread by StashScope.
+ *
+ * When no stash is bound, objects are allocated on the heap. Objects
+ * are owned and deleted as usual (typically by std::unique_ptr), but
+ * deleting an object living in a stash only runs its destructor; the
+ * memory is released in one go together with the stash.
+ **/
+class StashAllocated
+{
+public:
+    static void *operator new(size_t size);
+    static void *operator new(size_t size, std::align_val_t align);
+    static void *operator new(size_t, void *ptr) noexcept { return ptr; }
+    static void operator delete(void *ptr) noexcept;
+    static void operator delete(void *ptr, std::align_val_t align) noexcept;
+    static void operator delete(void *, void *) noexcept {}
+};
+
 } // namespace vespalib
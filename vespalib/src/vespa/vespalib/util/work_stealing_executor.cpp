@@ -0,0 +1,532 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "work_stealing_executor.h"
+#include <vespa/fastos/thread.h>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace vespalib {
+
+VESPA_THREAD_STACK_TAG(unnamed_work_stealing_executor);
+
+namespace {
+
+template <typename T>
+void atomic_min(std::atomic<T> &target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while ((value < current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+template <typename T>
+void atomic_max(std::atomic<T> &target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while ((value > current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+/**
+ * A work-stealing deque (Chase and Lev, with the memory orderings
+ * described by Le, Pop, Cohen and Zappa Nardelli). Only the owning
+ * worker may push and pop items (at the bottom), while any thread may
+ * steal items (at the top). Arrays replaced when growing are kept
+ * until the deque is destructed, since thieves may still read them.
+ **/
+template <typename Item>
+class WorkStealingDeque {
+private:
+    struct Array {
+        const int64_t size;
+        std::unique_ptr<std::atomic<Item*>[]> slots;
+        explicit Array(int64_t size_in) : size(size_in), slots(new std::atomic<Item*>[size_in]) {}
+        Item *get(int64_t idx) const { return slots[idx & (size - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t idx, Item *item) { slots[idx & (size - 1)].store(item, std::memory_order_relaxed); }
+    };
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+    std::atomic<Array*>                 _array;
+    std::vector<std::unique_ptr<Array>> _arrays;
+
+    Array *grow(Array *old_array, int64_t top, int64_t bottom) {
+        _arrays.push_back(std::make_unique<Array>(old_array->size * 2));
+        Array *new_array = _arrays.back().get();
+        for (int64_t i = top; i < bottom; ++i) {
+            new_array->put(i, old_array->get(i));
+        }
+        _array.store(new_array, std::memory_order_release);
+        return new_array;
+    }
+
+public:
+    WorkStealingDeque() : _top(0), _bottom(0), _array(), _arrays() {
+        _arrays.push_back(std::make_unique<Array>(64));
+        _array.store(_arrays.back().get(), std::memory_order_relaxed);
+    }
+    bool empty() const {
+        return (_top.load(std::memory_order_relaxed) >= _bottom.load(std::memory_order_relaxed));
+    }
+    void push(Item *item) {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_acquire);
+        Array *array = _array.load(std::memory_order_relaxed);
+        if ((bottom - top) > (array->size - 1)) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    Item *pop() {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Array *array = _array.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Item *item = array->get(bottom);
+        if (top == bottom) {
+            // last item; race against thieves
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+    Item *steal() {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Item *item = _array.load(std::memory_order_acquire)->get(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+};
+
+} // namespace vespalib::<unnamed>
+
+struct WorkStealingExecutor::Item {
+    Task::UP               task;
+    std::atomic<uint32_t> *pending;
+    Item                  *next;
+    Item(Task::UP task_in, std::atomic<uint32_t> *pending_in)
+        : task(std::move(task_in)), pending(pending_in), next(nullptr) {}
+};
+
+struct alignas(64) WorkStealingExecutor::Worker {
+    const uint32_t          idx;
+    std::atomic<Item*>      inbox;      // lock-free stack, always emptied as a whole
+    WorkStealingDeque<Item> deque;
+    std::atomic<uint32_t>   pending[2]; // accepted tasks per sync epoch
+    std::atomic<size_t>     acceptedTasks;
+    std::atomic<size_t>     queueSizeCount;
+    std::atomic<size_t>     queueSizeTotal;
+    std::atomic<size_t>     queueSizeMin;
+    std::atomic<size_t>     queueSizeMax;
+    std::mutex              lock;
+    std::condition_variable cond;
+    bool                    sleeping;   // protected by lock
+    explicit Worker(uint32_t idx_in)
+        : idx(idx_in), inbox(nullptr), deque(), pending{0, 0}, acceptedTasks(0),
+          queueSizeCount(0), queueSizeTotal(0), queueSizeMin(std::numeric_limits<size_t>::max()),
+          queueSizeMax(0), lock(), cond(), sleeping(false) {}
+    ~Worker() { assert(inbox.load() == nullptr); assert(deque.empty()); }
+    void push_inbox(Item *item) {
+        Item *head = inbox.load(std::memory_order_relaxed);
+        do {
+            item->next = head;
+        } while (!inbox.compare_exchange_weak(head, item, std::memory_order_seq_cst, std::memory_order_relaxed));
+    }
+    Item *take_inbox() {
+        if (inbox.load() == nullptr) {
+            return nullptr;
+        }
+        return inbox.exchange(nullptr, std::memory_order_acquire);
+    }
+    void sample_queue_size(size_t value) {
+        acceptedTasks.fetch_add(1, std::memory_order_relaxed);
+        queueSizeCount.fetch_add(1, std::memory_order_relaxed);
+        queueSizeTotal.fetch_add(value, std::memory_order_relaxed);
+        atomic_min(queueSizeMin, value);
+        atomic_max(queueSizeMax, value);
+    }
+    void collect_stats(Stats &stats) {
+        stats.acceptedTasks += acceptedTasks.exchange(0, std::memory_order_relaxed);
+        stats.queueSize.add(queueSizeCount.exchange(0, std::memory_order_relaxed),
+                            queueSizeTotal.exchange(0, std::memory_order_relaxed),
+                            queueSizeMin.exchange(std::numeric_limits<size_t>::max(), std::memory_order_relaxed),
+                            queueSizeMax.exchange(0, std::memory_order_relaxed));
+    }
+};
+
+struct WorkStealingExecutor::ThreadInit : public FastOS_Runnable {
+    Runnable &worker;
+    init_fun_t init_fun;
+    ThreadInit(Runnable &worker_in, init_fun_t init_fun_in)
+        : worker(worker_in), init_fun(std::move(init_fun_in)) {}
+    void Run(FastOS_ThreadInterface *, void *) override { init_fun(worker); }
+};
+
+thread_local WorkStealingExecutor *WorkStealingExecutor::_master = nullptr;
+thread_local WorkStealingExecutor::Worker *WorkStealingExecutor::_self = nullptr;
+
+//-----------------------------------------------------------------------------
+
+bool
+WorkStealingExecutor::reserveTask()
+{
+    uint32_t count = _taskCount.load(std::memory_order_relaxed);
+    for (;;) {
+        if (_closed.load()) {
+            return false;
+        }
+        if (count < _taskLimit.load(std::memory_order_relaxed)) {
+            if (_taskCount.compare_exchange_weak(count, count + 1)) {
+                if (_closed.load()) {
+                    // workers may have observed shutdown with no tasks left
+                    releaseTask();
+                    return false;
+                }
+                return true;
+            }
+        } else if (_blocking) {
+            std::unique_lock guard(_lock);
+            _numWaiting.fetch_add(1);
+            while (!_closed.load() && (_taskCount.load() >= _taskLimit.load())) {
+                _cond.wait(guard);
+            }
+            _numWaiting.fetch_sub(1);
+            count = _taskCount.load(std::memory_order_relaxed);
+        } else {
+            return false;
+        }
+    }
+}
+
+void
+WorkStealingExecutor::releaseTask()
+{
+    uint32_t left = (_taskCount.fetch_sub(1) - 1);
+    notifyWaiting();
+    if ((left == 0) && _closed.load()) {
+        wakeAllWorkers();
+    }
+}
+
+void
+WorkStealingExecutor::releasePending(std::atomic<uint32_t> &pending)
+{
+    pending.fetch_sub(1);
+    notifyWaiting();
+}
+
+void
+WorkStealingExecutor::notifyWaiting()
+{
+    if (_numWaiting.load() > 0) {
+        std::lock_guard guard(_lock);
+        _cond.notify_all();
+    }
+}
+
+WorkStealingExecutor::Worker &
+WorkStealingExecutor::selectWorker()
+{
+    static thread_local uint32_t next = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return *_workers[next++ % _workers.size()];
+}
+
+bool
+WorkStealingExecutor::wakeWorker(Worker &worker)
+{
+    std::lock_guard guard(worker.lock);
+    if (!worker.sleeping) {
+        return false;
+    }
+    worker.sleeping = false;
+    _numSleeping.fetch_sub(1);
+    worker.cond.notify_one();
+    return true;
+}
+
+void
+WorkStealingExecutor::wakeOneWorker(Worker &preferred)
+{
+    if (wakeWorker(preferred)) {
+        return;
+    }
+    for (size_t i = 1; (i < _workers.size()) && (_numSleeping.load() > 0); ++i) {
+        if (wakeWorker(*_workers[(preferred.idx + i) % _workers.size()])) {
+            return;
+        }
+    }
+}
+
+void
+WorkStealingExecutor::wakeAllWorkers()
+{
+    for (const auto &worker: _workers) {
+        wakeWorker(*worker);
+    }
+}
+
+void
+WorkStealingExecutor::cancelSleep(Worker &worker)
+{
+    std::lock_guard guard(worker.lock);
+    if (worker.sleeping) {
+        worker.sleeping = false;
+        _numSleeping.fetch_sub(1);
+    }
+}
+
+bool
+WorkStealingExecutor::done() const
+{
+    return (_closed.load() && (_taskCount.load() == 0));
+}
+
+WorkStealingExecutor::Item *
+WorkStealingExecutor::findTask(Worker &worker)
+{
+    if (Item *item = worker.deque.pop()) {
+        return item;
+    }
+    // the inbox is newest first; pushing it in that order leaves the
+    // oldest task at the bottom of the deque, where it is popped first
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        Worker &victim = *_workers[(worker.idx + i) % _workers.size()];
+        if (i > 0) {
+            if (Item *item = victim.deque.steal()) {
+                return item;
+            }
+        }
+        if (Item *list = victim.take_inbox()) {
+            while (list != nullptr) {
+                Item *next = list->next;
+                worker.deque.push(list);
+                list = next;
+            }
+            if (Item *item = worker.deque.pop()) {
+                return item;
+            }
+        }
+    }
+    return nullptr;
+}
+
+WorkStealingExecutor::Item *
+WorkStealingExecutor::obtainTask(Worker &worker)
+{
+    for (;;) {
+        if (Item *item = findTask(worker)) {
+            return item;
+        }
+        {
+            std::lock_guard guard(worker.lock);
+            worker.sleeping = true;
+            _numSleeping.fetch_add(1);
+        }
+        // look again, since tasks executed before we announced that
+        // we are sleeping will not wake us up
+        if (Item *item = findTask(worker)) {
+            cancelSleep(worker);
+            return item;
+        }
+        if (done()) {
+            cancelSleep(worker);
+            return nullptr;
+        }
+        std::unique_lock guard(worker.lock);
+        while (worker.sleeping) {
+            worker.cond.wait(guard);
+        }
+    }
+}
+
+void
+WorkStealingExecutor::completeTask(Item *item)
+{
+    item->task.reset();
+    std::atomic<uint32_t> &pending = *item->pending;
+    delete item;
+    releasePending(pending);
+    releaseTask();
+}
+
+void
+WorkStealingExecutor::run()
+{
+    uint32_t idx = _nextWorker.fetch_add(1);
+    assert(idx < _workers.size());
+    Worker &worker = *_workers[idx];
+    _master = this;
+    _self = &worker;
+    while (Item *item = obtainTask(worker)) {
+        item->task->run();
+        completeTask(item);
+    }
+    _self = nullptr;
+    _master = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+
+WorkStealingExecutor::WorkStealingExecutor(uint32_t threads, uint32_t stackSize, uint32_t taskLimit, bool blocking)
+    : WorkStealingExecutor(threads, stackSize, unnamed_work_stealing_executor, taskLimit, blocking)
+{
+}
+
+WorkStealingExecutor::WorkStealingExecutor(uint32_t threads, uint32_t stackSize, init_fun_t init_function,
+                                           uint32_t taskLimit, bool blocking)
+    : SyncableThreadExecutor(),
+      Runnable(),
+      _pool(std::make_unique<FastOS_ThreadPool>(stackSize)),
+      _workers(),
+      _nextWorker(0),
+      _taskCount(0),
+      _taskLimit(taskLimit),
+      _closed(false),
+      _blocking(blocking),
+      _numSleeping(0),
+      _numWaiting(0),
+      _syncEpoch(0),
+      _rejectedTasks(0),
+      _lock(),
+      _cond(),
+      _syncLock(),
+      _threadInit(std::make_unique<ThreadInit>(*this, std::move(init_function)))
+{
+    assert(threads > 0);
+    assert(taskLimit > 0);
+    for (uint32_t i = 0; i < threads; ++i) {
+        _workers.push_back(std::make_unique<Worker>(i));
+    }
+    for (uint32_t i = 0; i < threads; ++i) {
+        FastOS_ThreadInterface *thread = _pool->NewThread(_threadInit.get());
+        assert(thread != nullptr);
+        (void)thread;
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    shutdown().sync();
+    _pool->Close();
+    assert(_taskCount.load() == 0);
+}
+
+WorkStealingExecutor::Stats
+WorkStealingExecutor::getStats()
+{
+    Stats stats;
+    for (const auto &worker: _workers) {
+        worker->collect_stats(stats);
+    }
+    stats.rejectedTasks = _rejectedTasks.exchange(0, std::memory_order_relaxed);
+    Worker &first = *_workers[0];
+    size_t taskCount = _taskCount.load(std::memory_order_relaxed);
+    first.queueSizeCount.fetch_add(1, std::memory_order_relaxed);
+    first.queueSizeTotal.fetch_add(taskCount, std::memory_order_relaxed);
+    atomic_min(first.queueSizeMin, taskCount);
+    atomic_max(first.queueSizeMax, taskCount);
+    return stats;
+}
+
+WorkStealingExecutor::Task::UP
+WorkStealingExecutor::execute(Task::UP task)
+{
+    if (!reserveTask()) {
+        _rejectedTasks.fetch_add(1, std::memory_order_relaxed);
+        return task;
+    }
+    Worker *self = (_master == this) ? _self : nullptr;
+    Worker &target = (self != nullptr) ? *self : selectWorker();
+    target.sample_queue_size(_taskCount.load(std::memory_order_relaxed));
+    // count the task in the current sync epoch; if a sync started in
+    // the meantime, it might not see the count, so try again
+    std::atomic<uint32_t> *pending = nullptr;
+    for (;;) {
+        uint64_t epoch = _syncEpoch.load();
+        pending = &target.pending[epoch & 1];
+        pending->fetch_add(1);
+        if (_syncEpoch.load() == epoch) {
+            break;
+        }
+        releasePending(*pending);
+    }
+    Item *item = new Item(std::move(task), pending);
+    if (self != nullptr) {
+        self->deque.push(item);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    } else {
+        target.push_inbox(item);
+    }
+    if (_numSleeping.load() > 0) {
+        wakeOneWorker(target);
+    }
+    return Task::UP();
+}
+
+WorkStealingExecutor &
+WorkStealingExecutor::sync()
+{
+    std::lock_guard syncGuard(_syncLock);
+    uint64_t epoch = _syncEpoch.fetch_add(1);
+    std::unique_lock guard(_lock);
+    _numWaiting.fetch_add(1);
+    for (const auto &worker: _workers) {
+        while (worker->pending[epoch & 1].load() != 0) {
+            _cond.wait(guard);
+        }
+    }
+    _numWaiting.fetch_sub(1);
+    return *this;
+}
+
+size_t
+WorkStealingExecutor::getNumThreads() const
+{
+    return _workers.size();
+}
+
+void
+WorkStealingExecutor::setTaskLimit(uint32_t taskLimit)
+{
+    if (!_closed.load()) {
+        _taskLimit.store(taskLimit);
+        notifyWaiting();
+    }
+}
+
+uint32_t
+WorkStealingExecutor::getTaskLimit() const
+{
+    return _taskLimit.load();
+}
+
+void
+WorkStealingExecutor::wakeup()
+{
+    // Nothing to do here as workers are always attentive.
+}
+
+WorkStealingExecutor &
+WorkStealingExecutor::shutdown()
+{
+    _closed.store(true);
+    _taskLimit.store(0);
+    notifyWaiting();
+    wakeAllWorkers();
+    return *this;
+}
+
+} // namespace vespalib
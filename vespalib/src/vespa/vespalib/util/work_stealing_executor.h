@@ -0,0 +1,128 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "threadexecutor.h"
+#include "runnable.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+class FastOS_ThreadPool;
+
+namespace vespalib {
+
+/**
+ * An executor service that executes tasks in multiple threads
+ * without a single lock protecting all tasks. Each worker thread has
+ * a lock-free inbox and a lock-free work-stealing deque. Tasks
+ * executed by external threads are pushed to the inbox of a worker
+ * selected round-robin by the executing thread, while tasks executed
+ * by one of the worker threads are pushed directly to the deque of
+ * that worker. Workers move tasks from their inbox to their deque,
+ * and workers without tasks of their own steal tasks from the other
+ * workers before going to sleep.
+ *
+ * Task limit, blocking when the task limit is reached, shutdown,
+ * sync and stats behave like in the ThreadStackExecutor and the
+ * BlockingThreadStackExecutor. Tasks are not guaranteed to be started
+ * in the order they were accepted.
+ **/
+class WorkStealingExecutor : public SyncableThreadExecutor,
+                             public Runnable
+{
+private:
+    struct Item;
+    struct Worker;
+    struct ThreadInit;
+
+    std::unique_ptr<FastOS_ThreadPool>   _pool;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<uint32_t>                _nextWorker;
+    std::atomic<uint32_t>                _taskCount;
+    std::atomic<uint32_t>                _taskLimit;
+    std::atomic<bool>                    _closed;
+    const bool                           _blocking;
+    std::atomic<uint32_t>                _numSleeping;
+    std::atomic<uint32_t>                _numWaiting;
+    std::atomic<uint64_t>                _syncEpoch;
+    std::atomic<size_t>                  _rejectedTasks;
+    std::mutex                           _lock;
+    std::condition_variable              _cond;
+    std::mutex                           _syncLock;
+    std::unique_ptr<ThreadInit>          _threadInit;
+    static thread_local WorkStealingExecutor *_master;
+    static thread_local Worker               *_self;
+
+    bool reserveTask();
+    void releaseTask();
+    void releasePending(std::atomic<uint32_t> &pending);
+    void notifyWaiting();
+    Worker &selectWorker();
+    bool wakeWorker(Worker &worker);
+    void wakeOneWorker(Worker &preferred);
+    void wakeAllWorkers();
+    void cancelSleep(Worker &worker);
+    bool done() const;
+    Item *findTask(Worker &worker);
+    Item *obtainTask(Worker &worker);
+    void completeTask(Item *item);
+
+    // Runnable (all workers live here)
+    void run() override;
+
+public:
+    /**
+     * Create a new work stealing executor. The task limit specifies
+     * the maximum number of tasks that are currently handled by this
+     * executor. Both the number of threads and the task limit must be
+     * greater than 0.
+     *
+     * @param threads number of worker threads (concurrent tasks)
+     * @param stackSize stack size per worker thread
+     * @param taskLimit upper limit on accepted tasks
+     * @param blocking block instead of rejecting tasks when the task
+     *                 limit is reached
+     **/
+    WorkStealingExecutor(uint32_t threads, uint32_t stackSize,
+                         uint32_t taskLimit = 0xffffffff, bool blocking = false);
+
+    // same as above, but enables you to specify a custom function
+    // used to wrap the main loop of all worker threads
+    WorkStealingExecutor(uint32_t threads, uint32_t stackSize, init_fun_t init_function,
+                         uint32_t taskLimit = 0xffffffff, bool blocking = false);
+    WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+    WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+    /**
+     * Will invoke shutdown then sync.
+     **/
+    ~WorkStealingExecutor() override;
+
+    Stats getStats() override;
+    Task::UP execute(Task::UP task) override;
+
+    /**
+     * Synchronize with this executor. This function will block until
+     * all previously accepted tasks have been executed.
+     *
+     * @return this object; for chaining
+     **/
+    WorkStealingExecutor &sync() override;
+
+    size_t getNumThreads() const override;
+    void setTaskLimit(uint32_t taskLimit) override;
+    uint32_t getTaskLimit() const override;
+    void wakeup() override;
+
+    /**
+     * Shut down this executor. This will make this executor reject
+     * all new tasks.
+     *
+     * @return this object; for chaining
+     **/
+    WorkStealingExecutor &shutdown() override;
+};
+
+} // namespace vespalib
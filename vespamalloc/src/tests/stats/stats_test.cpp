@@ -0,0 +1,107 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/gate.h>
+#include <cstring>
+#include <dlfcn.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using StatsFunc = void (*)(FILE *);
+using SampleIntervalFunc = void (*)(size_t);
+using TrimFunc = size_t (*)();
+
+std::string
+read_stats(StatsFunc stats)
+{
+    FILE * fp = tmpfile();
+    ASSERT_TRUE(fp != nullptr);
+    stats(fp);
+    std::string result;
+    rewind(fp);
+    char buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        result.append(buf, got);
+    }
+    fclose(fp);
+    return result;
+}
+
+size_t
+number_before(const std::string & text, const std::string & suffix)
+{
+    size_t end = text.find(suffix);
+    if (end == std::string::npos) {
+        return 0;
+    }
+    size_t begin = text.find_last_not_of("0123456789", end - 1) + 1;
+    return strtoul(text.substr(begin, end - begin).c_str(), nullptr, 10);
+}
+
+__attribute__((noinline)) void
+allocate_and_free(size_t count)
+{
+    std::vector<std::unique_ptr<char[]>> blocks;
+    blocks.reserve(count);
+    for (size_t i(0); i < count; i++) {
+        blocks.emplace_back(new char[100 + (i % 3000)]);
+    }
+}
+
+TEST("require that control functions are exported") {
+    EXPECT_TRUE(dlsym(RTLD_DEFAULT, "vespamalloc_stats") != nullptr);
+    EXPECT_TRUE(dlsym(RTLD_DEFAULT, "vespamalloc_set_sample_interval") != nullptr);
+}
+
+TEST("require that stats are summed over threads and allocations are sampled") {
+    auto stats = reinterpret_cast<StatsFunc>(dlsym(RTLD_DEFAULT, "vespamalloc_stats"));
+    auto set_sample_interval = reinterpret_cast<SampleIntervalFunc>(dlsym(RTLD_DEFAULT, "vespamalloc_set_sample_interval"));
+    ASSERT_TRUE((stats != nullptr) && (set_sample_interval != nullptr));
+    set_sample_interval(10);
+    std::vector<std::thread> threads;
+    for (size_t i(0); i < 4; i++) {
+        threads.emplace_back([]() { allocate_and_free(10000); });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    set_sample_interval(0);
+    std::string result = read_stats(stats);
+    EXPECT_TRUE(result.find("CacheHit(") != std::string::npos);
+    EXPECT_TRUE(result.find("Thread local caches hold") != std::string::npos);
+    EXPECT_TRUE(result.find("GlobalPool lock taken") != std::string::npos);
+    EXPECT_TRUE(result.find("Sampled every 10 allocation") != std::string::npos);
+    // each thread does at least 10000 allocations
+    EXPECT_LESS_EQUAL(4000u, number_before(result, " samples,"));
+    size_t site = result.find("Site  0: Samples(");
+    ASSERT_TRUE(site != std::string::npos);
+    size_t site_samples = strtoul(result.c_str() + site + strlen("Site  0: Samples("), nullptr, 10);
+    EXPECT_LESS(0u, site_samples);
+    EXPECT_LESS_EQUAL(site_samples, number_before(result, " samples,"));
+}
+
+TEST("require that thread caches of idle threads can be trimmed") {
+    auto trim_thread_caches = reinterpret_cast<TrimFunc>(dlsym(RTLD_DEFAULT, "vespamalloc_trim_thread_caches"));
+    auto trim_thread_cache = reinterpret_cast<TrimFunc>(dlsym(RTLD_DEFAULT, "vespamalloc_trim_thread_cache"));
+    ASSERT_TRUE((trim_thread_caches != nullptr) && (trim_thread_cache != nullptr));
+    vespalib::Gate allocated;
+    vespalib::Gate done;
+    std::thread idle([&]() {
+                         allocate_and_free(1000);
+                         allocated.countDown();
+                         done.await();
+                         allocate_and_free(1000);
+                     });
+    allocated.await();
+    EXPECT_LESS(0u, trim_thread_caches());
+    EXPECT_EQUAL(0u, trim_thread_caches());
+    done.countDown();
+    idle.join();
+    allocate_and_free(1000);
+    EXPECT_LESS(0u, trim_thread_cache());
+    EXPECT_EQUAL(0u, trim_thread_cache());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,146 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "allocsampler.h"
+#include <string.h>
+
+namespace vespamalloc {
+
+namespace {
+
+thread_local size_t _G_sampleCountDown TLS_LINKAGE = 0;
+// backtrace() may allocate the first time it is used.
+thread_local bool _G_inSample TLS_LINKAGE = false;
+
+size_t hashStack(const AllocSampler::Stack * stack, size_t depth)
+{
+    const char * p = reinterpret_cast<const char *>(stack);
+    size_t h(0);
+    for (size_t i(0); i < depth * sizeof(AllocSampler::Stack); i += sizeof(size_t)) {
+        size_t v;
+        memcpy(&v, p + i, sizeof(v));
+        h = (h ^ (v >> 4)) * 0x9e3779b97f4a7c15ul;
+    }
+    return h ^ (h >> 32);
+}
+
+}
+
+AllocSampler::AllocSampler() :
+    _interval(0),
+    _lock(),
+    _numSamples(0),
+    _numDropped(0),
+    _sampledInterval(0),
+    _sites()
+{
+    _lock.clear();
+}
+
+void AllocSampler::setInterval(size_t interval)
+{
+    if ((interval != 0) && (interval != getInterval())) {
+        lock();
+        clear();
+        _sampledInterval = interval;
+        unlock();
+    }
+    _interval.store(interval, std::memory_order_relaxed);
+}
+
+void AllocSampler::clear()
+{
+    for (Site & site : _sites) {
+        site = Site();
+    }
+    _numSamples = 0;
+    _numDropped = 0;
+}
+
+void AllocSampler::sampleSlow(size_t sz)
+{
+    if (_G_sampleCountDown != 0) {
+        _G_sampleCountDown--;
+        return;
+    }
+    const size_t interval(getInterval());
+    if ((interval == 0) || _G_inSample) {
+        // Sampling may have been turned off since the caller checked.
+        return;
+    }
+    _G_inSample = true;
+    _G_sampleCountDown = interval - 1;
+    Stack stack[STACK_DEPTH];
+    Stack::fillStack(stack, STACK_DEPTH);
+    record(stack, sz);
+    _G_inSample = false;
+}
+
+void AllocSampler::record(const Stack * stack, size_t sz)
+{
+    const size_t mask(NUM_SITES - 1);
+    const size_t maxProbes(16);
+    size_t index(hashStack(stack, STACK_DEPTH) & mask);
+    lock();
+    _numSamples++;
+    bool found(false);
+    for (size_t probe(0); !found && (probe < maxProbes); probe++, index = (index + 1) & mask) {
+        Site & site = _sites[index];
+        bool empty(site._count == 0);
+        if (empty || (memcmp(site._stack, stack, sizeof(site._stack)) == 0)) {
+            if (empty) {
+                memcpy(site._stack, stack, sizeof(site._stack));
+            }
+            site._count++;
+            site._bytes += sz;
+            found = true;
+        }
+    }
+    if ( ! found) {
+        _numDropped++;
+    }
+    unlock();
+}
+
+void AllocSampler::info(FILE * os, size_t numSites)
+{
+    if ((getInterval() == 0) && (_numSamples == 0)) {
+        return;
+    }
+    if ( ! tryLock()) {
+        fprintf(os, "Allocation samples are being updated, try again.\n");
+        return;
+    }
+    const size_t interval(_sampledInterval);
+    fprintf(os, "Sampled every %ld allocation in each thread. %ld samples, %ld not accounted to a call stack.\n",
+            interval, _numSamples, _numDropped);
+    // Selects the sites in order of decreasing bytes without any extra memory, as we are the allocator.
+    size_t prevBytes(size_t(-1));
+    size_t prevIndex(NUM_SITES);
+    for (size_t n(0); n < numSites; n++) {
+        size_t best(NUM_SITES);
+        for (size_t i(0); i < NUM_SITES; i++) {
+            const Site & site = _sites[i];
+            bool belowPrev((site._bytes < prevBytes) || ((site._bytes == prevBytes) && (i > prevIndex)));
+            if ((site._count != 0) && belowPrev &&
+                ((best == NUM_SITES) || (site._bytes > _sites[best]._bytes)))
+            {
+                best = i;
+            }
+        }
+        if (best == NUM_SITES) {
+            break;
+        }
+        const Site & site = _sites[best];
+        fprintf(os, "Site %2ld: Samples(%8ld) Bytes(%12ld) EstimatedAllocs(%12ld) EstimatedBytes(%14ld):",
+                n, site._count, site._bytes, site._count * interval, site._bytes * interval);
+        for (size_t i(0); (i < STACK_DEPTH) && site._stack[i].valid(); i++) {
+            fprintf(os, " ");
+            site._stack[i].info(os);
+        }
+        fprintf(os, "\n");
+        prevBytes = site._bytes;
+        prevIndex = best;
+    }
+    unlock();
+}
+
+}
@@ -0,0 +1,67 @@
+// Copyright Verizon Media. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespamalloc/malloc/common.h>
+#include <vespamalloc/util/callstack.h>
+#include <atomic>
+#include <stdio.h>
+
+namespace vespamalloc {
+
+/**
+ * Samples every N'th allocation done by each thread and accounts it to
+ * the call stack doing the allocation. This makes it possible to find
+ * allocation hot spots with the production allocator, without switching
+ * to one of the debug versions recording a stack for every block.
+ *
+ * Sampling is off (interval 0) by default, and then the cost is a single
+ * load and branch per allocation. The number of distinct call stacks is
+ * fixed; samples not fitting in the table are only counted.
+ */
+class AllocSampler
+{
+public:
+    using Stack = StackEntry<StackReturnEntry>;
+    static constexpr size_t STACK_DEPTH = 8;
+    static constexpr size_t NUM_SITES = 0x800;
+
+    AllocSampler();
+    /**
+     * Sample every interval'th allocation in each thread, 0 turns sampling off.
+     * Changing to a new non-zero interval discards the samples taken so far.
+     */
+    void setInterval(size_t interval);
+    size_t getInterval() const { return _interval.load(std::memory_order_relaxed); }
+    void sample(size_t sz) {
+        if (__builtin_expect(getInterval() != 0, false)) {
+            sampleSlow(sz);
+        }
+    }
+    /**
+     * Prints the numSites call stacks having allocated the most bytes.
+     */
+    void info(FILE * os, size_t numSites);
+private:
+    struct Site {
+        Stack  _stack[STACK_DEPTH];
+        size_t _count;
+        size_t _bytes;
+    };
+    AllocSampler(const AllocSampler &);
+    AllocSampler & operator = (const AllocSampler &);
+    void sampleSlow(size_t sz) __attribute__((noinline));
+    void record(const Stack * stack, size_t sz);
+    void clear();
+    bool tryLock() { return ! _lock.test_and_set(std::memory_order_acquire); }
+    void lock()    { while ( ! tryLock()) { } }
+    void unlock()  { _lock.clear(std::memory_order_release); }
+
+    std::atomic<size_t> _interval;
+    std::atomic_flag    _lock;
+    size_t              _numSamples;
+    size_t              _numDropped;
+    size_t              _sampledInterval;
+    Site                _sites[NUM_SITES];
+};
+
+}
@@ -1,6 +1,11 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "common.h"
 #include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/membarrier.h>
+#endif
 
 namespace vespamalloc {
 
@@ -10,7 +15,11 @@ bool     Mutex::_stopRecursion = true;
 void Mutex::lock()
 {
     if (_use) {
-        pthread_mutex_lock(&_mutex);
+        if (pthread_mutex_trylock(&_mutex) != 0) {
+            pthread_mutex_lock(&_mutex);
+            _contendedCount++;
+        }
+        _lockCount++;
     }
 }
 void Mutex::unlock()
@@ -35,6 +44,29 @@ void Mutex::init() {
     }
 }
 
+bool registerAsymmetricFence()
+{
+#if defined(__linux__) && defined(SYS_membarrier)
+    // Registering more than once is harmless, so racing threads may all do it.
+    static std::atomic<int> registered(-1);
+    int result = registered.load(std::memory_order_relaxed);
+    if (result < 0) {
+        result = (syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0) ? 1 : 0;
+        registered.store(result, std::memory_order_relaxed);
+    }
+    return (result == 1);
+#else
+    return false;
+#endif
+}
+
+void asymmetricFence()
+{
+#if defined(__linux__) && defined(SYS_membarrier)
+    syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+#endif
+}
+
 Guard::Guard(Mutex & m) :
      _mutex(&m)
 {
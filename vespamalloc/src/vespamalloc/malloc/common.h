@@ -11,6 +11,12 @@ namespace vespamalloc {
 
 #define VESPA_DLL_EXPORT __attribute__ ((visibility("default")))
 
+#ifdef __PIC__
+    #define TLS_LINKAGE __attribute__((visibility("hidden"), tls_model("initial-exec")))
+#else
+    #define TLS_LINKAGE __attribute__((visibility("hidden"), tls_model("local-exec")))
+#endif
+
 #define NELEMS(a) sizeof(a)/sizeof(a[0])
 
 #define NUM_SIZE_CLASSES 32   // Max 64G
@@ -84,7 +90,7 @@ inline void swap(T & a, T & b)      { T tmp(a); a = b; b = tmp; }
 class Mutex
 {
 public:
-    Mutex() : _mutex(), _use(false) { }
+    Mutex() : _mutex(), _use(false), _lockCount(0), _contendedCount(0) { }
     ~Mutex()           { quit(); }
     void lock();
     void unlock();
@@ -94,6 +100,12 @@ public:
     static void allowRecursion() { _stopRecursion = false; }
     void init();
     void quit();
+    /**
+     * Number of times the lock has been taken, and how many of those
+     * had to wait for another thread. Only updated while holding the lock.
+     */
+    size_t lockCount()      const { return _lockCount; }
+    size_t contendedCount() const { return _contendedCount; }
 private:
     static std::atomic<uint32_t> _threadCount;
     static bool     _stopRecursion;
@@ -101,8 +113,19 @@ private:
     Mutex & operator = (const Mutex & org);
     pthread_mutex_t  _mutex;
     bool             _use;
+    size_t           _lockCount;
+    size_t           _contendedCount;
 };
 
+/**
+ * Makes all other running threads of the process execute a full memory
+ * barrier (membarrier(2)). Lets the allocator fast path get away with
+ * compiler barriers where it must be ordered against a rare operation
+ * done by another thread. Returns false if not supported by the kernel.
+ */
+bool registerAsymmetricFence();
+void asymmetricFence();
+
 class Guard
 {
 public:
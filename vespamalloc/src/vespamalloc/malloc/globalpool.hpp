@@ -260,6 +260,8 @@ void AllocPoolT<MemBlockPtrT>::info(FILE * os, size_t level)
     if (level > 0) {
         fprintf(os, "GlobalPool getChunks(%ld, %ld) allocChunksList(%ld):\n",
                 _getChunks.load(), _getChunksSum.load(), _allocChunkList.load());
+        fprintf(os, "GlobalPool lock taken %ld times, %ld of them contended.\n",
+                _mutex.lockCount(), _mutex.contendedCount());
         for (size_t i = 0; i < NELEMS(_stat); i++) {
             const Stat & s = _stat[i];
             if (s.isUsed()) {
@@ -7,7 +7,7 @@
 
 namespace vespamalloc {
 
-typedef ThreadListT<MemBlock, NoStat> ThreadList;
+typedef ThreadListT<MemBlock, Stat> ThreadList;
 typedef MemoryWatcher<MemBlock, ThreadList> Allocator;
 
 static char _Gmem[sizeof(Allocator)];
@@ -8,6 +8,7 @@
 #include "threadpool.h"
 #include "threadlist.h"
 #include "threadproxy.h"
+#include "allocsampler.h"
 
 namespace vespamalloc {
 
@@ -49,6 +50,19 @@ public:
     }
 
     void info(FILE * os, size_t level=0) __attribute__ ((noinline));
+    /**
+     * Prints allocation statistics summed over all threads, global pool
+     * lock contention and the sampled allocation call stacks, if any.
+     */
+    void stats(FILE * os) __attribute__ ((noinline));
+    void setupSampling(size_t interval, size_t sitesToShow) {
+        _sampler.setInterval(interval);
+        _samplesToShow = sitesToShow;
+    }
+    void setSampleInterval(size_t interval) { _sampler.setInterval(interval); }
+    void setIdleTrimInterval(size_t trimInterval) { ThreadListT::setIdleTrimInterval(trimInterval); }
+    size_t trimThreadCaches()                     { return _threadList.trimThreadCaches(false); }
+    size_t trimThisThread()                       { return _threadList.trimThisThread(); }
 
     void setupSegmentLog(size_t noMemLogLevel,
                          size_t bigMemLogLevel,
@@ -75,9 +89,11 @@ private:
     size_t                     _doubleDeleteLogLevel;
     size_t                     _invalidMemLogLevel;
     size_t                     _prAllocLimit;
+    size_t                     _samplesToShow;
     DataSegment<MemBlockPtrT>  _segment;
     AllocPool                  _allocPool;
     ThreadListT                _threadList;
+    AllocSampler               _sampler;
 };
 
 template <typename MemBlockPtrT, typename ThreadListT>
@@ -86,9 +102,11 @@ MemoryManager<MemBlockPtrT, ThreadListT>::MemoryManager(size_t logLimitAtStart)
     _doubleDeleteLogLevel(1),
     _invalidMemLogLevel(1),
     _prAllocLimit(logLimitAtStart),
+    _samplesToShow(32),
     _segment(),
     _allocPool(_segment),
-    _threadList(_allocPool)
+    _threadList(_allocPool),
+    _sampler()
 {
     setAllocatorForThreads(this);
     initThisThread();
@@ -152,6 +170,16 @@ void MemoryManager<MemBlockPtrT, ThreadListT>::info(FILE * os, size_t level)
     _segment.info(os, level);
     _allocPool.info(os, level);
     _threadList.info(os, level);
+    _sampler.info(os, _samplesToShow);
+    fflush(os);
+}
+
+template <typename MemBlockPtrT, typename ThreadListT>
+void MemoryManager<MemBlockPtrT, ThreadListT>::stats(FILE * os)
+{
+    _threadList.stats(os);
+    _allocPool.info(os, 1);
+    _sampler.info(os, _samplesToShow);
     fflush(os);
 }
 
@@ -167,6 +195,7 @@ void * MemoryManager<MemBlockPtrT, ThreadListT>::malloc(size_t sz)
     }
     mem.setExact(sz);
     mem.alloc(_prAllocLimit<=mem.adjustSize(sz));
+    _sampler.sample(sz);
     return mem.ptr();
 }
 
@@ -182,6 +211,7 @@ void * MemoryManager<MemBlockPtrT, ThreadListT>::malloc(size_t sz, std::align_va
     }
     mem.setExact(sz, alignment);
     mem.alloc(_prAllocLimit<=mem.adjustSize(sz, alignment));
+    _sampler.sample(sz);
     return mem.ptr();
 }
 
@@ -50,6 +50,8 @@ public:
     static void bigBlockLimit(size_t lim);
     static void setFill(uint8_t ) { }
     static bool verifySizeClass(int sc) { (void) sc; return true; }
+    // Blocks carry no thread id or call stack to dump.
+    static constexpr bool hasAllocInfo() { return false; }
     static size_t getMinSizeForAlignment(size_t align, size_t sz) {
         return (sz < Parent::MAX_ALIGN)
                    ? std::max(sz, align)
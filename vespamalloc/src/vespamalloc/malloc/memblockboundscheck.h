@@ -36,6 +36,7 @@ public:
     static void dumpFile(FILE * fp)       { _logFile = fp; }
     static void setFill(uint8_t pattern)  { _fillValue = pattern; }
     static bool verifySizeClass(int sc)   { return sc >= 0; }
+    static constexpr bool hasAllocInfo() { return true; }
 
     template<typename T>
     void readjustAlignment(const T & segment) {
@@ -70,6 +70,9 @@ private:
             bigblocklimit,
             fillvalue,
             dumpsignal,
+            allocsample_interval,
+            allocsample_show,
+            threadcache_trim_interval,
             numberofentries  // Must be the last one
         };
         Params() __attribute__ ((noinline));
@@ -135,6 +138,9 @@ MemoryWatcher<T, S>::Params::Params()
     _params[          bigblocklimit] = NameValuePair("bigblocklimit", "0x80000000"); // 8M
     _params[              fillvalue] = NameValuePair("fillvalue", "0xa8"); // Means NO fill.
     _params[             dumpsignal] = NameValuePair("dumpsignal", "27"); // SIGPROF
+    _params[   allocsample_interval] = NameValuePair("allocsample_interval", "0"); // Means NO sampling.
+    _params[       allocsample_show] = NameValuePair("allocsample_show", "32");
+    _params[threadcache_trim_interval] = NameValuePair("threadcache_trim_interval", "0"); // ms. Means NO trimming.
 }
 
 template <typename T, typename S>
@@ -219,6 +225,9 @@ void MemoryWatcher<T, S>::activateOptions()
                     _params[Params::threadcachelimit].valueAsLong());
     T::bigBlockLimit(_params[Params::bigblocklimit].valueAsLong());
     T::setFill(_params[Params::fillvalue].valueAsLong());
+    this->setupSampling(_params[Params::allocsample_interval].valueAsLong(),
+                        _params[Params::allocsample_show].valueAsLong());
+    this->setIdleTrimInterval(_params[Params::threadcache_trim_interval].valueAsLong());
 
 }
 
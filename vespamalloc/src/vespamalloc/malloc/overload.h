@@ -162,6 +162,39 @@ void free(void * ptr) {
     if (ptr) { vespamalloc::_GmemP->free(ptr); }
 }
 
+/*
+ * Control functions to find allocation hot spots in a running process,
+ * to be looked up with dlsym as the allocator is usually preloaded.
+ */
+void vespamalloc_stats(FILE * os) VESPA_DLL_EXPORT;
+void vespamalloc_stats(FILE * os)
+{
+    vespamalloc::createAllocator()->stats(os ? os : stderr);
+}
+
+void vespamalloc_set_sample_interval(size_t interval) VESPA_DLL_EXPORT;
+void vespamalloc_set_sample_interval(size_t interval)
+{
+    vespamalloc::createAllocator()->setSampleInterval(interval);
+}
+
+/*
+ * Returns the blocks cached by the calling thread, or by all threads, to
+ * the global pool where other threads can reuse them. Returns the number
+ * of bytes trimmed. A thread about to become idle for a while should trim itself.
+ */
+size_t vespamalloc_trim_thread_cache() VESPA_DLL_EXPORT;
+size_t vespamalloc_trim_thread_cache()
+{
+    return vespamalloc::createAllocator()->trimThisThread();
+}
+
+size_t vespamalloc_trim_thread_caches() VESPA_DLL_EXPORT;
+size_t vespamalloc_trim_thread_caches()
+{
+    return vespamalloc::createAllocator()->trimThreadCaches();
+}
+
 #define ALIAS(x) __attribute__ ((weak, alias (x), visibility ("default")))
 #ifdef __clang__
 void* __libc_malloc(size_t sz)                       __THROW __attribute__((malloc, alloc_size(1))) ALIAS("malloc");
@@ -5,6 +5,6 @@
 
 namespace vespamalloc {
 
-template class ThreadListT<MemBlock, NoStat>;
+template class ThreadListT<MemBlock, Stat>;
 
 }
@@ -5,12 +5,6 @@
 
 namespace vespamalloc {
 
-#ifdef __PIC__
-    #define TLS_LINKAGE __attribute__((visibility("hidden"), tls_model("initial-exec")))
-#else
-    #define TLS_LINKAGE __attribute__((visibility("hidden"), tls_model("local-exec")))
-#endif
-
 template <typename MemBlockPtrT, typename ThreadStatT>
 class ThreadListT
 {
@@ -22,6 +16,23 @@ public:
     void setParams(size_t alwayReuseLimit, size_t threadCacheLimit) {
         ThreadPool::setParams(alwayReuseLimit, threadCacheLimit);
     }
+    /**
+     * Thread local caches of threads that have done no malloc/free for
+     * trimInterval milliseconds are returned to the global pool. Checked
+     * when some thread refills its cache. 0 turns it off.
+     */
+    static void setIdleTrimInterval(size_t trimInterval) { _idleTrimInterval = trimInterval; }
+    void trimIdleIfDue() {
+        if (__builtin_expect(_idleTrimInterval != 0, false)) {
+            trimIdle();
+        }
+    }
+    /**
+     * Returns the thread local caches of all threads, or only those idle
+     * since last time, to the global pool. Returns the number of bytes trimmed.
+     */
+    size_t trimThreadCaches(bool onlyIdle);
+    size_t trimThisThread();
     bool quitThisThread();
     bool initThisThread();
     ThreadPool & getCurrent()  { return *_myPool; }
@@ -31,19 +42,33 @@ public:
     }
 
     void info(FILE * os, size_t level=0);
+    /**
+     * Prints per size class alloc/free counts summed over all threads,
+     * the hit rate of the thread local caches, and how many bytes are
+     * currently held in them. Nothing is printed without thread statistics.
+     */
+    void stats(FILE * os);
     size_t getMaxNumThreads() const { return NELEMS(_threadVector); }
 private:
     ThreadListT(const ThreadListT & tl);
     ThreadListT & operator = (const ThreadListT & tl);
+    void trimIdle() __attribute__((noinline));
     std::atomic_flag           _isThreaded;
     std::atomic<uint32_t>      _threadCount;
     std::atomic<uint32_t>      _threadCountAccum;
+    std::atomic_flag           _trimming;
+    std::atomic<uint64_t>      _nextIdleTrim;
+    std::atomic<size_t>        _numTrims;
+    std::atomic<size_t>        _trimmedBytes;
     ThreadPool                 _threadVector[NUM_THREADS];
     AllocPoolT<MemBlockPtrT> & _allocPool;
     static thread_local ThreadPool * _myPool TLS_LINKAGE;
+    static size_t _idleTrimInterval __attribute__((visibility("hidden")));
 };
 
 template <typename MemBlockPtrT, typename ThreadStatT>
 thread_local ThreadPoolT<MemBlockPtrT, ThreadStatT> * ThreadListT<MemBlockPtrT, ThreadStatT>::_myPool TLS_LINKAGE = nullptr;
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadListT<MemBlockPtrT, ThreadStatT>::_idleTrimInterval __attribute__((visibility("hidden"))) = 0;
 
 }
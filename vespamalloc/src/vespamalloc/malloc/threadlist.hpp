@@ -2,6 +2,7 @@
 #pragma once
 
 #include "threadlist.h"
+#include <time.h>
 
 namespace vespamalloc {
 
@@ -10,10 +11,15 @@ ThreadListT<MemBlockPtrT, ThreadStatT>::ThreadListT(AllocPool & pool) :
     _isThreaded(false),
     _threadCount(0),
     _threadCountAccum(0),
+    _trimming(),
+    _nextIdleTrim(0),
+    _numTrims(0),
+    _trimmedBytes(0),
     _allocPool(pool)
 {
+    _trimming.clear();
     for (size_t i = 0; i < getMaxNumThreads(); i++) {
-        _threadVector[i].setPool(_allocPool);
+        _threadVector[i].setPool(_allocPool, *this);
     }
 }
 
@@ -34,7 +40,10 @@ void ThreadListT<MemBlockPtrT, ThreadStatT>::info(FILE * os, size_t level)
     }
     fprintf(os, "#%ld active threads. Peak threads #%ld. %u threads created in total.\n",
             activeThreads, peakThreads, _threadCountAccum.load());
-    if ((level > 1) && ! ThreadStatT::isDummy()) {
+    if (level > 0) {
+        stats(os);
+    }
+    if ((level > 1) && ! ThreadStatT::isDummy() && MemBlockPtrT::hasAllocInfo()) {
         for (SizeClassT sc(0); sc < NUM_SIZE_CLASSES; sc++) {
             _allocPool.dataSegment().infoThread(os, level, 0, sc, _threadCountAccum.load() + 1);
         }
@@ -52,10 +61,105 @@ void ThreadListT<MemBlockPtrT, ThreadStatT>::info(FILE * os, size_t level)
     }
 }
 
+template <typename MemBlockPtrT, typename ThreadStatT>
+void ThreadListT<MemBlockPtrT, ThreadStatT>::stats(FILE * os)
+{
+    if (ThreadStatT::isDummy()) {
+        return;
+    }
+    // Slots are reused by new threads, so the counters of threads that have quit are still there.
+    const size_t numSlots(std::min(size_t(_threadCountAccum.load()), getMaxNumThreads()));
+    size_t totalCached(0);
+    for (SizeClassT sc(0); sc < NUM_SIZE_CLASSES; sc++) {
+        size_t alloc(0), free(0), refill(0), flush(0), cached(0);
+        for (size_t i(0); i < numSlots; i++) {
+            const ThreadPool & thread = _threadVector[i];
+            const ThreadStatT & s = thread.stat(sc);
+            alloc += s.alloc();
+            free += s.free();
+            refill += s.exchangeAlloc() + s.exactAlloc();
+            flush += s.exchangeFree() + s.returnFree();
+            if (thread.isActive()) {
+                cached += thread.cachedCount(sc);
+            }
+        }
+        if (alloc || free) {
+            const size_t cs(MemBlockPtrT::classSize(sc));
+            double hitRate = (alloc > refill) ? (100.0 * (alloc - refill)) / alloc : 0.0;
+            fprintf(os, "SC %2d(%10ld) Alloc(%12ld) Free(%12ld) CacheHit(%6.2f%%) "
+                    "Refill(%10ld) Flush(%10ld) Cached(%6ld = %10ld bytes)\n",
+                    sc, cs, alloc, free, hitRate, refill, flush, cached, cached * cs);
+            totalCached += cached * cs;
+        }
+    }
+    fprintf(os, "Thread local caches hold %ld bytes in total. Trimmed %ld bytes, %ld trims of all threads.\n",
+            totalCached, _trimmedBytes.load(), _numTrims.load());
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+void ThreadListT<MemBlockPtrT, ThreadStatT>::trimIdle()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    uint64_t now = uint64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+    uint64_t next = _nextIdleTrim.load(std::memory_order_relaxed);
+    if ((now >= next) && _nextIdleTrim.compare_exchange_strong(next, now + _idleTrimInterval)) {
+        trimThreadCaches(true);
+    }
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadListT<MemBlockPtrT, ThreadStatT>::trimThreadCaches(bool onlyIdle)
+{
+    if (_trimming.test_and_set(std::memory_order_acquire)) {
+        return 0;
+    }
+    ThreadPool * self = _myPool;
+    const size_t numSlots(std::min(size_t(_threadCountAccum.load()), getMaxNumThreads()));
+    size_t trimmed(0);
+    if (registerAsymmetricFence()) {
+        size_t numRequested(0);
+        for (size_t i(0); i < numSlots; i++) {
+            ThreadPool & tp = _threadVector[i];
+            bool candidate = onlyIdle ? tp.idleSinceLastCheck() : true;
+            if ((&tp != self) && candidate && (tp.cachedBytes() > 0)) {
+                tp.requestTrim();
+                numRequested++;
+            }
+        }
+        if (numRequested > 0) {
+            asymmetricFence();
+            for (size_t i(0); i < numSlots; i++) {
+                ThreadPool & tp = _threadVector[i];
+                if (tp.trimRequested()) {
+                    trimmed += tp.trimRequestedIfUnused();
+                    tp.doneTrim();
+                }
+            }
+        }
+    }
+    if ( ! onlyIdle && (self != nullptr)) {
+        trimmed += self->trimLocal();
+    }
+    _numTrims.fetch_add(1, std::memory_order_relaxed);
+    _trimmedBytes.fetch_add(trimmed, std::memory_order_relaxed);
+    _trimming.clear(std::memory_order_release);
+    return trimmed;
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadListT<MemBlockPtrT, ThreadStatT>::trimThisThread()
+{
+    size_t trimmed = getCurrent().trimLocal();
+    _trimmedBytes.fetch_add(trimmed, std::memory_order_relaxed);
+    return trimmed;
+}
+
 template <typename MemBlockPtrT, typename ThreadStatT>
 bool ThreadListT<MemBlockPtrT, ThreadStatT>::quitThisThread()
 {
     ThreadPool & tp = getCurrent();
+    _trimmedBytes.fetch_add(tp.trimLocal(), std::memory_order_relaxed);
     tp.quit();
     _threadCount.fetch_sub(1);
     return true;
@@ -5,6 +5,6 @@
 
 namespace vespamalloc {
 
-template class ThreadPoolT<MemBlock, NoStat>;
+template class ThreadPoolT<MemBlock, Stat>;
 
 }
@@ -8,16 +8,20 @@
 
 namespace vespamalloc {
 
+template <typename MemBlockPtrT, typename ThreadStatT> class ThreadListT;
+
 template <typename MemBlockPtrT, typename ThreadStatT >
 class ThreadPoolT
 {
 public:
     typedef AFList<MemBlockPtrT> ChunkSList;
     typedef AllocPoolT<MemBlockPtrT> AllocPool;
+    typedef ThreadListT<MemBlockPtrT, ThreadStatT> ThreadList;
     ThreadPoolT();
     ~ThreadPoolT();
-    void setPool(AllocPool & pool) {
+    void setPool(AllocPool & pool, ThreadList & threadList) {
         _allocPool = & pool;
+        _threadList = & threadList;
     }
     void malloc(size_t sz, MemBlockPtrT & mem);
     void free(MemBlockPtrT mem, SizeClassT sc);
@@ -33,6 +37,35 @@ public:
      * @return true if this represents an active used thread.
      */
     bool isUsed() const;
+    const ThreadStatT & stat(SizeClassT sc) const { return _stat[sc]; }
+    /**
+     * Number of free blocks of the given size class held in this thread's local cache.
+     */
+    size_t cachedCount(SizeClassT sc) const;
+    /**
+     * Returns all blocks in the thread local cache to the global pool, and
+     * the number of bytes returned. Must be called by the owning thread.
+     */
+    size_t trimLocal();
+    /**
+     * Used by another thread to trim this thread local cache. The owner
+     * announces that it is using the cache with compiler barriers only,
+     * so after requesting a trim the trimmer must do an asymmetricFence()
+     * before checking whether the cache may be trimmed. The owner waits
+     * in its next malloc/free until the request is done.
+     */
+    void requestTrim()     { _trimRequested.store(true, std::memory_order_relaxed); }
+    bool trimRequested() const { return _trimRequested.load(std::memory_order_relaxed); }
+    size_t trimRequestedIfUnused() {
+        return (_useCount.load(std::memory_order_acquire) == 0) ? trim() : 0;
+    }
+    void doneTrim()        { _trimRequested.store(false, std::memory_order_release); }
+    /**
+     * Tells if there has been no malloc/free since last time asked.
+     * Only to be used by the single thread trimming idle caches.
+     */
+    bool idleSinceLastCheck();
+    size_t cachedBytes() const;
     int osThreadId()       const { return _osThreadId; }
     uint32_t threadId()    const { return _threadId; }
     void quit() { _osThreadId = 0; } // Implicit memory barrier
@@ -61,14 +94,33 @@ private:
         ChunkSList *_allocFrom;
         ChunkSList *_freeTo;
     };
+    void enter() {
+        _useCount.store(_useCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_seq_cst); // Paired with asymmetricFence() in the trimmer
+        // acquire pairs with doneTrim(), also when the trim completed before we got here
+        if (__builtin_expect(_trimRequested.load(std::memory_order_acquire), false)) {
+            waitForTrim();
+        }
+    }
+    void leave() {
+        _useCount.store(_useCount.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    }
+    void waitForTrim() __attribute__ ((noinline));
+    size_t trim();
+    size_t numOps() const;
+    ChunkSList * giveBack(SizeClassT sc, ChunkSList * csl);
     void mallocHelper(size_t exactSize, SizeClassT sc, AllocFree & af, MemBlockPtrT & mem) __attribute__ ((noinline));
     bool alwaysReuse(SizeClassT sc) { return sc > _alwaysReuseSCLimit; }
 
     AllocPool   * _allocPool;
+    ThreadList  * _threadList;
     AllocFree     _memList[NUM_SIZE_CLASSES];
     ThreadStatT   _stat[NUM_SIZE_CLASSES];
     uint32_t      _threadId;
     std::atomic<ssize_t> _osThreadId;
+    std::atomic<uint32_t> _useCount;
+    std::atomic<bool>     _trimRequested;
+    size_t        _opsAtLastCheck;
 
     static SizeClassT _alwaysReuseSCLimit __attribute__((visibility("hidden")));
     static size_t     _threadCacheLimit __attribute__((visibility("hidden")));
@@ -2,6 +2,8 @@
 #pragma once
 
 #include <vespamalloc/malloc/threadpool.h>
+#include <vespamalloc/malloc/threadlist.h>
+#include <sched.h>
 
 namespace vespamalloc {
 
@@ -15,10 +17,8 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::info(FILE * os, size_t level, const
     if (level > 0) {
         for (size_t i=0; i < NELEMS(_stat); i++) {
             const ThreadStatT & s = _stat[i];
-            const AllocFree & af = _memList[i];
             if (s.isUsed()) {
-                size_t localAvailCount((af._freeTo ? af._freeTo->count() : 0)
-                                       + (af._allocFrom ? af._allocFrom->count() : 0));
+                size_t localAvailCount(cachedCount(i));
                 fprintf(os, "SC %2ld(%10ld) Local(%3ld) Alloc(%10ld), "
                         "Free(%10ld) ExchangeAlloc(%8ld), ExChangeFree(%8ld) "
                         "Returned(%8ld) ExactAlloc(%8ld)\n",
@@ -28,7 +28,7 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::info(FILE * os, size_t level, const
             }
         }
     }
-    if (level > 2) {
+    if ((level > 2) && MemBlockPtrT::hasAllocInfo()) {
         fprintf(os, "BlockList:%ld,%ld,%ld\n", NELEMS(_stat), sizeof(_stat), sizeof(_stat[0]));
         size_t sum(0), sumLocal(0);
         for (size_t i=0; i < NELEMS(_stat); i++) {
@@ -36,9 +36,7 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::info(FILE * os, size_t level, const
             if (s.isUsed()) {
                 fprintf(os, "Allocated Blocks SC %2ld(%10ld): ", i, MemBlockPtrT::classSize(i));
                 size_t allocCount = ds.infoThread(os, level, threadId(), i);
-                const AllocFree & af = _memList[i];
-                size_t localAvailCount((af._freeTo ? af._freeTo->count() : 0)
-                                       + (af._allocFrom ? af._allocFrom->count() : 0));
+                size_t localAvailCount(cachedCount(i));
                 sum += allocCount*MemBlockPtrT::classSize(i);
                 sumLocal += localAvailCount*MemBlockPtrT::classSize(i);
                 fprintf(os, " Total used(%ld + %ld = %ld(%ld)).\n",
@@ -50,6 +48,84 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::info(FILE * os, size_t level, const
     }
 }
 
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadPoolT<MemBlockPtrT, ThreadStatT>::cachedCount(SizeClassT sc) const {
+    const AllocFree & af = _memList[sc];
+    return (af._freeTo ? af._freeTo->count() : 0) + (af._allocFrom ? af._allocFrom->count() : 0);
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadPoolT<MemBlockPtrT, ThreadStatT>::cachedBytes() const {
+    size_t sum(0);
+    for (SizeClassT sc(0); sc < NUM_SIZE_CLASSES; sc++) {
+        sum += cachedCount(sc) * MemBlockPtrT::classSize(sc);
+    }
+    return sum;
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadPoolT<MemBlockPtrT, ThreadStatT>::numOps() const {
+    size_t sum(0);
+    for (SizeClassT sc(0); sc < NUM_SIZE_CLASSES; sc++) {
+        sum += _stat[sc].alloc() + _stat[sc].free();
+    }
+    return sum;
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+bool ThreadPoolT<MemBlockPtrT, ThreadStatT>::idleSinceLastCheck() {
+    size_t ops(numOps());
+    bool idle(ops == _opsAtLastCheck);
+    _opsAtLastCheck = ops;
+    return idle;
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+typename ThreadPoolT<MemBlockPtrT, ThreadStatT>::ChunkSList *
+ThreadPoolT<MemBlockPtrT, ThreadStatT>::giveBack(SizeClassT sc, ChunkSList * csl)
+{
+    return alwaysReuse(sc)
+           ? _allocPool->returnMemory(sc, csl)
+           : _allocPool->exchangeFree(sc, csl);
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadPoolT<MemBlockPtrT, ThreadStatT>::trim()
+{
+    size_t trimmed(0);
+    for (SizeClassT sc(0); sc < NUM_SIZE_CLASSES; sc++) {
+        AllocFree & af = _memList[sc];
+        if (af._allocFrom == nullptr) {
+            continue;
+        }
+        trimmed += cachedCount(sc) * MemBlockPtrT::classSize(sc);
+        if ( ! af._freeTo->empty()) {
+            af._freeTo = giveBack(sc, af._freeTo);
+        }
+        if ( ! af._allocFrom->empty()) {
+            af._allocFrom = giveBack(sc, af._allocFrom);
+        }
+    }
+    return trimmed;
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+size_t ThreadPoolT<MemBlockPtrT, ThreadStatT>::trimLocal()
+{
+    enter();
+    size_t trimmed = trim();
+    leave();
+    return trimmed;
+}
+
+template <typename MemBlockPtrT, typename ThreadStatT>
+void ThreadPoolT<MemBlockPtrT, ThreadStatT>::waitForTrim()
+{
+    while (_trimRequested.load(std::memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
 template <typename MemBlockPtrT, typename ThreadStatT >
 void ThreadPoolT<MemBlockPtrT, ThreadStatT>::
 mallocHelper(size_t exactSize,
@@ -82,13 +158,18 @@ mallocHelper(size_t exactSize,
             }
         }
     }
+    _threadList->trimIdleIfDue();
 }
 
 template <typename MemBlockPtrT, typename ThreadStatT >
 ThreadPoolT<MemBlockPtrT, ThreadStatT>::ThreadPoolT() :
     _allocPool(nullptr),
+    _threadList(nullptr),
     _threadId(0),
-    _osThreadId(0)
+    _osThreadId(0),
+    _useCount(0),
+    _trimRequested(false),
+    _opsAtLastCheck(0)
 {
 }
 
@@ -100,6 +181,7 @@ ThreadPoolT<MemBlockPtrT, ThreadStatT>::~ThreadPoolT()
 template <typename MemBlockPtrT, typename ThreadStatT >
 void ThreadPoolT<MemBlockPtrT, ThreadStatT>::malloc(size_t sz, MemBlockPtrT & mem)
 {
+    enter();
     SizeClassT sc = MemBlockPtrT::sizeClass(sz);
     AllocFree & af = _memList[sc];
     af._allocFrom->sub(mem);
@@ -113,12 +195,14 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::malloc(size_t sz, MemBlockPtrT & me
     PARANOID_CHECK2(if (af._freeTo->count() > ChunkSList::NumBlocks) { *(int *)1 = 1; } );
     PARANOID_CHECK2(if (af._freeTo->full()) { *(int *)1 = 1; } );
     PARANOID_CHECK2(if (af._allocFrom->full()) { *(int *)1 = 1; } );
+    leave();
 }
 
 template <typename MemBlockPtrT, typename ThreadStatT >
 void ThreadPoolT<MemBlockPtrT, ThreadStatT>::free(MemBlockPtrT mem, SizeClassT sc)
 {
     PARANOID_CHECK2(if (!mem.validFree()) { *(int *)1 = 1; } );
+    enter();
     AllocFree & af = _memList[sc];
     const size_t cs(MemBlockPtrT::classSize(sc));
     if ((af._allocFrom->count()+1)*cs < _threadCacheLimit) {
@@ -151,6 +235,7 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::free(MemBlockPtrT mem, SizeClassT s
     PARANOID_CHECK2(if (af._allocFrom->count() > ChunkSList::NumBlocks) { *(int *)1 = 1; } );
     PARANOID_CHECK2(if (af._freeTo->count() > ChunkSList::NumBlocks) { *(int *)1 = 1; } );
     PARANOID_CHECK2(if (af._freeTo->full()) { *(int *)1 = 1; } );
+    leave();
 }
 
 template <typename MemBlockPtrT, typename ThreadStatT >